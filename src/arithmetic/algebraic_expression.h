@@ -37,6 +37,8 @@ struct AlgebraicExpression {
 			bool diagonal;          // Diagonal matrix.
 			bool bfree;             // If the matrix is scoped to this expression, it should be freed with it.
 			GrB_Matrix matrix;      // Matrix operand.
+			GrB_Matrix delta_plus;  // Entries added to matrix, see Graph_GetRelationMatrixDeltas.
+			GrB_Matrix delta_minus; // Entries deleted from matrix.
 			const char *src;        // Alias given to operand's rows (src node).
 			const char *dest;       // Alias given to operand's columns (destination node).
 			const char *edge;       // Alias given to operand (edge).
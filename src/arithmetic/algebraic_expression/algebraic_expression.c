@@ -177,6 +177,8 @@ AlgebraicExpression *AlgebraicExpression_NewOperand
 	AlgebraicExpression *node = rm_malloc(sizeof(AlgebraicExpression));
 	node->type = AL_OPERAND;
 	node->operand.matrix = mat;
+	node->operand.delta_plus = GrB_NULL;
+	node->operand.delta_minus = GrB_NULL;
 	node->operand.diagonal = diagonal;
 	node->operand.bfree = false;
 	node->operand.src = src;
@@ -6,11 +6,111 @@
 
 #include "utils.h"
 #include "../../query_ctx.h"
+#include "../../util/arr.h"
 #include "../algebraic_expression.h"
 
 // Forward declarations
 GrB_Matrix _AlgebraicExpression_Eval(const AlgebraicExpression *exp, GrB_Matrix res);
 
+// Returns operand's matrix, operands with pending changes are materialized
+// into a new matrix which is tracked by 'tmps'.
+static GrB_Matrix _Eval_OperandMatrix
+(
+	const AlgebraicExpression *operand,
+	GrB_Matrix **tmps
+) {
+	if(!_AlgebraicExpression_OperandHasDeltas(operand)) return operand->operand.matrix;
+
+	GrB_Matrix m = _AlgebraicExpression_MaterializeOperand(operand);
+	*tmps = array_append(*tmps, m);
+	return m;
+}
+
+static void _Eval_FreeTmps
+(
+	GrB_Matrix *tmps
+) {
+	uint n = array_len(tmps);
+	for(uint i = 0; i < n; i++) GrB_Matrix_free(tmps + i);
+	array_free(tmps);
+}
+
+/* res = A * (B + DP - DM)
+ * Rather than materializing B, entries added by DP are multiplied separately
+ * and deleted entries are discounted by counting the number of paths
+ * leading to each entry of the result, entries reachable only through
+ * deleted entries of B are dropped. A may alias res. */
+static void _Eval_MulOperand
+(
+	GrB_Matrix res,
+	GrB_Matrix A,
+	const AlgebraicExpression *operand,
+	GrB_Descriptor desc
+) {
+	GrB_Info info;
+	UNUSED(info);
+	GrB_Index nrows;
+	GrB_Index ncols;
+	GrB_Index additions = 0;
+	GrB_Index deletions = 0;
+	GrB_Matrix B = operand->operand.matrix;
+	GrB_Matrix DP = operand->operand.delta_plus;
+	GrB_Matrix DM = operand->operand.delta_minus;
+
+	if(DP != GrB_NULL) GrB_Matrix_nvals(&additions, DP);
+	if(DM != GrB_NULL) GrB_Matrix_nvals(&deletions, DM);
+
+	if(additions == 0 && deletions == 0) {
+		info = GrB_mxm(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, A, B, desc);
+		ASSERT(info == GrB_SUCCESS);
+		return;
+	}
+
+	GrB_Matrix_nrows(&nrows, res);
+	GrB_Matrix_ncols(&ncols, res);
+
+	// compute A * DP before res is overwritten
+	GrB_Matrix added = GrB_NULL;
+	if(additions > 0) {
+		GrB_Matrix_new(&added, GrB_BOOL, nrows, ncols);
+		info = GrB_mxm(added, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, A, DP, desc);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	if(deletions > 0) {
+		GrB_Matrix paths;
+		GrB_Matrix deleted;
+		GrB_Matrix_new(&paths, GrB_UINT64, nrows, ncols);
+		GrB_Matrix_new(&deleted, GrB_UINT64, nrows, ncols);
+
+		info = GrB_mxm(paths, GrB_NULL, GrB_NULL, GxB_PLUS_PAIR_UINT64, A, B, desc);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_mxm(deleted, GrB_NULL, GrB_NULL, GxB_PLUS_PAIR_UINT64, A, DM, desc);
+		ASSERT(info == GrB_SUCCESS);
+
+		// DM is contained in B, paths - deleted >= 0
+		info = GrB_eWiseAdd(paths, GrB_NULL, GrB_NULL, GrB_MINUS_UINT64, paths, deleted,
+				GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		// res<paths> = true, entries left with no path are masked out
+		info = GrB_Matrix_apply(res, paths, GrB_NULL, GxB_ONE_BOOL, paths, GrB_DESC_R);
+		ASSERT(info == GrB_SUCCESS);
+
+		GrB_Matrix_free(&paths);
+		GrB_Matrix_free(&deleted);
+	} else {
+		info = GrB_mxm(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, A, B, desc);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	if(added != GrB_NULL) {
+		info = GrB_eWiseAdd(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, res, added, GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+		GrB_Matrix_free(&added);
+	}
+}
+
 static GrB_Matrix _Eval_Transpose
 (
 	const AlgebraicExpression *exp,
@@ -21,8 +121,11 @@ static GrB_Matrix _Eval_Transpose
 
 	AlgebraicExpression *child = FIRST_CHILD(exp);
 	ASSERT(child->type == AL_OPERAND);
-	GrB_Info info = GrB_transpose(res, GrB_NULL, GrB_NULL, child->operand.matrix, GrB_NULL);
+	GrB_Matrix *tmps = array_new(GrB_Matrix, 0);
+	GrB_Matrix m = _Eval_OperandMatrix(child, &tmps);
+	GrB_Info info = GrB_transpose(res, GrB_NULL, GrB_NULL, m, GrB_NULL);
 	ASSERT(info == GrB_SUCCESS);
+	_Eval_FreeTmps(tmps);
 	return res;
 }
 
@@ -38,6 +141,7 @@ static GrB_Matrix _Eval_Add(const AlgebraicExpression *exp, GrB_Matrix res) {
 	GrB_Matrix b = GrB_NULL;        // Right operand.
 	GrB_Matrix inter = GrB_NULL;    // Intermediate matrix.
 	GrB_Descriptor desc = GrB_NULL; // Descriptor used for transposing operands (currently unused).
+	GrB_Matrix *tmps = array_new(GrB_Matrix, 0); // Materialized operands.
 
 	// Get left and right operands.
 	AlgebraicExpression *left = CHILD_AT(exp, 0);
@@ -46,11 +150,11 @@ static GrB_Matrix _Eval_Add(const AlgebraicExpression *exp, GrB_Matrix res) {
 	/* If left operand is a matrix, simply get it.
 	 * Otherwise evaluate left hand side using `res` to store LHS value. */
 	if(left->type == AL_OPERAND) {
-		a = left->operand.matrix;
+		a = _Eval_OperandMatrix(left, &tmps);
 	} else {
 		if(left->operation.op == AL_EXP_TRANSPOSE) {
 			ASSERT(AlgebraicExpression_ChildCount(left) == 1);
-			a = left->operation.children[0]->operand.matrix;
+			a = _Eval_OperandMatrix(left->operation.children[0], &tmps);
 			if(desc == GrB_NULL) GrB_Descriptor_new(&desc);
 			GrB_Descriptor_set(desc, GrB_INP0, GrB_TRAN);
 		} else {
@@ -62,11 +166,11 @@ static GrB_Matrix _Eval_Add(const AlgebraicExpression *exp, GrB_Matrix res) {
 	/* If right operand is a matrix, simply get it.
 	 * Otherwise evaluate right hand side using `res` if free or create an additional matrix to store RHS value. */
 	if(right->type == AL_OPERAND) {
-		b = right->operand.matrix;
+		b = _Eval_OperandMatrix(right, &tmps);
 	} else {
 		if(right->operation.op == AL_EXP_TRANSPOSE) {
 			ASSERT(AlgebraicExpression_ChildCount(right) == 1);
-			b = right->operation.children[0]->operand.matrix;
+			b = _Eval_OperandMatrix(right->operation.children[0], &tmps);
 			if(desc == GrB_NULL) GrB_Descriptor_new(&desc);
 			GrB_Descriptor_set(desc, GrB_INP1, GrB_TRAN);
 		} else if(res_in_use) {
@@ -97,11 +201,11 @@ static GrB_Matrix _Eval_Add(const AlgebraicExpression *exp, GrB_Matrix res) {
 		right = CHILD_AT(exp, i);
 
 		if(right->type == AL_OPERAND) {
-			b = right->operand.matrix;
+			b = _Eval_OperandMatrix(right, &tmps);
 		} else {
 			if(right->operation.op == AL_EXP_TRANSPOSE) {
 				ASSERT(AlgebraicExpression_ChildCount(right) == 1);
-				b = right->operation.children[0]->operand.matrix;
+				b = _Eval_OperandMatrix(right->operation.children[0], &tmps);
 				if(desc == GrB_NULL) GrB_Descriptor_new(&desc);
 				GrB_Descriptor_set(desc, GrB_INP1, GrB_TRAN);
 			} else {
@@ -124,6 +228,7 @@ static GrB_Matrix _Eval_Add(const AlgebraicExpression *exp, GrB_Matrix res) {
 
 	if(inter != GrB_NULL) GrB_Matrix_free(&inter);
 	if(desc != GrB_NULL) GrB_free(&desc);
+	_Eval_FreeTmps(tmps);
 	return res;
 }
 
@@ -138,6 +243,7 @@ static GrB_Matrix _Eval_Mul(const AlgebraicExpression *exp, GrB_Matrix res) {
 	GrB_Matrix B;
 	GrB_Index nvals;
 	GrB_Descriptor desc = GrB_NULL;
+	GrB_Matrix *tmps = array_new(GrB_Matrix, 0); // Materialized operands.
 	AlgebraicExpression *left = CHILD_AT(exp, 0);
 	AlgebraicExpression *right = CHILD_AT(exp, 1);
 
@@ -148,7 +254,7 @@ static GrB_Matrix _Eval_Mul(const AlgebraicExpression *exp, GrB_Matrix res) {
 		GrB_Descriptor_set(desc, GrB_INP0, GrB_TRAN);
 		left = CHILD_AT(left, 0);
 	}
-	A = left->operand.matrix;
+	A = _Eval_OperandMatrix(left, &tmps);
 
 	if(right->type == AL_OPERATION) {
 		ASSERT(right->operation.op == AL_EXP_TRANSPOSE);
@@ -167,8 +273,7 @@ static GrB_Matrix _Eval_Mul(const AlgebraicExpression *exp, GrB_Matrix res) {
 		ASSERT(info == GrB_SUCCESS);
 	} else {
 		// Perform multiplication.
-		info = GrB_mxm(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, A, B, desc);
-		ASSERT(info == GrB_SUCCESS);
+		_Eval_MulOperand(res, A, right, desc);
 	}
 
 	GrB_wait(&res);
@@ -195,14 +300,14 @@ static GrB_Matrix _Eval_Mul(const AlgebraicExpression *exp, GrB_Matrix res) {
 			// Reset descriptor, as the identity matrix does not need to be transposed.
 			if(desc != GrB_NULL) GrB_Descriptor_set(desc, GrB_INP1, GxB_DEFAULT);
 			// Perform multiplication.
-			info = GrB_mxm(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, res, B, desc);
-			ASSERT(info == GrB_SUCCESS);
+			_Eval_MulOperand(res, res, right, desc);
 		}
 		GrB_Matrix_nvals(&nvals, res);
 		if(nvals == 0) break;
 	}
 
 	if(desc != GrB_NULL) GrB_free(&desc);
+	_Eval_FreeTmps(tmps);
 
 	return res;
 }
@@ -433,6 +433,9 @@ static void _AlgebraicExpression_TransposeOperand(AlgebraicExpression *operand)
 	GrB_Index ncols;
 	GrB_Matrix replacement;
 	GrB_Matrix A = operand->operand.matrix;
+	// Apply pending changes prior to transposing.
+	bool materialized = _AlgebraicExpression_OperandHasDeltas(operand);
+	if(materialized) A = _AlgebraicExpression_MaterializeOperand(operand);
 	// Create a new empty matrix with the type and dimensions of the original.
 	GrB_Matrix_nrows(&nrows, A);
 	GrB_Matrix_ncols(&ncols, A);
@@ -454,8 +457,12 @@ static void _AlgebraicExpression_TransposeOperand(AlgebraicExpression *operand)
 		ASSERT(false);
 	}
 
+	if(materialized) GrB_Matrix_free(&A);
+
 	// Update the matrix pointer.
 	operand->operand.matrix = replacement;
+	operand->operand.delta_plus = GrB_NULL;
+	operand->operand.delta_minus = GrB_NULL;
 	// As this matrix was constructed, it must ultimately be freed.
 	operand->operand.bfree = true;
 }
@@ -242,20 +242,25 @@ static void _AlgebraicExpression_PopulateOperand(AlgebraicExpression *operand,
 	 * TODO Redesign _AlgebraicExpression_FromString to remove this condition. */
 	if(operand->operand.matrix != GrB_NULL) return;
 
+	// pending changes are kept apart and applied on evaluation
 	GrB_Matrix m = GrB_NULL;
+	GrB_Matrix dp = GrB_NULL;
+	GrB_Matrix dm = GrB_NULL;
 	const char *label = operand->operand.label;
 	if(label == NULL) {
-		m = Graph_GetAdjacencyMatrix(gc->g);
+		Graph_GetRelationMatrixDeltas(gc->g, GRAPH_NO_RELATION, false, &m, &dp, &dm);
 	} else if(operand->operand.diagonal) {
 		Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
 		if(!s) m = Graph_GetZeroMatrix(gc->g);
-		else m = Graph_GetLabelMatrix(gc->g, s->id);
+		else Graph_GetLabelMatrixDeltas(gc->g, s->id, &m, &dp, &dm);
 	} else {
 		Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_EDGE);
 		if(!s) m = Graph_GetZeroMatrix(gc->g);
-		else m = Graph_GetRelationMatrix(gc->g, s->id);
+		else Graph_GetRelationMatrixDeltas(gc->g, s->id, false, &m, &dp, &dm);
 	}
 	operand->operand.matrix = m;
+	operand->operand.delta_plus = dp;
+	operand->operand.delta_minus = dm;
 }
 
 // Populate a transposed operand with a transposed relationship matrix and swap the row/col domains.
@@ -274,15 +279,65 @@ static void _AlgebraicExpression_PopulateTransposedOperand(AlgebraicExpression *
 	if(operand->operand.matrix != GrB_NULL) return;
 
 	GrB_Matrix m = GrB_NULL;
+	GrB_Matrix dp = GrB_NULL;
+	GrB_Matrix dm = GrB_NULL;
 	const char *label = operand->operand.label;
 	if(label == NULL) {
-		m = Graph_GetTransposedAdjacencyMatrix(gc->g);
+		Graph_GetRelationMatrixDeltas(gc->g, GRAPH_NO_RELATION, true, &m, &dp, &dm);
 	} else {
 		Schema *s = GraphContext_GetSchema(gc, operand->operand.label, SCHEMA_EDGE);
 		if(!s) m = Graph_GetZeroMatrix(gc->g);
-		else m = Graph_GetTransposedRelationMatrix(gc->g, s->id);
+		else Graph_GetRelationMatrixDeltas(gc->g, s->id, true, &m, &dp, &dm);
 	}
 	operand->operand.matrix = m;
+	operand->operand.delta_plus = dp;
+	operand->operand.delta_minus = dm;
+}
+
+bool _AlgebraicExpression_OperandHasDeltas(const AlgebraicExpression *operand) {
+	ASSERT(operand->type == AL_OPERAND);
+
+	GrB_Index additions = 0;
+	GrB_Index deletions = 0;
+	if(operand->operand.delta_plus != GrB_NULL) {
+		GrB_Matrix_nvals(&additions, operand->operand.delta_plus);
+	}
+	if(operand->operand.delta_minus != GrB_NULL) {
+		GrB_Matrix_nvals(&deletions, operand->operand.delta_minus);
+	}
+	return (additions + deletions) > 0;
+}
+
+GrB_Matrix _AlgebraicExpression_MaterializeOperand(const AlgebraicExpression *operand) {
+	ASSERT(operand->type == AL_OPERAND);
+
+	GrB_Info info;
+	UNUSED(info);
+	GrB_Index nrows;
+	GrB_Index ncols;
+	GrB_Matrix res;
+	GrB_Matrix M = operand->operand.matrix;
+	GrB_Matrix_nrows(&nrows, M);
+	GrB_Matrix_ncols(&ncols, M);
+	GrB_Matrix_new(&res, GrB_BOOL, nrows, ncols);
+
+	// res<!DM> = M
+	if(operand->operand.delta_minus != GrB_NULL) {
+		info = GrB_Matrix_apply(res, operand->operand.delta_minus, GrB_NULL, GxB_ONE_BOOL, M,
+				GrB_DESC_RSC);
+	} else {
+		info = GrB_Matrix_apply(res, GrB_NULL, GrB_NULL, GxB_ONE_BOOL, M, GrB_NULL);
+	}
+	ASSERT(info == GrB_SUCCESS);
+
+	// res = res + DP
+	if(operand->operand.delta_plus != GrB_NULL) {
+		info = GrB_eWiseAdd(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, res,
+				operand->operand.delta_plus, GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	return res;
 }
 
 // TODO this function is only used within AlgebraicExpression_Optimize, consider moving it.
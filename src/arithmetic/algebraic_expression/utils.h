@@ -110,6 +110,20 @@ AlgebraicExpression *_AlgebraicExpression_GetOperand
 	uint operand_idx                    // Operand position (LTR, zero based).
 );
 
+// Returns true if the operand's matrix has pending changes,
+// see Graph_GetRelationMatrixDeltas.
+bool _AlgebraicExpression_OperandHasDeltas
+(
+	const AlgebraicExpression *operand  // Operand to inspect.
+);
+
+// Computes operand's matrix with its pending changes applied, M + DP - DM,
+// into a new boolean matrix, caller is responsible for freeing it.
+GrB_Matrix _AlgebraicExpression_MaterializeOperand
+(
+	const AlgebraicExpression *operand  // Operand to materialize.
+);
+
 // Resolves all missing operands, replacing transpose operations with
 // transposed operands if they are available.
 void _AlgebraicExpression_PopulateOperands
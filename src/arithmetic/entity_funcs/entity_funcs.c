@@ -163,6 +163,19 @@ SIValue AR_PROPERTY(SIValue *argv, int argc) {
 			prop_idx = GraphContext_GetAttributeID(gc, prop_name);
 		}
 
+		// Properties of labeled nodes may be held by a column.
+		if(SI_TYPE(obj) == T_NODE && prop_idx != ATTRIBUTE_NOTFOUND) {
+			Node *n = (Node *)graph_entity;
+			GraphContext *gc = QueryCtx_GetGraphCtx();
+			if(GraphContext_HasColumns(gc) && n->labelID != GRAPH_NO_LABEL &&
+			   n->id != INVALID_ENTITY_ID) {
+				Schema *s = GraphContext_GetSchemaByID(gc, n->labelID, SCHEMA_NODE);
+				PropertyColumn *c = Schema_GetColumn(s, prop_idx);
+				SIValue v;
+				if(c && PropertyColumn_Get(c, ENTITY_GET_ID(n), &v)) return v;
+			}
+		}
+
 		// Retrieve the property.
 		SIValue *value = GraphEntity_GetProperty(graph_entity, prop_idx);
 		return SI_ConstValue(*value);
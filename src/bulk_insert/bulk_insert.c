@@ -7,6 +7,7 @@
 #include "bulk_insert.h"
 #include "RG.h"
 #include "../schema/schema.h"
+#include "../util/arr.h"
 #include "../util/rmalloc.h"
 #include "../datatypes/array.h"
 #include <errno.h>
@@ -116,6 +117,9 @@ int _BulkInsert_ProcessNodeFile(RedisModuleCtx *ctx, GraphContext *gc, const cha
 	Attribute_ID *prop_indicies = _BulkInsert_ReadHeader(gc, SCHEMA_NODE, data, &data_idx, &label_id,
 														 &prop_count);
 
+	// Batches may target a label with property columns.
+	Schema *s = GraphContext_GetSchemaByID(gc, label_id, SCHEMA_NODE);
+
 	while(data_idx < data_len) {
 		Node n;
 		Graph_CreateNode(gc->g, label_id, &n);
@@ -126,6 +130,7 @@ int _BulkInsert_ProcessNodeFile(RedisModuleCtx *ctx, GraphContext *gc, const cha
 			if(SI_TYPE(value) == T_NULL) continue;
 			GraphEntity_AddProperty((GraphEntity *)&n, prop_indicies[i], value);
 		}
+		Schema_AddNodeToColumns(s, &n);
 	}
 
 	free(prop_indicies);
@@ -143,6 +148,7 @@ int _BulkInsert_ProcessRelationFile(RedisModuleCtx *ctx, GraphContext *gc, const
 														 &prop_count);
 	NodeID src;
 	NodeID dest;
+	Edge *edges = array_new(Edge, 0);
 
 	while(data_idx < data_len) {
 		Edge e;
@@ -153,7 +159,9 @@ int _BulkInsert_ProcessRelationFile(RedisModuleCtx *ctx, GraphContext *gc, const
 		dest = *(NodeID *)&data[data_idx];
 		data_idx += sizeof(NodeID);
 
-		Graph_ConnectNodes(gc->g, src, dest, reltype_id, &e);
+		// Edges are connected once the entire file is processed.
+		Graph_CreateEdge(gc->g, src, dest, reltype_id, &e);
+		edges = array_append(edges, e);
 
 		if(prop_count == 0) continue;
 
@@ -167,6 +175,13 @@ int _BulkInsert_ProcessRelationFile(RedisModuleCtx *ctx, GraphContext *gc, const
 		}
 	}
 
+	uint edge_count = array_len(edges);
+	Edge **connect = rm_malloc(sizeof(Edge *) * edge_count);
+	for(uint i = 0; i < edge_count; i++) connect[i] = edges + i;
+	Graph_ConnectNodesBatch(gc->g, connect, edge_count);
+	rm_free(connect);
+	array_free(edges);
+
 	free(prop_indicies);
 	return BULK_OK;
 }
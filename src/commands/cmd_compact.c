@@ -0,0 +1,96 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_compact.h"
+#include "../RG.h"
+#include "../util/rmalloc.h"
+#include "../graph/graph.h"
+#include "../util/thpool/pools.h"
+#include "../graph/compaction.h"
+#include "../graph/graphcontext.h"
+
+typedef struct {
+	RedisModuleBlockedClient *bc;  // Blocked client, NULL when running on the main thread.
+	GraphContext *gc;              // Graph to compact.
+	long long limit;               // Maximum number of entities relocated.
+} CompactCtx;
+
+// Compacts the graph while holding the GIL, replies and replicates.
+static void _Compact(RedisModuleCtx *ctx, CompactCtx *compact_ctx) {
+	uint64_t nodes;
+	uint64_t edges;
+	GraphContext *gc = compact_ctx->gc;
+
+	Graph_AcquireWriteLock(gc->g);
+	GraphContext_Compact(gc, compact_ctx->limit, &nodes, &edges);
+	Graph_ReleaseLock(gc->g);
+
+	char reply[128];
+	int len = snprintf(reply, sizeof(reply), "%llu nodes relocated, %llu edges relocated",
+					   (unsigned long long)nodes, (unsigned long long)edges);
+	RedisModule_ReplyWithStringBuffer(ctx, reply, len);
+
+	// Relocations must be mirrored by replicas.
+	if(nodes > 0 || edges > 0) {
+		RedisModule_Replicate(ctx, "graph.COMPACT", "cl", gc->graph_name, compact_ctx->limit);
+	}
+}
+
+// Runs on the writer thread, the GIL is acquired before the graph write lock
+// such that compaction doesn't stall Redis' main thread while waiting on queries.
+static void _CompactOnWriter(void *args) {
+	CompactCtx *compact_ctx = args;
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(compact_ctx->bc);
+
+	RedisModule_ThreadSafeContextLock(ctx);
+	_Compact(ctx, compact_ctx);
+	RedisModule_ThreadSafeContextUnlock(ctx);
+
+	GraphContext_Release(compact_ctx->gc);
+	RedisModule_FreeThreadSafeContext(ctx);
+	RedisModule_UnblockClient(compact_ctx->bc, NULL);
+	rm_free(compact_ctx);
+}
+
+/* GRAPH.COMPACT <graph> [limit]
+ * relocates up to 'limit' nodes and edges holding the highest IDs into free
+ * IDs, see compaction.h, replicas receive the passes of the background
+ * compaction task as GRAPH.COMPACT commands. */
+int MGraph_Compact(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc != 2 && argc != 3) return RedisModule_WrongArity(ctx);
+
+	long long limit = COMPACTION_SLICE;
+	if(argc == 3) {
+		if(RedisModule_StringToLongLong(argv[2], &limit) != REDISMODULE_OK || limit <= 0) {
+			RedisModule_ReplyWithError(ctx, "Error parsing compaction limit.");
+			return REDISMODULE_OK;
+		}
+	}
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], false, false);
+	// If the GraphContext is null, key access failed and an error has been emitted.
+	if(!gc) return REDISMODULE_ERR;
+
+	// Commands issued within a LUA script or multi exec block must
+	// run on Redis main thread, others are serialized with writers.
+	int flags = RedisModule_GetContextFlags(ctx);
+	if(flags & (REDISMODULE_CTX_FLAGS_MULTI | REDISMODULE_CTX_FLAGS_LUA |
+				REDISMODULE_CTX_FLAGS_LOADING)) {
+		CompactCtx compact_ctx = {.bc = NULL, .gc = gc, .limit = limit};
+		_Compact(ctx, &compact_ctx);
+		GraphContext_Release(gc);
+		return REDISMODULE_OK;
+	}
+
+	CompactCtx *compact_ctx = rm_malloc(sizeof(CompactCtx));
+	compact_ctx->bc = RedisModule_BlockClient(ctx, NULL, NULL, NULL, 0);
+	compact_ctx->gc = gc;
+	compact_ctx->limit = limit;
+	int res = ThreadPools_AddWorkWriter(_CompactOnWriter, compact_ctx);
+	ASSERT(res == 0);
+	UNUSED(res);
+	return REDISMODULE_OK;
+}
@@ -6,24 +6,84 @@
 
 #include "cmd_config.h"
 #include "../config.h"
+#include "../util/rmalloc.h"
 #include <string.h>
 
+// reply with a [name, value] pair
+// returns false if the field's value could not be retrieved
+static bool _Config_reply_field(RedisModuleCtx *ctx, Config_Option_Field field,
+		const char *config_name) {
+	switch(field) {
+		case Config_PROPERTIES_PLACEMENT:
+		case Config_DATABLOCK_PLACEMENT:
+		case Config_MATRIX_PLACEMENT:
+		case Config_SCRATCH_PLACEMENT:
+			{
+				NVM_Placement placement;
+				if(!Config_Option_get(field, &placement)) return false;
+				RedisModule_ReplyWithArray(ctx, 2);
+				RedisModule_ReplyWithCString(ctx, config_name);
+				RedisModule_ReplyWithCString(ctx, nvm_placement_name(placement));
+			}
+			break;
+
+		case Config_HUGEPAGES:
+			{
+				NVM_Pages pages;
+				if(!Config_Option_get(field, &pages)) return false;
+				RedisModule_ReplyWithArray(ctx, 2);
+				RedisModule_ReplyWithCString(ctx, config_name);
+				RedisModule_ReplyWithCString(ctx, nvm_pages_name(pages));
+			}
+			break;
+
+		case Config_NUMA_POLICY:
+			{
+				NVM_Numa numa;
+				if(!Config_Option_get(field, &numa)) return false;
+				RedisModule_ReplyWithArray(ctx, 2);
+				RedisModule_ReplyWithCString(ctx, config_name);
+				RedisModule_ReplyWithCString(ctx, nvm_numa_name(numa));
+			}
+			break;
+
+		case Config_PMEM_PATH:
+		case Config_PMEM_HEAP:
+		case Config_NUMA_NODES:
+			{
+				const char *path = NULL;
+				if(!Config_Option_get(field, &path)) return false;
+				RedisModule_ReplyWithArray(ctx, 2);
+				RedisModule_ReplyWithCString(ctx, config_name);
+				if(path) RedisModule_ReplyWithCString(ctx, path);
+				else RedisModule_ReplyWithNull(ctx);
+			}
+			break;
+
+		default:
+			{
+				long long value = 0;
+				if(!Config_Option_get(field, &value)) return false;
+				RedisModule_ReplyWithArray(ctx, 2);
+				RedisModule_ReplyWithCString(ctx, config_name);
+				RedisModule_ReplyWithLongLong(ctx, value);
+			}
+			break;
+	}
+
+	return true;
+}
+
 void _Config_get_all(RedisModuleCtx *ctx) {
 	uint config_count = Config_END_MARKER;
 	RedisModule_ReplyWithArray(ctx, config_count);
 
 	for(Config_Option_Field field = 0; field < Config_END_MARKER; field++) {
-		long long value = 0;
 		const char *config_name = Config_Field_name(field);
-		bool res = Config_Option_get(field, &value);
 
-		if(!res || config_name == NULL) {
+		if(config_name == NULL || !_Config_reply_field(ctx, field, config_name)) {
 			RedisModule_ReplyWithError(ctx, "Configuration field was not found");
 			return;
-		} else {
-			RedisModule_ReplyWithArray(ctx, 2);
-			RedisModule_ReplyWithCString(ctx, config_name);
-			RedisModule_ReplyWithLongLong(ctx, value);
 		}
 	}
 }
@@ -45,13 +105,7 @@ void _Config_get(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 		return;
 	}
 
-	long long value = 0;
-
-	if(Config_Option_get(config_field, &value)) {
-		RedisModule_ReplyWithArray(ctx, 2);
-		RedisModule_ReplyWithCString(ctx, config_name);
-		RedisModule_ReplyWithLongLong(ctx, value);
-	} else {
+	if(!_Config_reply_field(ctx, config_field, config_name)) {
 		RedisModule_ReplyWithError(ctx, "Configuration field was not found");
 	}
 }
@@ -100,6 +100,7 @@ static inline bool _validate_command_arity(GRAPH_Commands cmd, int arity) {
 		// Expect a command, graph name, a query, and optional config flags.
 		return arity >= 3 && arity <= 8;
 	case CMD_SLOWLOG:
+	case CMD_MEMORY:
 		// Expect just a command and graph name.
 		return arity == 2;
 	default:
@@ -120,6 +121,8 @@ static Command_Handler get_command_handler(GRAPH_Commands cmd) {
 		return Graph_Profile;
 	case CMD_SLOWLOG:
 		return Graph_Slowlog;
+	case CMD_MEMORY:
+		return Graph_Memory;
 	default:
 		ASSERT(false);
 	}
@@ -133,6 +136,7 @@ static GRAPH_Commands determine_command(const char *cmd_name) {
 	if(strcasecmp(cmd_name, "graph.EXPLAIN")  == 0) return CMD_EXPLAIN;
 	if(strcasecmp(cmd_name, "graph.PROFILE")  == 0) return CMD_PROFILE;
 	if(strcasecmp(cmd_name, "graph.SLOWLOG")  == 0) return CMD_SLOWLOG;
+	if(strcasecmp(cmd_name, "graph.MEMORY")   == 0) return CMD_MEMORY;
 
 	// we shouldn't reach this point
 	ASSERT(false);
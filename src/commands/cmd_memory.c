@@ -0,0 +1,44 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "./cmd_memory.h"
+#include "cmd_context.h"
+#include "../nvm_support/graph_memory.h"
+
+static void _ReplyUsage(RedisModuleCtx *ctx, const char *name,
+		const NVM_Usage *usage) {
+	RedisModule_ReplyWithArray(ctx, 2);
+	RedisModule_ReplyWithStringBuffer(ctx, name, strlen(name));
+	RedisModule_ReplyWithArray(ctx, 4);
+	RedisModule_ReplyWithStringBuffer(ctx, "dram", 4);
+	RedisModule_ReplyWithLongLong(ctx, usage->dram);
+	RedisModule_ReplyWithStringBuffer(ctx, "pmem", 4);
+	RedisModule_ReplyWithLongLong(ctx, usage->pmem);
+}
+
+// GRAPH.MEMORY <key>
+// replies with the bytes held on each kind per category, followed by a total
+void Graph_Memory(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	CommandCtx_TrackCtx(command_ctx);
+
+	GraphMemory mem = {0};
+	GraphMemory_Collect(gc, &mem);
+	NVM_Usage total = GraphMemory_Total(&mem);
+
+	RedisModule_ReplyWithArray(ctx, GRAPH_MEMORY_CATEGORY_COUNT + 1);
+	for(int c = 0; c < GRAPH_MEMORY_CATEGORY_COUNT; c++) {
+		_ReplyUsage(ctx, GraphMemory_CategoryName(c), mem.usage + c);
+	}
+	_ReplyUsage(ctx, "total", &total);
+
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
+
@@ -10,6 +10,8 @@
 #include <string.h>
 #include <limits.h>
 #include "util/redis_version.h"
+#include "util/rmalloc.h"
+#include "nvm_support/property_tiering.h"
 #include "../deps/GraphBLAS/Include/GraphBLAS.h"
 
 //-----------------------------------------------------------------------------
@@ -23,6 +25,26 @@
 #define OMP_THREAD_COUNT "OMP_THREAD_COUNT" // Config param, max number of OpenMP threads
 #define VKEY_MAX_ENTITY_COUNT "VKEY_MAX_ENTITY_COUNT" // Config param, max number of entities in each virtual key
 #define MAINTAIN_TRANSPOSED_MATRICES "MAINTAIN_TRANSPOSED_MATRICES" // Whether the module should maintain transposed relationship matrices
+#define PROPERTIES_PLACEMENT "PROPERTIES_PLACEMENT" // Config param, memory placement of entity properties
+#define DATABLOCK_PLACEMENT "DATABLOCK_PLACEMENT" // Config param, memory placement of DataBlock blocks
+#define MATRIX_PLACEMENT "MATRIX_PLACEMENT" // Config param, memory placement of GraphBLAS matrices
+#define SCRATCH_PLACEMENT "SCRATCH_PLACEMENT" // Config param, memory placement of all other allocations
+#define PMEM_PATH "PMEM_PATH" // Config param, directory backing the PMEM pool
+#define PROPERTIES_DRAM_BUDGET "PROPERTIES_DRAM_BUDGET" // Config param, DRAM bytes available to hot entity properties
+#define ALLOC_THRESHOLD "ALLOC_THRESHOLD" // Config param, allocations below this size are kept on DRAM under THRESHOLD placement
+#define ADAPTIVE_ALLOC_THRESHOLD "ADAPTIVE_ALLOC_THRESHOLD" // Config param, whether the allocation threshold is self-tuning
+#define PMEM_HEAP "PMEM_HEAP" // Config param, file backing the persistent heap
+#define CLUSTER_NODES_BY_LABEL "CLUSTER_NODES_BY_LABEL" // Config param, whether nodes are stored in per-label blocks
+#define HUGEPAGES "HUGEPAGES" // Config param, page size of DataBlock blocks and matrices
+#define NUMA_POLICY "NUMA_POLICY" // Config param, NUMA policy of DataBlock blocks and matrices
+#define NUMA_NODES "NUMA_NODES" // Config param, NUMA nodes the NUMA policy applies to
+#define DELTA_MAX_PENDING_CHANGES "DELTA_MAX_PENDING_CHANGES" // Config param, pending matrix changes triggering a background merge
+#define LAZY_TRANSPOSED_MATRICES "LAZY_TRANSPOSED_MATRICES" // Config param, whether transposed matrices are built on first use
+#define TRANSPOSED_MATRICES_MAX_MEMORY "TRANSPOSED_MATRICES_MAX_MEMORY" // Config param, memory of lazily built transposed matrices
+#define COMPACTION_THRESHOLD "COMPACTION_THRESHOLD" // Config param, percentage of free entity IDs triggering compaction
+#define PARALLEL_SCAN_THREADS "PARALLEL_SCAN_THREADS" // Config param, number of threads scanning nodes for aggregations
+#define TRAVERSE_BATCH_SIZE "TRAVERSE_BATCH_SIZE" // Config param, max number of records traversed at once
+#define JOIN_DRAM_BUDGET "JOIN_DRAM_BUDGET" // Config param, DRAM bytes a hash join's table may hold
 
 //------------------------------------------------------------------------------
 // Configuration defaults
@@ -30,6 +52,8 @@
 
 #define CACHE_SIZE_DEFAULT 25
 #define VKEY_MAX_ENTITY_COUNT_DEFAULT 100000
+#define DELTA_MAX_PENDING_CHANGES_DEFAULT 10000
+#define TRAVERSE_BATCH_SIZE_DEFAULT 4096
 
 extern RG_Config config; // global module configuration
 
@@ -72,6 +96,39 @@ static inline bool _Config_ParseYesNo(RedisModuleString *rm_str, bool *value) {
 	return res;
 }
 
+// parse placement policy, one of "DRAM", "PMEM" or "THRESHOLD"
+static inline bool _Config_ParsePlacement(RedisModuleString *rm_str, NVM_Placement *value) {
+	const char *str = RedisModule_StringPtrLen(rm_str, NULL);
+	return nvm_placement_parse(str, value);
+}
+
+// parse page size, one of "NO", "THP" or "HUGETLB"
+static inline bool _Config_ParsePages(RedisModuleString *rm_str, NVM_Pages *value) {
+	const char *str = RedisModule_StringPtrLen(rm_str, NULL);
+	return nvm_pages_parse(str, value);
+}
+
+// parse NUMA policy, one of "DEFAULT", "BIND" or "INTERLEAVE"
+static inline bool _Config_ParseNuma(RedisModuleString *rm_str, NVM_Numa *value) {
+	const char *str = RedisModule_StringPtrLen(rm_str, NULL);
+	return nvm_numa_parse(str, value);
+}
+
+// maps a placement configuration field to its allocation class
+static NVM_AllocClass _Config_PlacementClass(Config_Option_Field field) {
+	switch(field) {
+		case Config_PROPERTIES_PLACEMENT:
+			return NVM_CLASS_PROPERTIES;
+		case Config_DATABLOCK_PLACEMENT:
+			return NVM_CLASS_DATABLOCK;
+		case Config_MATRIX_PLACEMENT:
+			return NVM_CLASS_MATRIX;
+		default:
+			ASSERT(field == Config_SCRATCH_PLACEMENT);
+			return NVM_CLASS_SCRATCH;
+	}
+}
+
 //==============================================================================
 // Config access functions
 //==============================================================================
@@ -161,6 +218,187 @@ uint64_t Config_resultset_max_size_get(void) {
 	return config.resultset_size;
 }
 
+//------------------------------------------------------------------------------
+// memory placement
+//------------------------------------------------------------------------------
+
+void Config_placement_set(NVM_AllocClass cls, NVM_Placement placement) {
+	// placement is kept by the allocator, which consults it on every allocation
+	nvm_set_placement(cls, placement);
+}
+
+NVM_Placement Config_placement_get(NVM_AllocClass cls) {
+	return nvm_get_placement(cls);
+}
+
+//------------------------------------------------------------------------------
+// page size & NUMA
+//------------------------------------------------------------------------------
+
+void Config_hugepages_set(NVM_Pages pages) {
+	// page size is kept by the allocator, which consults it on every allocation
+	nvm_set_pages(pages);
+}
+
+NVM_Pages Config_hugepages_get(void) {
+	return nvm_get_pages();
+}
+
+void Config_numa_policy_set(NVM_Numa numa) {
+	nvm_set_numa(numa);
+}
+
+NVM_Numa Config_numa_policy_get(void) {
+	return nvm_get_numa();
+}
+
+bool Config_numa_nodes_set(const char *nodes) {
+	if(!nvm_set_numa_nodes(nodes)) return false;
+	if(config.numa_nodes) rm_free(config.numa_nodes);
+	config.numa_nodes = rm_strdup(nodes);
+	return true;
+}
+
+const char *Config_numa_nodes_get(void) {
+	return config.numa_nodes;
+}
+
+//------------------------------------------------------------------------------
+// PMEM path
+//------------------------------------------------------------------------------
+
+void Config_pmem_path_set(const char *path) {
+	if(config.pmem_path) rm_free(config.pmem_path);
+	config.pmem_path = rm_strdup(path);
+}
+
+const char *Config_pmem_path_get(void) {
+	return config.pmem_path;
+}
+
+//------------------------------------------------------------------------------
+// PMEM heap
+//------------------------------------------------------------------------------
+
+void Config_pmem_heap_set(const char *path) {
+	if(config.pmem_heap) rm_free(config.pmem_heap);
+	config.pmem_heap = rm_strdup(path);
+}
+
+const char *Config_pmem_heap_get(void) {
+	return config.pmem_heap;
+}
+
+//------------------------------------------------------------------------------
+// cluster nodes by label
+//------------------------------------------------------------------------------
+
+void Config_cluster_nodes_by_label_set(bool cluster) {
+	config.cluster_nodes_by_label = cluster;
+}
+
+bool Config_cluster_nodes_by_label_get(void) {
+	return config.cluster_nodes_by_label;
+}
+
+//------------------------------------------------------------------------------
+// properties DRAM budget
+//------------------------------------------------------------------------------
+
+void Config_properties_dram_budget_set(uint64_t budget) {
+	// budget is kept by property tiering, which consults it on every read
+	PropertyTiering_SetBudget(budget);
+}
+
+uint64_t Config_properties_dram_budget_get(void) {
+	return PropertyTiering_GetBudget();
+}
+
+//------------------------------------------------------------------------------
+// allocation threshold
+//------------------------------------------------------------------------------
+
+void Config_alloc_threshold_set(uint64_t threshold) {
+	nvm_set_threshold(threshold);
+}
+
+uint64_t Config_alloc_threshold_get(void) {
+	// reflects the tuned value when adaptive
+	return nvm_get_threshold();
+}
+
+void Config_adaptive_alloc_threshold_set(bool adaptive) {
+	nvm_set_threshold_adaptive(adaptive);
+}
+
+bool Config_adaptive_alloc_threshold_get(void) {
+	return nvm_get_threshold_adaptive();
+}
+
+//------------------------------------------------------------------------------
+// delta max pending changes
+//------------------------------------------------------------------------------
+
+void Config_delta_max_pending_changes_set(uint64_t max_pending_changes) {
+	config.delta_max_pending_changes = max_pending_changes;
+}
+
+uint64_t Config_delta_max_pending_changes_get(void) {
+	return config.delta_max_pending_changes;
+}
+
+//------------------------------------------------------------------------------
+// lazy transposed matrices
+//------------------------------------------------------------------------------
+
+void Config_lazy_transpose_set(bool lazy) {
+	config.lazy_transposed_matrices = lazy;
+}
+
+bool Config_lazy_transpose_get(void) {
+	return config.lazy_transposed_matrices;
+}
+
+void Config_transpose_max_memory_set(uint64_t max_memory) {
+	config.transposed_matrices_max_memory = max_memory;
+}
+
+uint64_t Config_transpose_max_memory_get(void) {
+	return config.transposed_matrices_max_memory;
+}
+
+void Config_compaction_threshold_set(uint64_t threshold) {
+	config.compaction_threshold = threshold;
+}
+
+uint64_t Config_compaction_threshold_get(void) {
+	return config.compaction_threshold;
+}
+
+void Config_parallel_scan_threads_set(uint nthreads) {
+	config.parallel_scan_threads = nthreads;
+}
+
+uint Config_parallel_scan_threads_get(void) {
+	return config.parallel_scan_threads;
+}
+
+void Config_traverse_batch_size_set(uint64_t batch_size) {
+	config.traverse_batch_size = batch_size;
+}
+
+uint64_t Config_traverse_batch_size_get(void) {
+	return config.traverse_batch_size;
+}
+
+void Config_join_dram_budget_set(uint64_t budget) {
+	config.join_dram_budget = budget;
+}
+
+uint64_t Config_join_dram_budget_get(void) {
+	return config.join_dram_budget;
+}
+
 bool Config_Contains_field(const char *field_str, Config_Option_Field *field) {
 	ASSERT(field_str != NULL);
 
@@ -178,6 +416,46 @@ bool Config_Contains_field(const char *field_str, Config_Option_Field *field) {
 		f = Config_CACHE_SIZE;
 	} else if(!(strcasecmp(field_str, RESULTSET_SIZE))) {
 		f = Config_RESULTSET_MAX_SIZE;
+	} else if(!(strcasecmp(field_str, PROPERTIES_PLACEMENT))) {
+		f = Config_PROPERTIES_PLACEMENT;
+	} else if(!(strcasecmp(field_str, DATABLOCK_PLACEMENT))) {
+		f = Config_DATABLOCK_PLACEMENT;
+	} else if(!(strcasecmp(field_str, MATRIX_PLACEMENT))) {
+		f = Config_MATRIX_PLACEMENT;
+	} else if(!(strcasecmp(field_str, SCRATCH_PLACEMENT))) {
+		f = Config_SCRATCH_PLACEMENT;
+	} else if(!(strcasecmp(field_str, PMEM_PATH))) {
+		f = Config_PMEM_PATH;
+	} else if(!(strcasecmp(field_str, PROPERTIES_DRAM_BUDGET))) {
+		f = Config_PROPERTIES_DRAM_BUDGET;
+	} else if(!(strcasecmp(field_str, ALLOC_THRESHOLD))) {
+		f = Config_ALLOC_THRESHOLD;
+	} else if(!(strcasecmp(field_str, ADAPTIVE_ALLOC_THRESHOLD))) {
+		f = Config_ADAPTIVE_ALLOC_THRESHOLD;
+	} else if(!(strcasecmp(field_str, PMEM_HEAP))) {
+		f = Config_PMEM_HEAP;
+	} else if(!(strcasecmp(field_str, CLUSTER_NODES_BY_LABEL))) {
+		f = Config_CLUSTER_NODES_BY_LABEL;
+	} else if(!(strcasecmp(field_str, HUGEPAGES))) {
+		f = Config_HUGEPAGES;
+	} else if(!(strcasecmp(field_str, NUMA_POLICY))) {
+		f = Config_NUMA_POLICY;
+	} else if(!(strcasecmp(field_str, NUMA_NODES))) {
+		f = Config_NUMA_NODES;
+	} else if(!(strcasecmp(field_str, DELTA_MAX_PENDING_CHANGES))) {
+		f = Config_DELTA_MAX_PENDING_CHANGES;
+	} else if(!(strcasecmp(field_str, LAZY_TRANSPOSED_MATRICES))) {
+		f = Config_LAZY_TRANSPOSE;
+	} else if(!(strcasecmp(field_str, TRANSPOSED_MATRICES_MAX_MEMORY))) {
+		f = Config_TRANSPOSE_MAX_MEMORY;
+	} else if(!(strcasecmp(field_str, COMPACTION_THRESHOLD))) {
+		f = Config_COMPACTION_THRESHOLD;
+	} else if(!(strcasecmp(field_str, PARALLEL_SCAN_THREADS))) {
+		f = Config_PARALLEL_SCAN_THREADS;
+	} else if(!(strcasecmp(field_str, TRAVERSE_BATCH_SIZE))) {
+		f = Config_TRAVERSE_BATCH_SIZE;
+	} else if(!(strcasecmp(field_str, JOIN_DRAM_BUDGET))) {
+		f = Config_JOIN_DRAM_BUDGET;
 	} else {
 		return false;
 	}
@@ -218,6 +496,86 @@ const char *Config_Field_name(Config_Option_Field field) {
 			name = ASYNC_DELETE;
 			break;
 
+		case Config_PROPERTIES_PLACEMENT:
+			name = PROPERTIES_PLACEMENT;
+			break;
+
+		case Config_DATABLOCK_PLACEMENT:
+			name = DATABLOCK_PLACEMENT;
+			break;
+
+		case Config_MATRIX_PLACEMENT:
+			name = MATRIX_PLACEMENT;
+			break;
+
+		case Config_SCRATCH_PLACEMENT:
+			name = SCRATCH_PLACEMENT;
+			break;
+
+		case Config_PMEM_PATH:
+			name = PMEM_PATH;
+			break;
+
+		case Config_PROPERTIES_DRAM_BUDGET:
+			name = PROPERTIES_DRAM_BUDGET;
+			break;
+
+		case Config_ALLOC_THRESHOLD:
+			name = ALLOC_THRESHOLD;
+			break;
+
+		case Config_ADAPTIVE_ALLOC_THRESHOLD:
+			name = ADAPTIVE_ALLOC_THRESHOLD;
+			break;
+
+		case Config_PMEM_HEAP:
+			name = PMEM_HEAP;
+			break;
+
+		case Config_CLUSTER_NODES_BY_LABEL:
+			name = CLUSTER_NODES_BY_LABEL;
+			break;
+
+		case Config_HUGEPAGES:
+			name = HUGEPAGES;
+			break;
+
+		case Config_NUMA_POLICY:
+			name = NUMA_POLICY;
+			break;
+
+		case Config_NUMA_NODES:
+			name = NUMA_NODES;
+			break;
+
+		case Config_DELTA_MAX_PENDING_CHANGES:
+			name = DELTA_MAX_PENDING_CHANGES;
+			break;
+
+		case Config_LAZY_TRANSPOSE:
+			name = LAZY_TRANSPOSED_MATRICES;
+			break;
+
+		case Config_TRANSPOSE_MAX_MEMORY:
+			name = TRANSPOSED_MATRICES_MAX_MEMORY;
+			break;
+
+		case Config_COMPACTION_THRESHOLD:
+			name = COMPACTION_THRESHOLD;
+			break;
+
+		case Config_PARALLEL_SCAN_THREADS:
+			name = PARALLEL_SCAN_THREADS;
+			break;
+
+		case Config_TRAVERSE_BATCH_SIZE:
+			name = TRAVERSE_BATCH_SIZE;
+			break;
+
+		case Config_JOIN_DRAM_BUDGET:
+			name = JOIN_DRAM_BUDGET;
+			break;
+
         //----------------------------------------------------------------------
         // invalid option
         //----------------------------------------------------------------------
@@ -260,6 +618,47 @@ void _Config_SetToDefaults(RedisModuleCtx *ctx) {
 
 	// no limit on result-set size
 	config.resultset_size = RESULTSET_SIZE_UNLIMITED;
+
+	// no PMEM pool, everything is placed on DRAM
+	config.pmem_path = NULL;
+	config.pmem_heap = NULL;
+	for(NVM_AllocClass cls = 0; cls < NVM_CLASS_COUNT; cls++) {
+		Config_placement_set(cls, NVM_PLACEMENT_DRAM);
+	}
+
+	// nodes are stored in insertion order, regardless of their label
+	config.cluster_nodes_by_label = false;
+
+	// regular pages, NUMA placement is left to the kernel
+	Config_hugepages_set(NVM_PAGES_DEFAULT);
+	Config_numa_policy_set(NVM_NUMA_DEFAULT);
+	config.numa_nodes = NULL;
+
+	// property tiering is disabled
+	Config_properties_dram_budget_set(0);
+
+	// fixed allocation threshold
+	Config_alloc_threshold_set(ALLOC_THRESHOLD_DEFAULT);
+	Config_adaptive_alloc_threshold_set(false);
+
+	// matrix deltas are merged once they hold this many changes
+	config.delta_max_pending_changes = DELTA_MAX_PENDING_CHANGES_DEFAULT;
+
+	// transposed matrices are maintained from the start, never dropped
+	config.lazy_transposed_matrices = false;
+	config.transposed_matrices_max_memory = 0;
+
+	// entity IDs are never relocated
+	config.compaction_threshold = 0;
+
+	// nodes are scanned by the query's thread
+	config.parallel_scan_threads = 1;
+
+	// traversals grow their batches up to this many records
+	config.traverse_batch_size = TRAVERSE_BATCH_SIZE_DEFAULT;
+
+	// hash join tables are kept on DRAM regardless of their size
+	config.join_dram_budget = 0;
 }
 
 int Config_Init(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
@@ -400,6 +799,219 @@ bool Config_Option_set(Config_Option_Field field, RedisModuleString *val) {
 			}
 			break;
 
+		//----------------------------------------------------------------------
+		// memory placement
+		//----------------------------------------------------------------------
+
+		case Config_PROPERTIES_PLACEMENT:
+		case Config_DATABLOCK_PLACEMENT:
+		case Config_MATRIX_PLACEMENT:
+		case Config_SCRATCH_PLACEMENT:
+			{
+				NVM_Placement placement;
+				if(!_Config_ParsePlacement(val, &placement)) return false;
+
+				Config_placement_set(_Config_PlacementClass(field), placement);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// PMEM path
+		//----------------------------------------------------------------------
+
+		case Config_PMEM_PATH:
+			{
+				size_t len;
+				const char *path = RedisModule_StringPtrLen(val, &len);
+				if(len == 0) return false;
+
+				Config_pmem_path_set(path);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// PMEM heap
+		//----------------------------------------------------------------------
+
+		case Config_PMEM_HEAP:
+			{
+				size_t len;
+				const char *path = RedisModule_StringPtrLen(val, &len);
+				if(len == 0) return false;
+
+				Config_pmem_heap_set(path);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// properties DRAM budget
+		//----------------------------------------------------------------------
+
+		case Config_PROPERTIES_DRAM_BUDGET:
+			{
+				long long budget;
+				if(!_Config_ParseInteger(val, &budget) || budget < 0) return false;
+
+				Config_properties_dram_budget_set(budget);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// allocation threshold
+		//----------------------------------------------------------------------
+
+		case Config_ALLOC_THRESHOLD:
+			{
+				long long threshold;
+				if(!_Config_ParsePositiveInteger(val, &threshold)) return false;
+
+				Config_alloc_threshold_set(threshold);
+			}
+			break;
+
+		case Config_ADAPTIVE_ALLOC_THRESHOLD:
+			{
+				bool adaptive;
+				if(!_Config_ParseYesNo(val, &adaptive)) return false;
+
+				Config_adaptive_alloc_threshold_set(adaptive);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// cluster nodes by label
+		//----------------------------------------------------------------------
+
+		case Config_CLUSTER_NODES_BY_LABEL:
+			{
+				bool cluster;
+				if(!_Config_ParseYesNo(val, &cluster)) return false;
+
+				Config_cluster_nodes_by_label_set(cluster);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// page size & NUMA
+		//----------------------------------------------------------------------
+
+		case Config_HUGEPAGES:
+			{
+				NVM_Pages pages;
+				if(!_Config_ParsePages(val, &pages)) return false;
+
+				Config_hugepages_set(pages);
+			}
+			break;
+
+		case Config_NUMA_POLICY:
+			{
+				NVM_Numa numa;
+				if(!_Config_ParseNuma(val, &numa)) return false;
+
+				Config_numa_policy_set(numa);
+			}
+			break;
+
+		case Config_NUMA_NODES:
+			{
+				size_t len;
+				const char *nodes = RedisModule_StringPtrLen(val, &len);
+				if(len == 0) return false;
+
+				if(!Config_numa_nodes_set(nodes)) return false;
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// delta max pending changes
+		//----------------------------------------------------------------------
+
+		case Config_DELTA_MAX_PENDING_CHANGES:
+			{
+				long long max_pending_changes;
+				if(!_Config_ParsePositiveInteger(val, &max_pending_changes)) return false;
+
+				Config_delta_max_pending_changes_set(max_pending_changes);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// lazy transposed matrices
+		//----------------------------------------------------------------------
+
+		case Config_LAZY_TRANSPOSE:
+			{
+				bool lazy;
+				if(!_Config_ParseYesNo(val, &lazy)) return false;
+
+				Config_lazy_transpose_set(lazy);
+			}
+			break;
+
+		case Config_TRANSPOSE_MAX_MEMORY:
+			{
+				long long max_memory;
+				if(!_Config_ParseInteger(val, &max_memory) || max_memory < 0) return false;
+
+				Config_transpose_max_memory_set(max_memory);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// compaction threshold
+		//----------------------------------------------------------------------
+
+		case Config_COMPACTION_THRESHOLD:
+			{
+				long long threshold;
+				if(!_Config_ParseInteger(val, &threshold) || threshold < 0 ||
+				   threshold > 100) return false;
+
+				Config_compaction_threshold_set(threshold);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// parallel scan threads
+		//----------------------------------------------------------------------
+
+		case Config_PARALLEL_SCAN_THREADS:
+			{
+				long long nthreads;
+				if(!_Config_ParsePositiveInteger(val, &nthreads)) return false;
+
+				Config_parallel_scan_threads_set(nthreads);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// traverse batch size
+		//----------------------------------------------------------------------
+
+		case Config_TRAVERSE_BATCH_SIZE:
+			{
+				long long batch_size;
+				if(!_Config_ParsePositiveInteger(val, &batch_size) ||
+				   batch_size > UINT32_MAX) return false;
+
+				Config_traverse_batch_size_set(batch_size);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// join DRAM budget
+		//----------------------------------------------------------------------
+
+		case Config_JOIN_DRAM_BUDGET:
+			{
+				long long budget;
+				if(!_Config_ParseInteger(val, &budget) || budget < 0) return false;
+
+				Config_join_dram_budget_set(budget);
+			}
+			break;
+
 	    //----------------------------------------------------------------------
 	    // invalid option
 	    //----------------------------------------------------------------------
@@ -526,6 +1138,244 @@ bool Config_Option_get(Config_Option_Field field, ...) {
 			}
 			break;
 
+		//----------------------------------------------------------------------
+		// memory placement
+		//----------------------------------------------------------------------
+
+		case Config_PROPERTIES_PLACEMENT:
+		case Config_DATABLOCK_PLACEMENT:
+		case Config_MATRIX_PLACEMENT:
+		case Config_SCRATCH_PLACEMENT:
+			{
+				va_start(ap, field);
+				NVM_Placement *placement = va_arg(ap, NVM_Placement*);
+				va_end(ap);
+
+				ASSERT(placement != NULL);
+				(*placement) = Config_placement_get(_Config_PlacementClass(field));
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// PMEM path
+		//----------------------------------------------------------------------
+
+		case Config_PMEM_PATH:
+			{
+				va_start(ap, field);
+				const char **pmem_path = va_arg(ap, const char**);
+				va_end(ap);
+
+				ASSERT(pmem_path != NULL);
+				(*pmem_path) = Config_pmem_path_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// PMEM heap
+		//----------------------------------------------------------------------
+
+		case Config_PMEM_HEAP:
+			{
+				va_start(ap, field);
+				const char **pmem_heap = va_arg(ap, const char**);
+				va_end(ap);
+
+				ASSERT(pmem_heap != NULL);
+				(*pmem_heap) = Config_pmem_heap_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// properties DRAM budget
+		//----------------------------------------------------------------------
+
+		case Config_PROPERTIES_DRAM_BUDGET:
+			{
+				va_start(ap, field);
+				uint64_t *budget = va_arg(ap, uint64_t*);
+				va_end(ap);
+
+				ASSERT(budget != NULL);
+				(*budget) = Config_properties_dram_budget_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// allocation threshold
+		//----------------------------------------------------------------------
+
+		case Config_ALLOC_THRESHOLD:
+			{
+				va_start(ap, field);
+				uint64_t *threshold = va_arg(ap, uint64_t*);
+				va_end(ap);
+
+				ASSERT(threshold != NULL);
+				(*threshold) = Config_alloc_threshold_get();
+			}
+			break;
+
+		case Config_ADAPTIVE_ALLOC_THRESHOLD:
+			{
+				va_start(ap, field);
+				bool *adaptive = va_arg(ap, bool*);
+				va_end(ap);
+
+				ASSERT(adaptive != NULL);
+				(*adaptive) = Config_adaptive_alloc_threshold_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// cluster nodes by label
+		//----------------------------------------------------------------------
+
+		case Config_CLUSTER_NODES_BY_LABEL:
+			{
+				va_start(ap, field);
+				bool *cluster = va_arg(ap, bool*);
+				va_end(ap);
+
+				ASSERT(cluster != NULL);
+				(*cluster) = Config_cluster_nodes_by_label_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// page size & NUMA
+		//----------------------------------------------------------------------
+
+		case Config_HUGEPAGES:
+			{
+				va_start(ap, field);
+				NVM_Pages *pages = va_arg(ap, NVM_Pages*);
+				va_end(ap);
+
+				ASSERT(pages != NULL);
+				(*pages) = Config_hugepages_get();
+			}
+			break;
+
+		case Config_NUMA_POLICY:
+			{
+				va_start(ap, field);
+				NVM_Numa *numa = va_arg(ap, NVM_Numa*);
+				va_end(ap);
+
+				ASSERT(numa != NULL);
+				(*numa) = Config_numa_policy_get();
+			}
+			break;
+
+		case Config_NUMA_NODES:
+			{
+				va_start(ap, field);
+				const char **nodes = va_arg(ap, const char**);
+				va_end(ap);
+
+				ASSERT(nodes != NULL);
+				(*nodes) = Config_numa_nodes_get();
+			}
+			break;
+
+		case Config_DELTA_MAX_PENDING_CHANGES:
+			{
+				va_start(ap, field);
+				uint64_t *max_pending_changes = va_arg(ap, uint64_t*);
+				va_end(ap);
+
+				ASSERT(max_pending_changes != NULL);
+				(*max_pending_changes) = Config_delta_max_pending_changes_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// lazy transposed matrices
+		//----------------------------------------------------------------------
+
+		case Config_LAZY_TRANSPOSE:
+			{
+				va_start(ap, field);
+				bool *lazy = va_arg(ap, bool*);
+				va_end(ap);
+
+				ASSERT(lazy != NULL);
+				(*lazy) = Config_lazy_transpose_get();
+			}
+			break;
+
+		case Config_TRANSPOSE_MAX_MEMORY:
+			{
+				va_start(ap, field);
+				uint64_t *max_memory = va_arg(ap, uint64_t*);
+				va_end(ap);
+
+				ASSERT(max_memory != NULL);
+				(*max_memory) = Config_transpose_max_memory_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// compaction threshold
+		//----------------------------------------------------------------------
+
+		case Config_COMPACTION_THRESHOLD:
+			{
+				va_start(ap, field);
+				uint64_t *threshold = va_arg(ap, uint64_t*);
+				va_end(ap);
+
+				ASSERT(threshold != NULL);
+				(*threshold) = Config_compaction_threshold_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// parallel scan threads
+		//----------------------------------------------------------------------
+
+		case Config_PARALLEL_SCAN_THREADS:
+			{
+				va_start(ap, field);
+				uint *nthreads = va_arg(ap, uint*);
+				va_end(ap);
+
+				ASSERT(nthreads != NULL);
+				(*nthreads) = Config_parallel_scan_threads_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// traverse batch size
+		//----------------------------------------------------------------------
+
+		case Config_TRAVERSE_BATCH_SIZE:
+			{
+				va_start(ap, field);
+				uint64_t *batch_size = va_arg(ap, uint64_t*);
+				va_end(ap);
+
+				ASSERT(batch_size != NULL);
+				(*batch_size) = Config_traverse_batch_size_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// join DRAM budget
+		//----------------------------------------------------------------------
+
+		case Config_JOIN_DRAM_BUDGET:
+			{
+				va_start(ap, field);
+				uint64_t *budget = va_arg(ap, uint64_t*);
+				va_end(ap);
+
+				ASSERT(budget != NULL);
+				(*budget) = Config_join_dram_budget_get();
+			}
+			break;
+
         //----------------------------------------------------------------------
         // invalid option
         //----------------------------------------------------------------------
@@ -20,7 +20,27 @@ typedef enum {
 	Config_RESULTSET_MAX_SIZE       = 4,  // max number of records in result-set
 	Config_MAINTAIN_TRANSPOSE       = 5,  // maintain transpose matrices
 	Config_VKEY_MAX_ENTITY_COUNT    = 6,  // max number of elements in vkey
-	Config_END_MARKER               = 7
+	Config_PROPERTIES_PLACEMENT     = 7,  // DRAM/PMEM placement of entity properties
+	Config_DATABLOCK_PLACEMENT      = 8,  // DRAM/PMEM placement of DataBlock blocks
+	Config_MATRIX_PLACEMENT         = 9,  // DRAM/PMEM placement of GraphBLAS matrices
+	Config_SCRATCH_PLACEMENT        = 10, // DRAM/PMEM placement of all other allocations
+	Config_PMEM_PATH                = 11, // directory backing the PMEM pool
+	Config_PROPERTIES_DRAM_BUDGET   = 12, // DRAM budget of hot entity properties
+	Config_ALLOC_THRESHOLD          = 13, // DRAM/PMEM size threshold of THRESHOLD placement
+	Config_ADAPTIVE_ALLOC_THRESHOLD = 14, // self-tune the allocation threshold
+	Config_PMEM_HEAP                = 15, // file backing the persistent heap
+	Config_CLUSTER_NODES_BY_LABEL   = 16, // store nodes in per-label blocks
+	Config_HUGEPAGES                = 17, // page size of DataBlock blocks and matrices
+	Config_NUMA_POLICY              = 18, // NUMA policy of DataBlock blocks and matrices
+	Config_NUMA_NODES               = 19, // NUMA nodes the NUMA policy applies to
+	Config_DELTA_MAX_PENDING_CHANGES = 20, // pending matrix changes triggering a merge
+	Config_LAZY_TRANSPOSE           = 21, // build transposed matrices on first use
+	Config_TRANSPOSE_MAX_MEMORY     = 22, // memory of lazily built transposed matrices
+	Config_COMPACTION_THRESHOLD     = 23, // percentage of free IDs triggering compaction
+	Config_PARALLEL_SCAN_THREADS    = 24, // number of threads scanning nodes for aggregations
+	Config_TRAVERSE_BATCH_SIZE      = 25, // max number of records traversed at once
+	Config_JOIN_DRAM_BUDGET         = 26, // DRAM budget of a hash join's table
+	Config_END_MARKER               = 27
 } Config_Option_Field;
 
 // configuration object
@@ -32,11 +52,38 @@ typedef struct {
 	uint64_t resultset_size;           // resultset maximum size, (-1) unlimited
 	uint64_t vkey_entity_count;        // The limit of number of entities encoded at once for each RDB key.
 	bool maintain_transposed_matrices; // If true, maintain a transposed version of each relationship matrix.
+	char *pmem_path;                   // Directory backing the PMEM pool, NULL for DRAM only.
+	char *pmem_heap;                   // File backing the persistent heap, NULL if disabled.
+	bool cluster_nodes_by_label;       // If true, nodes are stored in per-label blocks.
+	char *numa_nodes;                  // NUMA nodes of the NUMA policy, NULL for every node.
+	uint64_t delta_max_pending_changes; // Number of pending changes merged into a matrix in the background.
+	bool lazy_transposed_matrices;     // If true, transposed matrices are built on first use.
+	uint64_t transposed_matrices_max_memory; // Bytes lazily built transposed matrices may hold, 0 for unlimited.
+	uint64_t compaction_threshold;     // Percentage of free entity IDs triggering compaction, 0 to disable.
+	uint parallel_scan_threads;        // Number of threads scanning nodes for aggregations, 1 to disable.
+	uint64_t traverse_batch_size;      // Max number of records traversals multiply at once.
+	uint64_t join_dram_budget;         // Bytes a hash join's table may hold on DRAM, 0 for unlimited.
 } RG_Config;
 
 // Run-time configurable fields
-#define RUNTIME_CONFIG_COUNT 1
-static const Config_Option_Field RUNTIME_CONFIGS[] = { Config_RESULTSET_MAX_SIZE };
+#define RUNTIME_CONFIG_COUNT 15
+static const Config_Option_Field RUNTIME_CONFIGS[] = {
+	Config_RESULTSET_MAX_SIZE,
+	Config_PROPERTIES_PLACEMENT,
+	Config_DATABLOCK_PLACEMENT,
+	Config_MATRIX_PLACEMENT,
+	Config_SCRATCH_PLACEMENT,
+	Config_PROPERTIES_DRAM_BUDGET,
+	Config_ALLOC_THRESHOLD,
+	Config_ADAPTIVE_ALLOC_THRESHOLD,
+	Config_HUGEPAGES,
+	Config_NUMA_POLICY,
+	Config_DELTA_MAX_PENDING_CHANGES,
+	Config_TRANSPOSE_MAX_MEMORY,
+	Config_COMPACTION_THRESHOLD,
+	Config_TRAVERSE_BATCH_SIZE,
+	Config_JOIN_DRAM_BUDGET
+};
 
 // Set module-level configurations to defaults or to user arguments where provided.
 // returns REDISMODULE_OK on success, emits an error and returns REDISMODULE_ERR on failure.
@@ -9,10 +9,16 @@
 #include <pthread.h>
 #include <sys/types.h>
 #include "RG.h"
+#include "util/arr.h"
 #include "util/thpool/pools.h"
 #include "commands/cmd_context.h"
+#include "nvm_support/nvm.h"
+#include "nvm_support/pheap.h"
+#include "nvm_support/property_tiering.h"
+#include "graph/graphcontext.h"
 
 extern CommandCtx **command_ctxs;
+extern GraphContext **graphs_in_keyspace;  // global array tracking all extant GraphContexts
 
 static struct sigaction old_act;
 
@@ -37,9 +43,101 @@ static void logCommands(void) {
 	}
 }
 
+// report a size-class histogram as a dictionary field
+static void _InfoSizeClasses(RedisModuleInfoCtx *ctx, char *name,
+		const uint64_t *counts) {
+	char class_name[32];
+	RedisModule_InfoBeginDictField(ctx, name);
+	for(int c = 0; c < NVM_SIZE_CLASS_COUNT - 1; c++) {
+		snprintf(class_name, sizeof(class_name), "lt_%zu", nvm_size_class_limit(c));
+		RedisModule_InfoAddFieldULongLong(ctx, class_name, counts[c]);
+	}
+	snprintf(class_name, sizeof(class_name), "ge_%zu",
+			nvm_size_class_limit(NVM_SIZE_CLASS_COUNT - 2));
+	RedisModule_InfoAddFieldULongLong(ctx, class_name,
+			counts[NVM_SIZE_CLASS_COUNT - 1]);
+	RedisModule_InfoEndDictField(ctx);
+}
+
+// report DRAM/PMEM allocation threshold state
+static void _InfoAllocator(RedisModuleInfoCtx *ctx) {
+	if(RedisModule_InfoAddSection(ctx, "allocator") != REDISMODULE_OK) return;
+
+	NVM_Stats stats;
+	nvm_get_stats(&stats);
+
+	RedisModule_InfoAddFieldULongLong(ctx, "alloc_threshold", stats.threshold);
+	RedisModule_InfoAddFieldLongLong(ctx, "adaptive_alloc_threshold", stats.adaptive);
+	RedisModule_InfoAddFieldULongLong(ctx, "realloc_migrations",
+			stats.realloc_migrations);
+	RedisModule_InfoAddFieldULongLong(ctx, "realloc_migrated_bytes",
+			stats.realloc_migrated_bytes);
+	RedisModule_InfoAddFieldULongLong(ctx, "numa_policy_failures",
+			stats.numa_failures);
+	RedisModule_InfoAddFieldULongLong(ctx, "hugetlb_fallbacks",
+			stats.hugetlb_fallbacks);
+	_InfoSizeClasses(ctx, "size_class_allocs", stats.size_class_allocs);
+	_InfoSizeClasses(ctx, "size_class_bytes", stats.size_class_bytes);
+}
+
+// report bytes held on each kind as a dictionary field
+static void _InfoUsage(RedisModuleInfoCtx *ctx, const char *name,
+		const NVM_Usage *usage) {
+	RedisModule_InfoBeginDictField(ctx, (char *)name);
+	RedisModule_InfoAddFieldULongLong(ctx, "dram", usage->dram);
+	RedisModule_InfoAddFieldULongLong(ctx, "pmem", usage->pmem);
+	RedisModule_InfoEndDictField(ctx);
+}
+
+// report memory held on each kind
+// counters are maintained by the allocators as memory is allocated and freed,
+// GRAPH.MEMORY breaks a graph's memory down per category
+static void _InfoMemory(RedisModuleInfoCtx *ctx) {
+	if(RedisModule_InfoAddSection(ctx, "memory") != REDISMODULE_OK) return;
+
+	NVM_Usage allocated;
+	if(nvm_get_kind_usage(&allocated)) _InfoUsage(ctx, "allocated", &allocated);
+
+	RedisModule_InfoAddFieldULongLong(ctx, "persistent_heap", PHeap_Used());
+}
+
+// report property tiering between DRAM and PMEM
+static void _InfoTiering(RedisModuleInfoCtx *ctx) {
+	if(RedisModule_InfoAddSection(ctx, "tiering") != REDISMODULE_OK) return;
+
+	PropertyTiering_Stats stats;
+	PropertyTiering_GetStats(&stats);
+
+	RedisModule_InfoAddFieldULongLong(ctx, "dram_budget", PropertyTiering_GetBudget());
+	RedisModule_InfoAddFieldULongLong(ctx, "hot_threshold", stats.hot_threshold);
+	RedisModule_InfoAddFieldULongLong(ctx, "promotions", stats.promotions);
+	RedisModule_InfoAddFieldULongLong(ctx, "demotions", stats.demotions);
+}
+
+// report lazily built transposed matrices across all graphs
+static void _InfoTransposes(RedisModuleInfoCtx *ctx) {
+	if(RedisModule_InfoAddSection(ctx, "transposes") != REDISMODULE_OK) return;
+
+	TransposeStats stats = {0};
+	uint n = array_len(graphs_in_keyspace);
+	for(uint i = 0; i < n; i++) {
+		Graph_GetTransposeStats(graphs_in_keyspace[i]->g, &stats);
+	}
+
+	RedisModule_InfoAddFieldULongLong(ctx, "resident", stats.resident);
+	RedisModule_InfoAddFieldULongLong(ctx, "uses", stats.uses);
+	RedisModule_InfoAddFieldULongLong(ctx, "builds", stats.builds);
+	RedisModule_InfoAddFieldULongLong(ctx, "drops", stats.drops);
+}
+
 void InfoFunc(RedisModuleInfoCtx *ctx, int for_crash_report) {
-	// make sure information is requested for crash report
-	if(!for_crash_report) return;
+	if(!for_crash_report) {
+		_InfoAllocator(ctx);
+		_InfoMemory(ctx);
+		_InfoTiering(ctx);
+		_InfoTransposes(ctx);
+		return;
+	}
 
 	// pause all working threads
 	// NOTE: pausing is not an atomic action;
@@ -386,9 +386,13 @@ ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan) {
 
 	ExecutionPlan_Init(plan);
 
-	Record r = NULL;
-	// Execute the root operation and free the processed Record until the data stream is depleted.
-	while((r = OpBase_Consume(plan->root)) != NULL) ExecutionPlan_ReturnRecord(r->owner, r);
+	uint n = 0;
+	Record batch[OP_BATCH_SIZE];
+	// Execute the root operation and free the processed Records until the data stream is depleted.
+	do {
+		n = OpBase_ConsumeBatch(plan->root, batch, OP_BATCH_SIZE);
+		for(uint i = 0; i < n; i++) ExecutionPlan_ReturnRecord(batch[i]->owner, batch[i]);
+	} while(n == OP_BATCH_SIZE);
 
 	return QueryCtx_GetResultSet();
 }
@@ -412,6 +416,7 @@ bool ExecutionPlan_Drained(ExecutionPlan *plan) {
 
 static void _ExecutionPlan_Drain(OpBase *root) {
 	root->consume = deplete_consume;
+	root->consumeBatch = NULL;
 	for(int i = 0; i < root->childCount; i++) {
 		_ExecutionPlan_Drain(root->children[i]);
 	}
@@ -79,3 +79,17 @@ ExecutionPlan *ExecutionPlan_Clone(const ExecutionPlan *template) {
 	return clone;
 }
 
+/* Clones the tree of operations rooted at 'root' into a new ExecutionPlan,
+ * such that the clone can be executed independently of the template,
+ * e.g. on another thread. */
+ExecutionPlan *ExecutionPlan_CloneSegment(const OpBase *root) {
+	ASSERT(root != NULL);
+	// Store the original AST pointer.
+	AST *master_ast = QueryCtx_GetAST();
+	OpBase *clone_root = _CloneOpTree(NULL, (OpBase *)root, NULL);
+	ExecutionPlan *clone = (ExecutionPlan *)clone_root->plan;
+	clone->root = clone_root;
+	// Restore the original AST pointer.
+	QueryCtx_SetAST(master_ast);
+	return clone;
+}
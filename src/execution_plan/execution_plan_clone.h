@@ -11,3 +11,6 @@
 /* Clones an execution plan */
 ExecutionPlan *ExecutionPlan_Clone(const ExecutionPlan *plan);
 
+
+/* Clones the operations tree rooted at 'root' into a new execution plan. */
+ExecutionPlan *ExecutionPlan_CloneSegment(const OpBase *root);
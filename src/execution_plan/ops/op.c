@@ -39,12 +39,29 @@ void OpBase_Init(OpBase *op, OPType type, const char *name, fpInit init, fpConsu
 	op->clone = clone;
 	op->free = free;
 	op->profile = NULL;
+	op->consumeBatch = NULL;
 }
 
 inline Record OpBase_Consume(OpBase *op) {
 	return op->consume(op);
 }
 
+uint OpBase_ConsumeBatch(OpBase *op, Record *batch, uint cap) {
+	/* Profiled operations are consumed record by record,
+	 * such that their statistics are maintained. */
+	fpConsumeBatch consumeBatch = op->consumeBatch;
+	if(consumeBatch && !op->stats) return consumeBatch(op, batch, cap);
+
+	// Adapter for operations lacking a batch routine.
+	uint n = 0;
+	while(n < cap) {
+		Record r = OpBase_Consume(op);
+		if(!r) break;
+		batch[n++] = r;
+	}
+	return n;
+}
+
 int OpBase_Modifies(OpBase *op, const char *alias) {
 	if(!op->modifies) op->modifies = array_new(const char *, 1);
 	op->modifies = array_append(op->modifies, alias);
@@ -138,6 +155,12 @@ void OpBase_UpdateConsume(OpBase *op, fpConsume consume) {
 	 * otherwise update consume function. */
 	if(op->profile != NULL) op->profile = consume;
 	else op->consume = consume;
+	op->consumeBatch = NULL;
+}
+
+void OpBase_UpdateConsumeBatch(OpBase *op, fpConsumeBatch consumeBatch) {
+	ASSERT(op != NULL);
+	op->consumeBatch = consumeBatch;
 }
 
 inline Record OpBase_CreateRecord(const OpBase *op) {
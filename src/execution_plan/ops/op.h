@@ -16,6 +16,9 @@
 
 #define OP_REQUIRE_NEW_DATA(opRes) (opRes & (OP_DEPLETED | OP_REFRESH)) > 0
 
+// Number of records requested by batch consumers, see OpBase_ConsumeBatch.
+#define OP_BATCH_SIZE 256
+
 typedef enum {
 	OPType_ALL_NODE_SCAN,
 	OPType_NODE_BY_LABEL_SCAN,
@@ -51,6 +54,7 @@ typedef enum {
 	OPType_OR_APPLY_MULTIPLEXER,
 	OPType_AND_APPLY_MULTIPLEXER,
 	OPType_OPTIONAL,
+	OPType_EXCHANGE,
 } OPType;
 
 typedef enum {
@@ -84,6 +88,7 @@ struct ExecutionPlan;
 typedef void (*fpFree)(struct OpBase *);
 typedef OpResult(*fpInit)(struct OpBase *);
 typedef Record(*fpConsume)(struct OpBase *);
+typedef uint (*fpConsumeBatch)(struct OpBase *, Record *, uint);
 typedef OpResult(*fpReset)(struct OpBase *);
 typedef int (*fpToString)(const struct OpBase *, char *, uint);
 typedef struct OpBase *(*fpClone)(const struct ExecutionPlan *, const struct OpBase *);
@@ -102,6 +107,7 @@ struct OpBase {
 	fpClone clone;              // Operation clone.
 	fpConsume consume;          // Produce next record.
 	fpConsume profile;          // Profiled version of consume.
+	fpConsumeBatch consumeBatch;  // Produce up to N records, optional.
 	fpToString toString;        // Operation string representation.
 	const char *name;           // Operation name.
 	int childCount;             // Number of children.
@@ -123,6 +129,11 @@ void OpBase_Free(OpBase *op);       // Free op.
 Record OpBase_Consume(OpBase *op);  // Consume op.
 Record OpBase_Profile(OpBase *op);  // Profile op.
 
+/* Consume up to 'cap' records into 'batch', returns the number of records produced.
+ * A batch shorter than 'cap' indicates the operation is depleted.
+ * Operations without a batch routine are consumed record by record. */
+uint OpBase_ConsumeBatch(OpBase *op, Record *batch, uint cap);
+
 int OpBase_ToString(const OpBase *op, char *buff, uint buff_len);
 
 OpBase *OpBase_Clone(const struct ExecutionPlan *plan, const OpBase *op);
@@ -146,8 +157,12 @@ void OpBase_PropagateReset(OpBase *op); // Sends reset request to each operation
 bool OpBase_IsWriter(OpBase *op);
 
 // Update operation consume function.
+// Clears the batch consume function, which may no longer match.
 void OpBase_UpdateConsume(OpBase *op, fpConsume consume);
 
+// Update operation batch consume function.
+void OpBase_UpdateConsumeBatch(OpBase *op, fpConsumeBatch consumeBatch);
+
 // Creates a new record that will be populated during execution.
 Record OpBase_CreateRecord(const OpBase *op);
 
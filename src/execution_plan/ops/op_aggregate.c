@@ -226,8 +226,14 @@ static Record AggregateConsume(OpBase *opBase) {
 		r = OpBase_CreateRecord(opBase);
 		_aggregateRecord(op, r);
 	} else {
+		// Aggregate the child's records a batch at a time.
+		uint n = 0;
+		Record batch[OP_BATCH_SIZE];
 		OpBase *child = op->op.children[0];
-		while((r = OpBase_Consume(child))) _aggregateRecord(op, r);
+		do {
+			n = OpBase_ConsumeBatch(child, batch, OP_BATCH_SIZE);
+			for(uint i = 0; i < n; i++) _aggregateRecord(op, batch[i]);
+		} while(n == OP_BATCH_SIZE);
 	}
 
 	op->group_iter = CacheGroupIter(op->groups);
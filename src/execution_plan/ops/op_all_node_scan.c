@@ -5,6 +5,7 @@
 */
 
 #include "op_all_node_scan.h"
+#include "RG.h"
 #include "../../query_ctx.h"
 #include "shared/print_functions.h"
 
@@ -12,6 +13,7 @@
 static OpResult AllNodeScanInit(OpBase *opBase);
 static Record AllNodeScanConsume(OpBase *opBase);
 static Record AllNodeScanConsumeFromChild(OpBase *opBase);
+static uint AllNodeScanConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static OpResult AllNodeScanReset(OpBase *opBase);
 static OpBase *AllNodeScanClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void AllNodeScanFree(OpBase *opBase);
@@ -34,10 +36,20 @@ OpBase *NewAllNodeScanOp(const ExecutionPlan *plan, const char *alias) {
 	return (OpBase *)op;
 }
 
+void AllNodeScanOp_SetIDRange(AllNodeScan *op, NodeID start, NodeID end) {
+	ASSERT(op->op.childCount == 0);
+	if(op->iter) DataBlockIterator_Free(op->iter);
+	op->iter = DataBlock_ScanRange(QueryCtx_GetGraph()->nodes, start, end);
+}
+
 static OpResult AllNodeScanInit(OpBase *opBase) {
 	AllNodeScan *op = (AllNodeScan *)opBase;
-	if(opBase->childCount > 0) OpBase_UpdateConsume(opBase, AllNodeScanConsumeFromChild);
-	else op->iter = Graph_ScanNodes(QueryCtx_GetGraph());
+	if(opBase->childCount > 0) {
+		OpBase_UpdateConsume(opBase, AllNodeScanConsumeFromChild);
+	} else {
+		op->iter = Graph_ScanNodes(QueryCtx_GetGraph());
+		OpBase_UpdateConsumeBatch(opBase, AllNodeScanConsumeBatch);
+	}
 	return OP_OK;
 }
 
@@ -89,6 +101,23 @@ static Record AllNodeScanConsume(OpBase *opBase) {
 	return r;
 }
 
+static uint AllNodeScanConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	AllNodeScan *op = (AllNodeScan *)opBase;
+
+	uint n = 0;
+	Node node = GE_NEW_NODE();
+	while(n < cap) {
+		node.entity = (Entity *)DataBlockIterator_Next(op->iter, &node.id);
+		if(node.entity == NULL) break;
+
+		Record r = OpBase_CreateRecord(opBase);
+		Record_AddNode(r, op->nodeRecIdx, node);
+		batch[n++] = r;
+	}
+
+	return n;
+}
+
 static OpResult AllNodeScanReset(OpBase *op) {
 	AllNodeScan *allNodeScan = (AllNodeScan *)op;
 	if(allNodeScan->iter) DataBlockIterator_Reset(allNodeScan->iter);
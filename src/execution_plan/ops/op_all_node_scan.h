@@ -25,3 +25,6 @@ typedef struct {
 
 OpBase *NewAllNodeScanOp(const ExecutionPlan *plan, const char *alias);
 
+/* Restricts the scan to node IDs within [start, end), restarting it. */
+void AllNodeScanOp_SetIDRange(AllNodeScan *op, NodeID start, NodeID end);
+
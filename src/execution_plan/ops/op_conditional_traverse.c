@@ -8,9 +8,7 @@
 #include "RG.h"
 #include "shared/print_functions.h"
 #include "../../query_ctx.h"
-
-// default number of records to accumulate before traversing
-#define BATCH_SIZE 16
+#include "../../config.h"
 
 /* Forward declarations. */
 static OpResult CondTraverseInit(OpBase *opBase);
@@ -29,9 +27,58 @@ static void _populate_filter_matrix(OpCondTraverse *op) {
 		/* Update filter matrix F, set row i at position srcId
 		 * F[i, srcId] = true. */
 		Node *n = Record_GetNode(r, op->srcNodeIdx);
-		NodeID srcId = ENTITY_GET_ID(n);
-		GrB_Matrix_setElement_BOOL(op->F, true, i, srcId);
+		op->filter_cols[i] = ENTITY_GET_ID(n);
 	}
+	/* Build F at once from tuples already sorted by row,
+	 * rather than assembling pending tuples set one at a time. */
+	GrB_Matrix_build_BOOL(op->F, op->filter_rows, op->filter_cols, op->filter_vals,
+						  op->record_count, GrB_LOR);
+}
+
+/* Locates the destination label operand, a diagonal operand at the right
+ * end of the expression reached through multiplications and transposes only.
+ * Returns NULL if there's no such operand. */
+static AlgebraicExpression *_dest_label_operand(OpCondTraverse *op) {
+	if(op->dest_label == NULL) return NULL;
+	if(AlgebraicExpression_OperandCount(op->ae) < 2) return NULL;
+
+	bool transpose = false;
+	AlgebraicExpression *current = op->ae;
+	while(current->type == AL_OPERATION) {
+		uint child_count = AlgebraicExpression_ChildCount(current);
+		switch(current->operation.op) {
+		case AL_EXP_TRANSPOSE:
+			transpose = !transpose;
+			current = current->operation.children[0];
+			break;
+		case AL_EXP_MUL:
+			current = transpose ? current->operation.children[0] :
+					  current->operation.children[child_count - 1];
+			break;
+		default:
+			// Destination is reached through an addition or power.
+			return NULL;
+		}
+	}
+
+	if(!current->operand.diagonal || current->operand.label == NULL) return NULL;
+	if(strcmp(current->operand.label, op->dest_label) != 0) return NULL;
+	return current;
+}
+
+/* Replaces multiplication by the destination label matrix
+ * with a lookup into the label's bitmap, see Graph_NodeHasLabel. */
+static void _strip_dest_label(OpCondTraverse *op) {
+	if(_dest_label_operand(op) == NULL) return;
+
+	AlgebraicExpression *label_operand = AlgebraicExpression_RemoveDest(&op->ae);
+	AlgebraicExpression_Free(label_operand);
+
+	// Resolve label ID at runtime, missing label filters out every node.
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *schema = GraphContext_GetSchema(gc, op->dest_label, SCHEMA_NODE);
+	op->dest_label_id = (schema) ? schema->id : GRAPH_UNKNOWN_LABEL;
+	op->filter_dest = true;
 }
 
 /* Evaluate algebraic expression:
@@ -48,8 +95,21 @@ void _traverse(OpCondTraverse *op) {
 		size_t required_dim = Graph_RequiredMatrixDim(op->graph);
 		GrB_Matrix_new(&op->M, GrB_BOOL, op->record_cap, required_dim);
 		GrB_Matrix_new(&op->F, GrB_BOOL, op->record_cap, required_dim);
+
+		/* Tuples of the filter matrix, reused across batches,
+		 * only source IDs change from one batch to the next. */
+		op->filter_rows = rm_malloc(op->record_cap * sizeof(GrB_Index));
+		op->filter_cols = rm_malloc(op->record_cap * sizeof(GrB_Index));
+		op->filter_vals = rm_malloc(op->record_cap * sizeof(bool));
+		for(uint i = 0; i < op->record_cap; i++) {
+			op->filter_rows[i] = i;
+			op->filter_vals[i] = true;
+		}
 		GxB_set(op->M, GxB_SPARSITY_CONTROL, GxB_SPARSE);
 
+		// Filter destination nodes by label bitmap.
+		_strip_dest_label(op);
+
 		// Prepend the filter matrix to algebraic expression as the leftmost operand.
 		AlgebraicExpression_MultiplyToTheLeft(&op->ae, op->F);
 
@@ -63,6 +123,12 @@ void _traverse(OpCondTraverse *op) {
 	// Evaluate expression.
 	AlgebraicExpression_Eval(op->ae, op->M);
 
+	// Size the next batch by the fan-out of this one.
+	GrB_Index entries;
+	GrB_Matrix_nvals(&entries, op->M);
+	op->batch_size = Traverse_AdaptBatchSize(op->batch_size, op->record_cap,
+											 op->record_count, entries);
+
 	if(op->iter == NULL) GxB_MatrixTupleIter_new(&op->iter, op->M);
 	else GxB_MatrixTupleIter_reuse(op->iter, op->M);
 
@@ -79,10 +145,15 @@ OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpressi
 	op->F = GrB_NULL;
 	op->M = GrB_NULL;
 	op->records = NULL;
+	op->filter_rows = NULL;
+	op->filter_cols = NULL;
+	op->filter_vals = NULL;
 	op->record_count = 0;
 	op->edge_ctx = NULL;
 	op->dest_label = NULL;
-	op->record_cap = BATCH_SIZE;
+	op->filter_dest = false;
+	op->record_cap = UNLIMITED;
+	op->batch_size = TRAVERSE_INITIAL_BATCH_SIZE;
 	op->dest_label_id = GRAPH_NO_LABEL;
 
 	// Set our Op operations
@@ -117,9 +188,13 @@ static OpResult CondTraverseInit(OpBase *opBase) {
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
 	// Create 'records' with this Init function as 'record_cap'
 	// might be set during optimization time (applyLimit)
-	// If cap greater than BATCH_SIZE is specified,
-	// use BATCH_SIZE as the value.
-	if(op->record_cap > BATCH_SIZE) op->record_cap = BATCH_SIZE;
+	// If cap greater than TRAVERSE_BATCH_SIZE is specified,
+	// use TRAVERSE_BATCH_SIZE as the value.
+	uint64_t max_batch_size;
+	Config_Option_get(Config_TRAVERSE_BATCH_SIZE, &max_batch_size);
+	if(op->record_cap > max_batch_size) op->record_cap = max_batch_size;
+	// Batches start small and adapt to the observed fan-out.
+	if(op->batch_size > op->record_cap) op->batch_size = op->record_cap;
 	op->records = rm_calloc(op->record_cap, sizeof(Record));
 	return OP_OK;
 }
@@ -143,7 +218,12 @@ static Record CondTraverseConsume(OpBase *opBase) {
 		if(op->iter) GxB_MatrixTupleIter_next(op->iter, &src_id, &dest_id, &depleted);
 
 		// Managed to get a tuple, break.
-		if(!depleted) break;
+		if(!depleted) {
+			// Skip destination nodes missing the destination label.
+			if(op->filter_dest &&
+			   !Graph_NodeHasLabel(op->graph, dest_id, (int)op->dest_label_id)) continue;
+			break;
+		}
 
 		/* Run out of tuples, try to get new data.
 		 * Free old records. */
@@ -151,7 +231,7 @@ static Record CondTraverseConsume(OpBase *opBase) {
 		for(uint i = 0; i < op->record_count; i++) OpBase_DeleteRecord(op->records[i]);
 
 		// Ask child operations for data.
-		for(op->record_count = 0; op->record_count < op->record_cap; op->record_count++) {
+		for(op->record_count = 0; op->record_count < op->batch_size; op->record_count++) {
 			Record childRecord = OpBase_Consume(child);
 			// If the Record is NULL, the child has been depleted.
 			if(!childRecord) break;
@@ -216,7 +296,14 @@ static OpResult CondTraverseReset(OpBase *ctx) {
 static inline OpBase *CondTraverseClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_CONDITIONAL_TRAVERSE);
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
-	return NewCondTraverseOp(plan, QueryCtx_GetGraph(), AlgebraicExpression_Clone(op->ae));
+	OpCondTraverse *clone = (OpCondTraverse *)NewCondTraverseOp(plan, QueryCtx_GetGraph(),
+															   AlgebraicExpression_Clone(op->ae));
+	// The cloned expression lacks the destination label operand if it was stripped.
+	clone->filter_dest = op->filter_dest;
+	clone->dest_label_id = op->dest_label_id;
+	// Keep the cap imposed by a downstream LIMIT.
+	clone->record_cap = op->record_cap;
+	return (OpBase *)clone;
 }
 
 /* Frees CondTraverse */
@@ -237,6 +324,15 @@ static void CondTraverseFree(OpBase *ctx) {
 		op->M = GrB_NULL;
 	}
 
+	if(op->filter_rows) {
+		rm_free(op->filter_rows);
+		rm_free(op->filter_cols);
+		rm_free(op->filter_vals);
+		op->filter_rows = NULL;
+		op->filter_cols = NULL;
+		op->filter_vals = NULL;
+	}
+
 	if(op->ae) {
 		AlgebraicExpression_Free(op->ae);
 		op->ae = NULL;
@@ -36,6 +36,13 @@ void _DeleteEntities(OpDelete *op) {
 		}
 	}
 
+	if(GraphContext_HasColumns(op->gc)) {
+		for(int i = 0; i < node_count; i++) {
+			Node *n = op->deleted_nodes + i;
+			GraphContext_DeleteNodeFromColumns(op->gc, n);
+		}
+	}
+
 	Graph_BulkDelete(g, op->deleted_nodes, node_count, op->deleted_edges,
 					 edge_count, &node_deleted, &relationships_deleted);
 
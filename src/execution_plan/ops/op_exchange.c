@@ -0,0 +1,273 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "op_exchange.h"
+#include "RG.h"
+#include "op_all_node_scan.h"
+#include "op_node_by_label_scan.h"
+#include "../../errors.h"
+#include "../../query_ctx.h"
+#include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+#include "../execution_plan_clone.h"
+#include "../../ast/ast_shared.h"
+#include <setjmp.h>
+
+/* Forward declarations. */
+static OpResult ExchangeInit(OpBase *opBase);
+static Record ExchangeConsume(OpBase *opBase);
+static uint ExchangeConsumeBatch(OpBase *opBase, Record *batch, uint cap);
+static OpResult ExchangeReset(OpBase *opBase);
+static OpBase *ExchangeClone(const ExecutionPlan *plan, const OpBase *opBase);
+static void ExchangeFree(OpBase *opBase);
+
+static inline int ExchangeToString(const OpBase *ctx, char *buf, uint buf_len) {
+	return snprintf(buf, buf_len, "%s | Workers: %u", ctx->name, ((OpExchange *)ctx)->worker_count);
+}
+
+OpBase *NewExchangeOp(const ExecutionPlan *plan, uint worker_count) {
+	ASSERT(worker_count > 0);
+
+	OpExchange *op = rm_malloc(sizeof(OpExchange));
+	op->worker_count = worker_count;
+	op->sequential = false;
+	op->segments = NULL;
+	op->scans = NULL;
+	op->buffers = NULL;
+	op->errors = NULL;
+	op->round_workers = 0;
+	op->buffer_idx = 0;
+	op->record_idx = 0;
+	op->next_morsel = 0;
+	op->morsel_count = 0;
+
+	// Set our Op operations
+	OpBase_Init((OpBase *)op, OPType_EXCHANGE, "Exchange", ExchangeInit, ExchangeConsume,
+				ExchangeReset, ExchangeToString, ExchangeClone, ExchangeFree, false, plan);
+	OpBase_UpdateConsumeBatch((OpBase *)op, ExchangeConsumeBatch);
+
+	return (OpBase *)op;
+}
+
+OpBase *Exchange_SegmentScan(OpBase *root) {
+	OpBase *op = root;
+
+	// Records flow through filters and projections only.
+	while(op->type == OPType_FILTER || op->type == OPType_PROJECT) {
+		if(op->childCount != 1 || op->plan != root->plan) return NULL;
+		op = op->children[0];
+	}
+
+	if(op->childCount != 0 || op->plan != root->plan) return NULL;
+	if(op->type == OPType_ALL_NODE_SCAN ||
+	   op->type == OPType_NODE_BY_LABEL_SCAN ||
+	   op->type == OPType_NODE_BY_LABEL_AND_ID_SCAN) return op;
+
+	return NULL;
+}
+
+static OpResult ExchangeInit(OpBase *opBase) {
+	OpExchange *op = (OpExchange *)opBase;
+	/* Profiled segments are consumed directly,
+	 * such that each operation reports its own statistics. */
+	op->sequential = (op->worker_count == 1 || opBase->stats != NULL);
+	if(op->sequential) OpBase_UpdateConsumeBatch(opBase, NULL);
+	return OP_OK;
+}
+
+// Clone the segment for each worker, segments are initialized by the query's thread.
+static void _Exchange_BuildSegments(OpExchange *op) {
+	OpBase *child = op->op.children[0];
+	op->segments = rm_malloc(op->worker_count * sizeof(ExecutionPlan *));
+	op->scans = rm_malloc(op->worker_count * sizeof(OpBase *));
+	op->buffers = rm_malloc(op->worker_count * sizeof(Record *));
+	op->errors = rm_calloc(op->worker_count, sizeof(char *));
+
+	for(uint i = 0; i < op->worker_count; i++) {
+		ExecutionPlan *segment = ExecutionPlan_CloneSegment(child);
+		ExecutionPlan_Init(segment);
+		op->segments[i] = segment;
+		op->scans[i] = Exchange_SegmentScan(segment->root);
+		op->buffers[i] = array_new(Record, OP_BATCH_SIZE);
+		ASSERT(op->scans[i] != NULL);
+	}
+
+	uint64_t id_count = Graph_RequiredMatrixDim(QueryCtx_GetGraph());
+	op->morsel_count = (id_count + EXCHANGE_MORSEL_SIZE - 1) / EXCHANGE_MORSEL_SIZE;
+	if(op->morsel_count == 0) op->morsel_count = 1;
+}
+
+// Restrict the scan of a segment clone to morsel 'morsel'.
+static void _Exchange_SetMorsel(OpExchange *op, OpBase *scan, uint64_t morsel) {
+	NodeID start = morsel * EXCHANGE_MORSEL_SIZE;
+	// The last morsel extends to the end of the ID space,
+	// as nodes may be created once the morsels are set.
+	NodeID end = (morsel + 1 == op->morsel_count) ? UINT64_MAX : start + EXCHANGE_MORSEL_SIZE;
+
+	if(scan->type == OPType_ALL_NODE_SCAN) {
+		AllNodeScanOp_SetIDRange((AllNodeScan *)scan, start, end);
+		return;
+	}
+
+	// Intersect the morsel with the template's ID range.
+	OpBase *template = Exchange_SegmentScan(op->op.children[0]);
+	UnsignedRange *range = UnsignedRange_Clone(((NodeByLabelScan *)template)->id_range);
+	UnsignedRange_TightenRange(range, OP_GE, start);
+	UnsignedRange_TightenRange(range, OP_LT, end);
+	NodeByLabelScanOp_SetIDRange((NodeByLabelScan *)scan, range);
+	UnsignedRange_Free(range);
+}
+
+// Executes segment 'worker' over morsel 'morsel', buffering its records.
+static void _Exchange_RunMorsel(OpExchange *op, uint worker, uint64_t morsel,
+								QueryCtx *query_ctx) {
+	// Workers share the query's context.
+	QueryCtx *prev_query_ctx = pthread_getspecific(_tlsQueryCtxKey);
+	QueryCtx_SetTLS(query_ctx);
+
+	// Runtime errors raised by the segment resume here.
+	jmp_buf breakpoint;
+	ErrorCtx *error_ctx = ErrorCtx_Get();
+	jmp_buf *prev_breakpoint = error_ctx->breakpoint;
+	error_ctx->breakpoint = &breakpoint;
+
+	if(setjmp(breakpoint) == 0) {
+		_Exchange_SetMorsel(op, op->scans[worker], morsel);
+
+		uint n = 0;
+		Record batch[OP_BATCH_SIZE];
+		OpBase *root = op->segments[worker]->root;
+		do {
+			n = OpBase_ConsumeBatch(root, batch, OP_BATCH_SIZE);
+			for(uint i = 0; i < n; i++) op->buffers[worker] = array_append(op->buffers[worker], batch[i]);
+		} while(n == OP_BATCH_SIZE);
+	} else {
+		// Hand the error over to the query's thread.
+		op->errors[worker] = error_ctx->error;
+		error_ctx->error = NULL;
+	}
+
+	error_ctx->breakpoint = prev_breakpoint;
+	QueryCtx_SetTLS(prev_query_ctx);
+}
+
+// Scans the next round of morsels, returns false once every morsel was scanned.
+static bool _Exchange_RunRound(OpExchange *op) {
+	if(!op->segments) _Exchange_BuildSegments(op);
+	if(op->next_morsel == op->morsel_count) return false;
+
+	uint64_t remaining = op->morsel_count - op->next_morsel;
+	uint workers = (remaining < op->worker_count) ? remaining : op->worker_count;
+	uint64_t first_morsel = op->next_morsel;
+	QueryCtx *query_ctx = QueryCtx_GetQueryCtx();
+
+	#pragma omp parallel for num_threads(workers) schedule(static, 1)
+	for(uint i = 0; i < workers; i++) {
+		_Exchange_RunMorsel(op, i, first_morsel + i, query_ctx);
+	}
+
+	op->next_morsel += workers;
+	op->round_workers = workers;
+	op->buffer_idx = 0;
+	op->record_idx = 0;
+
+	// Raise the first error encountered on the query's thread.
+	char *error = NULL;
+	for(uint i = 0; i < workers; i++) {
+		if(op->errors[i] == NULL) continue;
+		if(error == NULL) error = op->errors[i];
+		else free(op->errors[i]);
+		op->errors[i] = NULL;
+	}
+	if(error) {
+		ErrorCtx_SetError("%s", error);
+		free(error);
+		ErrorCtx_RaiseRuntimeException(NULL);
+	}
+
+	return true;
+}
+
+// Returns the next buffered record, scanning rounds of morsels as required.
+static Record _Exchange_Next(OpExchange *op) {
+	while(true) {
+		while(op->buffer_idx < op->round_workers) {
+			Record *buffer = op->buffers[op->buffer_idx];
+			if(op->record_idx < array_len(buffer)) return buffer[op->record_idx++];
+			// Buffer handed over, records are released by the parent.
+			array_clear(buffer);
+			op->buffer_idx++;
+			op->record_idx = 0;
+		}
+		if(!_Exchange_RunRound(op)) return NULL;
+	}
+}
+
+static Record ExchangeConsume(OpBase *opBase) {
+	OpExchange *op = (OpExchange *)opBase;
+	if(op->sequential) return OpBase_Consume(op->op.children[0]);
+	return _Exchange_Next(op);
+}
+
+static uint ExchangeConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	OpExchange *op = (OpExchange *)opBase;
+
+	uint n = 0;
+	while(n < cap) {
+		Record r = _Exchange_Next(op);
+		if(!r) break;
+		batch[n++] = r;
+	}
+
+	return n;
+}
+
+// Releases records which were not handed to the parent.
+static void _Exchange_ReleaseBuffers(OpExchange *op) {
+	if(!op->buffers) return;
+
+	for(uint i = 0; i < op->worker_count; i++) {
+		Record *buffer = op->buffers[i];
+		uint first = (i == op->buffer_idx) ? op->record_idx : 0;
+		if(i >= op->buffer_idx && i < op->round_workers) {
+			for(uint j = first; j < array_len(buffer); j++) OpBase_DeleteRecord(buffer[j]);
+		}
+		array_clear(buffer);
+	}
+
+	op->round_workers = 0;
+	op->buffer_idx = 0;
+	op->record_idx = 0;
+}
+
+static OpResult ExchangeReset(OpBase *opBase) {
+	OpExchange *op = (OpExchange *)opBase;
+	_Exchange_ReleaseBuffers(op);
+	op->next_morsel = 0;
+	return OP_OK;
+}
+
+static inline OpBase *ExchangeClone(const ExecutionPlan *plan, const OpBase *opBase) {
+	ASSERT(opBase->type == OPType_EXCHANGE);
+	return NewExchangeOp(plan, ((OpExchange *)opBase)->worker_count);
+}
+
+static void ExchangeFree(OpBase *opBase) {
+	OpExchange *op = (OpExchange *)opBase;
+	if(!op->segments) return;
+
+	_Exchange_ReleaseBuffers(op);
+	for(uint i = 0; i < op->worker_count; i++) {
+		array_free(op->buffers[i]);
+		ExecutionPlan_Free(op->segments[i]);
+	}
+
+	rm_free(op->segments);
+	rm_free(op->scans);
+	rm_free(op->buffers);
+	rm_free(op->errors);
+	op->segments = NULL;
+}
@@ -0,0 +1,47 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "op.h"
+#include "../execution_plan.h"
+
+/* Exchange runs the segment below it on multiple threads.
+ * The segment is a chain of Filter and Project operations over a node scan,
+ * each worker executes a clone of the segment over a morsel, a range of
+ * EXCHANGE_MORSEL_SIZE node IDs, producing records into its own buffer.
+ * Morsels are scanned in rounds of one morsel per worker, once a round
+ * completes the buffered records are handed to the parent in node ID order.
+ *
+ * Records are borrowed from the workers' record pools, which are only accessed
+ * by the workers during a round and by the query's thread in between rounds,
+ * as such the parent must release every record it consumes before
+ * requesting the next one. */
+
+// Number of node IDs scanned by a single worker at a time.
+#define EXCHANGE_MORSEL_SIZE 16384
+
+typedef struct {
+	OpBase op;
+	uint worker_count;          // Number of workers.
+	bool sequential;            // Consume the segment directly, without workers.
+	ExecutionPlan **segments;   // Segment clone of each worker.
+	OpBase **scans;             // Scan operation of each segment clone.
+	Record **buffers;           // Records produced by each worker in the current round.
+	char **errors;              // Runtime error raised by each worker in the current round.
+	uint round_workers;         // Number of workers active in the current round.
+	uint buffer_idx;            // Buffer currently handed to the parent.
+	uint record_idx;            // Next record within the current buffer.
+	uint64_t next_morsel;       // Index of the next morsel to scan.
+	uint64_t morsel_count;      // Number of morsels.
+} OpExchange;
+
+// Creates a new Exchange operation, running its segment on 'worker_count' threads.
+OpBase *NewExchangeOp(const ExecutionPlan *plan, uint worker_count);
+
+// Returns the scan operation of the segment rooted at 'root',
+// NULL if the segment can't be executed by an Exchange operation.
+OpBase *Exchange_SegmentScan(OpBase *root);
@@ -7,9 +7,7 @@
 #include "op_expand_into.h"
 #include "shared/print_functions.h"
 #include "../../query_ctx.h"
-
-// default number of records to accumulate before traversing
-#define BATCH_SIZE 16
+#include "../../config.h"
 
 /* Forward declarations. */
 static OpResult ExpandIntoInit(OpBase *opBase);
@@ -29,9 +27,12 @@ static void _populate_filter_matrix(OpExpandInto *op) {
 		/* Update filter matrix F, set row i at position srcId
 		 * F[i, srcId] = true. */
 		Node *n = Record_GetNode(r, op->srcNodeIdx);
-		NodeID srcId = ENTITY_GET_ID(n);
-		GrB_Matrix_setElement_BOOL(op->F, true, i, srcId);
+		op->filter_cols[i] = ENTITY_GET_ID(n);
 	}
+	/* Build F at once from tuples already sorted by row,
+	 * rather than assembling pending tuples set one at a time. */
+	GrB_Matrix_build_BOOL(op->F, op->filter_rows, op->filter_cols, op->filter_vals,
+						  op->record_count, GrB_LOR);
 }
 
 /* Evaluate algebraic expression:
@@ -47,6 +48,16 @@ static void _traverse(OpExpandInto *op) {
 		GrB_Matrix_new(&op->M, GrB_BOOL, op->record_cap, required_dim);
 		GrB_Matrix_new(&op->F, GrB_BOOL, op->record_cap, required_dim);
 
+		/* Tuples of the filter matrix, reused across batches,
+		 * only source IDs change from one batch to the next. */
+		op->filter_rows = rm_malloc(op->record_cap * sizeof(GrB_Index));
+		op->filter_cols = rm_malloc(op->record_cap * sizeof(GrB_Index));
+		op->filter_vals = rm_malloc(op->record_cap * sizeof(bool));
+		for(uint i = 0; i < op->record_cap; i++) {
+			op->filter_rows[i] = i;
+			op->filter_vals[i] = true;
+		}
+
 		// Prepend the filter matrix to algebraic expression as the leftmost operand.
 		AlgebraicExpression_MultiplyToTheLeft(&op->ae, op->F);
 
@@ -60,6 +71,12 @@ static void _traverse(OpExpandInto *op) {
 	// Evaluate expression.
 	AlgebraicExpression_Eval(op->ae, op->M);
 
+	// Size the next batch by the fan-out of this one.
+	GrB_Index entries;
+	GrB_Matrix_nvals(&entries, op->M);
+	op->batch_size = Traverse_AdaptBatchSize(op->batch_size, op->record_cap,
+											 op->record_count, entries);
+
 	// Clear filter matrix.
 	GrB_Matrix_clear(op->F);
 }
@@ -72,7 +89,11 @@ OpBase *NewExpandIntoOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpression
 	op->F = GrB_NULL;
 	op->M = GrB_NULL;
 	op->records = NULL;
-	op->record_cap = BATCH_SIZE;
+	op->filter_rows = NULL;
+	op->filter_cols = NULL;
+	op->filter_vals = NULL;
+	op->record_cap = UNLIMITED;
+	op->batch_size = TRAVERSE_INITIAL_BATCH_SIZE;
 	op->record_count = 0;
 	op->edge_ctx = NULL;
 
@@ -104,9 +125,13 @@ static OpResult ExpandIntoInit(OpBase *opBase) {
 	OpExpandInto *op = (OpExpandInto *)opBase;
 	// Create 'records' with this Init function as 'record_cap'
 	// might be set during optimization time (applyLimit)
-	// If cap greater than BATCH_SIZE is specified,
-	// use BATCH_SIZE as the value.
-	if(op->record_cap > BATCH_SIZE) op->record_cap = BATCH_SIZE;
+	// If cap greater than TRAVERSE_BATCH_SIZE is specified,
+	// use TRAVERSE_BATCH_SIZE as the value.
+	uint64_t max_batch_size;
+	Config_Option_get(Config_TRAVERSE_BATCH_SIZE, &max_batch_size);
+	if(op->record_cap > max_batch_size) op->record_cap = max_batch_size;
+	// Batches start small and adapt to the observed fan-out.
+	if(op->batch_size > op->record_cap) op->batch_size = op->record_cap;
 	op->records = rm_calloc(op->record_cap, sizeof(Record));
 	return OP_OK;
 }
@@ -169,7 +194,7 @@ static Record ExpandIntoConsume(OpBase *opBase) {
 		for(uint i = 0; i < op->record_count; i++) OpBase_DeleteRecord(op->records[i]);
 
 		// Ask child operations for data.
-		for(op->record_count = 0; op->record_count < op->record_cap; op->record_count++) {
+		for(op->record_count = 0; op->record_count < op->batch_size; op->record_count++) {
 			Record childRecord = OpBase_Consume(child);
 			// Did not manage to get new data, break.
 			if(!childRecord) break;
@@ -214,7 +239,11 @@ static OpResult ExpandIntoReset(OpBase *ctx) {
 static inline OpBase *ExpandIntoClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_EXPAND_INTO);
 	OpExpandInto *op = (OpExpandInto *)opBase;
-	return NewExpandIntoOp(plan, QueryCtx_GetGraph(), AlgebraicExpression_Clone(op->ae));
+	OpExpandInto *clone = (OpExpandInto *)NewExpandIntoOp(plan, QueryCtx_GetGraph(),
+														  AlgebraicExpression_Clone(op->ae));
+	// Keep the cap imposed by a downstream LIMIT.
+	clone->record_cap = op->record_cap;
+	return (OpBase *)clone;
 }
 
 /* Frees ExpandInto */
@@ -230,6 +259,15 @@ static void ExpandIntoFree(OpBase *ctx) {
 		op->M = GrB_NULL;
 	}
 
+	if(op->filter_rows) {
+		rm_free(op->filter_rows);
+		rm_free(op->filter_cols);
+		rm_free(op->filter_vals);
+		op->filter_rows = NULL;
+		op->filter_cols = NULL;
+		op->filter_vals = NULL;
+	}
+
 	if(op->ae) {
 		AlgebraicExpression_Free(op->ae);
 		op->ae = NULL;
@@ -19,11 +19,15 @@ typedef struct {
 	AlgebraicExpression *ae;
 	GrB_Matrix F;               // Filter matrix.
 	GrB_Matrix M;               // Algebraic expression result.
+	GrB_Index *filter_rows;     // Row indices of F's tuples.
+	GrB_Index *filter_cols;     // Column indices of F's tuples, source node IDs.
+	bool *filter_vals;          // Values of F's tuples.
 	EdgeTraverseCtx *edge_ctx;  // Edge collection data if the edge needs to be set.
 	int srcNodeIdx;             // Source node index into record.
 	int destNodeIdx;            // Destination node index into record.
 	uint record_count;          // Number of held records.
-	uint record_cap;            // Max number of records to process.
+	uint record_cap;            // Max number of records in a batch.
+	uint batch_size;            // Number of records to accumulate for the next batch.
 	Record *records;            // Array of records.
 	Record r;                   // Currently selected record.
 } OpExpandInto;
@@ -9,6 +9,7 @@
 
 /* Forward declarations. */
 static Record FilterConsume(OpBase *opBase);
+static uint FilterConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void FilterFree(OpBase *opBase);
 
@@ -19,6 +20,7 @@ OpBase *NewFilterOp(const ExecutionPlan *plan, FT_FilterNode *filterTree) {
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_FILTER, "Filter", NULL, FilterConsume,
 				NULL, NULL, FilterClone, FilterFree, false, plan);
+	OpBase_UpdateConsumeBatch((OpBase *)op, FilterConsumeBatch);
 
 	return (OpBase *)op;
 }
@@ -42,6 +44,32 @@ static Record FilterConsume(OpBase *opBase) {
 	return r;
 }
 
+/* Fills the batch with records passing the filter tree,
+ * pulling batches from the child until it is depleted. */
+static uint FilterConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	OpFilter *filter = (OpFilter *)opBase;
+	OpBase *child = filter->op.children[0];
+
+	uint n = 0;
+	while(n < cap) {
+		uint requested = cap - n;
+		uint pulled = OpBase_ConsumeBatch(child, batch + n, requested);
+
+		// Compact passing records in place.
+		Record *pending = batch + n;
+		for(uint i = 0; i < pulled; i++) {
+			Record r = pending[i];
+			if(FilterTree_applyFilters(filter->filterTree, r) == FILTER_PASS) batch[n++] = r;
+			else OpBase_DeleteRecord(r);
+		}
+
+		// Child depleted.
+		if(pulled < requested) break;
+	}
+
+	return n;
+}
+
 static inline OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_FILTER);
 	OpFilter *op = (OpFilter *)opBase;
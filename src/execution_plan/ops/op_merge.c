@@ -10,6 +10,7 @@
 #include "op_merge_create.h"
 #include "../../query_ctx.h"
 #include "../../schema/schema.h"
+#include "../../nvm_support/property_buffer.h"
 #include "../../arithmetic/arithmetic_expression.h"
 #include "../execution_plan_build/execution_plan_modify.h"
 
@@ -22,12 +23,13 @@ static void MergeFree(OpBase *opBase);
 //------------------------------------------------------------------------------
 // ON MATCH / ON CREATE logic
 //------------------------------------------------------------------------------
-// Perform necessary index updates.
+// Perform necessary index and column updates.
 static void _UpdateIndices(GraphContext *gc, Node *n) {
 	int label_id = Graph_GetNodeLabel(gc->g, ENTITY_GET_ID(n));
 	if(label_id == GRAPH_NO_LABEL) return; // Unlabeled node, no need to update.
 
 	Schema *s = GraphContext_GetSchemaByID(gc, label_id, SCHEMA_NODE);
+	if(Schema_HasColumns(s)) Schema_AddNodeToColumns(s, n);
 	if(!Schema_HasIndices(s)) return; // No indices, no need to update.
 
 	Schema_AddNodeToIndices(s, n);
@@ -46,6 +48,9 @@ static int _UpdateProperty(Record r, GraphEntity *ge, EntityUpdateEvalCtx *updat
 		goto cleanup;
 	}
 
+	// combine updates to PMEM resident properties on DRAM
+	PropertyBuffer_Stage(ge->entity);
+
 	// Try to get current property value.
 	SIValue *old_value = GraphEntity_GetProperty(ge, update_ctx->attribute_id);
 
@@ -56,10 +61,10 @@ static int _UpdateProperty(Record r, GraphEntity *ge, EntityUpdateEvalCtx *updat
 			goto cleanup;
 		}
 		// Add new property.
-		GraphEntity_AddProperty(ge, update_ctx->attribute_id, new_value);
+		res = GraphEntity_AddProperty(ge, update_ctx->attribute_id, new_value);
 	} else {
 		// Update property.
-		GraphEntity_SetProperty(ge, update_ctx->attribute_id, new_value);
+		res = GraphEntity_SetProperty(ge, update_ctx->attribute_id, new_value);
 	}
 
 cleanup:
@@ -100,6 +105,8 @@ static void _UpdateProperties(ResultSetStatistics *stats, EntityUpdateEvalCtx *u
 			if(t == REC_TYPE_NODE) _UpdateIndices(gc, (Node *)ge); // Update indices if necessary.
 		}
 	}
+	// write staged property bags back to PMEM
+	PropertyBuffer_Flush();
 	if(stats) stats->properties_set += (update_count * record_count) - failed_updates;
 }
 
@@ -14,17 +14,18 @@
 static OpResult NodeByLabelScanInit(OpBase *opBase);
 static Record NodeByLabelScanConsume(OpBase *opBase);
 static Record NodeByLabelScanConsumeFromChild(OpBase *opBase);
+static uint NodeByLabelScanConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static Record NodeByLabelScanNoOp(OpBase *opBase);
 static OpResult NodeByLabelScanReset(OpBase *opBase);
 static OpBase *NodeByLabelScanClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void NodeByLabelScanFree(OpBase *opBase);
-#ifdef LABEL_DATABLOCK
 static OpResult NodeByLabelScanInit_Label(OpBase *opBase);
 static Record NodeByLabelScanConsume_Label(OpBase *opBase);
 static Record NodeByLabelScanConsumeFromChild_Label(OpBase *opBase);
+static uint NodeByLabelScanConsumeBatch_Label(OpBase *opBase, Record *batch, uint cap);
 static OpResult NodeByLabelScanReset_Label(OpBase *opBase);
-static void NodeByLabelScanFree_Label(OpBase *opBase);
-#endif
+static void _ResetIterator(NodeByLabelScan *op);
+static void _ConstructIterator_Label(NodeByLabelScan *op);
 
 static inline int NodeByLabelScanToString(const OpBase *ctx, char *buf, uint buf_len) {
 	NodeByLabelScan *op = (NodeByLabelScan *)ctx;
@@ -36,24 +37,26 @@ OpBase *NewNodeByLabelScanOp(const ExecutionPlan *plan, NodeScanCtx n) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	op->g = gc->g;
 	op->n = n;
-	op->iter = NULL;
-#ifdef LABEL_ITERATOR
+	op->iter_built = false;
+	op->depleted = true;
+	op->cursor = 0;
+	op->max_id = 0;
 	op->iter_label = NULL;
-#endif
 	op->child_record = NULL;
 	// Defaults to [0...UINT64_MAX].
 	op->id_range = UnsignedRange_New();
 
 	// Set our Op operations
-#ifdef LABEL_ITERATOR
-    OpBase_Init((OpBase *)op, OPType_NODE_BY_LABEL_SCAN, "Node By Label Scan", NodeByLabelScanInit_Label,
-                NodeByLabelScanConsume_Label, NodeByLabelScanReset_Label, NodeByLabelScanToString, NodeByLabelScanClone,
-                NodeByLabelScanFree_Label, false, plan);
-#else
-	OpBase_Init((OpBase *)op, OPType_NODE_BY_LABEL_SCAN, "Node By Label Scan", NodeByLabelScanInit,
-				NodeByLabelScanConsume, NodeByLabelScanReset, NodeByLabelScanToString, NodeByLabelScanClone,
-				NodeByLabelScanFree, false, plan);
-#endif
+	// nodes clustered by label are scanned through their label's blocks
+	if(DataBlock_IsClustered(op->g->nodes)) {
+		OpBase_Init((OpBase *)op, OPType_NODE_BY_LABEL_SCAN, "Node By Label Scan", NodeByLabelScanInit_Label,
+					NodeByLabelScanConsume_Label, NodeByLabelScanReset_Label, NodeByLabelScanToString,
+					NodeByLabelScanClone, NodeByLabelScanFree, false, plan);
+	} else {
+		OpBase_Init((OpBase *)op, OPType_NODE_BY_LABEL_SCAN, "Node By Label Scan", NodeByLabelScanInit,
+					NodeByLabelScanConsume, NodeByLabelScanReset, NodeByLabelScanToString, NodeByLabelScanClone,
+					NodeByLabelScanFree, false, plan);
+	}
 
 	op->nodeRecIdx = OpBase_Modifies((OpBase *)op, n.alias);
 
@@ -66,14 +69,48 @@ void NodeByLabelScanOp_SetIDRange(NodeByLabelScan *op, UnsignedRange *id_range)
 
 	op->op.type = OPType_NODE_BY_LABEL_AND_ID_SCAN;
 	op->op.name = "Node By Label and ID Scan";
+
+	// Restart a scan in progress over the new range.
+	if(op->iter_built) _ResetIterator(op);
+	if(op->iter_label) {
+		DataBlockIterator_Free(op->iter_label);
+		_ConstructIterator_Label(op);
+	}
 }
 
-static GrB_Info _ConstructIterator(NodeByLabelScan *op, Schema *schema) {
-	GraphContext *gc = QueryCtx_GetGraphCtx();
-	GxB_MatrixTupleIter_new(&op->iter, Graph_GetLabelMatrix(gc->g, schema->id));
-	NodeID minId = op->id_range->include_min ? op->id_range->min : op->id_range->min + 1;
-	NodeID maxId = op->id_range->include_max ? op->id_range->max : op->id_range->max - 1;
-	return GxB_MatrixTupleIter_iterate_range(op->iter, minId, maxId);
+/* Labeled nodes are located through the label's bitmap,
+ * see Graph_NextLabeledNode. */
+
+static void _ResetIterator(NodeByLabelScan *op) {
+	const UnsignedRange *range = op->id_range;
+	op->cursor = range->include_min ? range->min : range->min + 1;
+	op->max_id = range->include_max ? range->max : range->max - 1;
+	// Exclusive bounds at the edges of the ID space make for an empty range.
+	op->depleted = (!range->include_min && range->min == UINT64_MAX) ||
+				   (!range->include_max && range->max == 0) ||
+				   op->cursor > op->max_id;
+}
+
+static void _ConstructIterator(NodeByLabelScan *op, Schema *schema) {
+	op->n.label_id = schema->id;
+	op->iter_built = true;
+	_ResetIterator(op);
+}
+
+// Retrieves the next labeled node ID within range, returns false once depleted.
+static bool _NextNodeID(NodeByLabelScan *op, NodeID *id) {
+	if(op->depleted) return false;
+
+	*id = op->cursor;
+	if(!Graph_NextLabeledNode(op->g, op->n.label_id, id) || *id > op->max_id) {
+		op->depleted = true;
+		return false;
+	}
+
+	// Avoid overflowing the cursor at the end of the ID space.
+	if(*id == op->max_id) op->depleted = true;
+	else op->cursor = *id + 1;
+	return true;
 }
 
 static OpResult NodeByLabelScanInit(OpBase *opBase) {
@@ -95,43 +132,29 @@ static OpResult NodeByLabelScanInit(OpBase *opBase) {
 		return OP_OK;
 	}
 	// Resolve label ID at runtime.
-	op->n.label_id = schema->id;
-
-	// The iterator build may fail if the ID range does not match the matrix dimensions.
-	GrB_Info iterator_built = _ConstructIterator(op, schema);
-	if(iterator_built != GrB_SUCCESS) {
-		// Invalid range, use the NOP consume function.
-		OpBase_UpdateConsume(opBase, NodeByLabelScanNoOp);
-		return OP_OK;
-	}
+	_ConstructIterator(op, schema);
+	OpBase_UpdateConsumeBatch(opBase, NodeByLabelScanConsumeBatch);
 
 	return OP_OK;
 }
 
-static inline void _UpdateRecord(NodeByLabelScan *op, Record r, GrB_Index node_id) {
+static inline void _UpdateRecord(NodeByLabelScan *op, Record r, NodeID node_id) {
 	// Populate the Record with the graph entity data.
 	Node n = GE_NEW_LABELED_NODE(op->n.label, op->n.label_id);
 	Graph_GetNode(op->g, node_id, &n);
 	Record_AddNode(r, op->nodeRecIdx, n);
 }
 
-static inline void _ResetIterator(NodeByLabelScan *op) {
-	NodeID minId = op->id_range->include_min ? op->id_range->min : op->id_range->min + 1;
-	NodeID maxId = op->id_range->include_max ? op->id_range->max : op->id_range->max - 1 ;
-	GxB_MatrixTupleIter_iterate_range(op->iter, minId, maxId);
-}
-
 static Record NodeByLabelScanConsumeFromChild(OpBase *opBase) {
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 
 	// Try to get new nodeID.
-	GrB_Index nodeId;
-	bool depleted = true;
-	GxB_MatrixTupleIter_next(op->iter, NULL, &nodeId, &depleted);
+	NodeID nodeId;
+	bool depleted = !_NextNodeID(op, &nodeId);
 	/* depleted will be true in the following cases:
-	 * 1. No iterator: GxB_MatrixTupleIter_next will fail and depleted will stay true. This scenario means
+	 * 1. No iterator: the label wasn't resolved yet. This scenario means
 	 * that there was no consumption of a record from a child, otherwise there was an iterator.
-	 * 2. Iterator depleted - For every child record the iterator finished the entire matrix scan and it needs to restart.
+	 * 2. Iterator depleted - For every child record the iterator finished the entire label scan and it needs to restart.
 	 * The child record will be NULL if this is the op's first invocation or it has just been reset, in which case we
 	 * should also enter this loop. */
 	while(depleted || op->child_record == NULL) {
@@ -141,20 +164,19 @@ static Record NodeByLabelScanConsumeFromChild(OpBase *opBase) {
 		if(op->child_record == NULL) return NULL;
 
 		// Got a record.
-		if(!op->iter) {
+		if(!op->iter_built) {
 			// Iterator wasn't set up until now.
 			GraphContext *gc = QueryCtx_GetGraphCtx();
 			Schema *schema = GraphContext_GetSchema(gc, op->n.label, SCHEMA_NODE);
-			// No label matrix, it might be created in the next iteration.
+			// No label, it might be created in the next iteration.
 			if(!schema) continue;
-			_ConstructIterator(op, schema); // OK to fail (invalid range) iter will be depleted.
+			_ConstructIterator(op, schema); // Empty range, iterator will be depleted.
 		} else {
 			// Iterator depleted - reset.
-			// TODO: GxB_MatrixTupleIter_reset
 			_ResetIterator(op);
 		}
 		// Try to get new NodeID.
-		GxB_MatrixTupleIter_next(op->iter, NULL, &nodeId, &depleted);
+		depleted = !_NextNodeID(op, &nodeId);
 	}
 
 	// We've got a record and NodeID.
@@ -168,10 +190,8 @@ static Record NodeByLabelScanConsumeFromChild(OpBase *opBase) {
 static Record NodeByLabelScanConsume(OpBase *opBase) {
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 
-	GrB_Index nodeId;
-	bool depleted = false;
-	GxB_MatrixTupleIter_next(op->iter, NULL, &nodeId, &depleted);
-	if(depleted) return NULL;
+	NodeID nodeId;
+	if(!_NextNodeID(op, &nodeId)) return NULL;
 
 	Record r = OpBase_CreateRecord((OpBase *)op);
 
@@ -181,6 +201,20 @@ static Record NodeByLabelScanConsume(OpBase *opBase) {
 	return r;
 }
 
+static uint NodeByLabelScanConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
+
+	uint n = 0;
+	NodeID nodeId;
+	while(n < cap && _NextNodeID(op, &nodeId)) {
+		Record r = OpBase_CreateRecord(opBase);
+		_UpdateRecord(op, r, nodeId);
+		batch[n++] = r;
+	}
+
+	return n;
+}
+
 /* This function is invoked when the op has no children and no valid label is requested (either no label, or non existing label).
  * The op simply needs to return NULL */
 static Record NodeByLabelScanNoOp(OpBase *opBase) {
@@ -193,23 +227,27 @@ static OpResult NodeByLabelScanReset(OpBase *ctx) {
 		OpBase_DeleteRecord(op->child_record); // Free old record.
 		op->child_record = NULL;
 	}
-	_ResetIterator(op);
+	if(op->iter_built) _ResetIterator(op);
 	return OP_OK;
 }
 
 static OpBase *NodeByLabelScanClone(const ExecutionPlan *plan, const OpBase *opBase) {
-	ASSERT(opBase->type == OPType_NODE_BY_LABEL_SCAN);
+	ASSERT(opBase->type == OPType_NODE_BY_LABEL_SCAN ||
+		   opBase->type == OPType_NODE_BY_LABEL_AND_ID_SCAN);
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 	OpBase *clone = NewNodeByLabelScanOp(plan, op->n);
+	if(opBase->type == OPType_NODE_BY_LABEL_AND_ID_SCAN) {
+		NodeByLabelScanOp_SetIDRange((NodeByLabelScan *)clone, op->id_range);
+	}
 	return clone;
 }
 
 static void NodeByLabelScanFree(OpBase *op) {
 	NodeByLabelScan *nodeByLabelScan = (NodeByLabelScan *)op;
 
-	if(nodeByLabelScan->iter) {
-		GxB_MatrixTupleIter_free(nodeByLabelScan->iter);
-		nodeByLabelScan->iter = NULL;
+	if(nodeByLabelScan->iter_label) {
+		DataBlockIterator_Free(nodeByLabelScan->iter_label);
+		nodeByLabelScan->iter_label = NULL;
 	}
 
 	if(nodeByLabelScan->child_record) {
@@ -223,139 +261,140 @@ static void NodeByLabelScanFree(OpBase *op) {
 	}
 }
 
-#ifdef LABEL_ITERATOR
+//------------------------------------------------------------------------------
+// Label clustered nodes
+//------------------------------------------------------------------------------
 
-static void _ConstructIterator_Label(NodeByLabelScan *op, Schema *schema) {
-    GraphContext *gc = QueryCtx_GetGraphCtx();
-    op->iter_label = DataBlockIterator_New(gc->g->nodes->blocks[0], 0, gc->g->nodes->blockCount << 14, 1);
-    DataBlockLabelIterator_RecordDataBlock(op->iter_label, gc->g->nodes);
-    NodeID minId = op->id_range->include_min ? op->id_range->min : op->id_range->min + 1;
-    NodeID maxId = op->id_range->include_max ? op->id_range->max : op->id_range->max - 1;
-    DataBlockLabelIterator_iterate_range(op->iter_label, minId, maxId);
+/* When nodes are clustered by label (see CLUSTER_NODES_BY_LABEL)
+ * the label's blocks are scanned directly rather than its label matrix.
+ * Shared blocks, holding nodes of several labels, are scanned last
+ * and their nodes are checked against the label bitmap. */
+
+static void _ConstructIterator_Label(NodeByLabelScan *op) {
+	// DataBlock scans are exclusive of their end position.
+	NodeID minId = op->id_range->min;
+	NodeID endId = op->id_range->max;
+	if(!op->id_range->include_min && minId < UINT64_MAX) minId++;
+	if(op->id_range->include_max && endId < UINT64_MAX) endId++;
+
+	op->iter_label = DataBlock_ScanLabel(op->g->nodes, op->n.label_id, minId, endId);
 }
 
-static inline void _ResetIterator_Label(NodeByLabelScan *op) {
-    NodeID minId = op->id_range->include_min ? op->id_range->min : op->id_range->min + 1;
-    NodeID maxId = op->id_range->include_max ? op->id_range->max : op->id_range->max - 1 ;
-    DataBlockLabelIterator_iterate_range(op->iter_label, minId, maxId);
+// Returns the next node of the scanned label, NULL once depleted.
+static Entity *_NextNode_Label(NodeByLabelScan *op, NodeID *id) {
+	if(!op->iter_label) return NULL;
+
+	Entity *en;
+	while((en = DataBlockIterator_Next(op->iter_label, id)) != NULL) {
+		if(!DataBlockIterator_InSecondChain(op->iter_label)) break;
+		if(Graph_NodeHasLabel(op->g, *id, op->n.label_id)) break;
+	}
+	return en;
 }
 
 static OpResult NodeByLabelScanInit_Label(OpBase *opBase) {
-    NodeByLabelScan *op = (NodeByLabelScan *)opBase;
-    OpBase_UpdateConsume(opBase, NodeByLabelScanConsume_Label); // Default consume function.
-
-    // Operation has children, consume from child.
-    if(opBase->childCount > 0) {
-        OpBase_UpdateConsume(opBase, NodeByLabelScanConsumeFromChild_Label);
-        return OP_OK;
-    }
-
-    // If we have no children, we can build the iterator now.
-    GraphContext *gc = QueryCtx_GetGraphCtx();
-    Schema *schema = GraphContext_GetSchema(gc, op->n.label, SCHEMA_NODE);
-    if(!schema) {
-        // Missing schema, use the NOP consume function.
-        OpBase_UpdateConsume(opBase, NodeByLabelScanNoOp);
-        return OP_OK;
-    }
-    // Resolve label ID at runtime.
-    op->n.label_id = schema->id;
-
-    // The iterator build may fail if the ID range does not match the matrix dimensions.
-    _ConstructIterator_Label(op, schema);
-
-    return OP_OK;
+	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
+	OpBase_UpdateConsume(opBase, NodeByLabelScanConsume_Label); // Default consume function.
+
+	// Operation has children, consume from child.
+	if(opBase->childCount > 0) {
+		OpBase_UpdateConsume(opBase, NodeByLabelScanConsumeFromChild_Label);
+		return OP_OK;
+	}
+
+	// If we have no children, we can build the iterator now.
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *schema = GraphContext_GetSchema(gc, op->n.label, SCHEMA_NODE);
+	if(!schema) {
+		// Missing schema, use the NOP consume function.
+		OpBase_UpdateConsume(opBase, NodeByLabelScanNoOp);
+		return OP_OK;
+	}
+	// Resolve label ID at runtime.
+	op->n.label_id = schema->id;
+	_ConstructIterator_Label(op);
+	OpBase_UpdateConsumeBatch(opBase, NodeByLabelScanConsumeBatch_Label);
+
+	return OP_OK;
 }
 
 static Record NodeByLabelScanConsumeFromChild_Label(OpBase *opBase) {
-    NodeByLabelScan *op = (NodeByLabelScan *)opBase;
-
-    // Try to get new nodeID.
-    Node n = GE_NEW_LABELED_NODE(op->n.label, op->n.label_id);
-    n.entity = (Entity *)DataBlockLabelIterator_Next(op->iter_label, n.labelID, &n.id);
-    /* depleted will be true in the following cases:
-     * 1. No iterator: GxB_MatrixTupleIter_next will fail and depleted will stay true. This scenario means
-     * that there was no consumption of a record from a child, otherwise there was an iterator.
-     * 2. Iterator depleted - For every child record the iterator finished the entire matrix scan and it needs to restart.
-     * The child record will be NULL if this is the op's first invocation or it has just been reset, in which case we
-     * should also enter this loop. */
-    while(!n.entity || op->child_record == NULL) {
-        // Try to get a record.
-        if(op->child_record) OpBase_DeleteRecord(op->child_record);
-        op->child_record = OpBase_Consume(op->op.children[0]);
-        if(op->child_record == NULL) return NULL;
-
-        // Got a record.
-        if(!op->iter_label) {
-            // Iterator wasn't set up until now.
-            GraphContext *gc = QueryCtx_GetGraphCtx();
-            Schema *schema = GraphContext_GetSchema(gc, op->n.label, SCHEMA_NODE);
-            // No label matrix, it might be created in the next iteration.
-            if(!schema) continue;
-            _ConstructIterator_Label(op, schema); // OK to fail (invalid range) iter will be depleted.
-        } else {
-            // Iterator depleted - reset.
-            _ResetIterator_Label(op);
-        }
-        // Try to get new NodeID.
-        n.entity = (Entity *)DataBlockLabelIterator_Next(op->iter_label, n.labelID, &n.id);
-    }
-
-    // We've got a record and NodeID.
-    // Clone the held Record, as it will be freed upstream.
-    Record r = OpBase_CloneRecord(op->child_record);
-    // Populate the Record with the actual node.
-    Record_AddNode(r, op->nodeRecIdx, n);
-    return r;
+	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
+
+	// Try to get new nodeID.
+	Node n = GE_NEW_LABELED_NODE(op->n.label, op->n.label_id);
+	n.entity = _NextNode_Label(op, &n.id);
+	// See NodeByLabelScanConsumeFromChild.
+	while(!n.entity || op->child_record == NULL) {
+		// Try to get a record.
+		if(op->child_record) OpBase_DeleteRecord(op->child_record);
+		op->child_record = OpBase_Consume(op->op.children[0]);
+		if(op->child_record == NULL) return NULL;
+
+		// Got a record.
+		if(!op->iter_label) {
+			// Iterator wasn't set up until now.
+			GraphContext *gc = QueryCtx_GetGraphCtx();
+			Schema *schema = GraphContext_GetSchema(gc, op->n.label, SCHEMA_NODE);
+			// No label, it might be created in the next iteration.
+			if(!schema) continue;
+			op->n.label_id = schema->id;
+			n.labelID = schema->id;
+			_ConstructIterator_Label(op);
+		} else {
+			// Iterator depleted - reset.
+			DataBlockIterator_Reset(op->iter_label);
+		}
+		// Try to get new NodeID.
+		n.entity = _NextNode_Label(op, &n.id);
+	}
+
+	// We've got a record and NodeID.
+	// Clone the held Record, as it will be freed upstream.
+	Record r = OpBase_CloneRecord(op->child_record);
+	// Populate the Record with the actual node.
+	Record_AddNode(r, op->nodeRecIdx, n);
+	return r;
 }
 
 static Record NodeByLabelScanConsume_Label(OpBase *opBase) {
-    NodeByLabelScan *op = (NodeByLabelScan *)opBase;
-
-    Node n = GE_NEW_LABELED_NODE(op->n.label, op->n.label_id);
-    n.entity = (Entity *)DataBlockLabelIterator_Next(op->iter_label, n.labelID, &n.id);
-    if (!n.entity) return NULL;
+	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 
-    Record r = OpBase_CreateRecord((OpBase *)op);
+	Node n = GE_NEW_LABELED_NODE(op->n.label, op->n.label_id);
+	n.entity = _NextNode_Label(op, &n.id);
+	if(!n.entity) return NULL;
 
-    // Populate the Record with the actual node.
-    Record_AddNode(r, op->nodeRecIdx, n);
+	Record r = OpBase_CreateRecord((OpBase *)op);
 
-    return r;
-}
+	// Populate the Record with the actual node.
+	Record_AddNode(r, op->nodeRecIdx, n);
 
-static OpResult NodeByLabelScanReset_Label(OpBase *ctx) {
-    NodeByLabelScan *op = (NodeByLabelScan *)ctx;
-    if(op->child_record) {
-        OpBase_DeleteRecord(op->child_record); // Free old record.
-        op->child_record = NULL;
-    }
-    _ResetIterator_Label(op);
-    return OP_OK;
+	return r;
 }
 
-static void NodeByLabelScanFree_Label(OpBase *op) {
-    NodeByLabelScan *nodeByLabelScan = (NodeByLabelScan *)op;
-
-    if(nodeByLabelScan->iter) {
-        GxB_MatrixTupleIter_free(nodeByLabelScan->iter);
-        nodeByLabelScan->iter = NULL;
-    }
+static uint NodeByLabelScanConsumeBatch_Label(OpBase *opBase, Record *batch, uint cap) {
+	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 
-    if(nodeByLabelScan->iter_label) {
-        DataBlockIterator_Free(nodeByLabelScan->iter_label);
-        nodeByLabelScan->iter_label = NULL;
-    }
+	uint n = 0;
+	Node node = GE_NEW_LABELED_NODE(op->n.label, op->n.label_id);
+	while(n < cap) {
+		node.entity = _NextNode_Label(op, &node.id);
+		if(!node.entity) break;
 
-    if(nodeByLabelScan->child_record) {
-        OpBase_DeleteRecord(nodeByLabelScan->child_record);
-        nodeByLabelScan->child_record = NULL;
-    }
+		Record r = OpBase_CreateRecord(opBase);
+		Record_AddNode(r, op->nodeRecIdx, node);
+		batch[n++] = r;
+	}
 
-    if(nodeByLabelScan->id_range) {
-        UnsignedRange_Free(nodeByLabelScan->id_range);
-        nodeByLabelScan->id_range = NULL;
-    }
+	return n;
 }
 
-#endif
+static OpResult NodeByLabelScanReset_Label(OpBase *ctx) {
+	NodeByLabelScan *op = (NodeByLabelScan *)ctx;
+	if(op->child_record) {
+		OpBase_DeleteRecord(op->child_record); // Free old record.
+		op->child_record = NULL;
+	}
+	if(op->iter_label) DataBlockIterator_Reset(op->iter_label);
+	return OP_OK;
+}
@@ -11,7 +11,6 @@
 #include "../execution_plan.h"
 #include "../../graph/graph.h"
 #include "../../graph/entities/node.h"
-#include "../../../deps/GraphBLAS/Include/GraphBLAS.h"
 #include "../../util/range/unsigned_range.h"
 
 /* NodeByLabelScan, scans entire label. */
@@ -22,16 +21,18 @@ typedef struct {
 	NodeScanCtx n;           /* Label data of node being scanned. */
 	unsigned int nodeRecIdx;    /* Node position within record. */
 	UnsignedRange *id_range;    /* ID range to iterate over. */
-	GxB_MatrixTupleIter *iter;
-#ifdef LABEL_ITERATOR
-    DataBlockIterator *iter_label;
-#endif
+	bool iter_built;            /* True once the scanned label was resolved. */
+	bool depleted;              /* True once the ID range was scanned. */
+	NodeID cursor;              /* Next node ID to inspect within the label bitmap. */
+	NodeID max_id;              /* Last node ID within range. */
+	DataBlockIterator *iter_label;  /* Label blocks iterator, nodes clustered by label. */
 	Record child_record;        /* The Record this op acts on if it is not a tap. */
 } NodeByLabelScan;
 
 /* Creates a new NodeByLabelScan operation */
 OpBase *NewNodeByLabelScanOp(const ExecutionPlan *plan, NodeScanCtx n);
 
-/* Transform a simple label scan to perform additional range query over the label  matrix. */
+/* Transform a simple label scan to perform additional range query over the label  matrix.
+ * A scan already in progress restarts over the new range. */
 void NodeByLabelScanOp_SetIDRange(NodeByLabelScan *op, UnsignedRange *id_range);
 
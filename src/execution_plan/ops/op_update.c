@@ -12,6 +12,7 @@
 #include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
 #include "../../arithmetic/arithmetic_expression.h"
+#include "../../nvm_support/property_buffer.h"
 
 /* Forward declarations. */
 static OpResult UpdateInit(OpBase *opBase);
@@ -20,13 +21,16 @@ static OpResult UpdateReset(OpBase *opBase);
 static OpBase *UpdateClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void UpdateFree(OpBase *opBase);
 
-static bool _UpdateEntity(GraphEntity *ge, PendingUpdateCtx *update) {
+static bool _UpdateEntity(GraphEntity *ge, GraphEntityType t, PendingUpdateCtx *update) {
 	bool           res       =  false;
 	Attribute_ID  attr_id    =  update->attr_id;
 	SIValue       new_value  =  update->new_value;
 
 	// If this entity has been deleted, perform no updates and return early.
-	if(GraphEntity_IsDeleted(ge)) goto cleanup;
+	if(GraphEntity_IsDeleted(ge, t)) goto cleanup;
+
+	// combine updates to PMEM resident properties on DRAM
+	PropertyBuffer_Stage(ge->entity);
 
 	// Try to get current property value.
 	SIValue *old_value = GraphEntity_GetProperty(ge, attr_id);
@@ -63,7 +67,7 @@ static int _UpdateEdge(OpUpdate *op, PendingUpdateCtx *updates,
 
 	for(uint i = 0; i < update_count; i++) {
 		PendingUpdateCtx *update = updates + i;
-		attributes_set += (int)_UpdateEntity(ge, update);
+		attributes_set += (int)_UpdateEntity(ge, GETYPE_EDGE, update);
 	}
 
 	return attributes_set;
@@ -86,20 +90,22 @@ static int _UpdateNode(OpUpdate *op, PendingUpdateCtx *updates,
 	bool         update_index    =  false;
 	Node         *node           =  &updates->n;
 	GraphEntity  *ge             =  (GraphEntity*)node;
+	Schema       *s              =  GraphContext_GetSchemaByID(op->gc, node->labelID, SCHEMA_NODE);
 
 	for(uint i = 0; i < update_count; i++) {
 		PendingUpdateCtx *update = updates + i;
-		if(_UpdateEntity(ge, update)) {
+		if(_UpdateEntity(ge, GETYPE_NODE, update)) {
 			attributes_set++;
 			// Do we need to update an index for this property?
 			update_index |= update->update_index;
+			// Update the column holding this property, if any.
+			PropertyColumn *c = (s) ? Schema_GetColumn(s, update->attr_id) : NULL;
+			if(c) PropertyColumn_Set(c, ENTITY_GET_ID(node), GraphEntity_GetProperty(ge, update->attr_id));
 		}
 	}
 
 	// Update index for node entities if indexed fields have been modified.
 	if(update_index) {
-		int label_id = node->labelID;
-		Schema *s = GraphContext_GetSchemaByID(op->gc, label_id, SCHEMA_NODE);
 		// Introduce updated entity to index.
 		Schema_AddNodeToIndices(s, node);
 	}
@@ -332,6 +338,7 @@ static Record UpdateConsume(OpBase *opBase) {
 	// Lock everything.
 	QueryCtx_LockForCommit();
 	_CommitUpdates(op);
+	PropertyBuffer_Flush();
 	// Release lock.
 	QueryCtx_UnlockCommit(opBase);
 
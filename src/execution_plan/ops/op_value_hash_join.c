@@ -8,7 +8,7 @@
 #include "../../value.h"
 #include "../../util/arr.h"
 #include "../../util/rmalloc.h"
-#include "../../util/qsort.h"
+#include "../../config.h"
 
 /* Forward declarations. */
 static OpResult ValueHashJoinInit(OpBase *opBase);
@@ -17,155 +17,195 @@ static OpResult ValueHashJoinReset(OpBase *opBase);
 static OpBase *ValueHashJoinClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ValueHashJoinFree(OpBase *opBase);
 
-/* Determins order between two records by inspecting
- * element stored at postion idx. */
-static bool _record_islt(Record l, Record r, uint idx) {
-	SIValue lv = Record_Get(l, idx);
-	SIValue rv = Record_Get(r, idx);
-	return SIValue_Compare(lv, rv, NULL) < 0;
-}
-
-/* `idx` is an actual variable in the caller function.
- * Using it in a macro like this is rather ugly,
- * but the macro passed to QSORT must accept only 2 arguments. */
-#define RECORD_SORT_ON_ENTRY(a, b) (_record_islt((*a), (*b), idx))
-
-// Performs binary search, returns the leftmost index of a match.
-static bool _binarySearchLeftmost(uint *idx, Record *array, uint array_len,
-								  int join_key_idx, SIValue v) {
-	ASSERT(idx != NULL);
-
-	SIValue x;
-	uint pos = 0;
-	uint left = 0;
-	uint right = array_len;
-
-	while(left < right) {
-		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(x, v, NULL) < 0) left = pos + 1;
-		else right = pos;
-	}
-
-	// Make sure value was found.
-	*idx = left;
-
-	if(left == array_len) return false;
-
-	x = Record_Get(array[*idx], join_key_idx);
-	// Return false if the value wasn't found or evaluated to NULL.
+/* Returns true if join values 'a' and 'b' intersect,
+ * values evaluated to NULL don't intersect with any value. */
+static inline bool _join_values_equal(SIValue a, SIValue b) {
 	int disjointOrNull = 0;
-	return (SIValue_Compare(x, v, &disjointOrNull) == 0 &&
+	return (SIValue_Compare(a, b, &disjointOrNull) == 0 &&
 			disjointOrNull != COMPARED_NULL);
 }
 
-// Performs binary search, returns the rightmost index of a match.
-// assuming 'v' exists in 'array'
-static bool _binarySearchRightmost(uint *idx, Record *array, uint array_len, int join_key_idx,
-								   SIValue v) {
-	ASSERT(idx != NULL);
-
-	SIValue x;
-	uint pos = 0;
-	uint left = 0;
-	uint right = array_len;
-
-	while(left < right) {
-		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(v, x, NULL) < 0) right = pos;
-		else left = pos + 1;
-	}
-
-	*idx = right - 1;
-	return true;
-}
-
 /* Retrive the next intersecting record
  * if such exists, otherwise returns NULL. */
 static Record _get_intersecting_record(OpValueHashJoin *op) {
 	// No more intersecting records.
-	if(op->intersect_idx == -1 ||
-	   op->number_of_intersections == 0) return NULL;
+	if(op->intersect_idx == JOIN_NO_RECORD) return NULL;
 
 	Record cr = op->cached_records[op->intersect_idx];
 
-	// Update intersection trackers.
-	op->intersect_idx++;
-	op->number_of_intersections--;
+	// Advance along the chain of records sharing the join value.
+	op->intersect_idx = op->chains[op->intersect_idx];
 
 	return cr;
 }
 
 /* Look up first intersecting cached record CR position.
  * Returns false if no intersecting record is found. */
-static bool _set_intersection_idx(OpValueHashJoin *op, SIValue v) {
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
-	uint record_count = array_len(op->cached_records);
-
-	uint leftmost_idx = 0;
-	uint rightmost_idx = 0;
-
-	if(!_binarySearchLeftmost(&leftmost_idx, op->cached_records,
-							  array_len(op->cached_records), op->join_value_rec_idx, v)) {
-		return false;
+static bool _set_intersection_idx(OpValueHashJoin *op, SIValue v, uint64_t hash) {
+	op->intersect_idx = JOIN_NO_RECORD;
+
+	// Linear probing, stop at the first empty slot.
+	uint64_t pos = hash & op->slot_mask;
+	while(op->table[pos].head != JOIN_NO_RECORD) {
+		JoinSlot *slot = op->table + pos;
+		if(slot->hash == hash) {
+			SIValue x = Record_Get(op->cached_records[slot->head], op->join_value_rec_idx);
+			if(_join_values_equal(x, v)) {
+				op->intersect_idx = slot->head;
+				return true;
+			}
+		}
+		pos = (pos + 1) & op->slot_mask;
 	}
 
-	/* Value was found
-	 * idx points to the first intersecting record.
-	 * update number_of_intersections to count how many
-	 * records share the same value. */
-	op->intersect_idx = leftmost_idx;
-
-	/* Count how many records share the same node.
-	 * reduce search space by truncating left bound */
-	bool found = _binarySearchRightmost(&rightmost_idx, op->cached_records +
-								  leftmost_idx, record_count - leftmost_idx,
-								  op->join_value_rec_idx, v);
-	UNUSED(found);
-	ASSERT(found == true);
-
-	// Compensate index.
-	rightmost_idx += leftmost_idx;
-	// +1 consider rightmost_idx == leftmost_idx.
-	op->number_of_intersections = rightmost_idx - leftmost_idx + 1;
-	ASSERT(op->number_of_intersections > 0);
-
-	return true;
+	return false;
 }
 
-/* Sorts cached records by joined value. */
-void _sort_cached_records(OpValueHashJoin *op) {
-	uint idx = op->join_value_rec_idx;
-	QSORT(Record, op->cached_records,
-		  array_len(op->cached_records), RECORD_SORT_ON_ENTRY);
+/* Builds a hash table over cached records' join values,
+ * records sharing a join value are chained from a single slot. */
+static void _build_table(OpValueHashJoin *op) {
+	uint record_count = array_len(op->cached_records);
+
+	// At most half of the slots are occupied.
+	uint64_t slot_count = 16;
+	while(slot_count < (uint64_t)record_count * 2) slot_count <<= 1;
+	op->slot_mask = slot_count - 1;
+
+	/* Tables exceeding the DRAM budget are placed on the PMEM pool,
+	 * allocations of either kind are released by rm_free. */
+	uint64_t budget;
+	Config_Option_get(Config_JOIN_DRAM_BUDGET, &budget);
+	size_t table_size = slot_count * sizeof(JoinSlot);
+	size_t chains_size = record_count * sizeof(uint);
+	if(budget > 0 && table_size + chains_size > budget) {
+		op->table = nvm_malloc(table_size);
+		op->chains = nvm_malloc(chains_size);
+	} else {
+		op->table = rm_malloc(table_size);
+		op->chains = rm_malloc(chains_size);
+	}
+	for(uint64_t i = 0; i < slot_count; i++) op->table[i].head = JOIN_NO_RECORD;
+
+	/* Insert records last to first,
+	 * such that chains follow the order in which records were cached. */
+	for(uint i = record_count; i-- > 0;) {
+		SIValue v = Record_Get(op->cached_records[i], op->join_value_rec_idx);
+		uint64_t hash = SIValue_HashCode(v);
+		uint64_t pos = hash & op->slot_mask;
+
+		while(true) {
+			JoinSlot *slot = op->table + pos;
+			if(slot->head == JOIN_NO_RECORD) {
+				// First record holding this join value.
+				slot->hash = hash;
+				slot->head = i;
+				op->chains[i] = JOIN_NO_RECORD;
+				break;
+			}
+			if(slot->hash == hash &&
+			   _join_values_equal(Record_Get(op->cached_records[slot->head],
+											 op->join_value_rec_idx), v)) {
+				// Prepend record to the value's chain.
+				op->chains[i] = slot->head;
+				slot->head = i;
+				break;
+			}
+			pos = (pos + 1) & op->slot_mask;
+		}
+	}
 }
 
 /* Caches all records coming from left branch. */
-void _cache_records(OpValueHashJoin *op) {
+static void _cache_records(OpValueHashJoin *op) {
 	ASSERT(op->cached_records == NULL);
 
 	OpBase *left_child = op->op.children[0];
 	op->cached_records = array_new(Record, 32);
 
-	Record r = left_child->consume(left_child);
-	if(!r) return;
+	uint n = 0;
+	Record batch[OP_BATCH_SIZE];
 
 	// As long as there's data coming in from left branch.
 	do {
-		// Evaluate joined expression.
-		SIValue v = AR_EXP_Evaluate(op->lhs_exp, r);
+		n = OpBase_ConsumeBatch(left_child, batch, OP_BATCH_SIZE);
+		for(uint i = 0; i < n; i++) {
+			Record r = batch[i];
+			// Evaluate joined expression.
+			SIValue v = AR_EXP_Evaluate(op->lhs_exp, r);
+
+			// If the joined value is NULL, it cannot be compared to other values - skip this record.
+			if(SIValue_IsNull(v)) {
+				OpBase_DeleteRecord(r);
+				continue;
+			}
+
+			// Add joined value to record.
+			Record_AddScalar(r, op->join_value_rec_idx, v);
+
+			// Cache the record.
+			op->cached_records = array_append(op->cached_records, r);
+		}
+	} while(n == OP_BATCH_SIZE);
+}
 
-		// If the joined value is NULL, it cannot be compared to other values - skip this record.
+/* Pulls a batch of right hand side records, evaluating and hashing
+ * their join values ahead of probing while prefetching the slots to probe.
+ * Returns false once the right hand side is depleted. */
+static bool _probe_batch(OpValueHashJoin *op) {
+	op->probe_idx = 0;
+	op->probe_count = 0;
+	if(op->rhs_depleted) return false;
+
+	OpBase *right_child = op->op.children[1];
+	uint n = OpBase_ConsumeBatch(right_child, op->probe_records, OP_BATCH_SIZE);
+	op->rhs_depleted = (n < OP_BATCH_SIZE);
+	op->probe_count = n;
+
+	// Values are released along with the batch, even if evaluation fails.
+	for(uint i = 0; i < n; i++) op->probe_values[i] = SI_NullVal();
+
+	for(uint i = 0; i < n; i++) {
+		// Get value on which we're intersecting.
+		SIValue v = AR_EXP_Evaluate(op->rhs_exp, op->probe_records[i]);
+		op->probe_values[i] = v;
 		if(SIValue_IsNull(v)) continue;
 
-		// Add joined value to record.
-		Record_AddScalar(r, op->join_value_rec_idx, v);
+		op->probe_hashes[i] = SIValue_HashCode(v);
+		__builtin_prefetch(op->table + (op->probe_hashes[i] & op->slot_mask));
+	}
+
+	return n > 0;
+}
+
+/* Releases the records and join values of the current batch
+ * which were not probed. */
+static void _release_probe_batch(OpValueHashJoin *op) {
+	for(uint i = op->probe_idx; i < op->probe_count; i++) {
+		SIValue_Free(op->probe_values[i]);
+		OpBase_DeleteRecord(op->probe_records[i]);
+	}
+	op->probe_idx = 0;
+	op->probe_count = 0;
+}
+
+/* Releases cached records along with their hash table. */
+static void _release_cached_records(OpValueHashJoin *op) {
+	if(op->cached_records) {
+		uint record_count = array_len(op->cached_records);
+		for(uint i = 0; i < record_count; i++) {
+			Record r = op->cached_records[i];
+			OpBase_DeleteRecord(r);
+		}
+		array_free(op->cached_records);
+		op->cached_records = NULL;
+	}
 
-		// Cache the record.
-		op->cached_records = array_append(op->cached_records, r);
-	} while((r = left_child->consume(left_child)));
+	if(op->table) {
+		rm_free(op->table);
+		rm_free(op->chains);
+		op->table = NULL;
+		op->chains = NULL;
+	}
 }
 
 /* String representation of operation */
@@ -201,9 +241,14 @@ OpBase *NewValueHashJoin(const ExecutionPlan *plan, AR_ExpNode *lhs_exp, AR_ExpN
 	op->rhs_rec = NULL;
 	op->lhs_exp = lhs_exp;
 	op->rhs_exp = rhs_exp;
-	op->intersect_idx = -1;
+	op->intersect_idx = JOIN_NO_RECORD;
 	op->cached_records = NULL;
-	op->number_of_intersections = 0;
+	op->table = NULL;
+	op->chains = NULL;
+	op->slot_mask = 0;
+	op->probe_count = 0;
+	op->probe_idx = 0;
+	op->rhs_depleted = false;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_VALUE_HASH_JOIN, "Value Hash Join", ValueHashJoinInit,
@@ -224,13 +269,12 @@ static OpResult ValueHashJoinInit(OpBase *ctx) {
  * of this operation. */
 static Record ValueHashJoinConsume(OpBase *opBase) {
 	OpValueHashJoin *op = (OpValueHashJoin *)opBase;
-	OpBase *right_child = op->op.children[1];
 
 	// Eager, pull from left branch until depleted.
 	if(op->cached_records == NULL) {
 		_cache_records(op);
-		// Sort cache on intersect node ID.
-		_sort_cached_records(op);
+		// Hash cache on joined value.
+		_build_table(op);
 	}
 
 	/* Try to produce a record:
@@ -242,54 +286,39 @@ static Record ValueHashJoinConsume(OpBase *opBase) {
 	 * return merged record:
 	 * X merged with R. */
 
-	Record l;
-	if(op->number_of_intersections > 0) {
-		while((l = _get_intersecting_record(op))) {
+	while(true) {
+		Record l = _get_intersecting_record(op);
+		if(l) {
 			// Clone cached record before merging rhs.
 			Record c = OpBase_CloneRecord(l);
 			Record_Merge(c, op->rhs_rec);
 			return c;
 		}
-	}
-
-	/* If we're here there are no more
-	 * left hand side records which intersect with R
-	 * discard R. */
-	if(op->rhs_rec) OpBase_DeleteRecord(op->rhs_rec);
 
-	/* Try to get new right hand side record
-	 * which intersect with a left hand side record. */
-	while(true) {
-		// Pull from right branch.
-		op->rhs_rec = right_child->consume(right_child);
-		if(!op->rhs_rec) return NULL;
-
-		// Get value on which we're intersecting.
-		SIValue v = AR_EXP_Evaluate(op->rhs_exp, op->rhs_rec);
-
-		bool found_intersection = _set_intersection_idx(op, v);
-		SIValue_Free(v);
-		// No intersection, discard R.
-		if(!found_intersection) {
+		/* If we're here there are no more
+		 * left hand side records which intersect with R
+		 * discard R. */
+		if(op->rhs_rec) {
 			OpBase_DeleteRecord(op->rhs_rec);
-			continue;
+			op->rhs_rec = NULL;
 		}
 
-		// Found atleast one intersecting record.
-		l = _get_intersecting_record(op);
+		/* Try to get new right hand side record
+		 * which intersect with a left hand side record. */
+		if(op->probe_idx == op->probe_count && !_probe_batch(op)) return NULL;
 
-		// Clone cached record before merging rhs.
-		Record c = OpBase_CloneRecord(l);
-		Record_Merge(c, op->rhs_rec);
-
-		return c;
+		uint i = op->probe_idx++;
+		op->rhs_rec = op->probe_records[i];
+		SIValue v = op->probe_values[i];
+		if(!SIValue_IsNull(v)) _set_intersection_idx(op, v, op->probe_hashes[i]);
+		SIValue_Free(v);
 	}
 }
 
 static OpResult ValueHashJoinReset(OpBase *ctx) {
 	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
+	op->intersect_idx = JOIN_NO_RECORD;
+	op->rhs_depleted = false;
 
 	// Clear cached records.
 	if(op->rhs_rec) {
@@ -297,15 +326,8 @@ static OpResult ValueHashJoinReset(OpBase *ctx) {
 		op->rhs_rec = NULL;
 	}
 
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
-	}
+	_release_probe_batch(op);
+	_release_cached_records(op);
 
 	return OP_OK;
 }
@@ -325,15 +347,8 @@ static void ValueHashJoinFree(OpBase *ctx) {
 		op->rhs_rec = NULL;
 	}
 
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
-	}
+	_release_probe_batch(op);
+	_release_cached_records(op);
 
 	if(op->lhs_exp) {
 		AR_EXP_Free(op->lhs_exp);
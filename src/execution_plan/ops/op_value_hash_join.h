@@ -10,15 +10,33 @@
 #include "../execution_plan.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
+// Marks an empty hash table slot and the end of a chain of cached records.
+#define JOIN_NO_RECORD UINT_MAX
+
+/* Slot of the open-addressing hash table built over the cached records,
+ * holding the first of the cached records sharing a join value. */
+typedef struct {
+	uint64_t hash;                      // Hash code of the join value.
+	uint head;                          // First cached record, JOIN_NO_RECORD if empty.
+} JoinSlot;
+
 typedef struct {
 	OpBase op;
 	Record rhs_rec;                     // Right hand side record.
 	AR_ExpNode *lhs_exp;                // Left hand side expression to join on.
 	AR_ExpNode *rhs_exp;                // Right hand side expression to join on.
-	int64_t intersect_idx;              // Current intersection, < number_of_intersections
+	uint intersect_idx;                 // Next intersecting cached record, JOIN_NO_RECORD if none.
 	Record *cached_records;             // Cached left hand side records.
 	uint join_value_rec_idx;            // position on joined expression within record.
-	int64_t number_of_intersections;    // Number of intersections located.
+	JoinSlot *table;                    // Hash table over cached records' join values.
+	uint *chains;                       // Next cached record sharing a join value.
+	uint64_t slot_mask;                 // Number of slots - 1, a power of two.
+	Record probe_records[OP_BATCH_SIZE];    // Batch of right hand side records.
+	SIValue probe_values[OP_BATCH_SIZE];    // Join values of the batch.
+	uint64_t probe_hashes[OP_BATCH_SIZE];   // Hash codes of the batch's join values.
+	uint probe_count;                   // Number of records in the batch.
+	uint probe_idx;                     // Next record within the batch.
+	bool rhs_depleted;                  // Right hand side has been depleted.
 } OpValueHashJoin;
 
 /* Creates a new ValueHashJoin operation */
@@ -8,11 +8,14 @@
 #include "RG.h"
 #include "../../../errors.h"
 #include "../../../query_ctx.h"
+#include "../../../nvm_support/property_buffer.h"
 
 // Add properties to the GraphEntity.
 static inline void _AddProperties(ResultSetStatistics *stats, GraphEntity *ge,
 								  PendingProperties *props) {
 	int failed_updates = 0;
+	// build the bag on DRAM, it is written to PMEM once on commit
+	PropertyBuffer_Stage(ge->entity);
 	for(int i = 0; i < props->property_count; i++) {
 		bool updated = GraphEntity_AddProperty(ge, props->attr_keys[i], props->values[i]);
 		if(!updated) failed_updates++;
@@ -67,6 +70,7 @@ static void _CommitNodes(PendingCreations *pending) {
 														   pending->node_properties[i]);
 
 		if(s && Schema_HasIndices(s)) Schema_AddNodeToIndices(s, n);
+		if(s && Schema_HasColumns(s)) Schema_AddNodeToColumns(s, n);
 	}
 }
 
@@ -112,12 +116,14 @@ static void _CommitEdges(PendingCreations *pending) {
 		ASSERT(schema); // All schemas have been created in the edge blueprint loop or earlier.
 		int relation_id = schema->id;
 
-		int nodes_created = Graph_ConnectNodes(g, srcNodeID, destNodeID, relation_id, e);
-		ASSERT(nodes_created == 1);
+		Graph_CreateEdge(g, srcNodeID, destNodeID, relation_id, e);
 
 		if(pending->edge_properties[i]) _AddProperties(pending->stats, (GraphEntity *)e,
 														   pending->edge_properties[i]);
 	}
+
+	// Introduce all edges into the graph's matrices at once.
+	Graph_ConnectNodesBatch(g, pending->created_edges, edge_count);
 }
 
 // Initialize all variables for storing pending creations.
@@ -153,6 +159,7 @@ void CommitNewEntities(OpBase *op, PendingCreations *pending) {
 	 * Recall that edge creation/deletion doesn't have an effect on matrix dimensions. */
 	Graph_SetMatrixPolicy(g, SYNC_AND_MINIMIZE_SPACE);
 	if(edge_count > 0) _CommitEdges(pending);
+	PropertyBuffer_Flush();
 	// Release lock.
 	pending->stats->nodes_created += node_count;
 	pending->stats->relationships_created += edge_count;
@@ -117,3 +117,22 @@ void Traverse_FreeEdgeCtx(EdgeTraverseCtx *edge_ctx) {
 	rm_free(edge_ctx);
 }
 
+
+uint Traverse_AdaptBatchSize(uint batch_size, uint cap, uint record_count, uint64_t entries) {
+	uint64_t next = batch_size;
+	if(entries == 0) {
+		// Nothing was traversed, grow as long as batches are filled.
+		if(record_count == batch_size) next = (uint64_t)batch_size * 2;
+	} else {
+		// Records expected to produce the target number of entries.
+		next = (TRAVERSE_BATCH_TARGET_ENTRIES * (uint64_t)record_count) / entries;
+		if(next > (uint64_t)batch_size * 2) next = (uint64_t)batch_size * 2;
+		if(next < batch_size / 2) next = batch_size / 2;
+		// Partial batches don't tell whether a larger batch would fill.
+		if(record_count < batch_size && next > batch_size) next = batch_size;
+	}
+
+	if(next > cap) next = cap;
+	if(next == 0) next = 1;
+	return next;
+}
@@ -9,6 +9,12 @@
 #include "../../execution_plan.h"
 #include "../../../arithmetic/algebraic_expression.h"
 
+// Number of records traversals accumulate before their first multiplication.
+#define TRAVERSE_INITIAL_BATCH_SIZE 16
+
+// Number of result entries a traversal batch is sized to produce.
+#define TRAVERSE_BATCH_TARGET_ENTRIES 65536
+
 /* Container struct for traversing and populating referenced edges in
  * traversal ops like CondTraverse and ExpandInto. */
 typedef struct {
@@ -33,3 +39,11 @@ void Traverse_ResetEdgeCtx(EdgeTraverseCtx *edge_ctx);
 // Free an EdgeTraverseCtx struct.
 void Traverse_FreeEdgeCtx(EdgeTraverseCtx *edge_ctx);
 
+
+/* Returns the number of records to accumulate for the next batch
+ * of a traversal, given that the previous batch of 'record_count' records
+ * out of 'batch_size' produced 'entries' result entries.
+ * The batch size follows the observed fan-out towards
+ * TRAVERSE_BATCH_TARGET_ENTRIES entries, at most doubling or halving
+ * at a time and never exceeding 'cap'. */
+uint Traverse_AdaptBatchSize(uint batch_size, uint cap, uint record_count, uint64_t entries);
@@ -20,6 +20,7 @@
 #include "./reduce_distinct.h"
 #include "./reduce_traversal.h"
 #include "./optimize_cartesian_product.h"
+#include "./parallelize_scans.h"
 
 #endif
 
@@ -50,5 +50,8 @@ void optimizePlan(ExecutionPlan *plan) {
 
 	// Let operations know about specified skip(s)
 	applySkip(plan);
+
+	// Run scans feeding aggregations on multiple threads.
+	parallelizeScans(plan);
 }
 
@@ -0,0 +1,39 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "parallelize_scans.h"
+#include "RG.h"
+#include "../../config.h"
+#include "../ops/op_exchange.h"
+#include "../ops/op_aggregate.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+void parallelizeScans(ExecutionPlan *plan) {
+	uint worker_count;
+	Config_Option_get(Config_PARALLEL_SCAN_THREADS, &worker_count);
+	if(worker_count <= 1) return;
+
+	// Look for Aggregate operations.
+	OpBase **aggregate_ops = ExecutionPlan_CollectOps(plan->root, OPType_AGGREGATE);
+
+	for(uint i = 0; i < array_len(aggregate_ops); i++) {
+		OpBase *aggregate = aggregate_ops[i];
+		if(aggregate->childCount != 1) continue;
+
+		/* Records are handed over by the Exchange operation only
+		 * as long as its parent doesn't hold on to them. */
+		if(((OpAggregate *)aggregate)->should_cache_records) continue;
+
+		OpBase *child = aggregate->children[0];
+		if(child->plan != aggregate->plan) continue;
+		if(Exchange_SegmentScan(child) == NULL) continue;
+
+		OpBase *exchange = NewExchangeOp(aggregate->plan, worker_count);
+		ExecutionPlan_PushBelow(child, exchange);
+	}
+
+	array_free(aggregate_ops);
+}
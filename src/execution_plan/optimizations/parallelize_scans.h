@@ -0,0 +1,15 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../execution_plan.h"
+
+/* When PARALLEL_SCAN_THREADS is greater than 1, an aggregation consuming
+ * a chain of filters and projections over a node scan is fed through an
+ * Exchange operation, which runs the chain on multiple threads,
+ * each scanning a different range of node IDs. */
+void parallelizeScans(ExecutionPlan *plan);
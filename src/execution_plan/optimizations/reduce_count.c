@@ -8,6 +8,7 @@
 #include "../ops/ops.h"
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
+#include "../../graph/entities/multi_edge.h"
 #include "../../arithmetic/aggregate_funcs/agg_funcs.h"
 #include "../execution_plan_build/execution_plan_modify.h"
 
@@ -151,7 +152,7 @@ void _countEdges(void *z, const void *x) {
 	} else {
 		// Multiple edges
 		EdgeID *ids = (EdgeID *)(*entry);
-		*(uint64_t *)z = array_len(ids);
+		*(uint64_t *)z = MultiEdge_Count(ids);
 	}
 }
 
@@ -227,8 +228,17 @@ void _reduceEdgeCount(ExecutionPlan *plan) {
 		case GRAPH_UNKNOWN_RELATION:
 			// No change to current count, -[:none_existing]->
 			break;
-		default:
-			edges += _countRelationshipEdges(Graph_GetRelationMatrix(g, relType));
+		default: {
+			/* Pending changes aren't merged, the matrix is M + DP - DM
+			 * where every deleted entry of M holds a single edge. */
+			GrB_Matrix M;
+			GrB_Matrix DP;
+			GrB_Matrix DM;
+			GrB_Index deletions;
+			Graph_GetRelationMatrixDeltas(g, relType, false, &M, &DP, &DM);
+			GrB_Matrix_nvals(&deletions, DM);
+			edges += _countRelationshipEdges(M) + _countRelationshipEdges(DP) - deletions;
+		}
 		}
 	}
 	edgeCount = SI_LongVal(edges);
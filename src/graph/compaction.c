@@ -0,0 +1,90 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "compaction.h"
+#include "../RG.h"
+#include "../config.h"
+#include "../util/arr.h"
+#include "../util/periodic_task.h"
+#include "graphcontext.h"
+
+extern GraphContext **graphs_in_keyspace;  // global array tracking all extant GraphContexts
+
+// returns true if at least 'threshold' percent of the DataBlock's IDs are free
+static bool _Compaction_Fragmented(const DataBlock *dataBlock, uint64_t threshold) {
+	// clustered DataBlocks aren't compacted
+	if(DataBlock_IsClustered(dataBlock)) return false;
+
+	uint64_t deleted = DataBlock_DeletedItemsCount(dataBlock);
+	uint64_t span = DataBlock_ItemCount(dataBlock) + deleted;
+	return deleted > 0 && deleted * 100 >= span * threshold;
+}
+
+// compaction is enabled by a non zero threshold
+static bool _Compaction_Enabled(void *pdata) {
+	UNUSED(pdata);
+
+	uint64_t threshold;
+	Config_Option_get(Config_COMPACTION_THRESHOLD, &threshold);
+	return threshold > 0;
+}
+
+// compaction pass
+static void _Compaction_Pass(void *pdata) {
+	UNUSED(pdata);
+
+	uint64_t threshold;
+	Config_Option_get(Config_COMPACTION_THRESHOLD, &threshold);
+
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+
+	// pick fragmented graphs, retained such that they outlive their deletion
+	GraphContext **fragmented = array_new(GraphContext *, 0);
+	RedisModule_ThreadSafeContextLock(ctx);
+	// replicas relocate entities as instructed by their primary
+	int flags = RedisModule_GetContextFlags(ctx);
+	if(!(flags & (REDISMODULE_CTX_FLAGS_SLAVE | REDISMODULE_CTX_FLAGS_LOADING))) {
+		uint graph_count = array_len(graphs_in_keyspace);
+		for(uint i = 0; i < graph_count; i++) {
+			GraphContext *gc = graphs_in_keyspace[i];
+			Graph *g = gc->g;
+			if(!_Compaction_Fragmented(g->nodes, threshold) &&
+			   !_Compaction_Fragmented(g->edges, threshold)) continue;
+			GraphContext_Retain(gc);
+			fragmented = array_append(fragmented, gc);
+		}
+	}
+	RedisModule_ThreadSafeContextUnlock(ctx);
+
+	// the GIL is held while compacting a single slice of a single graph,
+	// indices are updated and the slice is replicated
+	uint fragmented_count = array_len(fragmented);
+	for(uint i = 0; i < fragmented_count; i++) {
+		uint64_t nodes;
+		uint64_t edges;
+		GraphContext *gc = fragmented[i];
+
+		RedisModule_ThreadSafeContextLock(ctx);
+		Graph_AcquireWriteLock(gc->g);
+		GraphContext_Compact(gc, COMPACTION_SLICE, &nodes, &edges);
+		Graph_ReleaseLock(gc->g);
+
+		if(nodes > 0 || edges > 0) {
+			RedisModule_Replicate(ctx, "graph.COMPACT", "cl", gc->graph_name,
+					(long long)COMPACTION_SLICE);
+		}
+		RedisModule_ThreadSafeContextUnlock(ctx);
+
+		GraphContext_Release(gc);
+	}
+
+	array_free(fragmented);
+	RedisModule_FreeThreadSafeContext(ctx);
+}
+
+void Compaction_Start(void) {
+	PeriodicTask_Start(COMPACTION_INTERVAL, _Compaction_Pass, _Compaction_Enabled, NULL);
+}
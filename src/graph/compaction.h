@@ -0,0 +1,30 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+/* Deleted entities leave free IDs behind, which are only reused by later
+ * creations, graphs which shrink keep scanning and holding mostly empty blocks
+ *
+ * a periodic writer task (see util/periodic_task.h) runs a compaction pass
+ * each pass visits every graph in the keyspace in which at least
+ * COMPACTION_THRESHOLD percent of the node or edge IDs are free, and relocates
+ * up to COMPACTION_SLICE nodes and edges holding the highest IDs into the
+ * lowest free IDs, blocks left empty are freed, see GraphContext_Compact
+ * only the matrix rows and columns of relocated nodes are moved, the GIL and
+ * the graph's write lock are held for one graph's slice at a time
+ *
+ * relocation changes entity IDs, passes are replicated as GRAPH.COMPACT
+ * commands such that replicas relocate the very same entities */
+
+// number of milliseconds between compaction passes
+#define COMPACTION_INTERVAL 1000
+
+// maximum number of nodes and of edges relocated by a single pass
+#define COMPACTION_SLICE 16384
+
+// start the background compaction task, should be called once
+void Compaction_Start(void);
@@ -0,0 +1,53 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "delta_merge.h"
+#include "../RG.h"
+#include "../config.h"
+#include "../util/arr.h"
+#include "../util/periodic_task.h"
+#include "graphcontext.h"
+
+extern GraphContext **graphs_in_keyspace;  // global array tracking all extant GraphContexts
+
+// merge pass
+static void _DeltaMerge_Pass(void *pdata) {
+	UNUSED(pdata);
+
+	uint64_t threshold;
+	uint64_t transpose_budget;
+	Config_Option_get(Config_DELTA_MAX_PENDING_CHANGES, &threshold);
+	Config_Option_get(Config_TRANSPOSE_MAX_MEMORY, &transpose_budget);
+
+	// retain every graph, the GIL is only held while collecting them
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	RedisModule_ThreadSafeContextLock(ctx);
+
+	// under memory pressure idle transposed matrices are dropped
+	bool pressure = RedisModule_GetContextFlags(ctx) & REDISMODULE_CTX_FLAGS_OOM_WARNING;
+
+	uint graph_count = array_len(graphs_in_keyspace);
+	GraphContext **graphs = array_new(GraphContext *, graph_count);
+	for(uint i = 0; i < graph_count; i++) {
+		GraphContext *gc = graphs_in_keyspace[i];
+		GraphContext_Retain(gc);
+		graphs = array_append(graphs, gc);
+	}
+
+	RedisModule_ThreadSafeContextUnlock(ctx);
+	RedisModule_FreeThreadSafeContext(ctx);
+
+	for(uint i = 0; i < graph_count; i++) {
+		Graph_MergeDeltas(graphs[i]->g, threshold);
+		Graph_EvictTransposes(graphs[i]->g, transpose_budget, pressure);
+		GraphContext_Release(graphs[i]);
+	}
+	array_free(graphs);
+}
+
+void DeltaMerge_Start(void) {
+	PeriodicTask_Start(DELTA_MERGE_INTERVAL, _DeltaMerge_Pass, NULL, NULL);
+}
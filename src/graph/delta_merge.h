@@ -0,0 +1,28 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+/* Graph matrices absorb writes in small delta matrices, see _RG_Matrix
+ *
+ * a periodic writer task (see util/periodic_task.h) runs a merge pass
+ * each pass visits every graph in the keyspace and merges the deltas of
+ * matrices holding at least DELTA_MAX_PENDING_CHANGES changes, as well as
+ * deltas which weren't modified since the previous pass
+ *
+ * merged matrices are computed under the read lock, such that readers keep
+ * going while a merge is in progress, the write lock is only taken to swap
+ * the merged matrices in
+ *
+ * the same pass drops lazily built transposed matrices, least recently used
+ * first, once they exceed TRANSPOSED_MATRICES_MAX_MEMORY, or once they weren't
+ * used since the previous pass while Redis is close to its maxmemory limit */
+
+// number of milliseconds between merge passes
+#define DELTA_MERGE_INTERVAL 100
+
+// start the background merge task, should be called once
+void DeltaMerge_Start(void);
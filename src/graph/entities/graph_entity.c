@@ -12,40 +12,71 @@
 #include "../../query_ctx.h"
 #include "../graphcontext.h"
 #include "../../util/rmalloc.h"
+#include "../../nvm_support/property_tiering.h"
+#include <string.h>
 
 SIValue *PROPERTY_NOTFOUND = &(SIValue) {
 	.longval = 0, .type = T_NULL
 };
 
+/* Property bags are kept sorted by attribute ID,
+ * short runs are scanned, longer bags are binary searched. */
+#define PROPERTY_SCAN_LIMIT 8
+
+/* Returns the position of attribute within the entity's bag,
+ * or the position it would be inserted at if it is missing. */
+static inline int _GraphEntity_PropertyPos(const Entity *e, Attribute_ID attr_id) {
+	const EntityProperty *properties = e->properties;
+	int lo = 0;
+	int hi = e->prop_count;
+
+	while(hi - lo > PROPERTY_SCAN_LIMIT) {
+		int mid = (lo + hi) >> 1;
+		if(properties[mid].id < attr_id) lo = mid + 1;
+		else hi = mid;
+	}
+	while(lo < hi && properties[lo].id < attr_id) lo++;
+
+	return lo;
+}
+
+/* Resizes entity's properties bag to hold 'cap' properties. */
+static void _GraphEntity_ResizeProperties(Entity *e, int cap) {
+	e->properties = nvm_class_realloc(NVM_CLASS_PROPERTIES, e->properties,
+									  sizeof(EntityProperty) * cap);
+	e->prop_cap = cap;
+}
+
 /* Removes entity's property. */
 static bool _GraphEntity_RemoveProperty(const GraphEntity *e, Attribute_ID attr_id) {
 	// Quick return if attribute is missing.
 	if(attr_id == ATTRIBUTE_NOTFOUND) return false;
 
 	// Locate attribute position.
-	int prop_count = e->entity->prop_count;
-	for(int i = 0; i < prop_count; i++) {
-		if(attr_id == e->entity->properties[i].id) {
-			SIValue_Free(e->entity->properties[i].value);
-			e->entity->prop_count--;
-
-			if(e->entity->prop_count == 0) {
-				/* Only attribute removed, free properties bag. */
-				rm_free(e->entity->properties);
-				e->entity->properties = NULL;
-			} else {
-				/* Overwrite deleted attribute with the last
-				 * attribute and shrink properties bag. */
-				e->entity->properties[i] = e->entity->properties[prop_count - 1];
-				e->entity->properties = rm_realloc(e->entity->properties,
-												   sizeof(EntityProperty) * e->entity->prop_count);
-			}
+	Entity *en = e->entity;
+	int i = _GraphEntity_PropertyPos(en, attr_id);
+	if(i == en->prop_count || en->properties[i].id != attr_id) return false;
+
+	SIValue_Free(en->properties[i].value);
+	en->prop_count--;
+
+	if(en->prop_count == 0) {
+		/* Only attribute removed, free properties bag. */
+		rm_free(en->properties);
+		en->properties = NULL;
+		en->prop_cap = 0;
+		return true;
+	}
 
-			return true;
-		}
+	/* Close the gap, keeping the bag sorted,
+	 * shrink bags which are mostly unused. */
+	memmove(en->properties + i, en->properties + i + 1,
+			sizeof(EntityProperty) * (en->prop_count - i));
+	if(en->prop_count <= (en->prop_cap >> 2)) {
+		_GraphEntity_ResizeProperties(en, en->prop_count << 1);
 	}
 
-	return false;
+	return true;
 }
 
 /* Add a new property to entity */
@@ -53,46 +84,32 @@ bool GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value
 	ASSERT(e);
 	if(SIValue_IsNull(value)) return false;
 
-	if(e->entity->properties == NULL) {
-		e->entity->properties = rm_malloc(sizeof(EntityProperty));
-	} else {
-		e->entity->properties = rm_realloc(e->entity->properties,
-										   sizeof(EntityProperty) * (e->entity->prop_count + 1));
+	Entity *en = e->entity;
+
+	// Property count and capacity are 16 bit wide.
+	if(en->prop_count == UINT16_MAX) {
+		ErrorCtx_SetError("Entity can not hold more than %d properties", UINT16_MAX);
+		return false;
 	}
 
-	int prop_idx = e->entity->prop_count;
-	e->entity->properties[prop_idx].id = attr_id;
-	e->entity->properties[prop_idx].value = SI_CloneValue(value);
-	e->entity->prop_count++;
+	/* Grow bag geometrically, bags moved by tiering are sized to their content,
+	 * hence the capacity is never below the property count. */
+	if(en->prop_count >= en->prop_cap) {
+		int cap = en->prop_count + (en->prop_count >> 1) + 1;
+		if(cap > UINT16_MAX) cap = UINT16_MAX;
+		_GraphEntity_ResizeProperties(en, cap);
+	}
 
-	return true;
-}
+	int prop_idx = _GraphEntity_PropertyPos(en, attr_id);
+	ASSERT(prop_idx == en->prop_count || en->properties[prop_idx].id != attr_id);
+	memmove(en->properties + prop_idx + 1, en->properties + prop_idx,
+			sizeof(EntityProperty) * (en->prop_count - prop_idx));
 
-bool GraphEntity_AddPmemProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value) {
-    ASSERT(e);
-    if(SIValue_IsNull(value)) return false;
-
-    if(e->entity->properties == NULL) {
-#ifdef SLOW_ENTITY
-        e->entity->properties = nvm_malloc(sizeof(EntityProperty));
-#else
-        e->entity->properties = rm_malloc(sizeof(EntityProperty));
-#endif
-    } else {
-        e->entity->properties = rm_realloc(e->entity->properties,
-                                           sizeof(EntityProperty) * (e->entity->prop_count + 1));
-    }
-
-    int prop_idx = e->entity->prop_count;
-    e->entity->properties[prop_idx].id = attr_id;
-#ifdef NVM_PROP
-    e->entity->properties[prop_idx].value = SI_ClonePmemValue(value);
-#else
-    e->entity->properties[prop_idx].value = SI_CloneValue(value);
-#endif
-    e->entity->prop_count++;
-
-    return true;
+	en->properties[prop_idx].id = attr_id;
+	en->properties[prop_idx].value = SI_ClonePropertyValue(value);
+	en->prop_count++;
+
+	return true;
 }
 
 SIValue *GraphEntity_GetProperty(const GraphEntity *e, Attribute_ID attr_id) {
@@ -106,11 +123,12 @@ SIValue *GraphEntity_GetProperty(const GraphEntity *e, Attribute_ID attr_id) {
 		return PROPERTY_NOTFOUND;
 	}
 
-	for(int i = 0; i < e->entity->prop_count; i++) {
-		if(attr_id == e->entity->properties[i].id) {
-			// Note, unsafe as entity properties can get reallocated.
-			return &(e->entity->properties[i].value);
-		}
+	PropertyTiering_RecordAccess(e->entity);
+
+	int i = _GraphEntity_PropertyPos(e->entity, attr_id);
+	if(i < e->entity->prop_count && e->entity->properties[i].id == attr_id) {
+		// Note, unsafe as entity properties can get reallocated.
+		return &(e->entity->properties[i].value);
 	}
 
 	return PROPERTY_NOTFOUND;
@@ -131,7 +149,7 @@ bool GraphEntity_SetProperty(const GraphEntity *e, Attribute_ID attr_id, SIValue
 
 	// value != current, update entity
 	SIValue_Free(*current);
-	*current = SI_CloneValue(value);
+	*current = SI_ClonePropertyValue(value);
 	return true;
 }
 
@@ -247,8 +265,8 @@ void GraphEntity_ToString(const GraphEntity *e, char **buffer, size_t *bufferLen
 	*bytesWritten += snprintf(*buffer + *bytesWritten, *bufferLen, "%s", closeSymbole);
 }
 
-inline bool GraphEntity_IsDeleted(const GraphEntity *e) {
-	return Graph_EntityIsDeleted(e->entity);
+inline bool GraphEntity_IsDeleted(const GraphEntity *e, GraphEntityType t) {
+	return Graph_EntityIsDeleted(QueryCtx_GetGraph(), t, e->id);
 }
 
 void FreeEntity(Entity *e) {
@@ -258,6 +276,7 @@ void FreeEntity(Entity *e) {
 		rm_free(e->properties);
 		e->properties = NULL;
 		e->prop_count = 0;
+		e->prop_cap = 0;
 	}
 }
 
@@ -51,8 +51,10 @@ typedef struct {
 // Essence of a graph entity.
 // TODO: see if pragma pack 0 will cause memory access violation on ARM.
 typedef struct {
-	int prop_count;             // Number of properties.
-	EntityProperty *properties; // Key value pair of attributes.
+	uint16_t prop_count;        // Number of properties.
+	uint16_t prop_cap;          // Number of properties the bag can hold.
+	uint heat;                  // Sampled read count, see property_tiering.h
+	EntityProperty *properties; // Key value pair of attributes, sorted by attribute ID.
 } Entity;
 
 // Common denominator between nodes and edges.
@@ -61,10 +63,11 @@ typedef struct {
 	EntityID id;
 } GraphEntity;
 
-/* Adds property to entity
- * returns - reference to newly added property. */
+/* Adds property to entity, the attribute must not be set
+ * bags grow geometrically and are kept sorted by attribute ID.
+ * Returns false and sets an error if the entity already holds
+ * UINT16_MAX properties. */
 bool GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value);
-bool GraphEntity_AddPmemProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value);
 
 /* Retrieves entity's property
  * NOTE: If the key does not exist, we return the special
@@ -80,7 +83,7 @@ void GraphEntity_ToString(const GraphEntity *e, char **buffer, size_t *bufferLen
 						  GraphEntityStringFromat format, GraphEntityType entityType);
 
 // Returns true if the given graph entity has been deleted.
-bool GraphEntity_IsDeleted(const GraphEntity *e);
+bool GraphEntity_IsDeleted(const GraphEntity *e, GraphEntityType t);
 
 /* Release all memory allocated by entity */
 void FreeEntity(Entity *e);
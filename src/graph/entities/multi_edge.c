@@ -0,0 +1,297 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "multi_edge.h"
+#include "RG.h"
+#include "../../util/rmalloc.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Capacity of the largest class.
+#define MULTI_EDGE_MAX_CAP (MULTI_EDGE_MIN_CAP << (MULTI_EDGE_CLASS_COUNT - 1))
+
+// Capacity flag of heap allocated arrays.
+#define MULTI_EDGE_HEAP (1U << 31)
+
+// Slab arrays keep their offset within the slab above their capacity.
+#define MULTI_EDGE_OFFSET_SHIFT 15
+#define MULTI_EDGE_CAP_MASK ((1U << MULTI_EDGE_OFFSET_SHIFT) - 1)
+
+_Static_assert(MULTI_EDGE_MAX_CAP <= MULTI_EDGE_CAP_MASK,
+		"class capacities must fit below the slab offset");
+_Static_assert(MULTI_EDGE_SLAB_SIZE <= (1U << (31 - MULTI_EDGE_OFFSET_SHIFT)),
+		"slab offsets must fit below the heap flag");
+
+typedef struct {
+	uint32_t count;     // Number of edge IDs.
+	uint32_t cap;       // Capacity, MULTI_EDGE_HEAP is set for heap allocated arrays.
+	EdgeID ids[];       // Edge IDs.
+} MultiEdgeHdr;
+
+// Retrieves the array's header.
+#define MULTI_EDGE_HDR(ids) ((MultiEdgeHdr *)((char *)(ids) - sizeof(MultiEdgeHdr)))
+
+// Size of an array of capacity 'cap', including its header.
+#define MULTI_EDGE_SIZE(cap) (sizeof(MultiEdgeHdr) + (size_t)(cap) * sizeof(EdgeID))
+
+typedef struct MultiEdgeCache MultiEdgeCache;
+typedef struct MultiEdgeSlab MultiEdgeSlab;
+
+// Slab header, slots are carved right after it.
+struct MultiEdgeSlab {
+	MultiEdgeCache *cache;  // Cache the slab belongs to.
+	MultiEdgeSlab *prev;    // Previous slab holding released slots.
+	MultiEdgeSlab *next;    // Next slab holding released slots.
+	void *free_list;        // Released slots, linked through their first word.
+	uint32_t offset;        // Offset of the slab's first unused byte.
+	uint32_t live;          // Number of arrays residing in the slab.
+	uint32_t cls;           // Class the slab serves.
+};
+
+#define MULTI_EDGE_SLAB_HDR_SIZE ((sizeof(MultiEdgeSlab) + 7) & ~(size_t)7)
+
+typedef struct {
+	MultiEdgeSlab *current;     // Slab slots are carved from.
+	MultiEdgeSlab *partial;     // Slabs holding released slots.
+} MultiEdgeClass;
+
+// Per thread set of classes, arrays are allocated from the calling thread's
+// cache and released to the cache of the slab they reside in, the lock is
+// contended only by threads releasing arrays allocated by another thread.
+struct MultiEdgeCache {
+	pthread_mutex_t lock;
+	MultiEdgeClass classes[MULTI_EDGE_CLASS_COUNT];
+	uint32_t slab_count;        // Number of slabs held by the cache.
+	bool orphaned;              // The owning thread has exited.
+};
+
+static __thread MultiEdgeCache *thread_cache = NULL;
+static pthread_key_t cache_key;
+static pthread_once_t cache_key_once = PTHREAD_ONCE_INIT;
+
+// Smallest class capacity able to hold n edge IDs.
+static inline uint32_t _MultiEdge_Cap(uint32_t n) {
+	uint32_t cap = MULTI_EDGE_MIN_CAP;
+	while(cap < n) cap <<= 1;
+	return cap;
+}
+
+// Index of the class serving arrays of capacity 'cap'.
+static inline uint32_t _MultiEdge_Class(uint32_t cap) {
+	return __builtin_ctz(cap) - __builtin_ctz(MULTI_EDGE_MIN_CAP);
+}
+
+// Capacity of the array.
+static inline uint32_t _MultiEdge_Capacity(const MultiEdgeHdr *hdr) {
+	return (hdr->cap & MULTI_EDGE_HEAP) ?
+		   hdr->cap & ~MULTI_EDGE_HEAP : hdr->cap & MULTI_EDGE_CAP_MASK;
+}
+
+// Slab the array resides in.
+static inline MultiEdgeSlab *_MultiEdge_Slab(MultiEdgeHdr *hdr) {
+	return (MultiEdgeSlab *)((char *)hdr - (hdr->cap >> MULTI_EDGE_OFFSET_SHIFT));
+}
+
+static void _MultiEdge_UnlinkPartial(MultiEdgeClass *c, MultiEdgeSlab *slab) {
+	if(slab->prev) slab->prev->next = slab->next;
+	else c->partial = slab->next;
+	if(slab->next) slab->next->prev = slab->prev;
+	slab->prev = NULL;
+	slab->next = NULL;
+}
+
+// Frees an empty slab, the cache's lock must be held.
+static void _MultiEdge_FreeSlab(MultiEdgeCache *cache, MultiEdgeSlab *slab) {
+	MultiEdgeClass *c = cache->classes + slab->cls;
+	// A slab holding no arrays has released slots unless nothing was carved.
+	if(slab->free_list != NULL) _MultiEdge_UnlinkPartial(c, slab);
+	if(c->current == slab) c->current = NULL;
+	rm_free(slab);
+	cache->slab_count--;
+}
+
+// Releases the cache of an exiting thread, slabs still holding arrays are
+// kept until their last array is released.
+static void _MultiEdge_CacheDestroy(void *arg) {
+	MultiEdgeCache *cache = arg;
+	thread_cache = NULL;
+
+	pthread_mutex_lock(&cache->lock);
+	cache->orphaned = true;
+	for(uint i = 0; i < MULTI_EDGE_CLASS_COUNT; i++) {
+		MultiEdgeClass *c = cache->classes + i;
+		MultiEdgeSlab *slab = c->current;
+		c->current = NULL;
+		if(slab != NULL && slab->live == 0) _MultiEdge_FreeSlab(cache, slab);
+	}
+	bool empty = (cache->slab_count == 0);
+	pthread_mutex_unlock(&cache->lock);
+
+	if(empty) {
+		pthread_mutex_destroy(&cache->lock);
+		rm_free(cache);
+	}
+}
+
+static void _MultiEdge_CreateKey(void) {
+	pthread_key_create(&cache_key, _MultiEdge_CacheDestroy);
+}
+
+// Retrieves the calling thread's cache.
+static MultiEdgeCache *_MultiEdge_ThreadCache(void) {
+	if(thread_cache != NULL) return thread_cache;
+
+	pthread_once(&cache_key_once, _MultiEdge_CreateKey);
+	MultiEdgeCache *cache = rm_calloc(1, sizeof(MultiEdgeCache));
+	pthread_mutex_init(&cache->lock, NULL);
+	pthread_setspecific(cache_key, cache);
+	thread_cache = cache;
+	return cache;
+}
+
+static MultiEdgeHdr *_MultiEdge_Alloc(uint32_t cap) {
+	MultiEdgeHdr *hdr;
+	cap = _MultiEdge_Cap(cap);
+
+	if(cap > MULTI_EDGE_MAX_CAP) {
+		hdr = rm_malloc(MULTI_EDGE_SIZE(cap));
+		hdr->cap = cap | MULTI_EDGE_HEAP;
+		hdr->count = 0;
+		return hdr;
+	}
+
+	size_t size = MULTI_EDGE_SIZE(cap);
+	uint32_t cls = _MultiEdge_Class(cap);
+	MultiEdgeCache *cache = _MultiEdge_ThreadCache();
+	MultiEdgeClass *c = cache->classes + cls;
+
+	pthread_mutex_lock(&cache->lock);
+	MultiEdgeSlab *slab = c->partial;
+	if(slab != NULL) {
+		hdr = slab->free_list;
+		slab->free_list = *(void **)hdr;
+		if(slab->free_list == NULL) _MultiEdge_UnlinkPartial(c, slab);
+	} else {
+		// Current slab is exhausted, it is freed once its arrays are released.
+		slab = c->current;
+		if(slab == NULL || slab->offset + size > MULTI_EDGE_SLAB_SIZE) {
+			slab = rm_calloc(1, MULTI_EDGE_SLAB_SIZE);
+			slab->cache = cache;
+			slab->cls = cls;
+			slab->offset = MULTI_EDGE_SLAB_HDR_SIZE;
+			c->current = slab;
+			cache->slab_count++;
+		}
+		hdr = (MultiEdgeHdr *)((char *)slab + slab->offset);
+		slab->offset += size;
+	}
+	slab->live++;
+	pthread_mutex_unlock(&cache->lock);
+
+	uint32_t offset = (char *)hdr - (char *)slab;
+	hdr->cap = cap | (offset << MULTI_EDGE_OFFSET_SHIFT);
+	hdr->count = 0;
+	return hdr;
+}
+
+static void _MultiEdge_Release(MultiEdgeHdr *hdr) {
+	if(hdr->cap & MULTI_EDGE_HEAP) {
+		rm_free(hdr);
+		return;
+	}
+
+	MultiEdgeSlab *slab = _MultiEdge_Slab(hdr);
+	MultiEdgeCache *cache = slab->cache;
+	MultiEdgeClass *c = cache->classes + slab->cls;
+
+	pthread_mutex_lock(&cache->lock);
+	if(slab->free_list == NULL) {
+		slab->next = c->partial;
+		if(c->partial) c->partial->prev = slab;
+		c->partial = slab;
+	}
+	*(void **)hdr = slab->free_list;
+	slab->free_list = hdr;
+	slab->live--;
+
+	// Slabs no longer carved from are freed once empty.
+	if(slab->live == 0 && slab != c->current) _MultiEdge_FreeSlab(cache, slab);
+	bool destroy = (cache->orphaned && cache->slab_count == 0);
+	pthread_mutex_unlock(&cache->lock);
+
+	if(destroy) {
+		pthread_mutex_destroy(&cache->lock);
+		rm_free(cache);
+	}
+}
+
+EdgeID *MultiEdge_New(uint32_t cap) {
+	return _MultiEdge_Alloc(cap)->ids;
+}
+
+uint32_t MultiEdge_Count(const EdgeID *ids) {
+	ASSERT(ids);
+	return MULTI_EDGE_HDR(ids)->count;
+}
+
+EdgeID *MultiEdge_Append(EdgeID *ids, EdgeID id) {
+	ASSERT(ids);
+	MultiEdgeHdr *hdr = MULTI_EDGE_HDR(ids);
+
+	if(hdr->count == _MultiEdge_Capacity(hdr)) {
+		// Array is full, move it to the next class.
+		MultiEdgeHdr *grown = _MultiEdge_Alloc(hdr->count + 1);
+		memcpy(grown->ids, hdr->ids, hdr->count * sizeof(EdgeID));
+		grown->count = hdr->count;
+		_MultiEdge_Release(hdr);
+		hdr = grown;
+	}
+
+	hdr->ids[hdr->count++] = id;
+	return hdr->ids;
+}
+
+void MultiEdge_Remove(EdgeID *ids, uint32_t idx) {
+	ASSERT(ids);
+	MultiEdgeHdr *hdr = MULTI_EDGE_HDR(ids);
+	ASSERT(idx < hdr->count);
+
+	hdr->count--;
+	ids[idx] = ids[hdr->count];
+}
+
+size_t MultiEdge_SizeOf(const EdgeID *ids) {
+	ASSERT(ids);
+	return MULTI_EDGE_SIZE(_MultiEdge_Capacity(MULTI_EDGE_HDR(ids)));
+}
+
+void *MultiEdge_Allocation(const EdgeID *ids) {
+	ASSERT(ids);
+	MultiEdgeHdr *hdr = MULTI_EDGE_HDR(ids);
+	return (hdr->cap & MULTI_EDGE_HEAP) ? hdr : NULL;
+}
+
+EdgeID *MultiEdge_Move(EdgeID *ids, void *(*alloc)(size_t)) {
+	ASSERT(ids && alloc);
+	MultiEdgeHdr *hdr = MULTI_EDGE_HDR(ids);
+
+	// The moved array is sized to its content.
+	MultiEdgeHdr *moved = alloc(MULTI_EDGE_SIZE(hdr->count));
+	if(moved == NULL) return NULL;
+
+	moved->count = hdr->count;
+	moved->cap = hdr->count | MULTI_EDGE_HEAP;
+	memcpy(moved->ids, hdr->ids, hdr->count * sizeof(EdgeID));
+	_MultiEdge_Release(hdr);
+
+	return moved->ids;
+}
+
+void MultiEdge_Free(EdgeID *ids) {
+	if(ids == NULL) return;
+	_MultiEdge_Release(MULTI_EDGE_HDR(ids));
+}
@@ -0,0 +1,69 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#ifndef MULTI_EDGE_H_
+#define MULTI_EDGE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "graph_entity.h"
+
+/*
+ * MULTI-EDGE ARRAYS:
+ *
+ * a relation matrix entry holding more than a single edge points to an
+ * array of edge IDs, IDs are stored contiguously right after an 8 byte
+ * header holding the array's length and capacity
+ *
+ * arrays are carved out of slabs of equally sized slots, one slab per
+ * power-of-two capacity class, released slots are reused by arrays of the
+ * same class, such that connecting and disconnecting parallel edges doesn't
+ * call the allocator
+ *
+ * each thread allocates from slabs of its own, released arrays return to the
+ * slab they were carved from, a slab is freed once it no longer holds arrays
+ * and isn't carved from, slabs of an exited thread are freed once empty
+ *
+ * arrays outgrowing the largest class and arrays moved out of the slabs
+ * (see MultiEdge_Move) are heap allocated
+ *
+ * arrays may be allocated and released concurrently, e.g. by GraphBLAS
+ * operators, modifying an array requires exclusive access to it
+ */
+
+#define MULTI_EDGE_MIN_CAP 2                 // capacity of the smallest class
+#define MULTI_EDGE_CLASS_COUNT 8             // classes of capacity 2 to 256
+#define MULTI_EDGE_SLAB_SIZE (64 << 10)      // bytes per slab
+
+// Creates an empty array able to hold 'cap' edge IDs.
+EdgeID *MultiEdge_New(uint32_t cap);
+
+// Number of edge IDs in the array.
+uint32_t MultiEdge_Count(const EdgeID *ids);
+
+// Appends an edge ID, the array is moved once it is full.
+// Returns the array.
+EdgeID *MultiEdge_Append(EdgeID *ids, EdgeID id);
+
+// Removes the edge ID at position 'idx', the last ID takes its place.
+void MultiEdge_Remove(EdgeID *ids, uint32_t idx);
+
+// Number of bytes taken by the array, including its header.
+size_t MultiEdge_SizeOf(const EdgeID *ids);
+
+// Returns the heap allocation holding the array,
+// NULL if the array resides in a slab.
+void *MultiEdge_Allocation(const EdgeID *ids);
+
+// Moves the array into memory allocated by 'alloc', releasing its slot.
+// The moved array is freed with rm_free.
+// Returns NULL, leaving the array in place, if 'alloc' fails.
+EdgeID *MultiEdge_Move(EdgeID *ids, void *(*alloc)(size_t));
+
+// Frees the array.
+void MultiEdge_Free(EdgeID *ids);
+
+#endif
@@ -12,6 +12,7 @@
 #include "../GraphBLASExt/GxB_Delete.h"
 #include "../util/rmalloc.h"
 #include "../util/datablock/oo_datablock.h"
+#include "entities/multi_edge.h"
 
 static GrB_BinaryOp _graph_edge_accum = NULL;
 // GraphBLAS binary operator for freeing edges
@@ -19,6 +20,7 @@ static GrB_BinaryOp _binary_op_delete_edges = NULL;
 
 /* ========================= Forward declarations  ========================= */
 void _MatrixResizeToCapacity(const Graph *g, RG_Matrix m);
+void _MatrixSynchronize(const Graph *g, RG_Matrix m);
 
 
 /* ========================= GraphBLAS functions ========================= */
@@ -31,17 +33,24 @@ void _edge_accum(void *_z, const void *_x, const void *_y) {
 	/* Single edge ID,
 	 * switching from single edge ID to multiple IDs. */
 	if(SINGLE_EDGE(*x)) {
-		ids = array_new(EdgeID, 2);
-		ids = array_append(ids, SINGLE_EDGE_ID(*x));
-		ids = array_append(ids, SINGLE_EDGE_ID(*y));
-		// TODO: Make sure MSB of ids isn't on.
-		*z = (EdgeID)ids;
+		ids = MultiEdge_New(2);
+		ids = MultiEdge_Append(ids, SINGLE_EDGE_ID(*x));
 	} else {
 		// Multiple edges, adding another edge.
 		ids = (EdgeID *)(*x);
-		ids = array_append(ids, SINGLE_EDGE_ID(*y));
-		*z = (EdgeID)ids;
 	}
+
+	if(SINGLE_EDGE(*y)) {
+		// TODO: Make sure MSB of ids isn't on.
+		ids = MultiEdge_Append(ids, SINGLE_EDGE_ID(*y));
+	} else {
+		// Merging a batch entry holding multiple edges, its array is consumed.
+		EdgeID *y_ids = (EdgeID *)(*y);
+		uint y_count = MultiEdge_Count(y_ids);
+		for(uint i = 0; i < y_count; i++) ids = MultiEdge_Append(ids, y_ids[i]);
+		MultiEdge_Free(y_ids);
+	}
+	*z = (EdgeID)ids;
 }
 
 void _binary_op_free_edge(void *z, const void *x, const void *y) {
@@ -52,16 +61,27 @@ void _binary_op_free_edge(void *z, const void *x, const void *y) {
 		DataBlock_DeleteItem(g->edges, SINGLE_EDGE_ID(*id));
 	} else {
 		EdgeID *ids = (EdgeID *)(*id);
-		uint id_count = array_len(ids);
+		uint id_count = MultiEdge_Count(ids);
 		for(uint i = 0; i < id_count; i++) {
 			DataBlock_DeleteItem(g->edges, ids[i]);
 		}
-		array_free(ids);
+		MultiEdge_Free(ids);
 	}
 }
 
 /* ========================= RG_Matrix functions =============================== */
 
+// Creates an empty hypersparse delta matrix
+static GrB_Matrix _RG_Matrix_NewDelta(GrB_Type data_type, GrB_Index nrows, GrB_Index ncols) {
+	GrB_Matrix delta;
+	GrB_Info info = GrB_Matrix_new(&delta, data_type, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_set(delta, GxB_SPARSITY_CONTROL, GxB_HYPERSPARSE);
+	ASSERT(info == GrB_SUCCESS);
+	UNUSED(info);
+	return delta;
+}
+
 // Creates a new matrix
 static RG_Matrix RG_Matrix_New(GrB_Type data_type, GrB_Index nrows, GrB_Index ncols) {
 	RG_Matrix matrix = rm_calloc(1, sizeof(_RG_Matrix));
@@ -71,6 +91,10 @@ static RG_Matrix RG_Matrix_New(GrB_Type data_type, GrB_Index nrows, GrB_Index nc
 	GrB_Info matrix_res = GrB_Matrix_new(&matrix->grb_matrix, data_type, nrows, ncols);
 	ASSERT(matrix_res == GrB_SUCCESS);
 
+	// deletions are only tracked by structure
+	matrix->delta_plus = _RG_Matrix_NewDelta(data_type, nrows, ncols);
+	matrix->delta_minus = _RG_Matrix_NewDelta(GrB_BOOL, nrows, ncols);
+
 	int mutex_res = pthread_mutex_init(&matrix->mutex, NULL);
 	ASSERT(mutex_res == 0);
 
@@ -96,13 +120,678 @@ static inline bool _RG_Matrix_MultiEdgeEnabled(RG_Matrix matrix) {
 	return matrix->allow_multi_edge;
 }
 
+// Number of pending changes held by the delta matrices.
+static inline GrB_Index _RG_Matrix_DeltaCount(RG_Matrix matrix) {
+	GrB_Index additions;
+	GrB_Index deletions;
+	GrB_Matrix_nvals(&additions, matrix->delta_plus);
+	GrB_Matrix_nvals(&deletions, matrix->delta_minus);
+	return additions + deletions;
+}
+
+// Resize the matrix and its deltas.
+static void _RG_Matrix_Resize(RG_Matrix matrix, GrB_Index nrows, GrB_Index ncols) {
+	GrB_Info res = GxB_Matrix_resize(matrix->grb_matrix, nrows, ncols);
+	ASSERT(res == GrB_SUCCESS);
+	res = GxB_Matrix_resize(matrix->delta_plus, nrows, ncols);
+	ASSERT(res == GrB_SUCCESS);
+	res = GxB_Matrix_resize(matrix->delta_minus, nrows, ncols);
+	ASSERT(res == GrB_SUCCESS);
+	UNUSED(res);
+}
+
+// Computes M + DP - DM into a new matrix of M's type and format,
+// used by the background merge only, see Graph_MergeDeltas.
+static GrB_Matrix _RG_Matrix_Combine(RG_Matrix matrix) {
+	GrB_Info info;
+	UNUSED(info);
+	GrB_Type type;
+	GrB_Index nrows;
+	GrB_Index ncols;
+	int sparsity;
+	GrB_Matrix C;
+	GrB_Matrix M = matrix->grb_matrix;
+
+	GxB_Matrix_type(&type, M);
+	GrB_Matrix_nrows(&nrows, M);
+	GrB_Matrix_ncols(&ncols, M);
+	GxB_Matrix_Option_get(M, GxB_SPARSITY_CONTROL, &sparsity);
+
+	info = GrB_Matrix_new(&C, type, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	GxB_set(C, GxB_SPARSITY_CONTROL, sparsity);
+
+	bool boolean = (type == GrB_BOOL);
+	GrB_UnaryOp identity = boolean ? GrB_IDENTITY_BOOL : GrB_IDENTITY_UINT64;
+	GrB_BinaryOp second = boolean ? GrB_SECOND_BOOL : GrB_SECOND_UINT64;
+
+	// C<!DM> = M
+	info = GrB_Matrix_apply(C, matrix->delta_minus, GrB_NULL, identity, M, GrB_DESC_RSC);
+	ASSERT(info == GrB_SUCCESS);
+	// C = C + DP, DP and C are disjoint
+	info = GrB_eWiseAdd(C, GrB_NULL, GrB_NULL, second, C, matrix->delta_plus, GrB_NULL);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_wait(&C);
+	ASSERT(info == GrB_SUCCESS);
+
+	return C;
+}
+
+// Merges the deltas into the underlying matrix in place,
+// requires exclusive access to the graph.
+static void _RG_Matrix_Merge(RG_Matrix matrix) {
+	GrB_Info info;
+	UNUSED(info);
+	GrB_Index additions;
+	GrB_Index deletions;
+	GrB_Type type;
+	GrB_Matrix M = matrix->grb_matrix;
+
+	GrB_Matrix_nvals(&additions, matrix->delta_plus);
+	GrB_Matrix_nvals(&deletions, matrix->delta_minus);
+	if(additions == 0 && deletions == 0) return;
+
+	GxB_Matrix_type(&type, M);
+	bool boolean = (type == GrB_BOOL);
+
+	if(deletions > 0) {
+		// M<!DM> = M
+		info = GrB_Matrix_apply(M, matrix->delta_minus, GrB_NULL,
+				boolean ? GrB_IDENTITY_BOOL : GrB_IDENTITY_UINT64, M, GrB_DESC_RSC);
+		ASSERT(info == GrB_SUCCESS);
+		GrB_Matrix_clear(matrix->delta_minus);
+	}
+
+	if(additions > 0) {
+		// M = M + DP
+		info = GrB_eWiseAdd(M, GrB_NULL, GrB_NULL,
+				boolean ? GrB_SECOND_BOOL : GrB_SECOND_UINT64, M, matrix->delta_plus, GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+		GrB_Matrix_clear(matrix->delta_plus);
+	}
+
+	info = GrB_wait(&M);
+	ASSERT(info == GrB_SUCCESS);
+
+	matrix->version++;
+}
+
+// Retrieves entry [i,j] of M + DP - DM.
+static GrB_Info _RG_Matrix_extractElement(uint64_t *x, RG_Matrix matrix, GrB_Index i,
+		GrB_Index j) {
+	bool deleted;
+	GrB_Info info = GrB_Matrix_extractElement_UINT64(x, matrix->delta_plus, i, j);
+	if(info == GrB_SUCCESS) return info;
+
+	info = GrB_Matrix_extractElement_UINT64(x, matrix->grb_matrix, i, j);
+	if(info != GrB_SUCCESS) return info;
+
+	if(GrB_Matrix_extractElement_BOOL(&deleted, matrix->delta_minus, i, j) == GrB_SUCCESS) {
+		return GrB_NO_VALUE;
+	}
+
+	return GrB_SUCCESS;
+}
+
+// Sets entry [i,j] of M + DP - DM to x.
+// Existing entries of M are updated in place, new entries are added to DP.
+static void _RG_Matrix_setElement(RG_Matrix matrix, uint64_t x, GrB_Index i, GrB_Index j) {
+	GrB_Info info;
+	UNUSED(info);
+	uint64_t v;
+	bool deleted;
+
+	if(GrB_Matrix_extractElement_UINT64(&v, matrix->grb_matrix, i, j) == GrB_SUCCESS) {
+		if(GrB_Matrix_extractElement_BOOL(&deleted, matrix->delta_minus, i, j) == GrB_SUCCESS) {
+			// revive deleted entry
+			info = GxB_Matrix_Delete(matrix->delta_minus, i, j);
+			ASSERT(info == GrB_SUCCESS);
+		} else if(v == x) {
+			// entry is already set
+			return;
+		}
+		info = GrB_Matrix_setElement_UINT64(matrix->grb_matrix, x, i, j);
+	} else {
+		info = GrB_Matrix_setElement_UINT64(matrix->delta_plus, x, i, j);
+	}
+	ASSERT(info == GrB_SUCCESS);
+
+	matrix->version++;
+	matrix->dirty = true;
+}
+
+// Adds edge to entry [i,j] of M + DP - DM, switching to an edge array
+// if the entry is already populated.
+static void _RG_Matrix_addEdge(RG_Matrix matrix, EdgeID edge_id, GrB_Index i, GrB_Index j) {
+	GrB_Info info;
+	UNUSED(info);
+	uint64_t v;
+	bool deleted;
+
+	if(!_RG_Matrix_MultiEdgeEnabled(matrix)) {
+		_RG_Matrix_setElement(matrix, edge_id, i, j);
+		return;
+	}
+
+	if(GrB_Matrix_extractElement_UINT64(&v, matrix->grb_matrix, i, j) == GrB_SUCCESS) {
+		if(GrB_Matrix_extractElement_BOOL(&deleted, matrix->delta_minus, i, j) == GrB_SUCCESS) {
+			// revive deleted entry, the previous edges are gone
+			info = GxB_Matrix_Delete(matrix->delta_minus, i, j);
+			ASSERT(info == GrB_SUCCESS);
+			v = edge_id;
+		} else {
+			_edge_accum(&v, &v, &edge_id);
+		}
+		info = GrB_Matrix_setElement_UINT64(matrix->grb_matrix, v, i, j);
+		ASSERT(info == GrB_SUCCESS);
+	} else {
+		// accumulate into DP without forcing a flush
+		GrB_Index I = i;
+		GrB_Index J = j;
+		info = GxB_Matrix_subassign_UINT64   // C(I,J)<Mask> = accum (C(I,J),x)
+			   (
+				   matrix->delta_plus,   // input/output matrix for results
+				   GrB_NULL,             // optional mask for C(I,J), unused if NULL
+				   _graph_edge_accum,    // optional accum for Z=accum(C(I,J),x)
+				   edge_id,              // scalar to assign to C(I,J)
+				   &I,                   // row indices
+				   1,                    // number of row indices
+				   &J,                   // column indices
+				   1,                    // number of column indices
+				   GrB_NULL              // descriptor for C(I,J) and Mask
+			   );
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	matrix->version++;
+	matrix->dirty = true;
+}
+
+// Removes entry [i,j] from M + DP - DM.
+static void _RG_Matrix_removeElement(RG_Matrix matrix, GrB_Index i, GrB_Index j) {
+	GrB_Info info;
+	UNUSED(info);
+	uint64_t v;
+
+	if(GrB_Matrix_extractElement_UINT64(&v, matrix->delta_plus, i, j) == GrB_SUCCESS) {
+		info = GxB_Matrix_Delete(matrix->delta_plus, i, j);
+	} else {
+		info = GrB_Matrix_setElement_BOOL(matrix->delta_minus, true, i, j);
+	}
+	ASSERT(info == GrB_SUCCESS);
+
+	matrix->version++;
+	matrix->dirty = true;
+}
+
+// Adds a batch of entries to M + DP - DM, entries of a relation matrix
+// are edge IDs, entries of a boolean matrix are set to true.
+// New positions are built into a matrix and added to DP at once,
+// positions already present in M are updated in place.
+static void _RG_Matrix_addBatch(RG_Matrix matrix, const GrB_Index *I, const GrB_Index *J,
+		const uint64_t *X, GrB_Index n) {
+	GrB_Info info;
+	UNUSED(info);
+	GrB_Type type;
+	GrB_Index nrows;
+	GrB_Index ncols;
+	GrB_Index nvals;
+	GrB_Matrix B;
+	GrB_Matrix existing;
+
+	GxB_Matrix_type(&type, matrix->grb_matrix);
+	GrB_Matrix_nrows(&nrows, matrix->grb_matrix);
+	GrB_Matrix_ncols(&ncols, matrix->grb_matrix);
+
+	bool multi_edge = (type == GrB_UINT64 && _RG_Matrix_MultiEdgeEnabled(matrix));
+	GrB_BinaryOp dup = (type == GrB_BOOL) ? GrB_LOR :
+					   (multi_edge) ? _graph_edge_accum : GrB_SECOND_UINT64;
+	GrB_UnaryOp identity = (type == GrB_BOOL) ? GrB_IDENTITY_BOOL : GrB_IDENTITY_UINT64;
+
+	// build the batch, duplicates are combined by 'dup' in insertion order
+	info = GrB_Matrix_new(&B, type, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	if(type == GrB_BOOL) {
+		bool *V = rm_malloc(sizeof(bool) * n);
+		for(GrB_Index k = 0; k < n; k++) V[k] = true;
+		info = GrB_Matrix_build_BOOL(B, I, J, V, n, dup);
+		rm_free(V);
+	} else {
+		info = GrB_Matrix_build_UINT64(B, I, J, X, n, dup);
+	}
+	ASSERT(info == GrB_SUCCESS);
+
+	// split off entries at positions already present in M
+	GrB_Matrix_nvals(&nvals, matrix->grb_matrix);
+	if(nvals > 0) {
+		info = GrB_Matrix_new(&existing, type, nrows, ncols);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_apply(existing, matrix->grb_matrix, GrB_NULL, identity, B, GrB_DESC_S);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_apply(B, matrix->grb_matrix, GrB_NULL, identity, B, GrB_DESC_RSC);
+		ASSERT(info == GrB_SUCCESS);
+
+		GrB_Matrix_nvals(&nvals, existing);
+		if(nvals > 0) {
+			GrB_Index *EI = rm_malloc(sizeof(GrB_Index) * nvals);
+			GrB_Index *EJ = rm_malloc(sizeof(GrB_Index) * nvals);
+			uint64_t *EX = rm_malloc(sizeof(uint64_t) * nvals);
+			GrB_Matrix_extractTuples_UINT64(EI, EJ, EX, &nvals, existing);
+
+			for(GrB_Index k = 0; k < nvals; k++) {
+				if(!multi_edge) {
+					_RG_Matrix_setElement(matrix, EX[k], EI[k], EJ[k]);
+				} else if(SINGLE_EDGE(EX[k])) {
+					_RG_Matrix_addEdge(matrix, EX[k], EI[k], EJ[k]);
+				} else {
+					EdgeID *ids = (EdgeID *)EX[k];
+					uint id_count = MultiEdge_Count(ids);
+					for(uint l = 0; l < id_count; l++) {
+						_RG_Matrix_addEdge(matrix, SET_MSB(ids[l]), EI[k], EJ[k]);
+					}
+					MultiEdge_Free(ids);
+				}
+			}
+
+			rm_free(EI);
+			rm_free(EJ);
+			rm_free(EX);
+		}
+		GrB_Matrix_free(&existing);
+	}
+
+	// DP and M are disjoint, remaining entries are added to DP
+	info = GrB_Matrix_eWiseAdd_BinaryOp(matrix->delta_plus, GrB_NULL, GrB_NULL, dup,
+										matrix->delta_plus, B, GrB_NULL);
+	ASSERT(info == GrB_SUCCESS);
+	GrB_Matrix_free(&B);
+
+	matrix->version++;
+	matrix->dirty = true;
+}
+
+// Flush pending work on the matrix and its deltas.
+static void _RG_Matrix_Flush(RG_Matrix matrix) {
+	bool pending;
+	GxB_Matrix_Pending(matrix->delta_plus, &pending);
+	if(pending) GrB_wait(&matrix->delta_plus);
+	GxB_Matrix_Pending(matrix->delta_minus, &pending);
+	if(pending) GrB_wait(&matrix->delta_minus);
+	GxB_Matrix_Pending(matrix->grb_matrix, &pending);
+	if(pending) GrB_wait(&matrix->grb_matrix);
+}
+
+// Flush the matrix if it was modified under the current write lock.
+static inline void _RG_Matrix_FlushDirty(RG_Matrix matrix) {
+	if(matrix == NULL || !matrix->dirty) return;
+	_RG_Matrix_Flush(matrix);
+	matrix->dirty = false;
+}
+
 // Free RG_Matrix.
 static void RG_Matrix_Free(RG_Matrix matrix) {
 	GrB_Matrix_free(&matrix->grb_matrix);
+	GrB_Matrix_free(&matrix->delta_plus);
+	GrB_Matrix_free(&matrix->delta_minus);
 	pthread_mutex_destroy(&matrix->mutex);
 	rm_free(matrix);
 }
 
+/* ========================= RG_Matrix iterator =============================== */
+
+RG_MatrixTupleIter *RG_MatrixTupleIter_new(GrB_Matrix M, GrB_Matrix DP, GrB_Matrix DM) {
+	ASSERT(M && DP && DM);
+	RG_MatrixTupleIter *iter = rm_calloc(1, sizeof(RG_MatrixTupleIter));
+	iter->M = M;
+	iter->DP = DP;
+	iter->DM = DM;
+	GrB_Matrix_nvals(&iter->deletions, DM);
+	GxB_MatrixTupleIter_new(&iter->it, M);
+	return iter;
+}
+
+// Extracts the entries of DP, DP is small and extracted at once.
+static void _RG_MatrixTupleIter_ExtractDeltas(RG_MatrixTupleIter *iter) {
+	iter->dp_extracted = true;
+	GrB_Matrix_nvals(&iter->n, iter->DP);
+	if(iter->n == 0) return;
+
+	iter->I = rm_malloc(sizeof(GrB_Index) * iter->n);
+	iter->J = rm_malloc(sizeof(GrB_Index) * iter->n);
+	iter->X = rm_malloc(sizeof(uint64_t) * iter->n);
+	GrB_Matrix_extractTuples_UINT64(iter->I, iter->J, iter->X, &iter->n, iter->DP);
+}
+
+void RG_MatrixTupleIter_iterate_row(RG_MatrixTupleIter *iter, GrB_Index row) {
+	ASSERT(iter);
+	GxB_MatrixTupleIter_iterate_row(iter->it, row);
+	iter->m_depleted = false;
+	iter->dp_extracted = true;
+	iter->row = row;
+	iter->idx = 0;
+	iter->n = 0;
+
+	rm_free(iter->I);
+	iter->I = NULL;
+
+	GrB_Index additions;
+	GrB_Matrix_nvals(&additions, iter->DP);
+	if(additions == 0) return;
+
+	// extract the row out of DP without modifying its format
+	GrB_Index nrows;
+	GrB_Vector v;
+	GrB_Matrix_nrows(&nrows, iter->DP);
+	GrB_Vector_new(&v, GrB_UINT64, nrows);
+	GrB_Col_extract(v, GrB_NULL, GrB_NULL, iter->DP, GrB_ALL, nrows, row, GrB_DESC_T0);
+
+	GrB_Vector_nvals(&iter->n, v);
+	if(iter->n > 0) {
+		iter->J = rm_realloc(iter->J, sizeof(GrB_Index) * iter->n);
+		iter->X = rm_realloc(iter->X, sizeof(uint64_t) * iter->n);
+		GrB_Vector_extractTuples_UINT64(iter->J, iter->X, &iter->n, v);
+	}
+	GrB_Vector_free(&v);
+}
+
+bool RG_MatrixTupleIter_next(RG_MatrixTupleIter *iter, GrB_Index *row, GrB_Index *col,
+		uint64_t *val) {
+	ASSERT(iter);
+	GrB_Index i;
+	GrB_Index j;
+	bool deleted;
+	bool depleted;
+
+	// entries of M, skipping deleted ones
+	while(!iter->m_depleted) {
+		GxB_MatrixTupleIter_next(iter->it, &i, &j, &depleted);
+		if(depleted) {
+			iter->m_depleted = true;
+			break;
+		}
+		if(iter->deletions > 0 &&
+		   GrB_Matrix_extractElement_BOOL(&deleted, iter->DM, i, j) == GrB_SUCCESS) continue;
+
+		if(row) *row = i;
+		if(col) *col = j;
+		if(val) GrB_Matrix_extractElement_UINT64(val, iter->M, i, j);
+		return true;
+	}
+
+	// entries added since the last merge
+	if(!iter->dp_extracted) _RG_MatrixTupleIter_ExtractDeltas(iter);
+	if(iter->idx == iter->n) return false;
+	if(row) *row = (iter->I) ? iter->I[iter->idx] : iter->row;
+	if(col) *col = iter->J[iter->idx];
+	if(val) *val = iter->X[iter->idx];
+	iter->idx++;
+	return true;
+}
+
+void RG_MatrixTupleIter_free(RG_MatrixTupleIter *iter) {
+	if(iter == NULL) return;
+	GxB_MatrixTupleIter_free(iter->it);
+	rm_free(iter->I);
+	rm_free(iter->J);
+	rm_free(iter->X);
+	rm_free(iter);
+}
+
+GrB_Matrix RG_Matrix_Materialize(GrB_Matrix M, GrB_Matrix DP, GrB_Matrix DM, bool *owned) {
+	ASSERT(M && DP && DM && owned);
+	GrB_Index additions;
+	GrB_Index deletions;
+	GrB_Matrix_nvals(&additions, DP);
+	GrB_Matrix_nvals(&deletions, DM);
+	*owned = (additions + deletions) > 0;
+	if(!*owned) return M;
+
+	GrB_Info info;
+	UNUSED(info);
+	GrB_Index nrows;
+	GrB_Index ncols;
+	GrB_Matrix P;
+	GrB_Matrix_nrows(&nrows, M);
+	GrB_Matrix_ncols(&ncols, M);
+	info = GrB_Matrix_new(&P, GrB_BOOL, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+
+	// P<!DM> = M
+	info = GrB_Matrix_apply(P, DM, GrB_NULL, GxB_ONE_BOOL, M, GrB_DESC_RSC);
+	ASSERT(info == GrB_SUCCESS);
+	// P = P + DP
+	info = GrB_eWiseAdd(P, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, P, DP, GrB_NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	return P;
+}
+
+/* ========================= Transposed relation matrices ========================= */
+
+/* With LAZY_TRANSPOSED_MATRICES a transposed relation matrix is only built
+ * once a query asks for it, from then on it is updated along with its
+ * relation matrix until Graph_EvictTransposes drops it.
+ * Building happens under the read lock, concurrent builders are serialized by
+ * the graph's transpose mutex, dropping requires the write lock. */
+
+// Returns the transposed relation matrix if it is built, NULL otherwise.
+static inline RG_Matrix _Graph_ResidentTranspose(const Graph *g, int r) {
+	if(g->t_relations == NULL) return NULL;
+	return __atomic_load_n(g->t_relations + r, __ATOMIC_ACQUIRE);
+}
+
+// Copies the edge ID arrays of 'X', matrices own their multi-edge arrays.
+static void _Graph_CopyEdgeArrays(uint64_t *X, GrB_Index n) {
+	for(GrB_Index i = 0; i < n; i++) {
+		if(SINGLE_EDGE(X[i])) continue;
+		EdgeID *ids = (EdgeID *)X[i];
+		uint count = MultiEdge_Count(ids);
+		EdgeID *copy = MultiEdge_New(count);
+		for(uint j = 0; j < count; j++) copy = MultiEdge_Append(copy, ids[j]);
+		X[i] = (uint64_t)copy;
+	}
+}
+
+// Frees the edge ID arrays referenced by 'M'.
+static void _Graph_FreeEdgeArrays(GrB_Matrix M) {
+	GrB_Index n;
+	GrB_Matrix_nvals(&n, M);
+	if(n == 0) return;
+
+	uint64_t *X = rm_malloc(sizeof(uint64_t) * n);
+	GrB_Matrix_extractTuples_UINT64(NULL, NULL, X, &n, M);
+	for(GrB_Index i = 0; i < n; i++) {
+		if(!(SINGLE_EDGE(X[i]))) MultiEdge_Free((EdgeID *)X[i]);
+	}
+	rm_free(X);
+}
+
+// Builds the transpose of relation matrix 'r' out of its current content.
+static RG_Matrix _Graph_BuildTranspose(const Graph *g, int r) {
+	RG_Matrix R = g->relations[r];
+	GrB_Index n = 0;
+	GrB_Index nrows;
+	GrB_Index ncols;
+	GrB_Index nvals;
+	GrB_Index additions;
+	GrB_Index *I = NULL;
+	GrB_Index *J = NULL;
+	uint64_t *X = NULL;
+
+	// entries are collected straight off the matrix and its deltas,
+	// the mutex guards against a concurrent resize
+	RG_Matrix_Lock(R);
+	GrB_Matrix_nrows(&nrows, R->grb_matrix);
+	GrB_Matrix_ncols(&ncols, R->grb_matrix);
+	GrB_Matrix_nvals(&nvals, R->grb_matrix);
+	GrB_Matrix_nvals(&additions, R->delta_plus);
+	if(nvals + additions > 0) {
+		I = rm_malloc(sizeof(GrB_Index) * (nvals + additions));
+		J = rm_malloc(sizeof(GrB_Index) * (nvals + additions));
+		X = rm_malloc(sizeof(uint64_t) * (nvals + additions));
+		RG_MatrixTupleIter *it = RG_MatrixTupleIter_new(R->grb_matrix, R->delta_plus,
+				R->delta_minus);
+		while(RG_MatrixTupleIter_next(it, I + n, J + n, X + n)) n++;
+		RG_MatrixTupleIter_free(it);
+	}
+	_RG_Matrix_Unlock(R);
+
+	RG_Matrix TM = RG_Matrix_New(GrB_UINT64, ncols, nrows);
+	TM->allow_multi_edge = R->allow_multi_edge;
+
+	if(n > 0) {
+		_Graph_CopyEdgeArrays(X, n);
+
+		GrB_Info info = GrB_Matrix_build_UINT64(TM->grb_matrix, J, I, X, n, GrB_SECOND_UINT64);
+		ASSERT(info == GrB_SUCCESS);
+		UNUSED(info);
+	}
+
+	rm_free(I);
+	rm_free(J);
+	rm_free(X);
+	return TM;
+}
+
+// Returns the transposed relation matrix, building it if required.
+static RG_Matrix _Graph_Transpose(const Graph *g, int r) {
+	ASSERT(g->t_relations != NULL);
+	Graph *_g = (Graph *)g;
+
+	RG_Matrix TM = _Graph_ResidentTranspose(g, r);
+	if(!g->lazy_transposes) return TM;
+
+	if(TM == NULL) {
+		pthread_mutex_lock(&_g->_transpose_mutex);
+		TM = g->t_relations[r];
+		if(TM == NULL) {
+			TM = _Graph_BuildTranspose(g, r);
+			__atomic_store_n(_g->t_relations + r, TM, __ATOMIC_RELEASE);
+			__atomic_fetch_add(&_g->t_stats.builds, 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&_g->t_stats.resident, 1, __ATOMIC_RELAXED);
+		}
+		pthread_mutex_unlock(&_g->_transpose_mutex);
+	}
+
+	uint64_t clock = __atomic_load_n(&g->t_relations_clock, __ATOMIC_RELAXED);
+	__atomic_store_n(_g->t_relations_used + r, clock, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&_g->t_stats.uses, 1, __ATOMIC_RELAXED);
+	return TM;
+}
+
+// Drops a transposed relation matrix, requires exclusive access to the graph.
+static void _Graph_DropTranspose(Graph *g, int r) {
+	RG_Matrix TM = g->t_relations[r];
+	ASSERT(TM != NULL);
+
+	// deleted entries never reference edge arrays
+	_Graph_FreeEdgeArrays(TM->grb_matrix);
+	_Graph_FreeEdgeArrays(TM->delta_plus);
+	RG_Matrix_Free(TM);
+	g->t_relations[r] = NULL;
+
+	g->t_stats.resident--;
+	g->t_stats.drops++;
+}
+
+// Estimated number of bytes held by a relation matrix.
+static size_t _RG_Matrix_Footprint(RG_Matrix M) {
+	GrB_Index nrows;
+	GrB_Index nvals;
+	GrB_Index pending;
+	GrB_Matrix_nrows(&nrows, M->grb_matrix);
+	GrB_Matrix_nvals(&nvals, M->grb_matrix);
+	pending = _RG_Matrix_DeltaCount(M);
+
+	// Sparse storage, row pointers followed by column indices and values.
+	return (nrows + 1) * sizeof(GrB_Index) +
+		   (nvals + pending) * (sizeof(GrB_Index) + sizeof(uint64_t));
+}
+
+void Graph_EvictTransposes(Graph *g, uint64_t max_memory, bool pressure) {
+	ASSERT(g);
+	if(g->t_relations == NULL || !g->lazy_transposes) return;
+
+	uint64_t now = __atomic_add_fetch(&g->t_relations_clock, 1, __ATOMIC_RELAXED);
+	if(max_memory == 0 && !pressure) return;
+
+	Graph_AcquireWriteLock(g);
+
+	// Graphs being loaded or bulk inserted are left alone.
+	if(g->SynchronizeMatrix != _MatrixSynchronize) {
+		Graph_ReleaseLock(g);
+		return;
+	}
+
+	uint relation_count = Graph_RelationTypeCount(g);
+	size_t footprint[relation_count];
+	size_t total = 0;
+	for(uint i = 0; i < relation_count; i++) {
+		RG_Matrix TM = g->t_relations[i];
+		footprint[i] = (TM) ? _RG_Matrix_Footprint(TM) : 0;
+		total += footprint[i];
+	}
+
+	// Matrices which weren't used since the previous pass are cold.
+	if(pressure) {
+		for(uint i = 0; i < relation_count; i++) {
+			if(g->t_relations[i] == NULL || g->t_relations_used[i] + 1 >= now) continue;
+			_Graph_DropTranspose(g, i);
+			total -= footprint[i];
+		}
+	}
+
+	// Drop least recently used matrices until within budget.
+	while(max_memory > 0 && total > max_memory) {
+		int lru = -1;
+		for(uint i = 0; i < relation_count; i++) {
+			if(g->t_relations[i] == NULL) continue;
+			if(lru == -1 || g->t_relations_used[i] < g->t_relations_used[lru]) lru = i;
+		}
+		if(lru == -1) break;
+		_Graph_DropTranspose(g, lru);
+		total -= footprint[lru];
+	}
+
+	Graph_ReleaseLock(g);
+}
+
+void Graph_GetTransposeStats(const Graph *g, TransposeStats *stats) {
+	ASSERT(g && stats);
+	stats->resident += __atomic_load_n(&g->t_stats.resident, __ATOMIC_RELAXED);
+	stats->uses += __atomic_load_n(&g->t_stats.uses, __ATOMIC_RELAXED);
+	stats->builds += __atomic_load_n(&g->t_stats.builds, __ATOMIC_RELAXED);
+	stats->drops += __atomic_load_n(&g->t_stats.drops, __ATOMIC_RELAXED);
+}
+
+// Returns the relation matrix, the adjacency matrix for GRAPH_NO_RELATION.
+static inline RG_Matrix _Graph_RelationMatrix(const Graph *g, int r, bool transposed) {
+	if(r == GRAPH_NO_RELATION) {
+		return transposed ? g->_t_adjacency_matrix : g->adjacency_matrix;
+	}
+	return transposed ? _Graph_Transpose(g, r) : g->relations[r];
+}
+
+// Collects every matrix of the graph except the zero matrix.
+static RG_Matrix *_Graph_Matrices(const Graph *g) {
+	uint label_count = array_len(g->labels);
+	uint relation_count = array_len(g->relations);
+	RG_Matrix *matrices = array_new(RG_Matrix, 2 + label_count + relation_count * 2);
+
+	matrices = array_append(matrices, g->adjacency_matrix);
+	matrices = array_append(matrices, g->_t_adjacency_matrix);
+	for(uint i = 0; i < label_count; i++) {
+		matrices = array_append(matrices, g->labels[i]);
+	}
+	for(uint i = 0; i < relation_count; i++) {
+		matrices = array_append(matrices, g->relations[i]);
+		RG_Matrix TM = _Graph_ResidentTranspose(g, i);
+		if(TM) matrices = array_append(matrices, TM);
+	}
+
+	return matrices;
+}
+
 /* ========================= Synchronization functions ========================= */
 
 /* Acquire a lock that does not restrict access from additional reader threads */
@@ -125,6 +814,19 @@ void Graph_ReleaseLock(Graph *g) {
 	 * for a reader thread to be considered as writer, performing illegal access to
 	 * underline matrices, consider a context switch after unlocking `_rwlock` but
 	 * before setting `_writelocked` to false. */
+	if(g->_writelocked) {
+		// make sure readers never encounter pending work on the delta matrices
+		// only matrices modified under the write lock are flushed
+		_RG_Matrix_FlushDirty(g->adjacency_matrix);
+		_RG_Matrix_FlushDirty(g->_t_adjacency_matrix);
+		uint label_count = array_len(g->labels);
+		for(uint i = 0; i < label_count; i++) _RG_Matrix_FlushDirty(g->labels[i]);
+		uint relation_count = array_len(g->relations);
+		for(uint i = 0; i < relation_count; i++) {
+			_RG_Matrix_FlushDirty(g->relations[i]);
+			_RG_Matrix_FlushDirty(_Graph_ResidentTranspose(g, i));
+		}
+	}
 	g->_writelocked = false;
 	pthread_rwlock_unlock(&g->_rwlock);
 }
@@ -157,6 +859,30 @@ size_t _Graph_EdgeCap(const Graph *g) {
 	return g->edges->itemCap;
 }
 
+// Number of 64 bit words required to hold n bits.
+#define LABEL_BITMAP_WORDS(n) (((n) + 63) / 64)
+
+// Grows label bitmaps to accommodate node 'id',
+// bitmaps are sized to node capacity.
+static void _Graph_ReserveLabelBitmaps(Graph *g, NodeID id) {
+	if(id < g->label_bitmap_words * 64) return;
+
+	uint64_t words = LABEL_BITMAP_WORDS(MAX(id + 1, _Graph_NodeCap(g)));
+	uint64_t prev_words = g->label_bitmap_words;
+	uint label_count = array_len(g->label_bitmaps);
+	for(uint i = 0; i < label_count; i++) {
+		uint64_t *bitmap = rm_realloc(g->label_bitmaps[i], words * sizeof(uint64_t));
+		memset(bitmap + prev_words, 0, (words - prev_words) * sizeof(uint64_t));
+		g->label_bitmaps[i] = bitmap;
+	}
+	g->label_bitmap_words = words;
+}
+
+static inline void _Graph_ClearNodeLabel(Graph *g, NodeID id, int label) {
+	if(id >= g->label_bitmap_words * 64) return;
+	g->label_bitmaps[label][id / 64] &= ~(1ULL << (id % 64));
+}
+
 // Locates edges connecting src to destination.
 void _Graph_GetEdgesConnectingNodes(const Graph *g, NodeID src, NodeID dest, int r, Edge **edges) {
 	ASSERT(g && src < Graph_RequiredMatrixDim(g) && dest < Graph_RequiredMatrixDim(g) &&
@@ -169,8 +895,9 @@ void _Graph_GetEdgesConnectingNodes(const Graph *g, NodeID src, NodeID dest, int
 	e.destNodeID = dest;
 
 	// relation map, maps (src, dest, r) to edge IDs.
-	GrB_Matrix relation = Graph_GetRelationMatrix(g, r);
-	GrB_Info res = GrB_Matrix_extractElement_UINT64(&edgeId, relation, src, dest);
+	RG_Matrix relation = g->relations[r];
+	g->SynchronizeMatrix(g, relation);
+	GrB_Info res = _RG_Matrix_extractElement(&edgeId, relation, src, dest);
 
 	// No entry at [dest, src], src is not connected to dest with relation R.
 	if(res == GrB_NO_VALUE) return;
@@ -186,7 +913,7 @@ void _Graph_GetEdgesConnectingNodes(const Graph *g, NodeID src, NodeID dest, int
 		/* Multiple edges connecting src to dest,
 		 * entry is a pointer to an array of edge IDs. */
 		EdgeID *edgeIds = (EdgeID *)edgeId;
-		int edgeCount = array_len(edgeIds);
+		int edgeCount = MultiEdge_Count(edgeIds);
 
 		for(int i = 0; i < edgeCount; i++) {
 			edgeId = edgeIds[i];
@@ -202,8 +929,9 @@ void _Graph_GetEdgesConnectingNodes(const Graph *g, NodeID src, NodeID dest, int
 bool Graph_EdgeExists(const Graph *g, NodeID srcID, NodeID destID, int r) {
 	ASSERT(g);
 	EdgeID edgeId;
-	GrB_Matrix M = Graph_GetRelationMatrix(g, r);
-	GrB_Info res = GrB_Matrix_extractElement_UINT64(&edgeId, M, destID, srcID);
+	RG_Matrix M = _Graph_RelationMatrix(g, r, false);
+	g->SynchronizeMatrix(g, M);
+	GrB_Info res = _RG_Matrix_extractElement(&edgeId, M, destID, srcID);
 	return res == GrB_SUCCESS;
 }
 
@@ -227,34 +955,34 @@ void _MatrixSynchronize(const Graph *g, RG_Matrix rg_matrix) {
 	// If the graph belongs to one thread, we don't need to lock the mutex.
 	if(g->_writelocked) {
 		if((n_rows != dims) || (n_cols != dims)) {
-			GrB_Info res = GxB_Matrix_resize(m, dims, dims);
-			ASSERT(res == GrB_SUCCESS);
+			_RG_Matrix_Resize(rg_matrix, dims, dims);
+			rg_matrix->dirty = true;
 		}
 
 		// Writer under write lock, no need to flush pending changes.
 		return;
 	}
 
-	// Lock the matrix.
-	RG_Matrix_Lock(rg_matrix);
-
+	// Writes are absorbed by the delta matrices which are flushed
+	// when the write lock is released, see Graph_ReleaseLock,
+	// as such the read path is expected to find no pending work.
 	bool pending = false;
 	GxB_Matrix_Pending(m, &pending);
+	if(!pending && (n_rows == dims) && (n_cols == dims)) return;
 
-	// If the matrix has pending operations or requires
-	// a resize, enter critical section.
-	if(pending || (n_rows != dims) || (n_cols != dims)) {
-		// Double-check if resize is necessary.
-		GrB_Matrix_nrows(&n_rows, m);
-		GrB_Matrix_ncols(&n_cols, m);
-		dims = Graph_RequiredMatrixDim(g);
-		if((n_rows != dims) || (n_cols != dims)) {
-			GrB_Info res = GxB_Matrix_resize(m, dims, dims);
-			ASSERT(res == GrB_SUCCESS);
-		}
-		// Flush changes to matrix.
-		_Graph_ApplyPending(m);
+	// Lock the matrix.
+	RG_Matrix_Lock(rg_matrix);
+
+	// Double-check if resize is necessary.
+	GrB_Matrix_nrows(&n_rows, m);
+	GrB_Matrix_ncols(&n_cols, m);
+	dims = Graph_RequiredMatrixDim(g);
+	if((n_rows != dims) || (n_cols != dims)) {
+		_RG_Matrix_Resize(rg_matrix, dims, dims);
 	}
+	// Flush changes to matrix.
+	_RG_Matrix_Flush(rg_matrix);
+
 	// Unlock matrix mutex.
 	_RG_Matrix_Unlock(rg_matrix);
 }
@@ -270,8 +998,7 @@ void _MatrixResizeToCapacity(const Graph *g, RG_Matrix matrix) {
 
 	// This policy should only be used in a thread-safe context, so no locking is required.
 	if(ncols != cap || nrows != cap) {
-		GrB_Info res = GxB_Matrix_resize(m, cap, cap);
-		ASSERT(res == GrB_SUCCESS);
+		_RG_Matrix_Resize(matrix, cap, cap);
 	}
 }
 
@@ -304,27 +1031,98 @@ void Graph_SetMatrixPolicy(Graph *g, MATRIX_POLICY policy) {
 
 /* Synchronize and resize all matrices in graph. */
 void Graph_ApplyAllPending(Graph *g) {
-	RG_Matrix M;
-
-	for(int i = 0; i < array_len(g->labels); i ++) {
-		M = g->labels[i];
+	// merge pending changes into the underlying matrices
+	// callers have exclusive access to the graph
+	RG_Matrix *matrices = _Graph_Matrices(g);
+	uint n = array_len(matrices);
+	for(uint i = 0; i < n; i++) {
+		RG_Matrix M = matrices[i];
 		g->SynchronizeMatrix(g, M);
+		_RG_Matrix_Merge(M);
 	}
+	array_free(matrices);
+}
 
-	for(int i = 0; i < array_len(g->relations); i ++) {
-		M = g->relations[i];
-		g->SynchronizeMatrix(g, M);
+// A merge candidate computed under the read lock.
+typedef struct {
+	RG_Matrix matrix;   // matrix to update
+	GrB_Matrix merged;  // M + DP - DM
+	uint64_t version;   // matrix version 'merged' reflects
+} _DeltaMerge;
+
+void Graph_MergeDeltas(Graph *g, uint64_t threshold) {
+	ASSERT(g);
+
+	_DeltaMerge *merges = array_new(_DeltaMerge, 0);
+
+	// compute merged matrices while readers are still allowed in
+	Graph_AcquireReadLock(g);
+
+	// graphs being loaded or bulk inserted are left alone
+	if(g->SynchronizeMatrix != _MatrixSynchronize) {
+		Graph_ReleaseLock(g);
+		array_free(merges);
+		return;
+	}
+
+	RG_Matrix *matrices = _Graph_Matrices(g);
+	uint n = array_len(matrices);
+	for(uint i = 0; i < n; i++) {
+		RG_Matrix M = matrices[i];
+		GrB_Index pending = _RG_Matrix_DeltaCount(M);
+		if(pending == 0) continue;
+
+		// merge once enough changes accumulated or the deltas went quiet
+		if(pending < threshold && M->version != M->merge_version) {
+			M->merge_version = M->version;
+			continue;
+		}
+
+		RG_Matrix_Lock(M);
+		_DeltaMerge merge = {.matrix = M, .version = M->version};
+		merge.merged = _RG_Matrix_Combine(M);
+		_RG_Matrix_Unlock(M);
+		merges = array_append(merges, merge);
 	}
+	array_free(matrices);
 
-	bool maintain_transpose;
-	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
+	Graph_ReleaseLock(g);
 
-	if(maintain_transpose) {
-		for(int i = 0; i < array_len(g->t_relations); i ++) {
-			M = g->t_relations[i];
-			g->SynchronizeMatrix(g, M);
+	uint merge_count = array_len(merges);
+	if(merge_count == 0) {
+		array_free(merges);
+		return;
+	}
+
+	// swap merged matrices in, no reader can hold a reference to the
+	// replaced matrices
+	Graph_AcquireWriteLock(g);
+
+	for(uint i = 0; i < merge_count; i++) {
+		_DeltaMerge *merge = merges + i;
+		RG_Matrix M = merge->matrix;
+		GrB_Index nrows;
+		GrB_Index merged_rows;
+		GrB_Matrix_nrows(&nrows, M->grb_matrix);
+		GrB_Matrix_nrows(&merged_rows, merge->merged);
+
+		// matrix modified while merging, retry on next pass
+		if(M->version != merge->version || nrows != merged_rows) {
+			GrB_Matrix_free(&merge->merged);
+			continue;
 		}
+
+		GrB_Matrix_free(&M->grb_matrix);
+		M->grb_matrix = merge->merged;
+		GrB_Matrix_clear(M->delta_plus);
+		GrB_Matrix_clear(M->delta_minus);
+		M->version++;
+		M->merge_version = M->version;
 	}
+
+	Graph_ReleaseLock(g);
+
+	array_free(merges);
 }
 
 /* ================================ Graph API ================================ */
@@ -332,10 +1130,18 @@ Graph *Graph_New(size_t node_cap, size_t edge_cap) {
 	node_cap = MAX(node_cap, GRAPH_DEFAULT_NODE_CAP);
 	edge_cap = MAX(node_cap, GRAPH_DEFAULT_EDGE_CAP);
 
+	// Nodes are optionally stored in per-label blocks, speeding up label scans.
+	bool cluster_nodes;
+	Config_Option_get(Config_CLUSTER_NODES_BY_LABEL, &cluster_nodes);
+
 	Graph *g = rm_malloc(sizeof(Graph));
-	g->nodes = DataBlock_New(node_cap, sizeof(Entity), (fpDestructor)FreeEntity);
+	g->nodes = cluster_nodes ?
+			   DataBlock_NewClustered(node_cap, sizeof(Entity), (fpDestructor)FreeEntity) :
+			   DataBlock_New(node_cap, sizeof(Entity), (fpDestructor)FreeEntity);
 	g->edges = DataBlock_New(edge_cap, sizeof(Entity), (fpDestructor)FreeEntity);
 	g->labels = array_new(RG_Matrix, GRAPH_DEFAULT_LABEL_CAP);
+	g->label_bitmaps = array_new(uint64_t *, GRAPH_DEFAULT_LABEL_CAP);
+	g->label_bitmap_words = LABEL_BITMAP_WORDS(node_cap);
 	g->relations = array_new(RG_Matrix, GRAPH_DEFAULT_RELATION_TYPE_CAP);
 	g->adjacency_matrix = RG_Matrix_New(GrB_BOOL, node_cap, node_cap);
 	g->_t_adjacency_matrix = RG_Matrix_New(GrB_BOOL, node_cap, node_cap);
@@ -346,6 +1152,13 @@ Graph *Graph_New(size_t node_cap, size_t edge_cap) {
 	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
 	g->t_relations = maintain_transpose ?
 					 array_new(RG_Matrix, GRAPH_DEFAULT_RELATION_TYPE_CAP) : NULL;
+	g->t_relations_used = maintain_transpose ?
+						  array_new(uint64_t, GRAPH_DEFAULT_RELATION_TYPE_CAP) : NULL;
+	g->t_relations_clock = 0;
+	memset(&g->t_stats, 0, sizeof(TransposeStats));
+
+	// Transposed matrices may be built on first use rather than maintained throughout.
+	Config_Option_get(Config_LAZY_TRANSPOSE, &g->lazy_transposes);
 
 	// Initialize a read-write lock scoped to the individual graph
 	int res;
@@ -360,6 +1173,8 @@ Graph *Graph_New(size_t node_cap, size_t edge_cap) {
 	// Synchronization objects initialization.
 	res = pthread_mutex_init(&g->_writers_mutex, NULL);
 	ASSERT(res == 0);
+	res = pthread_mutex_init(&g->_transpose_mutex, NULL);
+	ASSERT(res == 0);
 
 	// Create edge accumulator binary function
 	if(!_graph_edge_accum) {
@@ -377,11 +1192,7 @@ Graph *Graph_New(size_t node_cap, size_t edge_cap) {
 size_t Graph_RequiredMatrixDim(const Graph *g) {
 	// Matrix dimensions should be at least:
 	// Number of nodes + number of deleted nodes.
-#ifdef LABEL_DATABLOCK
-    return ((g->nodes->itemCount >> 14) + 2) << 14;
-#else
-	return g->nodes->itemCount + array_len(g->nodes->deletedIdx);
-#endif
+	return g->nodes->itemCount + DataBlock_DeletedItemsCount(g->nodes);
 }
 
 size_t Graph_NodeCount(const Graph *g) {
@@ -396,9 +1207,16 @@ uint Graph_DeletedNodeCount(const Graph *g) {
 
 size_t Graph_LabeledNodeCount(const Graph *g, int label) {
 	GrB_Index nvals = 0;
-	GrB_Matrix m = Graph_GetLabelMatrix(g, label);
-	if(m) GrB_Matrix_nvals(&nvals, m);
-	return nvals;
+	GrB_Index additions = 0;
+	GrB_Index deletions = 0;
+	RG_Matrix m = g->labels[label];
+	g->SynchronizeMatrix(g, m);
+
+	// DP is disjoint from M while DM is contained in it
+	GrB_Matrix_nvals(&nvals, m->grb_matrix);
+	GrB_Matrix_nvals(&additions, m->delta_plus);
+	GrB_Matrix_nvals(&deletions, m->delta_minus);
+	return nvals + additions - deletions;
 }
 
 size_t Graph_EdgeCount(const Graph *g) {
@@ -445,18 +1263,65 @@ int Graph_GetEdge(const Graph *g, EdgeID id, Edge *e) {
 
 int Graph_GetNodeLabel(const Graph *g, NodeID nodeID) {
 	ASSERT(g);
-	int label = GRAPH_NO_LABEL;
-	for(int i = 0; i < array_len(g->labels); i++) {
-		bool x = false;
-		GrB_Matrix M = Graph_GetLabelMatrix(g, i);
-		GrB_Info res = GrB_Matrix_extractElement_BOOL(&x, M, nodeID, nodeID);
-		if(res == GrB_SUCCESS && x == true) {
-			label = i;
-			break;
-		}
+	if(nodeID >= g->label_bitmap_words * 64) return GRAPH_NO_LABEL;
+
+	// Label bitmaps mirror label matrices, a node has at most a single label.
+	uint64_t word = nodeID / 64;
+	uint64_t bit = 1ULL << (nodeID % 64);
+	uint label_count = array_len(g->label_bitmaps);
+	for(uint i = 0; i < label_count; i++) {
+		if(g->label_bitmaps[i][word] & bit) return i;
+	}
+
+	return GRAPH_NO_LABEL;
+}
+
+bool Graph_NodeHasLabel(const Graph *g, NodeID nodeID, int label) {
+	ASSERT(g);
+	if(label < 0 || label >= Graph_LabelTypeCount(g)) return false;
+	if(nodeID >= g->label_bitmap_words * 64) return false;
+	return (g->label_bitmaps[label][nodeID / 64] >> (nodeID % 64)) & 1;
+}
+
+bool Graph_NextLabeledNode(const Graph *g, int label, NodeID *nodeID) {
+	ASSERT(g && nodeID);
+	if(label < 0 || label >= Graph_LabelTypeCount(g)) return false;
+
+	const uint64_t *bitmap = g->label_bitmaps[label];
+	uint64_t w = *nodeID / 64;
+	if(w >= g->label_bitmap_words) return false;
+
+	// Mask out bits preceding nodeID within its word.
+	uint64_t word = bitmap[w] & (~0ULL << (*nodeID % 64));
+	while(word == 0) {
+		if(++w == g->label_bitmap_words) return false;
+		word = bitmap[w];
 	}
 
-	return label;
+	*nodeID = w * 64 + __builtin_ctzll(word);
+	return true;
+}
+
+void Graph_MarkNodeLabel(Graph *g, NodeID nodeID, int label) {
+	ASSERT(g && label >= 0 && label < Graph_LabelTypeCount(g));
+	_Graph_ReserveLabelBitmaps(g, nodeID);
+	g->label_bitmaps[label][nodeID / 64] |= 1ULL << (nodeID % 64);
+}
+
+void Graph_RebuildLabelBitmaps(Graph *g) {
+	ASSERT(g);
+	_Graph_ReserveLabelBitmaps(g, _Graph_NodeCap(g) - 1);
+
+	NodeID id;
+	uint label_count = array_len(g->labels);
+	for(uint i = 0; i < label_count; i++) {
+		RG_Matrix L = g->labels[i];
+		memset(g->label_bitmaps[i], 0, g->label_bitmap_words * sizeof(uint64_t));
+		RG_MatrixTupleIter *it = RG_MatrixTupleIter_new(L->grb_matrix, L->delta_plus,
+				L->delta_minus);
+		while(RG_MatrixTupleIter_next(it, &id, NULL, NULL)) Graph_MarkNodeLabel(g, id, i);
+		RG_MatrixTupleIter_free(it);
+	}
 }
 
 int Graph_GetEdgeRelation(const Graph *g, Edge *e) {
@@ -470,8 +1335,9 @@ int Graph_GetEdgeRelation(const Graph *g, Edge *e) {
 	uint relationship_count = array_len(g->relations);
 	for(uint i = 0; i < relationship_count; i++) {
 		EdgeID edgeId = 0;
-		GrB_Matrix M = Graph_GetRelationMatrix(g, i);
-		GrB_Info res = GrB_Matrix_extractElement_UINT64(&edgeId, M, srcNodeID, destNodeID);
+		RG_Matrix M = g->relations[i];
+		g->SynchronizeMatrix(g, M);
+		GrB_Info res = _RG_Matrix_extractElement(&edgeId, M, srcNodeID, destNodeID);
 		if(res != GrB_SUCCESS) continue;
 
 		if(SINGLE_EDGE(edgeId)) {
@@ -484,7 +1350,7 @@ int Graph_GetEdgeRelation(const Graph *g, Edge *e) {
 			/* Multiple edges exists between src and dest
 			 * see if given edge is one of them. */
 			EdgeID *edges = (EdgeID *)edgeId;
-			int edge_count = array_len(edges);
+			int edge_count = MultiEdge_Count(edges);
 			for(int j = 0; j < edge_count; j++) {
 				if(edges[j] == id) {
 					Edge_SetRelationID(e, i);
@@ -527,95 +1393,50 @@ void Graph_CreateNode(Graph *g, int label, Node *n) {
 	ASSERT(g);
 
 	NodeID id;
-	Entity *en = DataBlock_AllocateItem(g->nodes, &id);
+	Entity *en = DataBlock_AllocateItem_Label(g->nodes, label, &id);
 	n->id = id;
 	n->entity = en;
 	en->prop_count = 0;
+	en->prop_cap = 0;
+	en->heat = 0;
 	en->properties = NULL;
 
 	if(label != GRAPH_NO_LABEL) {
-		// Try to set matrix at position [id, id]
-		// incase of a failure, scale matrix.
+		// Set matrix at position [id, id]
+		// scale matrix if it can't accommodate the new node.
 		RG_Matrix matrix = g->labels[label];
-		GrB_Matrix m = RG_Matrix_Get_GrB_Matrix(matrix);
-		GrB_Info res = GrB_Matrix_setElement_BOOL(m, true, id, id);
-		if(res != GrB_SUCCESS) {
-			_MatrixResizeToCapacity(g, matrix);
-			res = GrB_Matrix_setElement_BOOL(m, true, id, id);
-			ASSERT(res == GrB_SUCCESS);
-		}
+		GrB_Index nrows;
+		GrB_Matrix_nrows(&nrows, RG_Matrix_Get_GrB_Matrix(matrix));
+		if(id >= nrows) _MatrixResizeToCapacity(g, matrix);
+		_RG_Matrix_setElement(matrix, true, id, id);
+		Graph_MarkNodeLabel(g, id, label);
 	}
 }
 
 void Graph_FormConnection(Graph *g, NodeID src, NodeID dest, EdgeID edge_id, int r) {
-	GrB_Info info;
-	UNUSED(info);
 	RG_Matrix M = g->relations[r];
-	GrB_Matrix t_relationMat = NULL;
-	GrB_Matrix adj = Graph_GetAdjacencyMatrix(g);
-	GrB_Matrix tadj = Graph_GetTransposedAdjacencyMatrix(g);
-	GrB_Matrix relationMat = Graph_GetRelationMatrix(g, r);
+	RG_Matrix TM = _Graph_ResidentTranspose(g, r);
+	RG_Matrix adj = g->adjacency_matrix;
+	RG_Matrix tadj = g->_t_adjacency_matrix;
 
-	bool maintain_transpose;
-	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
-	if(maintain_transpose) {
-		t_relationMat = Graph_GetTransposedRelationMatrix(g, r);
-	}
+	g->SynchronizeMatrix(g, adj);
+	g->SynchronizeMatrix(g, tadj);
+	g->SynchronizeMatrix(g, M);
+	if(TM) g->SynchronizeMatrix(g, TM);
 
 	// Rows represent source nodes, columns represent destination nodes.
 	edge_id = SET_MSB(edge_id);
-	GrB_Matrix_setElement_BOOL(adj, true, src, dest);
-	GrB_Matrix_setElement_BOOL(tadj, true, dest, src);
-
-	// Matrix multi-edge is enable for this matrix, use GxB_Matrix_subassign.
-	if(_RG_Matrix_MultiEdgeEnabled(M)) {
-		GrB_Index I = src;
-		GrB_Index J = dest;
-		info = GxB_Matrix_subassign_UINT64   // C(I,J)<Mask> = accum (C(I,J),x)
-			   (
-				   relationMat,          // input/output matrix for results
-				   GrB_NULL,             // optional mask for C(I,J), unused if NULL
-				   _graph_edge_accum,    // optional accum for Z=accum(C(I,J),x)
-				   edge_id,              // scalar to assign to C(I,J)
-				   &I,                   // row indices
-				   1,                    // number of row indices
-				   &J,                   // column indices
-				   1,                    // number of column indices
-				   GrB_NULL              // descriptor for C(I,J) and Mask
-			   );
-		ASSERT(info == GrB_SUCCESS);
+	_RG_Matrix_setElement(adj, true, src, dest);
+	_RG_Matrix_setElement(tadj, true, dest, src);
 
-		// Update the transposed matrix if one is present.
-		if(t_relationMat != NULL) {
-			// Perform the same update to the J,I coordinates of the transposed matrix.
-			info = GxB_Matrix_subassign_UINT64   // C(I,J)<Mask> = accum (C(I,J),x)
-				   (
-					   t_relationMat,       // input/output matrix for results
-					   GrB_NULL,            // optional mask for C(J,I), unused if NULL
-					   _graph_edge_accum,   // optional accum for Z=accum(C(J,I),x)
-					   edge_id,             // scalar to assign to C(J,I)
-					   &J,                  // row indices
-					   1,                   // number of row indices
-					   &I,                  // column indices
-					   1,                   // number of column indices
-					   GrB_NULL             // descriptor for C(J,I) and Mask
-				   );
-			ASSERT(info == GrB_SUCCESS);
-		}
-	} else {
-		// Multi-edge is disabled, use GrB_Matrix_setElement.
-		info = GrB_Matrix_setElement_UINT64(relationMat, edge_id, src, dest);
-		ASSERT(info == GrB_SUCCESS);
+	// Multiple edges may connect src to dest if multi-edge is enabled.
+	_RG_Matrix_addEdge(M, edge_id, src, dest);
 
-		// Update the transposed matrix if one is present.
-		if(t_relationMat != NULL) {
-			info = GrB_Matrix_setElement_UINT64(t_relationMat, edge_id, dest, src);
-			ASSERT(info == GrB_SUCCESS);
-		}
-	}
+	// Perform the same update to the J,I coordinates of the transposed matrix.
+	if(TM) _RG_Matrix_addEdge(TM, edge_id, dest, src);
 }
 
-int Graph_ConnectNodes(Graph *g, NodeID src, NodeID dest, int r, Edge *e) {
+void Graph_CreateEdge(Graph *g, NodeID src, NodeID dest, int r, Edge *e) {
 	Node srcNode = GE_NEW_NODE();
 	Node destNode = GE_NEW_NODE();
 
@@ -630,25 +1451,107 @@ int Graph_ConnectNodes(Graph *g, NodeID src, NodeID dest, int r, Edge *e) {
 	EdgeID id;
 	Entity *en = DataBlock_AllocateItem(g->edges, &id);
 	en->prop_count = 0;
+	en->prop_cap = 0;
+	en->heat = 0;
 	en->properties = NULL;
 	e->id = id;
 	e->entity = en;
 	e->relationID = r;
 	e->srcNodeID = src;
 	e->destNodeID = dest;
-	Graph_FormConnection(g, src, dest, id, r);
+}
+
+int Graph_ConnectNodes(Graph *g, NodeID src, NodeID dest, int r, Edge *e) {
+	Graph_CreateEdge(g, src, dest, r, e);
+	Graph_FormConnection(g, src, dest, e->id, r);
 	return 1;
 }
 
+void Graph_ConnectNodesBatch(Graph *g, Edge **edges, uint edge_count) {
+	ASSERT(g && edges);
+	if(edge_count == 0) return;
+
+	int relation_count = Graph_RelationTypeCount(g);
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * edge_count);
+	GrB_Index *J = rm_malloc(sizeof(GrB_Index) * edge_count);
+	uint64_t *X = rm_malloc(sizeof(uint64_t) * edge_count);
+
+	/* Group edges by relation type, preserving their order
+	 * such that multi-edge arrays are built as if connected one by one. */
+	uint *offsets = rm_calloc(relation_count + 1, sizeof(uint));
+	for(uint i = 0; i < edge_count; i++) {
+		ASSERT(edges[i]->relationID < relation_count);
+		offsets[edges[i]->relationID + 1]++;
+	}
+	for(int r = 0; r < relation_count; r++) offsets[r + 1] += offsets[r];
+
+	uint *cursor = rm_malloc(sizeof(uint) * relation_count);
+	memcpy(cursor, offsets, sizeof(uint) * relation_count);
+	for(uint i = 0; i < edge_count; i++) {
+		Edge *e = edges[i];
+		uint k = cursor[e->relationID]++;
+		I[k] = e->srcNodeID;
+		J[k] = e->destNodeID;
+		X[k] = SET_MSB(e->id);
+	}
+	rm_free(cursor);
+
+	// Rows represent source nodes, columns represent destination nodes.
+	RG_Matrix adj = g->adjacency_matrix;
+	RG_Matrix tadj = g->_t_adjacency_matrix;
+	g->SynchronizeMatrix(g, adj);
+	g->SynchronizeMatrix(g, tadj);
+	_RG_Matrix_addBatch(adj, I, J, NULL, edge_count);
+	_RG_Matrix_addBatch(tadj, J, I, NULL, edge_count);
+
+	for(int r = 0; r < relation_count; r++) {
+		uint offset = offsets[r];
+		uint n = offsets[r + 1] - offset;
+		if(n == 0) continue;
+
+		RG_Matrix M = g->relations[r];
+		g->SynchronizeMatrix(g, M);
+		_RG_Matrix_addBatch(M, I + offset, J + offset, X + offset, n);
+
+		// Perform the same update to the J,I coordinates of the transposed matrix.
+		RG_Matrix TM = _Graph_ResidentTranspose(g, r);
+		if(TM) {
+			g->SynchronizeMatrix(g, TM);
+			_RG_Matrix_addBatch(TM, J + offset, I + offset, X + offset, n);
+		}
+	}
+
+	rm_free(I);
+	rm_free(J);
+	rm_free(X);
+	rm_free(offsets);
+}
+
+// Collects the edges of the node's row in M + DP - DM.
+static void _Graph_GetRowEdges(const Graph *g, RG_Matrix M, NodeID id, bool outgoing,
+		int edgeType, Edge **edges) {
+	NodeID neighbor;
+
+	/* Construct an iterator to traverse the node's row, rows of transposed
+	 * matrices hold incoming edges. */
+	RG_MatrixTupleIter *it = RG_MatrixTupleIter_new(M->grb_matrix, M->delta_plus,
+			M->delta_minus);
+	RG_MatrixTupleIter_iterate_row(it, id);
+	while(RG_MatrixTupleIter_next(it, NULL, &neighbor, NULL)) {
+		// Collect all edges connecting the node to its neighbor.
+		if(outgoing) Graph_GetEdgesConnectingNodes(g, id, neighbor, edgeType, edges);
+		else Graph_GetEdgesConnectingNodes(g, neighbor, id, edgeType, edges);
+	}
+	RG_MatrixTupleIter_free(it);
+}
+
 /* Retrieves all either incoming or outgoing edges
  * to/from given node N, depending on given direction. */
 void Graph_GetNodeEdges(const Graph *g, const Node *n, GRAPH_EDGE_DIR dir, int edgeType,
 						Edge **edges) {
 	ASSERT(g && n && edges);
-	GrB_Matrix M;
-	NodeID srcNodeID;
-	NodeID destNodeID;
-	GxB_MatrixTupleIter *tupleIter;
+	RG_Matrix M;
+	NodeID id = ENTITY_GET_ID(n);
 
 	if(edgeType == GRAPH_UNKNOWN_RELATION) return;
 
@@ -656,88 +1559,79 @@ void Graph_GetNodeEdges(const Graph *g, const Node *n, GRAPH_EDGE_DIR dir, int e
 	if(dir == GRAPH_EDGE_DIR_OUTGOING || dir == GRAPH_EDGE_DIR_BOTH) {
 		/* If a relationship type is specified, retrieve the appropriate relation matrix;
 		 * otherwise use the overall adjacency matrix. */
-		if(edgeType == GRAPH_NO_RELATION) M = Graph_GetAdjacencyMatrix(g);
-		else M = Graph_GetRelationMatrix(g, edgeType);
-
-		/* Construct an iterator to traverse the source node's row, which contains
-		 * all outgoing edges. */
-		GxB_MatrixTupleIter_new(&tupleIter, M);
-		srcNodeID = ENTITY_GET_ID(n);
-		GxB_MatrixTupleIter_iterate_row(tupleIter, srcNodeID);
-		while(true) {
-			bool depleted = false;
-			GxB_MatrixTupleIter_next(tupleIter, NULL, &destNodeID, &depleted);
-			if(depleted) break;
-			// Collect all edges connecting this source node to each of its destinations.
-			Graph_GetEdgesConnectingNodes(g, srcNodeID, destNodeID, edgeType, edges);
-		}
-		GxB_MatrixTupleIter_free(tupleIter);
+		M = _Graph_RelationMatrix(g, edgeType, false);
+		g->SynchronizeMatrix(g, M);
+		_Graph_GetRowEdges(g, M, id, true, edgeType, edges);
 	}
 
 	// Incoming.
 	if(dir == GRAPH_EDGE_DIR_INCOMING || dir == GRAPH_EDGE_DIR_BOTH) {
-		/* Retrieve the transposed adjacency matrix, regardless of whether or not
-		 * a relationship type is specified. */
-		M = Graph_GetTransposedAdjacencyMatrix(g);
-
-		/* Construct an iterator to traverse the node's row, which in the transposed
-		 * adjacency matrix contains all incoming edges. */
-		GxB_MatrixTupleIter_new(&tupleIter, M);
-		destNodeID = ENTITY_GET_ID(n);
-		GxB_MatrixTupleIter_iterate_row(tupleIter, destNodeID);
-
-		while(true) {
-			bool depleted = false;
-			GxB_MatrixTupleIter_next(tupleIter, NULL, &srcNodeID, &depleted);
-			if(depleted) break;
-			/* Collect all edges connecting this destination node to each of its sources.
-			 * This call will only collect edges of the appropriate relationship type,
-			 * if one is specified. */
-			Graph_GetEdgesConnectingNodes(g, srcNodeID, destNodeID, edgeType, edges);
-		}
+		/* If a relationship type is specified and its transposed relation matrix
+		 * is built, only the node's sources of that type are visited;
+		 * otherwise scan the transposed adjacency matrix.
+		 * Collected edges are of the appropriate relationship type, if one is specified. */
+		M = (edgeType != GRAPH_NO_RELATION) ? _Graph_ResidentTranspose(g, edgeType) : NULL;
+		if(M == NULL) M = g->_t_adjacency_matrix;
+		g->SynchronizeMatrix(g, M);
+		_Graph_GetRowEdges(g, M, id, false, edgeType, edges);
+	}
+}
 
-		// Clean up
-		GxB_MatrixTupleIter_free(tupleIter);
+// Removes edge ID from the edge array at entry [i,j] of M,
+// reverting back to a single edge ID if only one edge remains.
+static void _Graph_RemoveMultiEdge(RG_Matrix M, EdgeID *edges, EdgeID id, GrB_Index i,
+		GrB_Index j) {
+	int k = 0;
+	int edge_count = MultiEdge_Count(edges);
+
+	// Locate edge within edge array.
+	for(; k < edge_count; k++) if(edges[k] == id) break;
+	ASSERT(k < edge_count);
+
+	// Remove edge from edge array, migrating the last edge ID.
+	MultiEdge_Remove(edges, k);
+
+	/* Incase we're left with a single edge connecting src to dest
+	 * revert back from array to scalar. */
+	if(MultiEdge_Count(edges) == 1) {
+		EdgeID edge_id = edges[0];
+		MultiEdge_Free(edges);
+		_RG_Matrix_setElement(M, SET_MSB(edge_id), i, j);
 	}
 }
 
-/* Removes an edge from Graph and updates graph relevent matrices. */
-int Graph_DeleteEdge(Graph *g, Edge *e) {
+/* Removes an edge from graph relevent matrices,
+ * returns false if the edge doesn't exist. */
+static bool _Graph_RemoveEdge(Graph *g, Edge *e) {
 	uint64_t x;
-	GrB_Matrix R;
-	GrB_Matrix M;
 	GrB_Info info;
 	EdgeID edge_id;
-	GrB_Matrix TR = GrB_NULL;
 	int r = Edge_GetRelationID(e);
 	NodeID src_id = Edge_GetSrcNodeID(e);
 	NodeID dest_id = Edge_GetDestNodeID(e);
 
-	R = Graph_GetRelationMatrix(g, r);
-	bool maintain_transpose;
-	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
-	if(maintain_transpose) TR = Graph_GetTransposedRelationMatrix(g, r);
+	RG_Matrix R = g->relations[r];
+	RG_Matrix TR = _Graph_ResidentTranspose(g, r);
+	g->SynchronizeMatrix(g, R);
+	if(TR) g->SynchronizeMatrix(g, TR);
 
 	// Test to see if edge exists.
-	info = GrB_Matrix_extractElement(&edge_id, R, src_id, dest_id);
-	if(info != GrB_SUCCESS) return 0;
+	info = _RG_Matrix_extractElement(&edge_id, R, src_id, dest_id);
+	if(info != GrB_SUCCESS) return false;
 
 	if(SINGLE_EDGE(edge_id)) {
 		// Single edge of type R connecting src to dest, delete entry.
-		info = GxB_Matrix_Delete(R, src_id, dest_id);
-		ASSERT(info == GrB_SUCCESS);
-		if(TR) {
-			info = GxB_Matrix_Delete(TR, dest_id, src_id);
-			ASSERT(info == GrB_SUCCESS);
-		}
+		_RG_Matrix_removeElement(R, src_id, dest_id);
+		if(TR) _RG_Matrix_removeElement(TR, dest_id, src_id);
 
 		// See if source is connected to destination with additional edges.
 		bool connected = false;
 		int relationCount = Graph_RelationTypeCount(g);
 		for(int i = 0; i < relationCount; i++) {
 			if(i == r) continue;
-			M = Graph_GetRelationMatrix(g, i);
-			info = GrB_Matrix_extractElement(&x, M, src_id, dest_id);
+			RG_Matrix M = g->relations[i];
+			g->SynchronizeMatrix(g, M);
+			info = _RG_Matrix_extractElement(&x, M, src_id, dest_id);
 			if(info == GrB_SUCCESS) {
 				connected = true;
 				break;
@@ -747,67 +1641,44 @@ int Graph_DeleteEdge(Graph *g, Edge *e) {
 		/* There are no additional edges connecting source to destination
 		 * Remove edge from THE adjacency matrix. */
 		if(!connected) {
-			M = Graph_GetAdjacencyMatrix(g);
-			info = GxB_Matrix_Delete(M, src_id, dest_id);
-			ASSERT(info == GrB_SUCCESS);
-
-			M = Graph_GetTransposedAdjacencyMatrix(g);
-			info = GxB_Matrix_Delete(M, dest_id, src_id);
-			ASSERT(info == GrB_SUCCESS);
+			RG_Matrix adj = g->adjacency_matrix;
+			RG_Matrix tadj = g->_t_adjacency_matrix;
+			g->SynchronizeMatrix(g, adj);
+			g->SynchronizeMatrix(g, tadj);
+			_RG_Matrix_removeElement(adj, src_id, dest_id);
+			_RG_Matrix_removeElement(tadj, dest_id, src_id);
 		}
 	} else {
 		/* Multiple edges connecting src to dest
-		 * locate specific edge and remove it
-		 * revert back from array representation to edge ID
-		 * incase we're left with a single edge connecting src to dest. */
-
-		int i = 0;
+		 * locate specific edge and remove it. */
 		EdgeID id = ENTITY_GET_ID(e);
-		EdgeID *edges = (EdgeID *)edge_id;
-		int edge_count = array_len(edges);
-
-		// Locate edge within edge array.
-		for(; i < edge_count; i++) if(edges[i] == id) break;
-		ASSERT(i < edge_count);
-
-		/* Remove edge from edge array
-		 * migrate last edge ID and reduce array size.
-		 * TODO: reallocate array of size / capacity ratio is high. */
-		edges[i] = edges[edge_count - 1];
-		array_pop(edges);
-
-		/* Incase we're left with a single edge connecting src to dest
-		 * revert back from array to scalar. */
-		if(array_len(edges) == 1) {
-			edge_id = edges[0];
-			array_free(edges);
-			GrB_Matrix_setElement(R, SET_MSB(edge_id), src_id, dest_id);
-		}
+		_Graph_RemoveMultiEdge(R, (EdgeID *)edge_id, id, src_id, dest_id);
 
 		if(TR) {
 			/* We must make the matching updates to the transposed matrix.
 			 * First, extract the element that is known to be an edge array. */
-			info = GrB_Matrix_extractElement(edges, TR, dest_id, src_id);
+			info = _RG_Matrix_extractElement(&edge_id, TR, dest_id, src_id);
 			ASSERT(info == GrB_SUCCESS);
-			// Replace the deleted edge with the last edge in the matrix.
-			edges[i] = edges[edge_count - 1];
-			array_pop(edges);
-			// Free and replace the array if it now has 1 element.
-			if(array_len(edges) == 1) {
-				edge_id = edges[0];
-				array_free(edges);
-				GrB_Matrix_setElement(TR, SET_MSB(edge_id), dest_id, src_id);
-			}
+			_Graph_RemoveMultiEdge(TR, (EdgeID *)edge_id, id, dest_id, src_id);
 		}
 	}
 
+	return true;
+}
+
+/* Removes an edge from Graph and updates graph relevent matrices. */
+int Graph_DeleteEdge(Graph *g, Edge *e) {
+	if(!_Graph_RemoveEdge(g, e)) return 0;
+
 	// Free and remove edges from datablock.
 	DataBlock_DeleteItem(g->edges, ENTITY_GET_ID(e));
 	return 1;
 }
 
-inline bool Graph_EntityIsDeleted(Entity *e) {
-	return DataBlock_ItemIsDeleted(e);
+bool Graph_EntityIsDeleted(const Graph *g, GraphEntityType t, EntityID id) {
+	ASSERT(t == GETYPE_NODE || t == GETYPE_EDGE);
+	DataBlock *entities = (t == GETYPE_NODE) ? g->nodes : g->edges;
+	return DataBlock_ItemIsDeleted(entities, id);
 }
 
 void Graph_DeleteNode(Graph *g, Node *n) {
@@ -817,10 +1688,13 @@ void Graph_DeleteNode(Graph *g, Node *n) {
 	ASSERT(g && n);
 
 	// Clear label matrix at position node ID.
-	uint32_t label_count = array_len(g->labels);
-	for(int i = 0; i < label_count; i++) {
-		GrB_Matrix M = Graph_GetLabelMatrix(g, i);
-		GxB_Matrix_Delete(M, ENTITY_GET_ID(n), ENTITY_GET_ID(n));
+	NodeID id = ENTITY_GET_ID(n);
+	int label = Graph_GetNodeLabel(g, id);
+	if(label != GRAPH_NO_LABEL) {
+		RG_Matrix M = g->labels[label];
+		g->SynchronizeMatrix(g, M);
+		_RG_Matrix_removeElement(M, id, id);
+		_Graph_ClearNodeLabel(g, id, label);
 	}
 
 	DataBlock_DeleteItem(g->nodes, ENTITY_GET_ID(n));
@@ -844,14 +1718,14 @@ static void _Graph_FreeRelationMatrices(Graph *g) {
 	GxB_Scalar_new(&thunk, GrB_UINT64);
 	GxB_Scalar_setElement_UINT64(thunk, (uint64_t)g);
 
-	bool maintain_transpose;
-	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
 	uint relationCount = Graph_RelationTypeCount(g);
 	/* use the edge deletion binary operation to free all edge arrays within
 	 * the adjacency matrix */
 
 	for(uint i = 0; i < relationCount; i++) {
 		RG_Matrix  M = g->relations[i];
+		// deleted entries are no longer referenced, added ones are
+		_RG_Matrix_Merge(M);
 		GrB_Matrix C = M->grb_matrix;
 
 		GxB_Matrix_apply_BinaryOp1st(C, GrB_NULL, GrB_NULL,
@@ -861,8 +1735,9 @@ static void _Graph_FreeRelationMatrices(Graph *g) {
 		RG_Matrix_Free(M);
 
 		// perform the same update to transposed matrices
-		if(maintain_transpose) {
-			RG_Matrix TM = g->t_relations[i];
+		RG_Matrix TM = _Graph_ResidentTranspose(g, i);
+		if(TM) {
+			_RG_Matrix_Merge(TM);
 			C = TM->grb_matrix;
 
 			GxB_Matrix_apply_BinaryOp1st(C, GrB_NULL, GrB_NULL,
@@ -875,318 +1750,174 @@ static void _Graph_FreeRelationMatrices(Graph *g) {
 	GrB_free(&thunk);
 }
 
+// Appends the edge IDs of entry 'x' to 'ids'.
+static EdgeID *_Graph_CollectEdgeIDs(uint64_t x, EdgeID *ids) {
+	if(SINGLE_EDGE(x)) return array_append(ids, SINGLE_EDGE_ID(x));
+
+	EdgeID *multi_edges = (EdgeID *)x;
+	uint count = MultiEdge_Count(multi_edges);
+	for(uint j = 0; j < count; j++) ids = array_append(ids, multi_edges[j]);
+	return ids;
+}
+
+// Entry [i,j] holding 'x' is about to be removed from relation matrix M.
+// A removed entry of the underlying matrix lingers until the next merge,
+// it is reset to a single edge ID such that it never references an edge array.
+static void _Graph_ResetRemovedEntry(RG_Matrix M, uint64_t x, GrB_Index i, GrB_Index j) {
+	uint64_t v;
+	if(SINGLE_EDGE(x)) return;
+	if(GrB_Matrix_extractElement_UINT64(&v, M->grb_matrix, i, j) != GrB_SUCCESS) return;
+	GrB_Matrix_setElement_UINT64(M->grb_matrix, SET_MSB(((EdgeID *)x)[0]), i, j);
+}
+
+// Removes entry [i,j] holding 'x' from relation matrix M, freeing its edge array.
+static void _Graph_RemoveRelationEntry(RG_Matrix M, uint64_t x, GrB_Index i, GrB_Index j) {
+	_Graph_ResetRemovedEntry(M, x, i, j);
+	if(!(SINGLE_EDGE(x))) MultiEdge_Free((EdgeID *)x);
+	_RG_Matrix_removeElement(M, i, j);
+}
+
+// Returns true if 'id' is in the sorted array 'ids'.
+static bool _Graph_SortedContains(const GrB_Index *ids, uint n, GrB_Index id) {
+	uint lo = 0;
+	uint hi = n;
+	while(lo < hi) {
+		uint mid = (lo + hi) / 2;
+		if(ids[mid] == id) return true;
+		if(ids[mid] < id) lo = mid + 1;
+		else hi = mid;
+	}
+	return false;
+}
+
 static void _BulkDeleteNodes(Graph *g, Node *nodes, uint node_count,
 							 uint *node_deleted, uint *edge_deleted) {
 	ASSERT(g && g->_writelocked && nodes && node_count > 0);
 
-	if(!_binary_op_delete_edges) {
-		// The binary operator has not yet been constructed; build it now.
-		GrB_Info res;
-		UNUSED(res);
-		res = GrB_BinaryOp_new(&_binary_op_delete_edges, _binary_op_free_edge,
-				GrB_UINT64, GrB_UINT64, GrB_UINT64);
-		ASSERT(res == GrB_SUCCESS);
-	}
-
-	/* Create a matrix M where M[j,i] = 1 if:
-	 * Node i is connected to node j. */
-
-	GrB_Matrix          A;          // a = R(M) masked relation matrix
-	GrB_Matrix          adj;        // adjacency matrix
-	GrB_Matrix          tadj;       // transposed adjacency matrix
-	GrB_Index           nrows;
-	GrB_Index           ncols;
-	GrB_Index           nvals;      // number of elements in mask
-	GrB_Matrix          Mask;       // mask noteing all implicitly deleted edges
-	GrB_Matrix          Nodes;      // mask noteing each node marked for deletion
-	GrB_Descriptor      desc;       // GraphBLAS descriptor
-	GxB_MatrixTupleIter *adj_iter;  // iterator over the adjacency matrix
-	GxB_MatrixTupleIter *tadj_iter; // iterator over the transposed adjacency matrix
-
-	nrows = Graph_RequiredMatrixDim(g);
-	ncols = nrows;
-	GrB_Descriptor_new(&desc);
-	adj = Graph_GetAdjacencyMatrix(g);
-	tadj = Graph_GetTransposedAdjacencyMatrix(g);
-	GxB_MatrixTupleIter_new(&adj_iter, adj);
-	GxB_MatrixTupleIter_new(&tadj_iter, tadj);
-	GrB_Matrix_new(&A, GrB_UINT64, nrows, ncols);
-	GrB_Matrix_new(&Mask, GrB_BOOL, nrows, ncols);
-	GrB_Matrix_new(&Nodes, GrB_BOOL, nrows, ncols);
-
-	/* For user-defined select operators,
-	 * If Thunk is not NULL, it must be a valid GxB_Scalar. If it has no entry,
-	 * it is treated as if it had a single entry equal to zero, for built-in types (not
-	 * user-defined types).
-	 * For user-defined select operators, the entry is passed to the user-defined
-	 * select operator, with no typecasting. Its type must be identical to 'ttype' of
-	 * the select operator. */
-	GxB_Scalar thunk;
-	GxB_Scalar_new(&thunk, GrB_UINT64);
-	GxB_Scalar_setElement_UINT64(thunk, (uint64_t)g);
+	/* Implicitly deleted edges are located through the rows of the deleted
+	 * nodes within the adjacency matrices, entries are removed through the
+	 * delta matrices, the underlying matrices are left for the background merge. */
 
-	// Populate mask with implicit edges, take note of deleted nodes.
+	int nthreads;   // number of threads freeing entities
+	uint64_t x;
+	GrB_Index neighbor;
+	Config_Option_get(Config_OPENMP_NTHREAD, &nthreads);
+
+	RG_Matrix adj = g->adjacency_matrix;
+	RG_Matrix tadj = g->_t_adjacency_matrix;
+	g->SynchronizeMatrix(g, adj);
+	g->SynchronizeMatrix(g, tadj);
+
+	// sort the nodes marked for deletion, dropping duplicates
+	GrB_Index *node_ids = rm_malloc(sizeof(GrB_Index) * node_count);
+	for(uint i = 0; i < node_count; i++) node_ids[i] = ENTITY_GET_ID(nodes + i);
+#define is_id_lt(a, b) (*(a) < *(b))
+	QSORT(GrB_Index, node_ids, node_count, is_id_lt);
+	uint unique_count = 0;
 	for(uint i = 0; i < node_count; i++) {
-		GrB_Index src;
-		GrB_Index dest;
-		Node *n = nodes + i;
-		bool depleted = false;
-		NodeID ID = ENTITY_GET_ID(n);
-
-		// outgoing edges
-		GxB_MatrixTupleIter_iterate_row(adj_iter, ID);
-		while(true) {
-			GxB_MatrixTupleIter_next(adj_iter, NULL,  &dest, &depleted);
-			if(depleted) break;
-			GrB_Matrix_setElement_BOOL(Mask, true, ID, dest);
-		}
-
-		depleted = false;
+		if(unique_count > 0 && node_ids[unique_count - 1] == node_ids[i]) continue;
+		node_ids[unique_count++] = node_ids[i];
+	}
 
-		// incoming edges
-		GxB_MatrixTupleIter_iterate_row(tadj_iter, ID);
-		while(true) {
-			GxB_MatrixTupleIter_next(tadj_iter, NULL, &src, &depleted);
-			if(depleted) break;
-			GrB_Matrix_setElement_BOOL(Mask, true, src, ID);
+	/* collect implicit edges
+	 * outgoing edges of deleted nodes, followed by incoming edges
+	 * whose source isn't deleted, each pair is collected once */
+	GrB_Index *srcs = array_new(GrB_Index, unique_count);
+	GrB_Index *dests = array_new(GrB_Index, unique_count);
+	RG_MatrixTupleIter *out = RG_MatrixTupleIter_new(adj->grb_matrix, adj->delta_plus,
+			adj->delta_minus);
+	RG_MatrixTupleIter *in = RG_MatrixTupleIter_new(tadj->grb_matrix, tadj->delta_plus,
+			tadj->delta_minus);
+	for(uint i = 0; i < unique_count; i++) {
+		NodeID id = node_ids[i];
+		RG_MatrixTupleIter_iterate_row(out, id);
+		while(RG_MatrixTupleIter_next(out, NULL, &neighbor, NULL)) {
+			srcs = array_append(srcs, id);
+			dests = array_append(dests, neighbor);
+		}
+		RG_MatrixTupleIter_iterate_row(in, id);
+		while(RG_MatrixTupleIter_next(in, NULL, &neighbor, NULL)) {
+			if(_Graph_SortedContains(node_ids, unique_count, neighbor)) continue;
+			srcs = array_append(srcs, neighbor);
+			dests = array_append(dests, id);
 		}
-
-		// node to remove
-		GrB_Matrix_setElement_BOOL(Nodes, true, ID, ID);
 	}
+	RG_MatrixTupleIter_free(out);
+	RG_MatrixTupleIter_free(in);
 
-	// update deleted node count
-	GrB_Matrix_nvals(&nvals, Nodes);
-	*node_deleted += nvals;
-
-	// update deleted edge count
-	GrB_Matrix_nvals(&nvals, Mask);
-	*edge_deleted += nvals;
+	// update deleted node and edge counts
+	uint pair_count = array_len(srcs);
+	*node_deleted += unique_count;
+	*edge_deleted += pair_count;
 
-	// clear updated output matrix before assignment
-	GrB_Descriptor_set(desc, GrB_OUTP, GrB_REPLACE);
-
-	// free and remove implicit edges from relation matrices
+	// remove implicit edges from relation matrices, collecting their IDs
+	EdgeID *edge_ids = array_new(EdgeID, pair_count);
 	int relation_count = Graph_RelationTypeCount(g);
-	for(int i = 0; i < relation_count; i++) {
-		GrB_Matrix R = Graph_GetRelationMatrix(g, i);
-
-		// reset mask descriptor
-		GrB_Descriptor_set(desc, GrB_MASK, GxB_DEFAULT);
-
-		/* isolate implicit edges
-		 * A will contain all implicitly deleted edges from R */
-		GrB_Matrix_apply(A, Mask, GrB_NULL, GrB_IDENTITY_UINT64, R, desc);
-
-		// free each multi edge array entry in A
-		GxB_Matrix_apply_BinaryOp1st(A, GrB_NULL, GrB_NULL,
-				_binary_op_delete_edges, thunk, A, GrB_NULL);
-
-		// clear the relation matrix
-		GrB_Descriptor_set(desc, GrB_MASK, GrB_COMP);
-		GrB_Descriptor_set(desc, GrB_MASK, GrB_STRUCTURE);
-
-		// remove every entry of R marked by Mask
-		GrB_Matrix_apply(R, Mask, GrB_NULL, GrB_IDENTITY_UINT64, R, desc);
+	for(int r = 0; r < relation_count; r++) {
+		RG_Matrix R = g->relations[r];
+		// transposed matrices which aren't built are left alone
+		RG_Matrix TR = _Graph_ResidentTranspose(g, r);
+		g->SynchronizeMatrix(g, R);
+		if(TR) g->SynchronizeMatrix(g, TR);
+
+		for(uint i = 0; i < pair_count; i++) {
+			if(_RG_Matrix_extractElement(&x, R, srcs[i], dests[i]) != GrB_SUCCESS) continue;
+			edge_ids = _Graph_CollectEdgeIDs(x, edge_ids);
+			_Graph_RemoveRelationEntry(R, x, srcs[i], dests[i]);
+
+			// transposed matrices own copies of the edge arrays
+			if(TR && _RG_Matrix_extractElement(&x, TR, dests[i], srcs[i]) == GrB_SUCCESS) {
+				_Graph_RemoveRelationEntry(TR, x, dests[i], srcs[i]);
+			}
+		}
 	}
 
-	// reset mask descriptor
-	GrB_Descriptor_set(desc, GrB_MASK, GrB_COMP);
-	GrB_Descriptor_set(desc, GrB_MASK, GrB_STRUCTURE);
-
-	// update the adjacency matrix to remove deleted entries
-	GrB_Matrix_apply(adj, Mask, GrB_NULL, GrB_IDENTITY_BOOL, adj, desc);
-
-	// transpose the mask so that it will match the transposed adjacency matrix
-	GrB_transpose(Mask, GrB_NULL, GrB_NULL, Mask, GrB_NULL);
-
-	// update the transposed adjacency matrix
-	GrB_Matrix_apply(tadj, Mask, GrB_NULL, GrB_IDENTITY_BOOL, tadj, desc);
-
-	/* if we have individual transposed matrices, repeat all the above steps
-	 * with the transposed Mask */
-	bool maintain_transpose;
-	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
-	if(maintain_transpose) {
-		for(int i = 0; i < relation_count; i++) {
-			GrB_Matrix TR = Graph_GetTransposedRelationMatrix(g, i);
-
-			// reset mask descriptor
-			GrB_Descriptor_set(desc, GrB_MASK, GxB_DEFAULT);
-
-			/* isolate implicit edges
-			 * A will contain all implicitly deleted edges from TR */
-			GrB_Matrix_apply(A, Mask, GrB_NULL, GrB_IDENTITY_UINT64, TR, desc);
-
-			// free each multi edge array entry in A
-			GxB_Matrix_apply_BinaryOp1st(A, GrB_NULL, GrB_NULL,
-					_binary_op_delete_edges, thunk, A, GrB_NULL);
-
-			// clear the relation matrix
-			GrB_Descriptor_set(desc, GrB_MASK, GrB_COMP);
-			GrB_Descriptor_set(desc, GrB_MASK, GrB_STRUCTURE);
-
-			// remove every entry of TR marked by Mask
-			GrB_Matrix_apply(TR, Mask, GrB_NULL, GrB_IDENTITY_UINT64, TR, desc);
-		}
+	// remove implicit edges from the adjacency matrices
+	for(uint i = 0; i < pair_count; i++) {
+		_RG_Matrix_removeElement(adj, srcs[i], dests[i]);
+		_RG_Matrix_removeElement(tadj, dests[i], srcs[i]);
 	}
 
 	/* delete nodes
-	 * all nodes marked for deleteion are detected, no incoming / outgoing edges. */
-	int node_type_count = Graph_LabelTypeCount(g);
-	for(int i = 0; i < node_type_count; i++) {
-		GrB_Matrix L = Graph_GetLabelMatrix(g, i);
-		GrB_Matrix_apply(L, Nodes, GrB_NULL, GrB_IDENTITY_BOOL, L, desc);
+	 * all nodes marked for deleteion are detached, no incoming / outgoing edges. */
+	for(uint i = 0; i < unique_count; i++) {
+		NodeID id = node_ids[i];
+		int label = Graph_GetNodeLabel(g, id);
+		if(label == GRAPH_NO_LABEL) continue;
+		RG_Matrix L = g->labels[label];
+		g->SynchronizeMatrix(g, L);
+		_RG_Matrix_removeElement(L, id, id);
+		_Graph_ClearNodeLabel(g, id, label);
 	}
 
-	// TODO: use the apply operator to delete datablock entries
-	for(uint i = 0; i < node_count; i++) {
-		Node *n = nodes + i;
-		DataBlock_DeleteItem(g->nodes, ENTITY_GET_ID(n));
-	}
+	// free edges and nodes, blocks are released in parallel
+	DataBlock_DeleteItems(g->edges, edge_ids, array_len(edge_ids), nthreads);
+	DataBlock_DeleteItems(g->nodes, node_ids, unique_count, nthreads);
 
 	// Clean up.
-	GrB_free(&A);
-	GrB_free(&desc);
-	GrB_free(&Mask);
-	GrB_free(&thunk);
-	GrB_free(&Nodes);
-	GxB_MatrixTupleIter_free(adj_iter);
-	GxB_MatrixTupleIter_free(tadj_iter);
+	array_free(srcs);
+	array_free(dests);
+	array_free(edge_ids);
+	rm_free(node_ids);
 }
 
 static void _BulkDeleteEdges(Graph *g, Edge *edges, size_t edge_count) {
 	ASSERT(g && g->_writelocked && edges && edge_count > 0);
 
-	int relationCount = Graph_RelationTypeCount(g);
-	GrB_Matrix masks[relationCount];
-	for(int i = 0; i < relationCount; i++) masks[i] = NULL;
-	bool update_adj_matrices = false;
-
-	bool maintain_transpose;
-	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
+	int nthreads;
+	Config_Option_get(Config_OPENMP_NTHREAD, &nthreads);
 
-	for(int i = 0; i < edge_count; i++) {
+	// Edges are removed through the delta matrices one by one,
+	// the underlying matrices are left for the background merge.
+	EdgeID *edge_ids = array_new(EdgeID, edge_count);
+	for(size_t i = 0; i < edge_count; i++) {
 		Edge *e = edges + i;
-		int r = Edge_GetRelationID(e);
-		NodeID src_id = Edge_GetSrcNodeID(e);
-		NodeID dest_id = Edge_GetDestNodeID(e);
-		EdgeID edge_id;
-		GrB_Matrix R = Graph_GetRelationMatrix(g, r);  // Relation matrix.
-		GrB_Matrix TR = maintain_transpose ? Graph_GetTransposedRelationMatrix(g, r) : NULL;
-		GrB_Matrix_extractElement(&edge_id, R, src_id, dest_id);
-
-		if(SINGLE_EDGE(edge_id)) {
-			update_adj_matrices = true;
-			GrB_Matrix mask = masks[r];    // mask noteing all deleted edges.
-			// Get mask of this relation type.
-			if(mask == NULL) {
-				GrB_Matrix_new(&mask, GrB_BOOL, Graph_RequiredMatrixDim(g), Graph_RequiredMatrixDim(g));
-				masks[r] = mask;
-			}
-			// Update mask.
-			GrB_Matrix_setElement_BOOL(mask, true, src_id, dest_id);
-		} else {
-			/* Multiple edges connecting src to dest
-			 * locate specific edge and remove it
-			 * revert back from array representation to edge ID
-			 * incase we're left with a single edge connecting src to dest. */
-
-			int i = 0;
-			EdgeID id = ENTITY_GET_ID(e);
-			EdgeID *multi_edges = (EdgeID *)edge_id;
-			int multi_edge_count = array_len(multi_edges);
-
-			// Locate edge within edge array.
-			for(; i < multi_edge_count; i++) if(multi_edges[i] == id) break;
-			ASSERT(i < multi_edge_count);
-
-			/* Remove edge from edge array
-			 * migrate last edge ID and reduce array size.
-			 * TODO: reallocate array of size / capacity ratio is high. */
-			multi_edges[i] = multi_edges[multi_edge_count - 1];
-			array_pop(multi_edges);
-
-			/* Incase we're left with a single edge connecting src to dest
-			 * revert back from array to scalar. */
-			if(array_len(multi_edges) == 1) {
-				edge_id = multi_edges[0];
-				array_free(multi_edges);
-				GrB_Matrix_setElement(R, SET_MSB(edge_id), src_id, dest_id);
-			}
-
-			if(TR) {
-				/* We must make the matching updates to the transposed matrix.
-				 * First, extract the element that is known to be an edge array. */
-				GrB_Matrix_extractElement(&edge_id, TR, dest_id, src_id);
-				multi_edges = (EdgeID *)edge_id;
-				int multi_edge_count = array_len(multi_edges);
-				multi_edges[i] = multi_edges[multi_edge_count - 1];
-				array_pop(multi_edges);
-				// Free and replace the array if it now has 1 element.
-				if(array_len(multi_edges) == 1) {
-					edge_id = multi_edges[0];
-					array_free(multi_edges);
-					GrB_Matrix_setElement(TR, SET_MSB(edge_id), dest_id, src_id);
-				}
-			}
-		}
-
-		// Free and remove edges from datablock.
-		DataBlock_DeleteItem(g->edges, ENTITY_GET_ID(e));
-	}
-
-	if(update_adj_matrices) {
-		GrB_Matrix remaining_mask;
-		GrB_Matrix_new(&remaining_mask, GrB_BOOL, Graph_RequiredMatrixDim(g), Graph_RequiredMatrixDim(g));
-		GrB_Descriptor desc;    // GraphBLAS descriptor.
-		GrB_Descriptor_new(&desc);
-		// Descriptor sets to clear entry according to mask.
-		GrB_Descriptor_set(desc, GrB_MASK, GrB_COMP);
-
-		// Clear updated output matrix before assignment.
-		GrB_Descriptor_set(desc, GrB_OUTP, GrB_REPLACE);
-
-		bool maintain_transpose;
-		Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
-		for(int r = 0; r < relationCount; r++) {
-			GrB_Matrix mask = masks[r];
-			GrB_Matrix R = Graph_GetRelationMatrix(g, r);  // Relation matrix.
-			if(mask) {
-				// Remove every entry of R marked by Mask.
-				// Desc: GrB_MASK = GrB_COMP,  GrB_OUTP = GrB_REPLACE.
-				// R = R & !mask.
-				GrB_Matrix_apply(R, mask, GrB_NULL, GrB_IDENTITY_UINT64, R, desc);
-				if(maintain_transpose) {
-					GrB_Matrix tM = Graph_GetTransposedRelationMatrix(g, r);  // Transposed relation mapping matrix.
-					// Transpose mask (this cannot be done by descriptor).
-					GrB_transpose(mask, GrB_NULL, GrB_NULL, mask, GrB_NULL);
-					// tM = tM & !mask.
-					GrB_Matrix_apply(tM, mask, GrB_NULL, GrB_IDENTITY_UINT64, tM, desc);
-				}
-				GrB_free(&mask);
-			}
-
-			// Collect remaining edges. remaining_mask = remaining_mask + R.
-			GrB_eWiseAdd(remaining_mask, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, remaining_mask,
-										 R, GrB_NULL);
-		}
-
-		GrB_Matrix adj_matrix = Graph_GetAdjacencyMatrix(g);
-		GrB_Matrix t_adj_matrix = Graph_GetTransposedAdjacencyMatrix(g);
-		// To calculate edges to delete, remove all the remaining edges from "The" adjency matrix.
-		// Set descriptor mask to default.
-		GrB_Descriptor_set(desc, GrB_MASK, GxB_DEFAULT);
-		// adj_matrix = adj_matrix & remaining_mask.
-		GrB_Matrix_apply(adj_matrix, remaining_mask, GrB_NULL, GrB_IDENTITY_BOOL, adj_matrix, desc);
-		// Transpose remaining_mask.
-		GrB_transpose(remaining_mask, GrB_NULL,  GrB_NULL, remaining_mask, GrB_NULL);
-		// t_adj_matrix = t_adj_matrix & remaining_mask.
-		GrB_Matrix_apply(t_adj_matrix, remaining_mask, GrB_NULL, GrB_IDENTITY_BOOL, t_adj_matrix, desc);
-
-		GrB_free(&remaining_mask);
-		GrB_free(&desc);
+		if(_Graph_RemoveEdge(g, e)) edge_ids = array_append(edge_ids, ENTITY_GET_ID(e));
 	}
+
+	// Free and remove edges from datablock, blocks are released in parallel.
+	DataBlock_DeleteItems(g->edges, edge_ids, array_len(edge_ids), nthreads);
+	array_free(edge_ids);
 }
 
 /* Removes both nodes and edges from graph. */
@@ -1243,6 +1974,197 @@ void Graph_BulkDelete(Graph *g, Node *nodes, uint node_count, Edge *edges, uint
 	*edge_deleted += edge_count;
 }
 
+//------------------------------------------------------------------------------
+// Compaction
+//------------------------------------------------------------------------------
+
+// Entity IDs relocated by a compaction slice, 'from' is in descending order.
+typedef struct {
+	const EntityID *from;
+	const EntityID *to;
+	uint64_t n;
+} _Relocation;
+
+static GrB_BinaryOp _binary_op_relocate_edges = NULL;
+
+// Returns the new ID of entity 'id'.
+static inline EntityID _Graph_RelocatedID(const _Relocation *r, EntityID id) {
+	// Entities are relocated from the highest IDs.
+	if(id < r->from[r->n - 1]) return id;
+
+	uint64_t lo = 0;
+	uint64_t hi = r->n;
+	while(lo < hi) {
+		uint64_t mid = (lo + hi) / 2;
+		if(r->from[mid] == id) return r->to[mid];
+		if(r->from[mid] > id) lo = mid + 1;
+		else hi = mid;
+	}
+	return id;
+}
+
+void _binary_op_relocate_edge(void *z, const void *x, const void *y) {
+	const _Relocation *r = (const _Relocation *) *((uint64_t *)x);
+	EdgeID id = *(const EdgeID *)y;
+
+	if(SINGLE_EDGE(id)) {
+		*(EdgeID *)z = SET_MSB(_Graph_RelocatedID(r, SINGLE_EDGE_ID(id)));
+		return;
+	}
+
+	// Edge arrays are owned by their matrix, rewrite them in place.
+	EdgeID *ids = (EdgeID *)id;
+	uint count = MultiEdge_Count(ids);
+	for(uint i = 0; i < count; i++) ids[i] = _Graph_RelocatedID(r, ids[i]);
+	*(EdgeID *)z = id;
+}
+
+// Moves entry [i,j] holding 'x' of relation matrix M to the free entry [ni,nj],
+// an edge array moves along with its entry.
+static void _Graph_MoveRelationEntry(RG_Matrix M, uint64_t x, GrB_Index i, GrB_Index j,
+		GrB_Index ni, GrB_Index nj) {
+	_Graph_ResetRemovedEntry(M, x, i, j);
+	_RG_Matrix_removeElement(M, i, j);
+	_RG_Matrix_setElement(M, x, ni, nj);
+}
+
+// Moves entry [i,j] of boolean matrix M to the free entry [ni,nj].
+static inline void _Graph_MoveEntry(RG_Matrix M, GrB_Index i, GrB_Index j, GrB_Index ni,
+		GrB_Index nj) {
+	_RG_Matrix_removeElement(M, i, j);
+	_RG_Matrix_setElement(M, true, ni, nj);
+}
+
+uint64_t Graph_CompactNodes(Graph *g, uint64_t limit, NodeID *from, NodeID *to) {
+	ASSERT(g && g->_writelocked && from && to);
+	// Graphs being loaded or bulk inserted are left alone.
+	if(g->SynchronizeMatrix != _MatrixSynchronize) return 0;
+
+	// Matrices are sized before the node DataBlock shrinks.
+	RG_Matrix *matrices = _Graph_Matrices(g);
+	uint matrix_count = array_len(matrices);
+	for(uint i = 0; i < matrix_count; i++) g->SynchronizeMatrix(g, matrices[i]);
+	array_free(matrices);
+
+	uint64_t moved = DataBlock_Compact(g->nodes, limit, from, to);
+	if(moved == 0) return 0;
+
+	/* Only the rows and columns of relocated nodes are moved,
+	 * their entries are located through the adjacency matrices and moved
+	 * through the delta matrices, free IDs hold no entries. */
+	_Relocation reloc = {.from = from, .to = to, .n = moved};
+	RG_Matrix adj = g->adjacency_matrix;
+	RG_Matrix tadj = g->_t_adjacency_matrix;
+
+	// Collect connected pairs, each pair is collected once.
+	GrB_Index neighbor;
+	GrB_Index *srcs = array_new(GrB_Index, moved);
+	GrB_Index *dests = array_new(GrB_Index, moved);
+	RG_MatrixTupleIter *out = RG_MatrixTupleIter_new(adj->grb_matrix, adj->delta_plus,
+			adj->delta_minus);
+	RG_MatrixTupleIter *in = RG_MatrixTupleIter_new(tadj->grb_matrix, tadj->delta_plus,
+			tadj->delta_minus);
+	for(uint64_t i = 0; i < moved; i++) {
+		NodeID id = from[i];
+		RG_MatrixTupleIter_iterate_row(out, id);
+		while(RG_MatrixTupleIter_next(out, NULL, &neighbor, NULL)) {
+			srcs = array_append(srcs, id);
+			dests = array_append(dests, neighbor);
+		}
+		// Incoming edges of relocated sources are their outgoing edges.
+		RG_MatrixTupleIter_iterate_row(in, id);
+		while(RG_MatrixTupleIter_next(in, NULL, &neighbor, NULL)) {
+			if(_Graph_RelocatedID(&reloc, neighbor) != neighbor) continue;
+			srcs = array_append(srcs, neighbor);
+			dests = array_append(dests, id);
+		}
+	}
+	RG_MatrixTupleIter_free(out);
+	RG_MatrixTupleIter_free(in);
+
+	uint64_t x;
+	uint pair_count = array_len(srcs);
+	uint relation_count = Graph_RelationTypeCount(g);
+	for(uint i = 0; i < pair_count; i++) {
+		GrB_Index src = srcs[i];
+		GrB_Index dest = dests[i];
+		GrB_Index new_src = _Graph_RelocatedID(&reloc, src);
+		GrB_Index new_dest = _Graph_RelocatedID(&reloc, dest);
+
+		for(uint r = 0; r < relation_count; r++) {
+			RG_Matrix R = g->relations[r];
+			if(_RG_Matrix_extractElement(&x, R, src, dest) == GrB_SUCCESS) {
+				_Graph_MoveRelationEntry(R, x, src, dest, new_src, new_dest);
+			}
+			// Transposed matrices which aren't built are left alone.
+			RG_Matrix TR = _Graph_ResidentTranspose(g, r);
+			if(TR && _RG_Matrix_extractElement(&x, TR, dest, src) == GrB_SUCCESS) {
+				_Graph_MoveRelationEntry(TR, x, dest, src, new_dest, new_src);
+			}
+		}
+
+		_Graph_MoveEntry(adj, src, dest, new_src, new_dest);
+		_Graph_MoveEntry(tadj, dest, src, new_dest, new_src);
+	}
+
+	for(uint64_t i = 0; i < moved; i++) {
+		int label = Graph_GetNodeLabel(g, from[i]);
+		if(label == GRAPH_NO_LABEL) continue;
+		_Graph_MoveEntry(g->labels[label], from[i], from[i], to[i], to[i]);
+		_Graph_ClearNodeLabel(g, from[i], label);
+		Graph_MarkNodeLabel(g, to[i], label);
+	}
+
+	array_free(srcs);
+	array_free(dests);
+	return moved;
+}
+
+// Rewrites the edge IDs held by M and DP, see _binary_op_relocate_edge.
+static void _RG_Matrix_RelocateEdges(RG_Matrix M, GxB_Scalar thunk) {
+	GxB_Matrix_apply_BinaryOp1st(M->grb_matrix, GrB_NULL, GrB_NULL, _binary_op_relocate_edges,
+			thunk, M->grb_matrix, GrB_NULL);
+	GxB_Matrix_apply_BinaryOp1st(M->delta_plus, GrB_NULL, GrB_NULL, _binary_op_relocate_edges,
+			thunk, M->delta_plus, GrB_NULL);
+	M->version++;
+	M->dirty = true;
+}
+
+uint64_t Graph_CompactEdges(Graph *g, uint64_t limit, EdgeID *from, EdgeID *to) {
+	ASSERT(g && g->_writelocked && from && to);
+	// Graphs being loaded or bulk inserted are left alone.
+	if(g->SynchronizeMatrix != _MatrixSynchronize) return 0;
+
+	uint64_t moved = DataBlock_Compact(g->edges, limit, from, to);
+	if(moved == 0) return 0;
+
+	if(!_binary_op_relocate_edges) {
+		// The binary operator has not yet been constructed; build it now.
+		GrB_Info res;
+		UNUSED(res);
+		res = GrB_BinaryOp_new(&_binary_op_relocate_edges, _binary_op_relocate_edge,
+				GrB_UINT64, GrB_UINT64, GrB_UINT64);
+		ASSERT(res == GrB_SUCCESS);
+	}
+
+	_Relocation r = {.from = from, .to = to, .n = moved};
+	GxB_Scalar thunk;
+	GxB_Scalar_new(&thunk, GrB_UINT64);
+	GxB_Scalar_setElement_UINT64(thunk, (uint64_t)&r);
+
+	// Rewrite edge IDs held by relation matrices and their built transposes,
+	// in place within M and DP, entries deleted from M hold stale IDs harmlessly.
+	uint relation_count = Graph_RelationTypeCount(g);
+	for(uint i = 0; i < relation_count; i++) {
+		_RG_Matrix_RelocateEdges(g->relations[i], thunk);
+		RG_Matrix TM = _Graph_ResidentTranspose(g, i);
+		if(TM) _RG_Matrix_RelocateEdges(TM, thunk);
+	}
+
+	GrB_free(&thunk);
+	return moved;
+}
+
 DataBlockIterator *Graph_ScanNodes(const Graph *g) {
 	ASSERT(g);
 	return DataBlock_Scan(g->nodes);
@@ -1272,6 +2194,12 @@ int Graph_AddLabel(Graph *g) {
 	ASSERT(info == GrB_SUCCESS);
 
 	array_append(g->labels, m);
+
+	// Label bitmaps are sized to node capacity.
+	_Graph_ReserveLabelBitmaps(g, _Graph_NodeCap(g) - 1);
+	uint64_t *bitmap = rm_calloc(g->label_bitmap_words, sizeof(uint64_t));
+	array_append(g->label_bitmaps, bitmap);
+
 	return array_len(g->labels) - 1;
 }
 
@@ -1285,60 +2213,74 @@ int Graph_AddRelationType(Graph *g) {
 	Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
 
 	if(maintain_transpose) {
-		RG_Matrix tm = RG_Matrix_New(GrB_UINT64, dims, dims);
+		// Lazily built transposed matrices are built on first use.
+		RG_Matrix tm = g->lazy_transposes ? NULL : RG_Matrix_New(GrB_UINT64, dims, dims);
 		g->t_relations = array_append(g->t_relations, tm);
+		g->t_relations_used = array_append(g->t_relations_used, 0);
 	}
 
 	int relationID = Graph_RelationTypeCount(g) - 1;
 	return relationID;
 }
 
-GrB_Matrix Graph_GetAdjacencyMatrix(const Graph *g) {
-	ASSERT(g);
-	RG_Matrix m = g->adjacency_matrix;
+// Returns M + DP - DM, pending changes are merged in place,
+// requires exclusive access to the graph.
+static GrB_Matrix _Graph_GetMatrix(const Graph *g, RG_Matrix m) {
 	g->SynchronizeMatrix(g, m);
+	_RG_Matrix_Merge(m);
 	return RG_Matrix_Get_GrB_Matrix(m);
 }
 
+GrB_Matrix Graph_GetAdjacencyMatrix(const Graph *g) {
+	ASSERT(g);
+	return _Graph_GetMatrix(g, g->adjacency_matrix);
+}
+
 // Get the transposed adjacency matrix.
 GrB_Matrix Graph_GetTransposedAdjacencyMatrix(const Graph *g) {
 	ASSERT(g);
-	RG_Matrix m = g->_t_adjacency_matrix;
-	g->SynchronizeMatrix(g, m);
-	return RG_Matrix_Get_GrB_Matrix(m);
+	return _Graph_GetMatrix(g, g->_t_adjacency_matrix);
 }
 
 GrB_Matrix Graph_GetLabelMatrix(const Graph *g, int label_idx) {
 	ASSERT(g && label_idx < array_len(g->labels));
-	RG_Matrix m = g->labels[label_idx];
-	g->SynchronizeMatrix(g, m);
-	return RG_Matrix_Get_GrB_Matrix(m);
+	return _Graph_GetMatrix(g, g->labels[label_idx]);
 }
 
 GrB_Matrix Graph_GetRelationMatrix(const Graph *g, int relation_idx) {
 	ASSERT(g && (relation_idx == GRAPH_NO_RELATION || relation_idx < Graph_RelationTypeCount(g)));
-
-	if(relation_idx == GRAPH_NO_RELATION) {
-		return Graph_GetAdjacencyMatrix(g);
-	} else {
-		RG_Matrix m = g->relations[relation_idx];
-		g->SynchronizeMatrix(g, m);
-		return RG_Matrix_Get_GrB_Matrix(m);
-	}
+	return _Graph_GetMatrix(g, _Graph_RelationMatrix(g, relation_idx, false));
 }
 
 GrB_Matrix Graph_GetTransposedRelationMatrix(const Graph *g, int relation_idx) {
 	ASSERT(g && (relation_idx == GRAPH_NO_RELATION || relation_idx < Graph_RelationTypeCount(g)));
+	ASSERT((relation_idx == GRAPH_NO_RELATION || g->t_relations) &&
+		   "tried to retrieve nonexistent transposed matrix.");
+	return _Graph_GetMatrix(g, _Graph_RelationMatrix(g, relation_idx, true));
+}
 
-	if(relation_idx == GRAPH_NO_RELATION) {
-		return Graph_GetTransposedAdjacencyMatrix(g);
-	} else {
-		ASSERT(g->t_relations && "tried to retrieve nonexistent transposed matrix.");
+void Graph_GetLabelMatrixDeltas(const Graph *g, int label_idx, GrB_Matrix *M,
+		GrB_Matrix *DP, GrB_Matrix *DM) {
+	ASSERT(g && label_idx < array_len(g->labels) && M && DP && DM);
+	RG_Matrix m = g->labels[label_idx];
+	g->SynchronizeMatrix(g, m);
+	*M = m->grb_matrix;
+	*DP = m->delta_plus;
+	*DM = m->delta_minus;
+}
 
-		RG_Matrix m = g->t_relations[relation_idx];
-		g->SynchronizeMatrix(g, m);
-		return RG_Matrix_Get_GrB_Matrix(m);
-	}
+void Graph_GetRelationMatrixDeltas(const Graph *g, int relation_idx, bool transposed,
+		GrB_Matrix *M, GrB_Matrix *DP, GrB_Matrix *DM) {
+	ASSERT(g && (relation_idx == GRAPH_NO_RELATION || relation_idx < Graph_RelationTypeCount(g)));
+	ASSERT(M && DP && DM);
+	ASSERT((!transposed || relation_idx == GRAPH_NO_RELATION || g->t_relations) &&
+		   "tried to retrieve nonexistent transposed matrix.");
+
+	RG_Matrix m = _Graph_RelationMatrix(g, relation_idx, transposed);
+	g->SynchronizeMatrix(g, m);
+	*M = m->grb_matrix;
+	*DP = m->delta_plus;
+	*DM = m->delta_minus;
 }
 
 GrB_Matrix Graph_GetZeroMatrix(const Graph *g) {
@@ -1365,12 +2307,15 @@ void Graph_Free(Graph *g) {
 	_Graph_FreeRelationMatrices(g);
 	array_free(g->relations);
 	array_free(g->t_relations);
+	array_free(g->t_relations_used);
 
 	uint32_t labelCount = array_len(g->labels);
 	for(int i = 0; i < labelCount; i++) {
 		RG_Matrix_Free(g->labels[i]);
+		rm_free(g->label_bitmaps[i]);
 	}
 	array_free(g->labels);
+	array_free(g->label_bitmaps);
 
 	it = Graph_ScanNodes(g);
 	while((en = (Entity *)DataBlockIterator_Next(it, NULL)) != NULL)
@@ -1392,6 +2337,8 @@ void Graph_Free(Graph *g) {
 	UNUSED(res);
 	res = pthread_mutex_destroy(&g->_writers_mutex);
 	ASSERT(res == 0);
+	res = pthread_mutex_destroy(&g->_transpose_mutex);
+	ASSERT(res == 0);
 
 	if(g->_writelocked) Graph_ReleaseLock(g);
 	res = pthread_rwlock_destroy(&g->_rwlock);
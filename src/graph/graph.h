@@ -52,13 +52,47 @@ typedef enum {
 } MATRIX_POLICY;
 
 // Forward declaration of RG_Matrix type. Internal to graph.
+// Writes are absorbed by two small hypersparse delta matrices such that
+// the (possibly large) underlying matrix is never flushed on the read path,
+// the matrix content is grb_matrix + delta_plus - delta_minus.
 typedef struct {
 	bool allow_multi_edge;              // Entry i,j can contain multiple edges
 	GrB_Matrix grb_matrix;              // Underlying GrB_Matrix.
+	GrB_Matrix delta_plus;              // Entries added since last merge, disjoint from grb_matrix.
+	GrB_Matrix delta_minus;             // Entries of grb_matrix deleted since last merge.
+	uint64_t version;                   // Incremented on every modification of the deltas.
+	uint64_t merge_version;             // Version observed by the last merge pass.
+	bool dirty;                         // Modified under the current write lock.
 	pthread_mutex_t mutex;              // Lock.
 } _RG_Matrix;
 typedef _RG_Matrix *RG_Matrix;
 
+// Iterates the entries of M + DP - DM without merging the deltas,
+// entries of M are visited first followed by the entries of DP.
+typedef struct {
+	GxB_MatrixTupleIter *it;            // Iterator over M.
+	GrB_Matrix M;                       // Underlying matrix.
+	GrB_Matrix DP;                      // Added entries.
+	GrB_Matrix DM;                      // Deleted entries of M.
+	GrB_Index deletions;                // Number of deleted entries.
+	GrB_Index *I;                       // Rows of DP entries, NULL when iterating a single row.
+	GrB_Index *J;                       // Columns of DP entries.
+	uint64_t *X;                        // Values of DP entries.
+	GrB_Index row;                      // Row iterated.
+	GrB_Index n;                        // Number of DP entries.
+	GrB_Index idx;                      // Next DP entry.
+	bool m_depleted;                    // All entries of M were visited.
+	bool dp_extracted;                  // Entries of DP were extracted.
+} RG_MatrixTupleIter;
+
+// Transposed relation matrices usage statistics.
+typedef struct {
+	uint64_t resident;  // Number of transposed matrices built lazily and not yet dropped.
+	uint64_t uses;      // Number of times a lazily built transposed matrix was requested.
+	uint64_t builds;    // Number of transposed matrices built on first use.
+	uint64_t drops;     // Number of transposed matrices dropped.
+} TransposeStats;
+
 // Forward declaration of Graph struct
 typedef struct Graph Graph;
 // typedef for synchronization function pointer
@@ -70,8 +104,15 @@ struct Graph {
 	RG_Matrix adjacency_matrix;         // Adjacency matrix, holds all graph connections.
 	RG_Matrix _t_adjacency_matrix;      // Transposed Adjacency matrix.
 	RG_Matrix *labels;                  // Label matrices.
+	uint64_t **label_bitmaps;           // Per label bitmap of labeled node IDs, mirrors label matrices.
+	uint64_t label_bitmap_words;        // Number of 64 bit words in each label bitmap.
 	RG_Matrix *relations;               // Relation matrices.
-	RG_Matrix *t_relations;             // Transposed relation matrices.
+	RG_Matrix *t_relations;             // Transposed relation matrices, NULL entries are built on first use.
+	uint64_t *t_relations_used;         // Transpose clock at each transposed matrix's last use.
+	uint64_t t_relations_clock;         // Advanced by every transposed matrices eviction pass.
+	bool lazy_transposes;               // Transposed matrices are built on first use and may be dropped.
+	TransposeStats t_stats;             // Transposed matrices usage statistics.
+	pthread_mutex_t _transpose_mutex;   // Serializes building transposed matrices.
 	RG_Matrix _zero_matrix;             // Zero matrix.
 	pthread_mutex_t _writers_mutex;     // Mutex restrict single writer.
 	pthread_rwlock_t _rwlock;           // Read-write lock scoped to this specific graph
@@ -103,6 +144,22 @@ void Graph_SetMatrixPolicy(Graph *g, MATRIX_POLICY policy);
 /* Synchronize and resize all matrices in graph. */
 void Graph_ApplyAllPending(Graph *g);
 
+/* Merge the delta matrices of every matrix which accumulated at least
+ * 'threshold' pending changes or wasn't modified since the previous call,
+ * the merged matrix is computed under the read lock and swapped in
+ * under the write lock. */
+void Graph_MergeDeltas(Graph *g, uint64_t threshold);
+
+/* Drop lazily built transposed relation matrices, least recently used first,
+ * until they hold at most 'max_memory' bytes (0 for unlimited).
+ * Under memory 'pressure' every transposed matrix which wasn't used since
+ * the previous call is dropped as well.
+ * Dropped matrices are rebuilt on their next use. */
+void Graph_EvictTransposes(Graph *g, uint64_t max_memory, bool pressure);
+
+// Accumulate the graph's transposed matrices usage statistics into 'stats'.
+void Graph_GetTransposeStats(const Graph *g, TransposeStats *stats);
+
 // Create a new graph.
 Graph *Graph_New(
 	size_t node_cap,    // Allocation size for node datablocks and matrix dimensions.
@@ -139,6 +196,25 @@ void Graph_CreateNode(
 	Node *n
 );
 
+// Creates an edge from source node to destination node without
+// introducing it into the graph's matrices, the edge is
+// connected by a later call to Graph_ConnectNodesBatch.
+void Graph_CreateEdge(
+	Graph *g,           // Graph on which to operate.
+	NodeID src,         // Source node ID.
+	NodeID dest,        // Destination node ID.
+	int r,              // Edge type.
+	Edge *e             // [output] created edge.
+);
+
+// Connects a batch of edges created by Graph_CreateEdge,
+// each of the graph's matrices is updated once for the entire batch.
+void Graph_ConnectNodesBatch(
+	Graph *g,           // Graph on which to operate.
+	Edge **edges,       // Edges to connect, of any relation type.
+	uint edge_count     // Number of edges.
+);
+
 // Connects source node to destination node.
 // Returns 1 if connection is formed, 0 otherwise.
 int Graph_ConnectNodes(
@@ -163,7 +239,9 @@ int Graph_DeleteEdge(
 
 // Returns true if the given entity has been deleted.
 bool Graph_EntityIsDeleted(
-	Entity *e
+	const Graph *g,
+	GraphEntityType t,
+	EntityID id
 );
 
 // Removes both nodes and edges from graph.
@@ -177,6 +255,28 @@ void Graph_BulkDelete(
 	uint *edge_deleted  // Number of edges removed.
 );
 
+// Relocates up to 'limit' nodes with the highest IDs into free IDs,
+// freeing node blocks left empty, see DataBlock_Compact.
+// The previous and new ID of each relocated node are written to 'from' and 'to'.
+// Returns the number of relocated nodes, requires the write lock.
+uint64_t Graph_CompactNodes(
+	Graph *g,
+	uint64_t limit,
+	NodeID *from,
+	NodeID *to
+);
+
+// Relocates up to 'limit' edges with the highest IDs into free IDs,
+// freeing edge blocks left empty, see DataBlock_Compact.
+// The previous and new ID of each relocated edge are written to 'from' and 'to'.
+// Returns the number of relocated edges, requires the write lock.
+uint64_t Graph_CompactEdges(
+	Graph *g,
+	uint64_t limit,
+	EdgeID *from,
+	EdgeID *to
+);
+
 // All graph matrices are required to be squared NXN
 // where N is Graph_RequiredMatrixDim.
 size_t Graph_RequiredMatrixDim(
@@ -246,6 +346,36 @@ int Graph_GetNodeLabel(
 	NodeID nodeID
 );
 
+// Returns true if node is labeled as 'label',
+// false for GRAPH_NO_LABEL and GRAPH_UNKNOWN_LABEL.
+bool Graph_NodeHasLabel(
+	const Graph *g,
+	NodeID nodeID,
+	int label
+);
+
+// Advances 'nodeID' to the first node labeled as 'label'
+// with an ID greater than or equal to 'nodeID'.
+// Returns false if there's no such node.
+bool Graph_NextLabeledNode(
+	const Graph *g,
+	int label,
+	NodeID *nodeID
+);
+
+// Labels node without creating it, used by decoders
+// populating label matrices directly.
+void Graph_MarkNodeLabel(
+	Graph *g,
+	NodeID nodeID,
+	int label
+);
+
+// Rebuilds label bitmaps from label matrices.
+void Graph_RebuildLabelBitmaps(
+	Graph *g
+);
+
 // Retrieves edge with given id from graph,
 // Returns NULL if edge wasn't found.
 int Graph_GetEdge(
@@ -291,6 +421,10 @@ void Graph_GetNodeEdges(
 	Edge **edges            // array_t incoming/outgoing edges.
 );
 
+// The following getters merge pending changes into the returned matrix
+// and as such require exclusive access to the graph, e.g. while loading.
+// Queries read matrices through Graph_Get*MatrixDeltas.
+
 // Retrieves the adjacency matrix.
 // Matrix is resized if its size doesn't match graph's node count.
 GrB_Matrix Graph_GetAdjacencyMatrix(
@@ -319,11 +453,71 @@ GrB_Matrix Graph_GetRelationMatrix(
 
 // Retrieves a transposed typed adjacency matrix.
 // Matrix is resized if its size doesn't match graph's node count.
+// With LAZY_TRANSPOSED_MATRICES the matrix is built on its first use.
 GrB_Matrix Graph_GetTransposedRelationMatrix(
 	const Graph *g,     // Graph from which to get adjacency matrix.
 	int relation        // Relation described by matrix.
 );
 
+// Retrieves a label matrix along with its delta matrices,
+// the label matrix is M + DP - DM. Unlike Graph_GetLabelMatrix
+// pending changes aren't merged, DP and DM are empty if there are none.
+// Matrices remain valid for as long as the graph lock is held.
+void Graph_GetLabelMatrixDeltas(
+	const Graph *g,     // Graph from which to get the matrices.
+	int label,          // Label described by matrix.
+	GrB_Matrix *M,      // [output] underlying matrix.
+	GrB_Matrix *DP,     // [output] added entries.
+	GrB_Matrix *DM      // [output] deleted entries.
+);
+
+// Retrieves a (transposed) typed adjacency matrix along with its delta
+// matrices, the typed adjacency matrix is M + DP - DM.
+void Graph_GetRelationMatrixDeltas(
+	const Graph *g,     // Graph from which to get the matrices.
+	int relation,       // Relation described by matrix.
+	bool transposed,    // Retrieve the transposed matrix.
+	GrB_Matrix *M,      // [output] underlying matrix.
+	GrB_Matrix *DP,     // [output] added entries.
+	GrB_Matrix *DM      // [output] deleted entries.
+);
+
+// Creates an iterator over M + DP - DM, see Graph_Get*MatrixDeltas.
+RG_MatrixTupleIter *RG_MatrixTupleIter_new(
+	GrB_Matrix M,       // Underlying matrix.
+	GrB_Matrix DP,      // Added entries.
+	GrB_Matrix DM       // Deleted entries.
+);
+
+// Restricts the iterator to a single row.
+void RG_MatrixTupleIter_iterate_row(
+	RG_MatrixTupleIter *iter,
+	GrB_Index row
+);
+
+// Advances the iterator, returns false once all entries were visited.
+bool RG_MatrixTupleIter_next(
+	RG_MatrixTupleIter *iter,
+	GrB_Index *row,     // [optional output] entry row.
+	GrB_Index *col,     // [optional output] entry column.
+	uint64_t *val       // [optional output] entry value.
+);
+
+// Free iterator.
+void RG_MatrixTupleIter_free(
+	RG_MatrixTupleIter *iter
+);
+
+// Returns the pattern of M + DP - DM for algorithms requiring a single matrix,
+// M itself if there are no pending changes, otherwise a boolean matrix
+// computed for the caller, in which case 'owned' is set and the caller frees it.
+GrB_Matrix RG_Matrix_Materialize(
+	GrB_Matrix M,       // Underlying matrix.
+	GrB_Matrix DP,      // Added entries.
+	GrB_Matrix DM,      // Deleted entries.
+	bool *owned         // [output] caller owns the returned matrix.
+);
+
 // Retrieves the zero matrix.
 // The function will resize it to match all other
 // internal matrices, caller mustn't modify it in any way.
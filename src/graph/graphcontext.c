@@ -61,6 +61,7 @@ GraphContext *GraphContext_New(const char *graph_name, size_t node_cap, size_t e
 	gc->ref_count        = 0;  // no refences
 	gc->attributes       = raxNew();
 	gc->index_count      = 0;  // no indicies
+	gc->column_count     = 0;  // no property columns
 	gc->string_mapping   = array_new(char *, 64);
 	gc->encoding_context = GraphEncodeContext_New();
 	gc->decoding_context = GraphDecodeContext_New();
@@ -154,6 +155,11 @@ void GraphContext_Release(GraphContext *gc) {
 	_GraphContext_DecreaseRefCount(gc);
 }
 
+void GraphContext_Retain(GraphContext *gc) {
+	ASSERT(gc);
+	_GraphContext_IncreaseRefCount(gc);
+}
+
 void GraphContext_MarkWriter(RedisModuleCtx *ctx, GraphContext *gc) {
 	RedisModuleString *graphID = RedisModule_CreateString(ctx, gc->graph_name, strlen(gc->graph_name));
 
@@ -427,6 +433,122 @@ void GraphContext_DeleteNodeFromIndices(GraphContext *gc, Node *n) {
 	if(idx) Index_RemoveNode(idx, n);
 }
 
+//------------------------------------------------------------------------------
+// Column API
+//------------------------------------------------------------------------------
+bool GraphContext_HasColumns(GraphContext *gc) {
+	ASSERT(gc != NULL);
+
+	return gc->column_count > 0;
+}
+
+int GraphContext_AddColumn(PropertyColumn **column, GraphContext *gc, const char *label,
+						   const char *field) {
+	ASSERT(column && gc && label && field);
+
+	// Retrieve the schema for this label
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	if(s == NULL) s = GraphContext_AddSchema(gc, label, SCHEMA_NODE);
+
+	Attribute_ID attribute_id = GraphContext_FindOrAddAttribute(gc, field);
+	int res = Schema_AddColumn(column, s, attribute_id);
+	if(res == INDEX_OK) gc->column_count++;
+	return res;
+}
+
+int GraphContext_DeleteColumn(GraphContext *gc, const char *label, const char *field) {
+	ASSERT(gc != NULL);
+	ASSERT(label != NULL);
+	ASSERT(field != NULL);
+
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	if(s == NULL) return INDEX_FAIL;
+
+	Attribute_ID attribute_id = GraphContext_GetAttributeID(gc, field);
+	if(attribute_id == ATTRIBUTE_NOTFOUND) return INDEX_FAIL;
+
+	int res = Schema_RemoveColumn(s, attribute_id);
+	if(res == INDEX_OK) gc->column_count--;
+	return res;
+}
+
+void GraphContext_DeleteNodeFromColumns(GraphContext *gc, Node *n) {
+	int schema_id = NODE_GET_LABEL_ID(n, gc->g);
+	// Do nothing if node had no label
+	if(schema_id == GRAPH_NO_LABEL) return;
+
+	Schema *s = GraphContext_GetSchemaByID(gc, schema_id, SCHEMA_NODE);
+	Schema_RemoveNodeFromColumns(s, ENTITY_GET_ID(n));
+}
+
+//------------------------------------------------------------------------------
+// Compaction
+//------------------------------------------------------------------------------
+
+// Move the column entries of relocated nodes to their new IDs
+static void _GraphContext_RelocateColumns(GraphContext *gc, const NodeID *from,
+		const NodeID *to, uint64_t n) {
+	if(!GraphContext_HasColumns(gc)) return;
+
+	for(uint64_t i = 0; i < n; i++) {
+		int label = Graph_GetNodeLabel(gc->g, to[i]);
+		if(label == GRAPH_NO_LABEL) continue;
+		Schema *s = GraphContext_GetSchemaByID(gc, label, SCHEMA_NODE);
+		if(!Schema_HasColumns(s)) continue;
+
+		uint count = array_len(s->columns);
+		for(uint j = 0; j < count; j++) PropertyColumn_Move(s->columns[j], from[i], to[i]);
+	}
+}
+
+// Re-index relocated nodes under their new IDs
+static void _GraphContext_ReindexNodes(GraphContext *gc, const NodeID *from,
+		const NodeID *to, uint64_t n) {
+	if(!GraphContext_HasIndices(gc)) return;
+
+	for(uint64_t i = 0; i < n; i++) {
+		int label = Graph_GetNodeLabel(gc->g, to[i]);
+		if(label == GRAPH_NO_LABEL) continue;
+		Schema *s = GraphContext_GetSchemaByID(gc, label, SCHEMA_NODE);
+		if(!Schema_HasIndices(s)) continue;
+
+		Node prev = GE_NEW_NODE();
+		prev.id = from[i];
+		Node node = GE_NEW_NODE();
+		Graph_GetNode(gc->g, to[i], &node);
+
+		Index *idx = Schema_GetIndex(s, NULL, IDX_FULLTEXT);
+		if(idx) {
+			Index_RemoveNode(idx, &prev);
+			Index_IndexNode(idx, &node);
+		}
+		idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
+		if(idx) {
+			Index_RemoveNode(idx, &prev);
+			Index_IndexNode(idx, &node);
+		}
+	}
+}
+
+void GraphContext_Compact(GraphContext *gc, uint64_t limit, uint64_t *nodes,
+		uint64_t *edges) {
+	ASSERT(gc != NULL && limit > 0);
+
+	EntityID *from = rm_malloc(sizeof(EntityID) * limit);
+	EntityID *to = rm_malloc(sizeof(EntityID) * limit);
+
+	*nodes = Graph_CompactNodes(gc->g, limit, from, to);
+	_GraphContext_ReindexNodes(gc, from, to, *nodes);
+	_GraphContext_RelocateColumns(gc, from, to, *nodes);
+	*edges = Graph_CompactEdges(gc->g, limit, from, to);
+
+	// entity IDs held by clients are no longer valid
+	if(*nodes > 0 || *edges > 0) _GraphContext_UpdateVersion(gc, "compaction");
+
+	rm_free(from);
+	rm_free(to);
+}
+
 //------------------------------------------------------------------------------
 // Functions for globally tracking GraphContexts
 //------------------------------------------------------------------------------
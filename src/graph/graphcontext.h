@@ -36,6 +36,7 @@ typedef struct {
 	Schema **node_schemas;                  // Array of schemas for each node label
 	Schema **relation_schemas;              // Array of schemas for each relation type
 	unsigned short index_count;             // Number of indicies.
+	unsigned short column_count;            // Number of property columns.
 	SlowLog *slowlog;                       // Slowlog associated with graph.
 	GraphEncodeContext *encoding_context;   // Encode context of the graph.
 	GraphDecodeContext *decoding_context;   // Decode context of the graph.
@@ -55,6 +56,8 @@ GraphContext *GraphContext_Retrieve(RedisModuleCtx *ctx, RedisModuleString *grap
 									bool shouldCreate);
 // GraphContext_Retrieve counterpart, releases a retrieved GraphContext.
 void GraphContext_Release(GraphContext *gc);
+// Retain an already accessible GraphContext, released by GraphContext_Release.
+void GraphContext_Retain(GraphContext *gc);
 // Mark graph key as "dirty" for Redis to pick up on.
 void GraphContext_MarkWriter(RedisModuleCtx *ctx, GraphContext *gc);
 
@@ -109,6 +112,31 @@ int GraphContext_DeleteIndex(GraphContext *gc, const char *label, const char *fi
 // Remove a single node from all indices that refer to it
 void GraphContext_DeleteNodeFromIndices(GraphContext *gc, Node *n);
 
+//------------------------------------------------------------------------------
+// Column API
+//------------------------------------------------------------------------------
+
+bool GraphContext_HasColumns(GraphContext *gc);
+// Create an empty column for the given label and attribute
+int GraphContext_AddColumn(PropertyColumn **column, GraphContext *gc, const char *label,
+						   const char *field);
+// Remove and free a column
+int GraphContext_DeleteColumn(GraphContext *gc, const char *label, const char *field);
+// Clear a single node from all columns of its label
+void GraphContext_DeleteNodeFromColumns(GraphContext *gc, Node *n);
+
+//------------------------------------------------------------------------------
+// Compaction API
+//------------------------------------------------------------------------------
+
+/* Relocate up to 'limit' nodes and 'limit' edges with the highest IDs into
+ * free IDs, see Graph_CompactNodes, indices and columns are updated accordingly
+ * the graph version is updated whenever entities are relocated
+ * number of relocated nodes and edges are written to 'nodes' and 'edges'
+ * requires the graph's write lock */
+void GraphContext_Compact(GraphContext *gc, uint64_t limit, uint64_t *nodes,
+		uint64_t *edges);
+
 // Add GraphContext to global array
 void GraphContext_RegisterWithModule(GraphContext *gc);
 
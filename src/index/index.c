@@ -51,23 +51,16 @@ static void _populateIndex(Index *idx) {
 	if(s == NULL) return;
 
 	Node node = GE_NEW_NODE();
-	NodeID node_id;
+	NodeID node_id = 0;
 	Graph *g = gc->g;
 	int label_id = s->id;
-	GxB_MatrixTupleIter *it;
-	const GrB_Matrix label_matrix = Graph_GetLabelMatrix(g, label_id);
-	GxB_MatrixTupleIter_new(&it, label_matrix);
 
 	// Iterate over each labeled node.
-	while(true) {
-		bool depleted = false;
-		GxB_MatrixTupleIter_next(it, NULL, &node_id, &depleted);
-		if(depleted) break;
-
+	while(Graph_NextLabeledNode(g, label_id, &node_id)) {
 		Graph_GetNode(g, node_id, &node);
 		Index_IndexNode(idx, &node);
+		node_id++;
 	}
-	GxB_MatrixTupleIter_free(it);
 }
 
 // Create a new index.
@@ -13,11 +13,14 @@
 #include "version.h"
 #include "util/arr.h"
 #include "util/cron.h"
+#include "util/rmalloc.h"
 #include "query_ctx.h"
 #include "arithmetic/funcs.h"
 #include "commands/commands.h"
 #include "util/thpool/pools.h"
 #include "graph/graphcontext.h"
+#include "graph/delta_merge.h"
+#include "graph/compaction.h"
 #include "ast/cypher_whitelist.h"
 #include "procedures/procedure.h"
 #include "arithmetic/arithmetic_expression.h"
@@ -26,6 +29,8 @@
 #include "serializers/graphmeta_type.h"
 #include "redisearch_api.h"
 #include "util/redis_version.h"
+#include "nvm_support/property_tiering.h"
+#include "nvm_support/pheap.h"
 
 //------------------------------------------------------------------------------
 // Minimal supported Redis version
@@ -61,6 +66,65 @@ static void _PrepareModuleGlobals(RedisModuleCtx *ctx, RedisModuleString **argv,
 	process_is_child = false;
 }
 
+// open the persistent heap, graph images in it are attached while loading
+static int _InitPersistentHeap(RedisModuleCtx *ctx) {
+	const char *pmem_heap = NULL;
+	Config_Option_get(Config_PMEM_HEAP, &pmem_heap);
+	if(pmem_heap == NULL) return REDISMODULE_OK;
+
+	if(nvm_attach_heap(pmem_heap, NVM_POOL_SIZE_DEFAULT) != 0) {
+		RedisModule_Log(ctx, "warning", "Failed to open persistent heap at %s", pmem_heap);
+		return REDISMODULE_ERR;
+	}
+
+	if(PHeap_WasClean()) {
+		RedisModule_Log(ctx, "notice", "Persistent heap %s opened, graphs will be re-attached", pmem_heap);
+	} else {
+		RedisModule_Log(ctx, "notice", "Persistent heap %s was not closed cleanly, graphs will be loaded from RDB", pmem_heap);
+	}
+	return REDISMODULE_OK;
+}
+
+static int _InitPersistentMemory(RedisModuleCtx *ctx) {
+	const char *pmem_path = NULL;
+	Config_Option_get(Config_PMEM_PATH, &pmem_path);
+
+	if(pmem_path == NULL) {
+		for(NVM_AllocClass cls = 0; cls < NVM_CLASS_COUNT; cls++) {
+			if(nvm_get_placement(cls) != NVM_PLACEMENT_DRAM) {
+				RedisModule_Log(ctx, "warning",
+						"PMEM_PATH not set, all allocations will be served from DRAM");
+				break;
+			}
+		}
+		return REDISMODULE_OK;
+	}
+
+	if(init_memkind(pmem_path, NVM_POOL_SIZE_DEFAULT) != 0) {
+		RedisModule_Log(ctx, "warning", "Failed to create PMEM pool at %s", pmem_path);
+		return REDISMODULE_ERR;
+	}
+
+	RedisModule_Log(ctx, "notice", "PMEM pool created at %s", pmem_path);
+	return REDISMODULE_OK;
+}
+
+// NUMA policies require kernel support, warn if they can't be applied
+static void _InitMemoryPolicy(RedisModuleCtx *ctx) {
+	NVM_Numa numa;
+	Config_Option_get(Config_NUMA_POLICY, &numa);
+	if(numa != NVM_NUMA_DEFAULT && !nvm_numa_available()) {
+		RedisModule_Log(ctx, "warning", "NUMA is not available, NUMA_POLICY %s is ignored",
+				nvm_numa_name(numa));
+	}
+}
+
+// CRON task, adapts the allocation threshold to recent allocations
+static void _TuneAllocThreshold(void *pdata) {
+	if(nvm_get_threshold_adaptive() && pmem_kind != NULL) nvm_tune_threshold();
+	Cron_AddTask(ALLOC_THRESHOLD_TUNE_INTERVAL, _TuneAllocThreshold, NULL);
+}
+
 int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	/* TODO: when module unloads call GrB_finalize. */
 
@@ -69,15 +133,9 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
         return REDISMODULE_ERR;
     }
 
-#ifdef HYBRID_MEMORY
-	init_memkind();
-#endif
-
-#ifdef NVM_MATRIX
-    GrB_Info res = GxB_init(GrB_NONBLOCKING, nvm_malloc, nvm_calloc, rm_realloc, rm_free, true);
-#else
-	GrB_Info res = GxB_init(GrB_NONBLOCKING, rm_malloc, rm_calloc, rm_realloc, rm_free, true);
-#endif
+	// matrix allocations follow the MATRIX_PLACEMENT policy
+	GrB_Info res = GxB_init(GrB_NONBLOCKING, nvm_matrix_malloc, nvm_matrix_calloc,
+			nvm_matrix_realloc, nvm_free, true);
 
 	if(res != GrB_SUCCESS) {
 		RedisModule_Log(ctx, "warning", "Encountered error initializing GraphBLAS");
@@ -110,6 +168,13 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 	// Set up the module's configurable variables, using user-defined values where provided.
 	if(Config_Init(ctx, argv, argc) != REDISMODULE_OK) return REDISMODULE_ERR;
 
+	// Create the PMEM pool if a path was provided.
+	if(_InitPersistentMemory(ctx) != REDISMODULE_OK) return REDISMODULE_ERR;
+	// Open the persistent heap if a file was provided.
+	if(_InitPersistentHeap(ctx) != REDISMODULE_OK) return REDISMODULE_ERR;
+	_InitMemoryPolicy(ctx);
+	Cron_AddTask(ALLOC_THRESHOLD_TUNE_INTERVAL, _TuneAllocThreshold, NULL);
+
 	RegisterEventHandlers(ctx);
 	CypherWhitelist_Build(); // Build whitelist of supported Cypher elements.
 
@@ -127,6 +192,15 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 
 	RedisModule_Log(ctx, "notice", "Thread pool created, using %d threads.", reader_thread_count);
 
+	// migrate entity properties between DRAM and PMEM in the background
+	PropertyTiering_Start();
+
+	// merge pending matrix changes in the background
+	DeltaMerge_Start();
+
+	// relocate entities of fragmented graphs in the background
+	Compaction_Start();
+
 	int ompThreadCount;
 	Config_Option_get(Config_OPENMP_NTHREAD, &ompThreadCount);
 
@@ -171,11 +245,21 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.COMPACT", MGraph_Compact, "write", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
 	if(RedisModule_CreateCommand(ctx, "graph.SLOWLOG", CommandDispatch, "readonly", 1, 1,
 								 1) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.MEMORY", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
 	if(RedisModule_CreateCommand(ctx, "graph.CONFIG", MGraph_Config, "write", 1, 1,
 								 1) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
@@ -15,6 +15,9 @@
 #include "util/redis_version.h"
 #include "util/thpool/pools.h"
 #include "util/uuid.h"
+#include "nvm_support/nvm.h"
+#include "nvm_support/pheap.h"
+#include "nvm_support/graph_image.h"
 
 // Global array tracking all extant GraphContexts.
 extern GraphContext **graphs_in_keyspace;
@@ -77,6 +80,9 @@ static bool _GraphContext_NameContainsTag(const GraphContext *gc) {
 
 // Calculate how many virtual keys are needed to represent the graph.
 static uint64_t _GraphContext_RequiredMetaKeys(const GraphContext *gc) {
+	// Graphs whose entities are held by graph images fit in a single key.
+	if(GraphImage_SavingImages()) return 0;
+
 	uint64_t vkey_entity_count;
 	Config_Option_get(Config_VKEY_MAX_ENTITY_COUNT, &vkey_entity_count);
 
@@ -194,11 +200,73 @@ static bool _IsEventPersistenceEnd(RedisModuleEvent eid, uint64_t subevent) {
 		   );
 }
 
+// Returns the server's run id, which is unique to the running process.
+static const char *_ServerRunID(RedisModuleCtx *ctx) {
+	static char run_id[41] = {0};
+	if(run_id[0] != '\0') return run_id;
+
+	RedisModuleCallReply *reply = RedisModule_Call(ctx, "INFO", "c", "server");
+	if(reply == NULL) return NULL;
+
+	size_t len;
+	const char *ptr = RedisModule_CallReplyStringPtr(reply, &len);
+	char *info = (ptr != NULL) ? rm_strndup(ptr, len) : NULL;
+	char *field = (info != NULL) ? strstr(info, "run_id:") : NULL;
+	if(field != NULL) sscanf(field, "run_id:%40[0-9a-f]", run_id);
+
+	rm_free(info);
+	RedisModule_FreeCallReply(reply);
+	return (run_id[0] != '\0') ? run_id : NULL;
+}
+
 // Server persistence event handler.
 static void _PersistenceEventHandler(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t subevent,
 									 void *data) {
-	if(_IsEventPersistenceStart(eid, subevent)) _CreateKeySpaceMetaKeys(ctx);
-	else if(_IsEventPersistenceEnd(eid, subevent)) _ClearKeySpaceMetaKeys(ctx, false);
+	if(_IsEventPersistenceStart(eid, subevent)) {
+		// RDB files are identified for graph images to be matched against,
+		// an AOF preamble gets no identifier.
+		bool rdb = subevent != REDISMODULE_SUBEVENT_PERSISTENCE_AOF_START;
+		if(PHeap_IsOpen()) GraphImage_SaveStarted(rdb ? _ServerRunID(ctx) : NULL);
+		_CreateKeySpaceMetaKeys(ctx);
+	} else if(_IsEventPersistenceEnd(eid, subevent)) {
+		if(PHeap_IsOpen()) {
+			GraphImage_SaveEnded(subevent == REDISMODULE_SUBEVENT_PERSISTENCE_ENDED);
+		}
+		_ClearKeySpaceMetaKeys(ctx, false);
+	}
+}
+
+// Server loading event handler.
+static void _LoadingEventHandler(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t subevent,
+		void *data) {
+	if(!PHeap_IsOpen()) return;
+
+	if(subevent == REDISMODULE_SUBEVENT_LOADING_RDB_START) {
+		// images describe the dataset of the last RDB saved on shutdown
+		GraphImage_AllowAttach(true);
+	} else {
+		// AOF and replication streams may disagree with the images
+		GraphImage_AllowAttach(false);
+		GraphImage_DropAll();
+	}
+}
+
+// Returns true if the dataset was saved to an RDB file, which is the only
+// source graph images can be re-attached to.
+static bool _DatasetSavedToRDB(RedisModuleCtx *ctx) {
+	RedisModuleCallReply *reply = RedisModule_Call(ctx, "INFO", "c", "persistence");
+	if(reply == NULL) return false;
+
+	size_t len;
+	const char *ptr = RedisModule_CallReplyStringPtr(reply, &len);
+	char *info = (ptr != NULL) ? rm_strndup(ptr, len) : NULL;
+	bool saved = info != NULL &&
+		strstr(info, "rdb_changes_since_last_save:0\r\n") != NULL &&
+		strstr(info, "aof_enabled:0\r\n") != NULL;
+
+	rm_free(info);
+	RedisModule_FreeCallReply(reply);
+	return saved;
 }
 
 // Perform clean-up upon server shutdown.
@@ -210,6 +278,24 @@ static void _ShutdownEventHandler(RedisModuleCtx *ctx, RedisModuleEvent eid, uin
 	// after which it will simply call `thread_destroy` and continue.
 	ThreadPools_Destroy();
 
+	// Move graphs into the persistent heap and save the RDB again without the
+	// entities the heap now holds, a heap which doesn't hold all graphs is
+	// discarded on the next start, as is one which doesn't match the RDB.
+	if(PHeap_IsOpen()) {
+		bool persisted = _DatasetSavedToRDB(ctx) && GraphImage_PersistAll() && PHeap_Sync();
+		if(persisted) {
+			RedisModuleCallReply *reply = RedisModule_Call(ctx, "SAVE", "");
+			persisted = reply != NULL &&
+						RedisModule_CallReplyType(reply) != REDISMODULE_REPLY_ERROR;
+			if(reply != NULL) RedisModule_FreeCallReply(reply);
+		}
+		if(!persisted) {
+			RedisModule_Log(ctx, "warning", "Graphs were not persisted to the persistent heap");
+		}
+		// A synced heap is left as is.
+		nvm_detach_heap(false);
+	}
+
 	// Server is shutting down, finalize GraphBLAS.
 	GrB_finalize();
 }
@@ -219,6 +305,7 @@ static void _RegisterServerEvents(RedisModuleCtx *ctx) {
 	RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_FlushDB, _FlushDBHandler);
 	RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_Persistence, _PersistenceEventHandler);
 	RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_Shutdown, _ShutdownEventHandler);
+	RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_Loading, _LoadingEventHandler);
 }
 
 static void RG_AfterForkChild() {
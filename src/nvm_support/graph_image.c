@@ -0,0 +1,465 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "graph_image.h"
+#include "nvm.h"
+#include "pheap.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include "../graph/entities/multi_edge.h"
+#include "xxhash.h"
+#include <stdio.h>
+
+extern GraphContext **graphs_in_keyspace;  // global array tracking all extant GraphContexts
+
+// images are attached only while loading the RDB at startup
+static bool attach_allowed = false;
+
+static uint64_t save_seq = 0;       // number of RDB saves started
+static uint64_t saving_id = 0;      // identifier of the save in progress
+static uint64_t saved_id = 0;       // identifier of the last RDB saved
+static uint64_t image_id = 0;       // identifier reserved for the save of the images
+static bool saving_images = false;  // the save in progress is the images' save
+static uint64_t load_id = 0;        // identifier of the RDB being loaded
+
+// persisted GraphBLAS matrix in CSR form
+typedef struct {
+	GrB_Index nrows;        // number of rows
+	GrB_Index ncols;        // number of columns
+	GrB_Index *Ap;          // row pointers
+	GrB_Index *Aj;          // column indices
+	void *Ax;               // values
+	GrB_Index Ap_size;      // number of entries in Ap
+	GrB_Index Aj_size;      // number of entries in Aj
+	GrB_Index Ax_size;      // number of entries in Ax
+	bool jumbled;           // column indices within a row may be unsorted
+	bool relation;          // GrB_UINT64 edge IDs, GrB_BOOL otherwise
+	bool allow_multi_edge;  // see _RG_Matrix
+} MatrixImage;
+
+// persisted DataBlock
+typedef struct {
+	uint64_t itemCount;     // number of items stored
+	uint blockCount;        // number of blocks
+	uint itemSize;          // item size, including the item header
+	Block **blocks;         // array of blocks
+	uint64_t *deletedIdx;   // array of free indices
+	bool clustered;         // blocks are clustered by label
+} DataBlockImage;
+
+typedef struct {
+	uint64_t save_id;          // identifier of the RDB saved alongside the image
+	uint64_t node_count;       // number of nodes
+	uint64_t edge_count;       // number of edges
+	uint64_t label_count;      // number of label matrices
+	uint64_t relation_count;   // number of relation matrices
+	bool has_transpose;        // transposed relation matrices were persisted
+	DataBlockImage nodes;      // node entities
+	DataBlockImage edges;      // edge entities
+	MatrixImage adjacency;     // adjacency matrix
+	MatrixImage t_adjacency;   // transposed adjacency matrix
+	MatrixImage *labels;       // label matrices
+	MatrixImage *relations;    // relation matrices
+	MatrixImage *t_relations;  // transposed relation matrices, NULL if missing
+} GraphImage;
+
+static bool _GraphImage_RootName(char *root, const char *graph_name) {
+	int n = snprintf(root, PHEAP_ROOT_NAME_LEN, GRAPH_IMAGE_ROOT_PREFIX "%s",
+			graph_name);
+	return n > 0 && n < PHEAP_ROOT_NAME_LEN;
+}
+
+// transposed matrices are part of the image only if they're all maintained
+// lazily built transposed matrices are rebuilt on demand
+static bool _GraphImage_HasTranspose(const Graph *g) {
+	return g->t_relations != NULL && !g->lazy_transposes;
+}
+
+//------------------------------------------------------------------------------
+// save identifiers
+//------------------------------------------------------------------------------
+
+void GraphImage_SaveStarted(const char *run_id) {
+	if(run_id == NULL) {
+		saving_id = 0;
+		return;
+	}
+
+	// the first RDB saved once graphs were persisted carries the images' identifier
+	if(image_id != 0) {
+		saving_id = image_id;
+		saving_images = true;
+		image_id = 0;
+		return;
+	}
+
+	save_seq++;
+	saving_id = XXH64(run_id, strlen(run_id), save_seq);
+	// 0 is reserved for RDBs carrying no identifier
+	if(saving_id == 0) saving_id = 1;
+}
+
+void GraphImage_SaveEnded(bool saved) {
+	if(saved) saved_id = saving_id;
+	saving_id = 0;
+	saving_images = false;
+}
+
+uint64_t GraphImage_SaveID(void) {
+	return saving_id;
+}
+
+bool GraphImage_SavingImages(void) {
+	return saving_images;
+}
+
+void GraphImage_SetLoadID(uint64_t save_id) {
+	load_id = save_id;
+}
+
+//------------------------------------------------------------------------------
+// persist
+//------------------------------------------------------------------------------
+
+// move the first 'n' bytes of '*p' into the heap, freeing the original
+static bool _GraphImage_Adopt(void **p, size_t n) {
+	if(*p == NULL || PHeap_Contains(*p)) return true;
+
+	void *np = PHeap_Malloc(n);
+	if(np == NULL) return false;
+
+	memcpy(np, *p, n);
+	nvm_free(*p);
+	*p = np;
+	return true;
+}
+
+// move an arr.h array into the heap
+static bool _GraphImage_AdoptArray(void **arr) {
+	if(*arr == NULL) return true;
+
+	array_hdr_t *hdr = array_hdr(*arr);
+	if(!_GraphImage_Adopt((void **)&hdr, array_sizeof(hdr))) return false;
+
+	*arr = hdr->buf;
+	return true;
+}
+
+static bool _GraphImage_PersistValue(SIValue *v) {
+	// value held inline
+	if(!(v->type & (T_STRING | T_ARRAY))) return true;
+
+	// a borrowed reference can't outlive this process
+	if(v->allocation != M_SELF) return false;
+
+	if(v->type == T_STRING) {
+		return _GraphImage_Adopt((void **)&v->stringval, strlen(v->stringval) + 1);
+	}
+
+	uint n = array_len(v->array);
+	for(uint i = 0; i < n; i++) {
+		if(!_GraphImage_PersistValue(v->array + i)) return false;
+	}
+	return _GraphImage_AdoptArray((void **)&v->array);
+}
+
+static bool _GraphImage_PersistEntity(Entity *e) {
+	if(e->properties == NULL) return true;
+
+	for(int i = 0; i < e->prop_count; i++) {
+		if(!_GraphImage_PersistValue(&e->properties[i].value)) return false;
+	}
+	// the adopted bag is sized to its content
+	e->prop_cap = e->prop_count;
+	return _GraphImage_Adopt((void **)&e->properties,
+			sizeof(EntityProperty) * e->prop_count);
+}
+
+static bool _GraphImage_PersistDataBlock(DataBlock *dataBlock, DataBlockImage *img) {
+	// property bags are moved while their blocks are still in place
+	uint64_t n = dataBlock->itemCount + DataBlock_DeletedItemsCount(dataBlock);
+	for(uint64_t i = 0; i < n; i++) {
+		Entity *e = DataBlock_GetItem(dataBlock, i);
+		if(e != NULL && !_GraphImage_PersistEntity(e)) return false;
+	}
+
+	size_t block_size = Block_Data_Size(dataBlock->itemSize, DATABLOCK_BLOCK_CAP);
+	for(uint i = 0; i < dataBlock->blockCount; i++) {
+		if(!_GraphImage_Adopt((void **)&dataBlock->blocks[i], block_size)) return false;
+		if(i > 0) dataBlock->blocks[i - 1]->next = dataBlock->blocks[i];
+	}
+
+	if(!_GraphImage_Adopt((void **)&dataBlock->blocks,
+				sizeof(Block *) * dataBlock->blockCount)) return false;
+	if(!_GraphImage_AdoptArray((void **)&dataBlock->deletedIdx)) return false;
+
+	img->itemCount = dataBlock->itemCount;
+	img->blockCount = dataBlock->blockCount;
+	img->itemSize = dataBlock->itemSize;
+	img->blocks = dataBlock->blocks;
+	img->deletedIdx = dataBlock->deletedIdx;
+	// label chains are rebuilt out of the blocks' labels on attach
+	img->clustered = DataBlock_IsClustered(dataBlock);
+	return true;
+}
+
+// export matrix and move its arrays into the heap
+// the matrix is consumed, its GrB_Matrix is freed
+static bool _GraphImage_PersistMatrix(RG_Matrix m, MatrixImage *img, bool relation) {
+	GrB_Type type;
+	GrB_Info info = GxB_Matrix_export_CSR(&m->grb_matrix, &type, &img->nrows,
+			&img->ncols, &img->Ap, &img->Aj, &img->Ax, &img->Ap_size,
+			&img->Aj_size, &img->Ax_size, &img->jumbled, NULL);
+	if(info != GrB_SUCCESS) return false;
+
+	img->relation = relation;
+	img->allow_multi_edge = m->allow_multi_edge;
+
+	size_t x_size = relation ? sizeof(uint64_t) : sizeof(bool);
+	if(!_GraphImage_Adopt((void **)&img->Ap, img->Ap_size * sizeof(GrB_Index))) return false;
+	if(!_GraphImage_Adopt((void **)&img->Aj, img->Aj_size * sizeof(GrB_Index))) return false;
+	if(!_GraphImage_Adopt(&img->Ax, img->Ax_size * x_size)) return false;
+
+	if(!relation) return true;
+
+	// entries with a clear MSB point to arrays of edge IDs
+	uint64_t *Ax = img->Ax;
+	GrB_Index nvals = img->Ap[img->nrows];
+	for(GrB_Index k = 0; k < nvals; k++) {
+		if(SINGLE_EDGE(Ax[k])) continue;
+		EdgeID *edges = (EdgeID *)Ax[k];
+		if(PHeap_Contains(MultiEdge_Allocation(edges))) continue;
+		edges = MultiEdge_Move(edges, PHeap_Malloc);
+		if(edges == NULL) return false;
+		Ax[k] = (uint64_t)edges;
+	}
+
+	return true;
+}
+
+static bool _GraphImage_PersistGraph(GraphContext *gc) {
+	char root[PHEAP_ROOT_NAME_LEN];
+	if(!_GraphImage_RootName(root, gc->graph_name)) return false;
+
+	Graph *g = gc->g;
+	Graph_ApplyAllPending(g);
+
+	GraphImage *img = PHeap_Calloc(1, sizeof(GraphImage));
+	if(img == NULL) return false;
+
+	img->save_id = image_id;
+	img->node_count = Graph_NodeCount(g);
+	img->edge_count = Graph_EdgeCount(g);
+	img->label_count = Graph_LabelTypeCount(g);
+	img->relation_count = Graph_RelationTypeCount(g);
+	img->has_transpose = _GraphImage_HasTranspose(g);
+
+	img->labels = PHeap_Calloc(img->label_count, sizeof(MatrixImage));
+	img->relations = PHeap_Calloc(img->relation_count, sizeof(MatrixImage));
+	if(img->labels == NULL || img->relations == NULL) return false;
+	if(img->has_transpose) {
+		img->t_relations = PHeap_Calloc(img->relation_count, sizeof(MatrixImage));
+		if(img->t_relations == NULL) return false;
+	}
+
+	if(!_GraphImage_PersistDataBlock(g->nodes, &img->nodes)) return false;
+	if(!_GraphImage_PersistDataBlock(g->edges, &img->edges)) return false;
+
+	if(!_GraphImage_PersistMatrix(g->adjacency_matrix, &img->adjacency, false)) return false;
+	if(!_GraphImage_PersistMatrix(g->_t_adjacency_matrix, &img->t_adjacency, false)) return false;
+
+	for(uint64_t i = 0; i < img->label_count; i++) {
+		if(!_GraphImage_PersistMatrix(g->labels[i], img->labels + i, false)) return false;
+	}
+
+	for(uint64_t i = 0; i < img->relation_count; i++) {
+		if(!_GraphImage_PersistMatrix(g->relations[i], img->relations + i, true)) return false;
+		if(img->has_transpose &&
+		   !_GraphImage_PersistMatrix(g->t_relations[i], img->t_relations + i, true)) return false;
+	}
+
+	return PHeap_SetRoot(root, img);
+}
+
+bool GraphImage_PersistAll(void) {
+	// images can't be told apart from a stale RDB without an identifier
+	if(!PHeap_IsOpen() || saved_id == 0) return false;
+
+	// images are stamped with an identifier of their own, which is handed to
+	// the next RDB saved, see GraphImage_SaveStarted
+	save_seq++;
+	image_id = XXH64(&saved_id, sizeof(saved_id), save_seq);
+	if(image_id == 0) image_id = 1;
+
+	// a partially persisted graph is unreachable, callers are expected to
+	// discard the heap on failure
+	uint graph_count = array_len(graphs_in_keyspace);
+	for(uint i = 0; i < graph_count; i++) {
+		if(!_GraphImage_PersistGraph(graphs_in_keyspace[i])) return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// attach
+//------------------------------------------------------------------------------
+
+static DataBlock *_GraphImage_RestoreDataBlock(DataBlockImage *img, fpDestructor fp) {
+	return DataBlock_Restore(img->blocks, img->blockCount, img->itemCount,
+			img->itemSize, img->deletedIdx, img->clustered, fp);
+}
+
+// replace the matrix's GrB_Matrix with the image
+static void _GraphImage_RestoreMatrix(RG_Matrix m, MatrixImage *img) {
+	GrB_Matrix_free(&m->grb_matrix);
+
+	// GraphBLAS takes ownership over the arrays
+	GrB_Type type = img->relation ? GrB_UINT64 : GrB_BOOL;
+	GrB_Info info = GxB_Matrix_import_CSR(&m->grb_matrix, type, img->nrows,
+			img->ncols, &img->Ap, &img->Aj, &img->Ax, img->Ap_size,
+			img->Aj_size, img->Ax_size, img->jumbled, NULL);
+	UNUSED(info);
+	ASSERT(info == GrB_SUCCESS);
+
+	// the matrix is restored fully merged, its deltas only need to match it
+	GxB_Matrix_resize(m->delta_plus, img->nrows, img->ncols);
+	GxB_Matrix_resize(m->delta_minus, img->nrows, img->ncols);
+
+	m->allow_multi_edge = img->allow_multi_edge;
+}
+
+// free the image's own metadata, its content is owned by someone else
+static void _GraphImage_FreeMeta(GraphImage *img) {
+	PHeap_Free(img->labels);
+	PHeap_Free(img->relations);
+	PHeap_Free(img->t_relations);
+	PHeap_Free(img);
+}
+
+static void _GraphImage_FreeMatrix(MatrixImage *img) {
+	if(img->relation) {
+		uint64_t *Ax = img->Ax;
+		GrB_Index nvals = img->Ap[img->nrows];
+		for(GrB_Index k = 0; k < nvals; k++) {
+			if(SINGLE_EDGE(Ax[k])) continue;
+			MultiEdge_Free((EdgeID *)Ax[k]);
+		}
+	}
+
+	nvm_free(img->Ap);
+	nvm_free(img->Aj);
+	nvm_free(img->Ax);
+}
+
+static void _GraphImage_FreeDataBlock(DataBlockImage *img) {
+	DataBlock *dataBlock = _GraphImage_RestoreDataBlock(img, (fpDestructor)FreeEntity);
+
+	Entity *e;
+	DataBlockIterator *it = DataBlock_Scan(dataBlock);
+	while((e = DataBlockIterator_Next(it, NULL)) != NULL) FreeEntity(e);
+	DataBlockIterator_Free(it);
+
+	DataBlock_Free(dataBlock);
+}
+
+// free an image which won't be attached
+static void _GraphImage_Free(GraphImage *img) {
+	_GraphImage_FreeDataBlock(&img->nodes);
+	_GraphImage_FreeDataBlock(&img->edges);
+
+	_GraphImage_FreeMatrix(&img->adjacency);
+	_GraphImage_FreeMatrix(&img->t_adjacency);
+	for(uint64_t i = 0; i < img->label_count; i++) {
+		_GraphImage_FreeMatrix(img->labels + i);
+	}
+	for(uint64_t i = 0; i < img->relation_count; i++) {
+		_GraphImage_FreeMatrix(img->relations + i);
+		if(img->has_transpose) _GraphImage_FreeMatrix(img->t_relations + i);
+	}
+
+	_GraphImage_FreeMeta(img);
+}
+
+void GraphImage_AllowAttach(bool allow) {
+	attach_allowed = allow;
+	// the identifier is read from the aux data of the next RDB loaded
+	load_id = 0;
+}
+
+bool GraphImage_Attach(Graph *g, const char *name, uint64_t node_count,
+		uint64_t edge_count, uint64_t label_count, uint64_t relation_count) {
+	ASSERT(g != NULL && name != NULL);
+
+	if(!attach_allowed || !PHeap_IsOpen()) return false;
+
+	char root[PHEAP_ROOT_NAME_LEN];
+	if(!_GraphImage_RootName(root, name)) return false;
+
+	GraphImage *img = PHeap_GetRoot(root);
+	if(img == NULL) return false;
+	PHeap_SetRoot(root, NULL);
+
+	// the image must have been saved alongside the RDB being loaded,
+	// describe the graph being loaded and share its node layout
+	bool has_transpose = _GraphImage_HasTranspose(g);
+	if(load_id == 0 || img->save_id != load_id ||
+	   img->node_count != node_count || img->edge_count != edge_count ||
+	   img->label_count != label_count || img->relation_count != relation_count ||
+	   img->has_transpose != has_transpose ||
+	   img->nodes.clustered != DataBlock_IsClustered(g->nodes) || Graph_NodeCount(g) != 0 ||
+	   Graph_LabelTypeCount(g) != 0 || Graph_RelationTypeCount(g) != 0) {
+		_GraphImage_Free(img);
+		return false;
+	}
+
+	fpDestructor node_destructor = g->nodes->destructor;
+	fpDestructor edge_destructor = g->edges->destructor;
+	DataBlock_Free(g->nodes);
+	DataBlock_Free(g->edges);
+	g->nodes = _GraphImage_RestoreDataBlock(&img->nodes, node_destructor);
+	g->edges = _GraphImage_RestoreDataBlock(&img->edges, edge_destructor);
+
+	_GraphImage_RestoreMatrix(g->adjacency_matrix, &img->adjacency);
+	_GraphImage_RestoreMatrix(g->_t_adjacency_matrix, &img->t_adjacency);
+
+	for(uint64_t i = 0; i < label_count; i++) {
+		int l = Graph_AddLabel(g);
+		_GraphImage_RestoreMatrix(g->labels[l], img->labels + i);
+		// label matrices are iterated by LabelScan, see Graph_AddLabel
+		GxB_set(g->labels[l]->grb_matrix, GxB_SPARSITY_CONTROL, GxB_SPARSE);
+	}
+
+	for(uint64_t i = 0; i < relation_count; i++) {
+		int r = Graph_AddRelationType(g);
+		_GraphImage_RestoreMatrix(g->relations[r], img->relations + i);
+		if(has_transpose) _GraphImage_RestoreMatrix(g->t_relations[r], img->t_relations + i);
+	}
+
+	// label bitmaps are kept in DRAM, rebuild them from the label matrices
+	Graph_RebuildLabelBitmaps(g);
+
+	_GraphImage_FreeMeta(img);
+	return true;
+}
+
+void GraphImage_DropAll(void) {
+	if(!PHeap_IsOpen()) return;
+
+	size_t prefix_len = strlen(GRAPH_IMAGE_ROOT_PREFIX);
+	for(int i = 0; i < PHEAP_ROOT_CAP; i++) {
+		void *img;
+		const char *name;
+		if(!PHeap_RootAt(i, &name, &img)) continue;
+		if(strncmp(name, GRAPH_IMAGE_ROOT_PREFIX, prefix_len) != 0) continue;
+
+		PHeap_SetRoot(name, NULL);
+		_GraphImage_Free(img);
+	}
+}
+
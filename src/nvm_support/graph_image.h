@@ -0,0 +1,73 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../graph/graph.h"
+
+/* Graph images allow a restarted server to re-attach its graphs from the
+ * persistent heap (see pheap.h) rather than rebuilding them from the RDB
+ *
+ * on shutdown, once the dataset was saved to an RDB, every graph's
+ * DataBlocks, property bags and matrix arrays are moved into the heap and
+ * bound to a root named after the graph, the heap is synced and the RDB is
+ * saved once more, this time without entity payloads: each graph is reduced
+ * to its header and schema, the header marking the entities as omitted
+ *
+ * every RDB save is assigned an identifier, derived from the server's run id
+ * and a save sequence, which is written into the RDB's aux data, images are
+ * stamped with the identifier of the payload-less RDB saved right after them
+ *
+ * on load, a graph whose entities were omitted looks up its image, the image
+ * must be stamped with the identifier of the RDB being loaded and agree with
+ * the graph's header (entity, label and relation counts), otherwise the
+ * graph can't be restored and loading fails, graphs saved with their
+ * entities are always decoded
+ *
+ * images are only attached while loading the RDB at startup, images left
+ * unattached once loading ends are released */
+
+#define GRAPH_IMAGE_ROOT_PREFIX "graph:"
+
+// an RDB save started, assigns it an identifier derived from 'run_id'
+// saves which aren't RDB files (e.g. AOF rewrites) pass NULL and get none
+void GraphImage_SaveStarted(const char *run_id);
+
+// the last started save ended, images refer to it only if 'saved'
+void GraphImage_SaveEnded(bool saved);
+
+// identifier of the save in progress, 0 if it has none
+uint64_t GraphImage_SaveID(void);
+
+// returns true if the save in progress is the one the persisted images
+// belong to, such a save omits the graphs' entities
+bool GraphImage_SavingImages(void);
+
+// identifier of the RDB being loaded, as read from its aux data
+void GraphImage_SetLoadID(uint64_t save_id);
+
+// move every graph in the keyspace into the persistent heap
+// images are stamped with the identifier of the next RDB saved, which is
+// expected to omit the graphs' entities, see GraphImage_SavingImages
+// expects no concurrent access to the graphs, returns false if any graph
+// couldn't be persisted
+bool GraphImage_PersistAll(void);
+
+// enable or disable attaching images, see GraphImage_Attach
+void GraphImage_AllowAttach(bool allow);
+
+// attach the image of graph 'name' to the freshly created graph 'g'
+// the image is used only if it was stamped with the identifier of the RDB
+// being loaded and matches the given counts, it is consumed
+// either way, returns true if 'g' was populated from the image
+bool GraphImage_Attach(Graph *g, const char *name, uint64_t node_count,
+		uint64_t edge_count, uint64_t label_count, uint64_t relation_count);
+
+// release all images which were not attached
+void GraphImage_DropAll(void);
+
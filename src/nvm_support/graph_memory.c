@@ -0,0 +1,272 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "graph_memory.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/entities/multi_edge.h"
+
+static const char *category_names[GRAPH_MEMORY_CATEGORY_COUNT] = {
+	"nodes",
+	"edges",
+	"properties",
+	"labels",
+	"relations",
+	"transposes",
+	"indexes",
+	"plan_cache"
+};
+
+const char *GraphMemory_CategoryName(GraphMemory_Category c) {
+	ASSERT(c < GRAPH_MEMORY_CATEGORY_COUNT);
+	return category_names[c];
+}
+
+// account an arr.h array
+static void _GraphMemory_AddArray(NVM_Usage *usage, void *arr) {
+	if(arr == NULL) return;
+	nvm_usage_add(usage, array_hdr(arr));
+}
+
+//------------------------------------------------------------------------------
+// entities
+//------------------------------------------------------------------------------
+
+static void _GraphMemory_AddValue(NVM_Usage *usage, const SIValue *v) {
+	// borrowed references are accounted by their owner
+	if(v->allocation != M_SELF) return;
+
+	if(v->type == T_STRING) {
+		nvm_usage_add(usage, v->stringval);
+	} else if(v->type == T_ARRAY) {
+		uint n = array_len(v->array);
+		for(uint i = 0; i < n; i++) _GraphMemory_AddValue(usage, v->array + i);
+		_GraphMemory_AddArray(usage, v->array);
+	}
+}
+
+static void _GraphMemory_AddDataBlock(GraphMemory *mem, const DataBlock *dataBlock,
+		GraphMemory_Category c) {
+	NVM_Usage *usage = mem->usage + c;
+	NVM_Usage *properties = mem->usage + GRAPH_MEMORY_PROPERTIES;
+
+	nvm_usage_add(usage, (void *)dataBlock);
+	nvm_usage_add(usage, dataBlock->blocks);
+	for(uint i = 0; i < dataBlock->blockCount; i++) {
+		nvm_usage_add(usage, dataBlock->blocks[i]);
+	}
+	_GraphMemory_AddArray(usage, dataBlock->deletedIdx);
+
+	// label chains of a DataBlock clustered by label
+	uint chain_count = array_len(dataBlock->chains);
+	for(uint i = 0; i < chain_count; i++) {
+		_GraphMemory_AddArray(usage, dataBlock->chains[i].deletedIdx);
+	}
+	_GraphMemory_AddArray(usage, dataBlock->chains);
+
+	Entity *e;
+	DataBlockIterator *it = DataBlock_Scan(dataBlock);
+	while((e = (Entity *)DataBlockIterator_Next(it, NULL)) != NULL) {
+		if(e->properties == NULL) continue;
+		for(int i = 0; i < e->prop_count; i++) {
+			_GraphMemory_AddValue(properties, &e->properties[i].value);
+		}
+		nvm_usage_add(properties, e->properties);
+	}
+	DataBlockIterator_Free(it);
+}
+
+//------------------------------------------------------------------------------
+// matrices
+//------------------------------------------------------------------------------
+
+// estimate the storage of 'm' according to its sparsity structure
+static void _GraphMemory_AddMatrix(NVM_Usage *usage, GrB_Matrix m) {
+	int sparsity;
+	size_t type_size;
+	GrB_Type type;
+	GrB_Index nrows;
+	GrB_Index ncols;
+	GrB_Index nvals;
+
+	GrB_Matrix_nrows(&nrows, m);
+	GrB_Matrix_ncols(&ncols, m);
+	GrB_Matrix_nvals(&nvals, m);
+	GxB_Matrix_type(&type, m);
+	GxB_Type_size(&type_size, type);
+	GxB_Matrix_Option_get(m, GxB_SPARSITY_STATUS, &sparsity);
+
+	size_t idx_size = sizeof(GrB_Index);
+	switch(sparsity) {
+	case GxB_FULL:
+		nvm_usage_add_estimate(usage, NVM_CLASS_MATRIX, nrows * ncols * type_size);
+		break;
+	case GxB_BITMAP:
+		nvm_usage_add_estimate(usage, NVM_CLASS_MATRIX, nrows * ncols);
+		nvm_usage_add_estimate(usage, NVM_CLASS_MATRIX, nrows * ncols * type_size);
+		break;
+	case GxB_HYPERSPARSE: {
+		// a hypersparse matrix holds at most one vector per entry
+		GrB_Index nvec = (nvals < nrows) ? nvals : nrows;
+		nvm_usage_add_estimate(usage, NVM_CLASS_MATRIX, nvec * idx_size);
+		nvm_usage_add_estimate(usage, NVM_CLASS_MATRIX, (nvec + 1) * idx_size);
+		nvm_usage_add_estimate(usage, NVM_CLASS_MATRIX, nvals * idx_size);
+		nvm_usage_add_estimate(usage, NVM_CLASS_MATRIX, nvals * type_size);
+		break;
+	}
+	default:
+		nvm_usage_add_estimate(usage, NVM_CLASS_MATRIX, (nrows + 1) * idx_size);
+		nvm_usage_add_estimate(usage, NVM_CLASS_MATRIX, nvals * idx_size);
+		nvm_usage_add_estimate(usage, NVM_CLASS_MATRIX, nvals * type_size);
+		break;
+	}
+}
+
+// account the multi-edge arrays referenced by a relation matrix
+static void _GraphMemory_AddEdgeArrays(NVM_Usage *usage, GrB_Matrix m) {
+	GrB_Index nvals;
+	GrB_Matrix_nvals(&nvals, m);
+	if(nvals == 0) return;
+
+	uint64_t *edge_ids = rm_malloc(sizeof(uint64_t) * nvals);
+	GrB_Matrix_extractTuples_UINT64(NULL, NULL, edge_ids, &nvals, m);
+	for(GrB_Index i = 0; i < nvals; i++) {
+		// entries with a clear MSB point to arrays of edge IDs
+		if(SINGLE_EDGE(edge_ids[i])) continue;
+		EdgeID *ids = (EdgeID *)edge_ids[i];
+		void *allocation = MultiEdge_Allocation(ids);
+		// slab slots are accounted by their size
+		if(allocation != NULL) nvm_usage_add(usage, allocation);
+		else nvm_usage_add_estimate(usage, NVM_CLASS_SCRATCH, MultiEdge_SizeOf(ids));
+	}
+	rm_free(edge_ids);
+}
+
+// account a matrix and its deltas
+static void _GraphMemory_AddRGMatrix(NVM_Usage *usage, RG_Matrix rm, bool relation) {
+	_GraphMemory_AddMatrix(usage, rm->grb_matrix);
+	_GraphMemory_AddMatrix(usage, rm->delta_plus);
+	_GraphMemory_AddMatrix(usage, rm->delta_minus);
+
+	if(!relation || !rm->allow_multi_edge) return;
+
+	// edge arrays are referenced by either M or DP
+	_GraphMemory_AddEdgeArrays(usage, rm->grb_matrix);
+	_GraphMemory_AddEdgeArrays(usage, rm->delta_plus);
+}
+
+static void _GraphMemory_AddMatrices(GraphMemory *mem, const Graph *g) {
+	NVM_Usage *labels = mem->usage + GRAPH_MEMORY_LABELS;
+	NVM_Usage *relations = mem->usage + GRAPH_MEMORY_RELATIONS;
+	NVM_Usage *transposes = mem->usage + GRAPH_MEMORY_TRANSPOSES;
+
+	_GraphMemory_AddRGMatrix(relations, g->adjacency_matrix, false);
+	_GraphMemory_AddRGMatrix(transposes, g->_t_adjacency_matrix, false);
+
+	int label_count = Graph_LabelTypeCount(g);
+	for(int i = 0; i < label_count; i++) {
+		_GraphMemory_AddRGMatrix(labels, g->labels[i], false);
+		nvm_usage_add(labels, g->label_bitmaps[i]);
+	}
+	_GraphMemory_AddArray(labels, g->label_bitmaps);
+
+	int relation_count = Graph_RelationTypeCount(g);
+	for(int i = 0; i < relation_count; i++) {
+		_GraphMemory_AddRGMatrix(relations, g->relations[i], true);
+		// lazily built transposed matrices may not be built
+		if(g->t_relations == NULL || g->t_relations[i] == NULL) continue;
+		_GraphMemory_AddRGMatrix(transposes, g->t_relations[i], true);
+	}
+}
+
+//------------------------------------------------------------------------------
+// indexes, columns and plan cache
+//------------------------------------------------------------------------------
+
+static void _GraphMemory_AddIndex(NVM_Usage *usage, const Index *idx) {
+	if(idx == NULL) return;
+
+	nvm_usage_add(usage, (void *)idx);
+	nvm_usage_add(usage, idx->label);
+	for(uint i = 0; i < idx->fields_count; i++) {
+		nvm_usage_add(usage, idx->fields[i]);
+	}
+	_GraphMemory_AddArray(usage, idx->fields);
+	_GraphMemory_AddArray(usage, idx->fields_ids);
+}
+
+static void _GraphMemory_AddIndexes(NVM_Usage *usage, const GraphContext *gc) {
+	uint n = array_len(gc->node_schemas);
+	for(uint i = 0; i < n; i++) {
+		Schema *s = gc->node_schemas[i];
+		_GraphMemory_AddIndex(usage, s->index);
+		_GraphMemory_AddIndex(usage, s->fulltextIdx);
+	}
+}
+
+// columns are copies of properties
+static void _GraphMemory_AddColumns(NVM_Usage *usage, const GraphContext *gc) {
+	uint n = array_len(gc->node_schemas);
+	for(uint i = 0; i < n; i++) {
+		Schema *s = gc->node_schemas[i];
+		uint column_count = array_len(s->columns);
+		for(uint j = 0; j < column_count; j++) {
+			PropertyColumn *c = s->columns[j];
+			nvm_usage_add(usage, c);
+			nvm_usage_add(usage, c->values);
+			nvm_usage_add(usage, c->valid);
+			nvm_usage_add(usage, c->floats);
+			nvm_usage_add(usage, c->spilled);
+		}
+		_GraphMemory_AddArray(usage, s->columns);
+	}
+}
+
+static void _GraphMemory_AddCache(NVM_Usage *usage, Cache *cache) {
+	if(cache == NULL) return;
+
+	pthread_rwlock_rdlock(&cache->_cache_rwlock);
+	nvm_usage_add(usage, cache);
+	nvm_usage_add(usage, cache->arr);
+	for(uint i = 0; i < cache->size; i++) {
+		nvm_usage_add(usage, cache->arr[i].key);
+		nvm_usage_add(usage, cache->arr[i].value);
+	}
+	pthread_rwlock_unlock(&cache->_cache_rwlock);
+}
+
+//------------------------------------------------------------------------------
+// API
+//------------------------------------------------------------------------------
+
+void GraphMemory_Collect(GraphContext *gc, GraphMemory *mem) {
+	ASSERT(gc != NULL);
+	ASSERT(mem != NULL);
+
+	Graph *g = gc->g;
+	Graph_AcquireReadLock(g);
+
+	_GraphMemory_AddDataBlock(mem, g->nodes, GRAPH_MEMORY_NODES);
+	_GraphMemory_AddDataBlock(mem, g->edges, GRAPH_MEMORY_EDGES);
+	_GraphMemory_AddMatrices(mem, g);
+	_GraphMemory_AddIndexes(mem->usage + GRAPH_MEMORY_INDEXES, gc);
+	_GraphMemory_AddColumns(mem->usage + GRAPH_MEMORY_PROPERTIES, gc);
+
+	Graph_ReleaseLock(g);
+
+	_GraphMemory_AddCache(mem->usage + GRAPH_MEMORY_PLAN_CACHE, gc->cache);
+}
+
+NVM_Usage GraphMemory_Total(const GraphMemory *mem) {
+	NVM_Usage total = {0};
+	for(int c = 0; c < GRAPH_MEMORY_CATEGORY_COUNT; c++) {
+		total.dram += mem->usage[c].dram;
+		total.pmem += mem->usage[c].pmem;
+	}
+	return total;
+}
+
@@ -0,0 +1,49 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "nvm.h"
+#include "../graph/graphcontext.h"
+
+/* GraphMemory breaks down the memory held by a graph per category and kind
+ *
+ * allocations are attributed to DRAM or PMEM by address (see nvm_usage_add)
+ * GraphBLAS matrices are opaque, their size is derived from their dimensions,
+ * entry count and storage format and attributed following the MATRIX
+ * placement, multi-edge arrays are accounted by address
+ *
+ * indexes only account for the index descriptors, the RediSearch indices
+ * themselves are owned and accounted by RediSearch
+ * the plan cache accounts for its entries, not for the cached plans */
+
+typedef enum {
+	GRAPH_MEMORY_NODES = 0,       // node DataBlock
+	GRAPH_MEMORY_EDGES,           // edge DataBlock
+	GRAPH_MEMORY_PROPERTIES,      // property bags and values
+	GRAPH_MEMORY_LABELS,          // label matrices
+	GRAPH_MEMORY_RELATIONS,       // adjacency and relation matrices
+	GRAPH_MEMORY_TRANSPOSES,      // transposed adjacency and relation matrices
+	GRAPH_MEMORY_INDEXES,         // index descriptors
+	GRAPH_MEMORY_PLAN_CACHE,      // execution plan cache
+	GRAPH_MEMORY_CATEGORY_COUNT
+} GraphMemory_Category;
+
+typedef struct {
+	NVM_Usage usage[GRAPH_MEMORY_CATEGORY_COUNT];  // bytes per category
+} GraphMemory;
+
+// returns category name
+const char *GraphMemory_CategoryName(GraphMemory_Category c);
+
+// accumulate memory held by 'gc' into 'mem'
+// acquires the graph's read lock, cost is linear in the number of entities
+// as such it is only called by GRAPH.MEMORY, on a reader thread
+void GraphMemory_Collect(GraphContext *gc, GraphMemory *mem);
+
+// total bytes held on each kind
+NVM_Usage GraphMemory_Total(const GraphMemory *mem);
+
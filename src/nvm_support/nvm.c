@@ -1,26 +1,82 @@
 #include "nvm.h"
-#ifndef INDEPENDENT_TEST
+#include "pheap.h"
+#include <numa.h>
+#include <numaif.h>
+#include <errno.h>
+#include <unistd.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/sysinfo.h>
+
 struct memkind *pmem_kind = NULL;
 
-void init_memkind() {
-    char nvm_path[32] = "/home/yuxiuyuan/mnt";
+// every class defaults to DRAM
+NVM_Placement nvm_placement[NVM_CLASS_COUNT] = {
+	NVM_PLACEMENT_DRAM, NVM_PLACEMENT_DRAM, NVM_PLACEMENT_DRAM, NVM_PLACEMENT_DRAM
+};
+
+// threshold of NVM_PLACEMENT_THRESHOLD
+static size_t nvm_alloc_threshold = ALLOC_THRESHOLD_DEFAULT;
+static bool nvm_threshold_adaptive = false;
+
+// size-class histogram of threshold allocations, reset on tuning
+static uint64_t nvm_size_class_allocs[NVM_SIZE_CLASS_COUNT];
+static uint64_t nvm_size_class_bytes[NVM_SIZE_CLASS_COUNT];
+
+// page size and NUMA policy of DATABLOCK and MATRIX allocations on DRAM
+static NVM_Pages nvm_pages = NVM_PAGES_DEFAULT;
+static NVM_Numa nvm_numa = NVM_NUMA_DEFAULT;
+static struct bitmask *nvm_numa_nodes = NULL;  // NULL for every node
+
+// set once an allocation was served from hugetlb pages, from then on
+// DRAM allocations are no longer assumed to belong to MEMKIND_DEFAULT
+static bool nvm_hugetlb_used = false;
+
+// cross-kind copies performed by nvm_class_realloc
+static uint64_t nvm_realloc_migrations = 0;
+static uint64_t nvm_numa_failures = 0;
+// DRAM allocations served from regular pages for lack of reserved hugepages
+static uint64_t nvm_hugetlb_fallbacks = 0;
+static uint64_t nvm_realloc_migrated_bytes = 0;
+
+int init_memkind(const char *nvm_path, size_t pool_size) {
+    // a non-DAX path (e.g. tmpfs) is still usable as a file-backed pool
     int status = memkind_check_dax_path(nvm_path);
     if (!status) {
         fprintf(stdout, "PMEM kind %s is on DAX-enabled file system.\n", nvm_path);
     } else {
         fprintf(stdout, "PMEM kind %s is not on DAX-enabled file system.\n",
                 nvm_path);
-        exit(222);
     }
-    int err = memkind_create_pmem(nvm_path, (64LL << 30), &pmem_kind);
-    if (err) fprintf(stdout, "Fail to create PMEM pool !\n");
-    else fprintf(stdout, "PMEM pool created !\n");
+    int err = memkind_create_pmem(nvm_path, pool_size, &pmem_kind);
+    if (err) pmem_kind = NULL;
+    return err;
 }
 
 void set_memkind(void* kind_to_set) {
     pmem_kind = (struct memkind *)kind_to_set;
 }
 
+int nvm_attach_heap(const char *heap_path, size_t heap_size) {
+    return PHeap_Open(heap_path, heap_size) ? 0 : -1;
+}
+
+void nvm_detach_heap(bool clean) {
+    PHeap_Close(clean);
+}
+
+// move 'p' out of the persistent heap into an allocation of class 'cls'
+static void *_nvm_heap_realloc(NVM_AllocClass cls, void *p, size_t n) {
+    size_t usable = PHeap_UsableSize(p);
+    if (n <= usable) return p;
+
+    void *np = nvm_class_malloc(cls, n);
+    if (!np) return NULL;
+    memcpy(np, p, usable);
+    PHeap_Free(p);
+    return np;
+}
+
 void* dram_malloc(size_t size) {
     return memkind_malloc(MEMKIND_DEFAULT, size);
 }
@@ -37,48 +93,507 @@ void dram_free(void* ptr) {
     memkind_free(MEMKIND_DEFAULT, ptr);
 }
 
+// returns the kind 'p' was allocated from
+static inline struct memkind *_nvm_detect_kind(void *p) {
+    if (!pmem_kind && !nvm_hugetlb_used) return MEMKIND_DEFAULT;
+    return memkind_detect_kind(p);
+}
+
 int is_nvm_addr(void* ptr) {
+    if (PHeap_Contains(ptr)) return 1;
+    if (!pmem_kind || !ptr) return 0;
     struct memkind *temp_kind = memkind_detect_kind(ptr);
-    return (temp_kind != MEMKIND_DEFAULT);
+    return (temp_kind == pmem_kind);
 }
 
 void* nvm_malloc(size_t size) {
-#ifdef NVM_THRESHOLD
-    if (size < ALLOC_THRESHOLD) return dram_malloc(size);
-#endif
+    if (!pmem_kind) return dram_malloc(size);
     return memkind_malloc(pmem_kind, size);
 }
 
 void* nvm_calloc(size_t nelem, size_t elemsz) {
-#ifdef NVM_THRESHOLD
-    if (nelem * elemsz < ALLOC_THRESHOLD) return dram_calloc(nelem, elemsz);
-#endif
+    if (!pmem_kind) return dram_calloc(nelem, elemsz);
     return memkind_calloc(pmem_kind, nelem, elemsz);
 }
 
 void* nvm_realloc(void *p, size_t n) {
+    if (PHeap_Contains(p)) return _nvm_heap_realloc(NVM_CLASS_SCRATCH, p, n);
+    if (!pmem_kind && !nvm_hugetlb_used) return dram_realloc(p, n);
+    if (!p) return nvm_class_malloc(NVM_CLASS_SCRATCH, n);
     struct memkind *temp_kind = memkind_detect_kind(p);
-#ifdef NVM_THRESHOLD
-    void *tp = memkind_realloc(temp_kind, p, n);
-    if (temp_kind == MEMKIND_DEFAULT ^ n < ALLOC_THRESHOLD) {
-        void *np = nvm_malloc(n);
-        memcpy(np, tp, n);
-        nvm_free(tp);
-        return np;
-    } else return tp;
-#else
     return memkind_realloc(temp_kind, p, n);
-#endif
 }
 
 void nvm_free(void* ptr) {
+    // graphs re-attached from the persistent heap are freed back into it
+    if (PHeap_Contains(ptr)) {
+        PHeap_Free(ptr);
+        return;
+    }
+    if (!pmem_kind && !nvm_hugetlb_used) {
+        dram_free(ptr);
+        return;
+    }
+    if (!ptr) return;
     struct memkind *temp_kind = memkind_detect_kind(ptr);
     memkind_free(temp_kind, ptr);
 }
 
 int fin_memkind() {
+    if (!pmem_kind) return 0;
     int err = memkind_destroy_kind(pmem_kind);
+    pmem_kind = NULL;
     return err;
 }
 
-#endif
+//------------------------------------------------------------------------------
+// placement
+//------------------------------------------------------------------------------
+
+void nvm_set_placement(NVM_AllocClass cls, NVM_Placement placement) {
+    nvm_placement[cls] = placement;
+}
+
+NVM_Placement nvm_get_placement(NVM_AllocClass cls) {
+    return nvm_placement[cls];
+}
+
+bool nvm_placement_parse(const char *str, NVM_Placement *placement) {
+    if (!strcasecmp(str, "DRAM")) *placement = NVM_PLACEMENT_DRAM;
+    else if (!strcasecmp(str, "PMEM")) *placement = NVM_PLACEMENT_PMEM;
+    else if (!strcasecmp(str, "THRESHOLD")) *placement = NVM_PLACEMENT_THRESHOLD;
+    else return false;
+    return true;
+}
+
+const char *nvm_placement_name(NVM_Placement placement) {
+    switch (placement) {
+        case NVM_PLACEMENT_DRAM:
+            return "DRAM";
+        case NVM_PLACEMENT_PMEM:
+            return "PMEM";
+        case NVM_PLACEMENT_THRESHOLD:
+            return "THRESHOLD";
+        default:
+            return NULL;
+    }
+}
+
+//------------------------------------------------------------------------------
+// page size & NUMA
+//------------------------------------------------------------------------------
+
+void nvm_set_pages(NVM_Pages pages) {
+    nvm_pages = pages;
+}
+
+NVM_Pages nvm_get_pages(void) {
+    return nvm_pages;
+}
+
+bool nvm_pages_parse(const char *str, NVM_Pages *pages) {
+    if (!strcasecmp(str, "NO")) *pages = NVM_PAGES_DEFAULT;
+    else if (!strcasecmp(str, "THP")) *pages = NVM_PAGES_THP;
+    else if (!strcasecmp(str, "HUGETLB")) *pages = NVM_PAGES_HUGETLB;
+    else return false;
+    return true;
+}
+
+const char *nvm_pages_name(NVM_Pages pages) {
+    switch (pages) {
+        case NVM_PAGES_DEFAULT:
+            return "NO";
+        case NVM_PAGES_THP:
+            return "THP";
+        case NVM_PAGES_HUGETLB:
+            return "HUGETLB";
+        default:
+            return NULL;
+    }
+}
+
+void nvm_set_numa(NVM_Numa numa) {
+    nvm_numa = numa;
+}
+
+NVM_Numa nvm_get_numa(void) {
+    return nvm_numa;
+}
+
+bool nvm_numa_parse(const char *str, NVM_Numa *numa) {
+    if (!strcasecmp(str, "DEFAULT")) *numa = NVM_NUMA_DEFAULT;
+    else if (!strcasecmp(str, "BIND")) *numa = NVM_NUMA_BIND;
+    else if (!strcasecmp(str, "INTERLEAVE")) *numa = NVM_NUMA_INTERLEAVE;
+    else return false;
+    return true;
+}
+
+const char *nvm_numa_name(NVM_Numa numa) {
+    switch (numa) {
+        case NVM_NUMA_DEFAULT:
+            return "DEFAULT";
+        case NVM_NUMA_BIND:
+            return "BIND";
+        case NVM_NUMA_INTERLEAVE:
+            return "INTERLEAVE";
+        default:
+            return NULL;
+    }
+}
+
+bool nvm_numa_available(void) {
+    return numa_available() != -1;
+}
+
+bool nvm_set_numa_nodes(const char *nodes) {
+    struct bitmask *mask = NULL;
+    if (nodes) {
+        if (!nvm_numa_available()) return false;
+        mask = numa_parse_nodestring(nodes);
+        if (!mask) return false;
+    }
+
+    if (nvm_numa_nodes) numa_bitmask_free(nvm_numa_nodes);
+    nvm_numa_nodes = mask;
+    return true;
+}
+
+// returns true if DRAM allocations of class 'cls' follow the page size and
+// NUMA policy
+static inline bool _nvm_class_paged(NVM_AllocClass cls) {
+    return (cls == NVM_CLASS_DATABLOCK || cls == NVM_CLASS_MATRIX);
+}
+
+// returns the kind DRAM allocations of class 'cls' are served from
+static inline struct memkind *_nvm_dram_kind(NVM_AllocClass cls) {
+    if (_nvm_class_paged(cls) && nvm_pages == NVM_PAGES_HUGETLB) return MEMKIND_HUGETLB;
+    return MEMKIND_DEFAULT;
+}
+
+// advise transparent hugepages over the hugepages [p, p + size) spans entirely
+static void _nvm_advise_thp(void *p, size_t size) {
+    uintptr_t start = ((uintptr_t)p + NVM_HUGEPAGE_SIZE - 1) & ~(NVM_HUGEPAGE_SIZE - 1);
+    uintptr_t end = ((uintptr_t)p + size) & ~(NVM_HUGEPAGE_SIZE - 1);
+    if (start < end) madvise((void *)start, end - start, MADV_HUGEPAGE);
+}
+
+// apply NUMA policy to the pages of [p, p + size)
+// hugetlb pages are only shared with allocations following the same policy,
+// as such every page the range touches is bound, otherwise pages shared with
+// neighbouring allocations are left alone
+static void _nvm_apply_numa(void *p, size_t size, bool hugetlb) {
+    if (!nvm_numa_available()) return;
+
+    uintptr_t page = hugetlb ? NVM_HUGEPAGE_SIZE : (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)p & ~(page - 1);
+    uintptr_t end = ((uintptr_t)p + size + page - 1) & ~(page - 1);
+    if (!hugetlb) {
+        start = ((uintptr_t)p + page - 1) & ~(page - 1);
+        end = ((uintptr_t)p + size) & ~(page - 1);
+    }
+    if (start >= end) return;
+
+    struct bitmask *nodes = nvm_numa_nodes ? nvm_numa_nodes : numa_all_nodes_ptr;
+    int mode = (nvm_numa == NVM_NUMA_BIND) ? MPOL_BIND : MPOL_INTERLEAVE;
+    // pages may have been touched by a previous owner, move them to the policy's nodes
+    if (mbind((void *)start, end - start, mode, nodes->maskp, nodes->size + 1,
+              MPOL_MF_MOVE) == 0) return;
+
+    // report the first failure, count all of them (see INFO allocator)
+    if (__atomic_fetch_add(&nvm_numa_failures, 1, __ATOMIC_RELAXED) == 0) {
+        fprintf(stderr, "NUMA policy could not be applied to %zu bytes: %s\n",
+                (size_t)(end - start), strerror(errno));
+    }
+}
+
+// reserved hugepages exhausted, fall back to regular pages
+static inline struct memkind *_nvm_hugetlb_fallback(void) {
+    __atomic_fetch_add(&nvm_hugetlb_fallbacks, 1, __ATOMIC_RELAXED);
+    return MEMKIND_DEFAULT;
+}
+
+// apply page size advice and NUMA policy to allocation 'p' served from 'kind'
+static void _nvm_apply_policy(NVM_AllocClass cls, struct memkind *kind, void *p, size_t size) {
+    if (!p || kind == pmem_kind || !_nvm_class_paged(cls)) return;
+
+    if (kind == MEMKIND_HUGETLB) nvm_hugetlb_used = true;
+    else if (nvm_pages == NVM_PAGES_THP) _nvm_advise_thp(p, size);
+
+    if (nvm_numa != NVM_NUMA_DEFAULT) _nvm_apply_numa(p, size, kind == MEMKIND_HUGETLB);
+}
+
+//------------------------------------------------------------------------------
+// threshold
+//------------------------------------------------------------------------------
+
+void nvm_set_threshold(size_t threshold) {
+    nvm_alloc_threshold = threshold;
+}
+
+size_t nvm_get_threshold(void) {
+    return nvm_alloc_threshold;
+}
+
+void nvm_set_threshold_adaptive(bool adaptive) {
+    nvm_threshold_adaptive = adaptive;
+}
+
+bool nvm_get_threshold_adaptive(void) {
+    return nvm_threshold_adaptive;
+}
+
+static inline int _nvm_size_class(size_t size) {
+    if (size < 8) return 0;
+    int c = (63 - __builtin_clzll(size)) - 2;
+    return (c < NVM_SIZE_CLASS_COUNT) ? c : NVM_SIZE_CLASS_COUNT - 1;
+}
+
+size_t nvm_size_class_limit(int c) {
+    return (c == NVM_SIZE_CLASS_COUNT - 1) ? SIZE_MAX : ((size_t)8 << c);
+}
+
+// DRAM available to the process, free memory plus buffers
+static size_t _nvm_dram_headroom(void) {
+    struct sysinfo info;
+    if (sysinfo(&info) != 0) return 0;
+    return (size_t)(info.freeram + info.bufferram) * info.mem_unit;
+}
+
+void nvm_tune_threshold(void) {
+    uint64_t bytes[NVM_SIZE_CLASS_COUNT];
+    uint64_t total = 0;
+    for (int c = 0; c < NVM_SIZE_CLASS_COUNT; c++) {
+        __atomic_store_n(&nvm_size_class_allocs[c], 0, __ATOMIC_RELAXED);
+        bytes[c] = __atomic_exchange_n(&nvm_size_class_bytes[c], 0, __ATOMIC_RELAXED);
+        total += bytes[c];
+    }
+
+    // nothing was allocated, no evidence to act on
+    if (total == 0) return;
+
+    // largest class boundary whose allocations fit in the DRAM share
+    size_t budget = _nvm_dram_headroom() / ALLOC_THRESHOLD_HEADROOM_SHARE;
+    size_t target = ALLOC_THRESHOLD_MIN;
+    uint64_t below = 0;
+    for (int c = 0; c < NVM_SIZE_CLASS_COUNT - 1; c++) {
+        below += bytes[c];
+        if (below > budget) break;
+        target = nvm_size_class_limit(c);
+    }
+
+    // move a single class at a time to avoid oscillating
+    size_t threshold = nvm_alloc_threshold;
+    if (target > threshold) {
+        threshold = (threshold * 2 < target) ? threshold * 2 : target;
+    } else if (target < threshold) {
+        threshold = (threshold / 2 > target) ? threshold / 2 : target;
+    }
+
+    if (threshold < ALLOC_THRESHOLD_MIN) threshold = ALLOC_THRESHOLD_MIN;
+    if (threshold > ALLOC_THRESHOLD_MAX) threshold = ALLOC_THRESHOLD_MAX;
+    nvm_alloc_threshold = threshold;
+}
+
+void nvm_get_stats(NVM_Stats *stats) {
+    stats->threshold = nvm_alloc_threshold;
+    stats->adaptive = nvm_threshold_adaptive;
+    for (int c = 0; c < NVM_SIZE_CLASS_COUNT; c++) {
+        stats->size_class_allocs[c] = __atomic_load_n(&nvm_size_class_allocs[c], __ATOMIC_RELAXED);
+        stats->size_class_bytes[c] = __atomic_load_n(&nvm_size_class_bytes[c], __ATOMIC_RELAXED);
+    }
+    stats->realloc_migrations = __atomic_load_n(&nvm_realloc_migrations, __ATOMIC_RELAXED);
+    stats->realloc_migrated_bytes = __atomic_load_n(&nvm_realloc_migrated_bytes, __ATOMIC_RELAXED);
+    stats->numa_failures = __atomic_load_n(&nvm_numa_failures, __ATOMIC_RELAXED);
+    stats->hugetlb_fallbacks = __atomic_load_n(&nvm_hugetlb_fallbacks, __ATOMIC_RELAXED);
+}
+
+// returns the kind an allocation of 'size' bytes of class 'cls' is served from
+static inline struct memkind *_nvm_class_kind(NVM_AllocClass cls, size_t size) {
+    if (!pmem_kind) return _nvm_dram_kind(cls);
+    switch (nvm_placement[cls]) {
+        case NVM_PLACEMENT_PMEM:
+            return pmem_kind;
+        case NVM_PLACEMENT_THRESHOLD:
+            return (size < nvm_alloc_threshold) ? _nvm_dram_kind(cls) : pmem_kind;
+        default:
+            return _nvm_dram_kind(cls);
+    }
+}
+
+// record a new allocation in the size-class histogram
+static inline void _nvm_record_alloc(NVM_AllocClass cls, size_t size) {
+    if (!pmem_kind || nvm_placement[cls] != NVM_PLACEMENT_THRESHOLD) return;
+    int c = _nvm_size_class(size);
+    __atomic_fetch_add(&nvm_size_class_allocs[c], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&nvm_size_class_bytes[c], size, __ATOMIC_RELAXED);
+}
+
+void* nvm_class_malloc(NVM_AllocClass cls, size_t size) {
+    _nvm_record_alloc(cls, size);
+    struct memkind *kind = _nvm_class_kind(cls, size);
+    void *p = memkind_malloc(kind, size);
+
+    if (!p && kind == MEMKIND_HUGETLB) {
+        kind = _nvm_hugetlb_fallback();
+        p = memkind_malloc(kind, size);
+    }
+
+    _nvm_apply_policy(cls, kind, p, size);
+    return p;
+}
+
+void* nvm_class_calloc(NVM_AllocClass cls, size_t nelem, size_t elemsz) {
+    _nvm_record_alloc(cls, nelem * elemsz);
+    struct memkind *kind = _nvm_class_kind(cls, nelem * elemsz);
+    void *p = memkind_calloc(kind, nelem, elemsz);
+
+    if (!p && kind == MEMKIND_HUGETLB) {
+        kind = _nvm_hugetlb_fallback();
+        p = memkind_calloc(kind, nelem, elemsz);
+    }
+
+    _nvm_apply_policy(cls, kind, p, nelem * elemsz);
+    return p;
+}
+
+void* nvm_class_realloc(NVM_AllocClass cls, void *p, size_t n) {
+    if (PHeap_Contains(p)) return _nvm_heap_realloc(cls, p, n);
+    if (!p) return nvm_class_malloc(cls, n);
+
+    // resized allocations weigh in the threshold's histogram as new ones do
+    _nvm_record_alloc(cls, n);
+    if (!pmem_kind && !_nvm_class_paged(cls) && !nvm_hugetlb_used) return dram_realloc(p, n);
+
+    // allocations are resized within the kind they were allocated from,
+    // moved DRAM allocations follow the class' NUMA policy
+    if (!pmem_kind) {
+        struct memkind *kind = _nvm_detect_kind(p);
+        void *np = memkind_realloc(kind, p, n);
+
+        // reserved hugepages exhausted, move to regular pages
+        if (!np && kind == MEMKIND_HUGETLB) {
+            size_t size = memkind_malloc_usable_size(kind, p);
+            kind = _nvm_hugetlb_fallback();
+            np = memkind_malloc(kind, n);
+            if (!np) return NULL;
+            memcpy(np, p, (size < n) ? size : n);
+            memkind_free(MEMKIND_HUGETLB, p);
+        }
+
+        if (np && np != p) _nvm_apply_policy(cls, kind, np, n);
+        return np;
+    }
+
+    struct memkind *temp_kind = memkind_detect_kind(p);
+    void *tp = memkind_realloc(temp_kind, p, n);
+    if (!tp) return NULL;
+    if (tp != p) _nvm_apply_policy(cls, temp_kind, tp, n);
+    if (nvm_placement[cls] != NVM_PLACEMENT_THRESHOLD) return tp;
+
+    // resize crossed the threshold, move allocation to the other kind
+    struct memkind *target_kind = _nvm_class_kind(cls, n);
+    if ((target_kind == pmem_kind) == (temp_kind == pmem_kind)) return tp;
+    void *np = memkind_malloc(target_kind, n);
+
+    if (!np && target_kind == MEMKIND_HUGETLB) {
+        target_kind = _nvm_hugetlb_fallback();
+        np = memkind_malloc(target_kind, n);
+    }
+
+    // keep the allocation in place if the target kind is exhausted
+    if (!np) return tp;
+
+    memcpy(np, tp, n);
+    memkind_free(temp_kind, tp);
+    _nvm_apply_policy(cls, target_kind, np, n);
+    __atomic_fetch_add(&nvm_realloc_migrations, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&nvm_realloc_migrated_bytes, n, __ATOMIC_RELAXED);
+    return np;
+}
+
+void* nvm_matrix_malloc(size_t size) {
+    return nvm_class_malloc(NVM_CLASS_MATRIX, size);
+}
+
+void* nvm_matrix_calloc(size_t nelem, size_t elemsz) {
+    return nvm_class_calloc(NVM_CLASS_MATRIX, nelem, elemsz);
+}
+
+void* nvm_matrix_realloc(void *p, size_t n) {
+    return nvm_class_realloc(NVM_CLASS_MATRIX, p, n);
+}
+
+void* nvm_migrate(void *p, size_t n, bool to_pmem) {
+    if (!pmem_kind || !p) return p;
+
+    // persistent heap resides on PMEM, only promotions leave it
+    if (PHeap_Contains(p)) {
+        if (to_pmem) return p;
+        void *np = dram_malloc(n);
+        if (!np) return p;
+        memcpy(np, p, n);
+        PHeap_Free(p);
+        return np;
+    }
+
+    struct memkind *src_kind = memkind_detect_kind(p);
+    bool on_pmem = (src_kind == pmem_kind);
+    if (on_pmem == to_pmem) return p;
+
+    // keep the allocation in place if the target kind is exhausted
+    struct memkind *dst_kind = to_pmem ? pmem_kind : MEMKIND_DEFAULT;
+    void *np = memkind_malloc(dst_kind, n);
+    if (!np) return p;
+
+    memcpy(np, p, n);
+    memkind_free(src_kind, p);
+    return np;
+}
+
+//------------------------------------------------------------------------------
+// accounting
+//------------------------------------------------------------------------------
+
+size_t nvm_usable_size(void *p) {
+    if (!p) return 0;
+    if (PHeap_Contains(p)) return PHeap_UsableSize(p);
+    return memkind_malloc_usable_size(_nvm_detect_kind(p), p);
+}
+
+void nvm_usage_add(NVM_Usage *usage, void *p) {
+    if (!p) return;
+
+    if (PHeap_Contains(p)) {
+        usage->pmem += PHeap_UsableSize(p);
+        return;
+    }
+
+    struct memkind *kind = _nvm_detect_kind(p);
+    size_t size = memkind_malloc_usable_size(kind, p);
+    if (kind == pmem_kind) usage->pmem += size;
+    else usage->dram += size;
+}
+
+void nvm_usage_add_estimate(NVM_Usage *usage, NVM_AllocClass cls, size_t size) {
+    if (_nvm_class_kind(cls, size) == pmem_kind) usage->pmem += size;
+    else usage->dram += size;
+}
+
+bool nvm_get_kind_usage(NVM_Usage *usage) {
+    size_t total = 0;
+    size_t pmem = 0;
+
+    if (memkind_update_cached_stats() != MEMKIND_SUCCESS) return false;
+    if (memkind_get_stat(NULL, MEMKIND_STAT_TYPE_ALLOCATED, &total) != MEMKIND_SUCCESS) {
+        return false;
+    }
+    if (pmem_kind && memkind_get_stat(pmem_kind, MEMKIND_STAT_TYPE_ALLOCATED,
+                &pmem) != MEMKIND_SUCCESS) {
+        return false;
+    }
+
+    // global statistics cover every kind
+    usage->pmem = pmem;
+    usage->dram = (total > pmem) ? total - pmem : 0;
+    return true;
+}
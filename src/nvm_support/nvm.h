@@ -5,48 +5,145 @@
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 
 #define INDEPENDENT_TEST
 
 /*
- * MODE:
+ * PLACEMENT:
+ *
+ * Every allocation belongs to an allocation class, each class is assigned
+ * a placement policy at runtime (see PROPERTIES_PLACEMENT & co. in config.c)
+ *
+ * CLASS        PROPERTIES      DATABLOCK       MATRIX          SCRATCH
+ *
+ * owns         entity props    node/edge       GraphBLAS       everything
+ *              bags & values   blocks          matrices        else
  *
- * NVM_NONE     NVM_PROP       NVM_MATRIX      NVM_LAYOUT      NVM_ALL
+ * the former compile-time modes map to:
  *
- * only-dram    only-pmem       only-dram       only-pmem       only-pmem
+ * NVM_PROP       pmem            pmem            dram            dram
+ * NVM_MATRIX     dram            dram            pmem            dram
+ * NVM_FULL       pmem            pmem            pmem            pmem
+ * NVM_THRESHOLD  threshold       threshold       threshold       threshold
  *
+ * as long as no PMEM pool was created every class is served from DRAM
+ *
+ * graphs re-attached from the persistent heap (PMEM_HEAP, see pheap.h) keep
+ * their data in the heap until it is freed or reallocated, such allocations
+ * are recognised by address and released back into the heap
  */
 
-// #define NVM_MATRIX
-// #define NVM_PROP
-// #define NVM_FULL
-// #define NVM_THRESHOLD
+/*
+ * PAGE SIZE & NUMA:
+ *
+ * DRAM allocations of the DATABLOCK and MATRIX classes, which hold the data
+ * scanned by queries, follow a page size and a NUMA policy
+ * (see HUGEPAGES & NUMA_POLICY in config.c)
+ *
+ * NVM_PAGES_THP advises transparent hugepages over every aligned hugepage
+ * an allocation spans, NVM_PAGES_HUGETLB serves allocations from explicitly
+ * reserved hugepages (MEMKIND_HUGETLB) and falls back to regular pages once
+ * the reserved hugepages are exhausted
+ *
+ * NUMA policies are applied with mbind to the pages an allocation spans
+ * entirely, hugetlb allocations to the hugepages they reside on, pages
+ * already touched keep their node
+ */
 
-#if (defined(NVM_PROP) || defined(NVM_MATRIX) || defined(NVM_FULL) || defined(NVM_THRESHOLD))
+#define NVM_HUGEPAGE_SIZE (2UL << 20)
 
-#define HYBRID_MEMORY
+// allocations smaller than the threshold are kept on DRAM under
+// NVM_PLACEMENT_THRESHOLD, see ALLOC_THRESHOLD in config.c
+#define ALLOC_THRESHOLD_DEFAULT 64
 
-#endif
+/*
+ * ADAPTIVE THRESHOLD:
+ *
+ * allocations served under NVM_PLACEMENT_THRESHOLD are counted in a histogram
+ * of power-of-two size classes, class 0 holds sizes below 8 bytes and class i
+ * holds sizes in [4 << i, 8 << i), the last class holds everything larger
+ *
+ * when adaptive, nvm_tune_threshold periodically picks the largest class
+ * boundary such that the bytes allocated below it since the previous call fit
+ * in 1/ALLOC_THRESHOLD_HEADROOM_SHARE of the available DRAM, the threshold
+ * then moves a single class towards that boundary
+ */
 
-#ifdef NVM_PROP
+#define NVM_SIZE_CLASS_COUNT 11
 
-#define SLOW_BLOCK
-// #define SLOW_ENTITY
+// bounds of the adaptive threshold
+#define ALLOC_THRESHOLD_MIN 8
+#define ALLOC_THRESHOLD_MAX (8 << (NVM_SIZE_CLASS_COUNT - 2))
 
-#endif
+// share of available DRAM small allocations may take per tuning period
+#define ALLOC_THRESHOLD_HEADROOM_SHARE 16
 
-#ifdef NVM_THRESHOLD
+// number of milliseconds between threshold tuning
+#define ALLOC_THRESHOLD_TUNE_INTERVAL 1000
 
-#define ALLOC_THRESHOLD 64
+// maximum size of the PMEM pool created by init_memkind
+#define NVM_POOL_SIZE_DEFAULT (64LL << 30)
 
-#endif
+typedef enum {
+	NVM_CLASS_PROPERTIES = 0,  // entity property bags and values
+	NVM_CLASS_DATABLOCK  = 1,  // DataBlock blocks
+	NVM_CLASS_MATRIX     = 2,  // GraphBLAS matrices
+	NVM_CLASS_SCRATCH    = 3,  // query-time and all other allocations
+	NVM_CLASS_COUNT      = 4
+} NVM_AllocClass;
+
+typedef enum {
+	NVM_PLACEMENT_DRAM      = 0,  // always allocate from DRAM
+	NVM_PLACEMENT_PMEM      = 1,  // always allocate from the PMEM pool
+	NVM_PLACEMENT_THRESHOLD = 2,  // small allocations on DRAM, the rest on PMEM
+} NVM_Placement;
+
+typedef enum {
+	NVM_PAGES_DEFAULT = 0,  // regular pages, THP as configured system-wide
+	NVM_PAGES_THP     = 1,  // advise transparent hugepages
+	NVM_PAGES_HUGETLB = 2,  // explicit hugepages
+} NVM_Pages;
+
+typedef enum {
+	NVM_NUMA_DEFAULT    = 0,  // kernel default, local to the first touch
+	NVM_NUMA_BIND       = 1,  // restrict to the configured nodes
+	NVM_NUMA_INTERLEAVE = 2,  // interleave pages across the configured nodes
+} NVM_Numa;
+
+// PMEM pool, NULL when running DRAM only
+extern struct memkind *pmem_kind;
+
+// placement policy of each allocation class
+extern NVM_Placement nvm_placement[NVM_CLASS_COUNT];
+
+// allocator statistics
+typedef struct {
+    size_t threshold;                                    // current allocation threshold
+    bool adaptive;                                       // threshold is self-tuning
+    uint64_t size_class_allocs[NVM_SIZE_CLASS_COUNT];    // threshold allocations since last tuning
+    uint64_t size_class_bytes[NVM_SIZE_CLASS_COUNT];     // threshold bytes since last tuning
+    uint64_t realloc_migrations;                         // reallocs copied across kinds
+    uint64_t realloc_migrated_bytes;                     // bytes copied by those reallocs
+    uint64_t numa_failures;                              // allocations the NUMA policy failed to apply to
+    uint64_t hugetlb_fallbacks;                          // allocations served from regular pages instead of hugetlb
+} NVM_Stats;
+
+// bytes held on each kind
+typedef struct {
+    uint64_t dram;  // bytes on MEMKIND_DEFAULT
+    uint64_t pmem;  // bytes on the PMEM pool or the persistent heap
+} NVM_Usage;
 
 void* dram_malloc(size_t size);
 void* dram_calloc(size_t nelem, size_t elemsz);
 void* dram_realloc(void *p, size_t n);
 void dram_free(void* ptr);
 
-void init_memkind();
+// create a PMEM pool under 'nvm_path', returns 0 on success
+int init_memkind(const char *nvm_path, size_t pool_size);
 void set_memkind(void* kind_to_set);
 int is_nvm_addr(void* ptr);
 void* nvm_malloc(size_t size);
@@ -55,11 +152,111 @@ void* nvm_realloc(void *p, size_t n);
 void nvm_free(void* ptr);
 int fin_memkind();
 
-#include <string.h>
+// open the persistent heap at 'heap_path', returns 0 on success
+int nvm_attach_heap(const char *heap_path, size_t heap_size);
+
+// close the persistent heap, see PHeap_Close
+void nvm_detach_heap(bool clean);
+
+// set placement policy of allocation class
+void nvm_set_placement(NVM_AllocClass cls, NVM_Placement placement);
+
+// get placement policy of allocation class
+NVM_Placement nvm_get_placement(NVM_AllocClass cls);
+
+// parse placement name, returns false if 'str' isn't a valid placement
+bool nvm_placement_parse(const char *str, NVM_Placement *placement);
+
+// returns placement name
+const char *nvm_placement_name(NVM_Placement placement);
+
+// set page size of DRAM DATABLOCK and MATRIX allocations
+void nvm_set_pages(NVM_Pages pages);
+
+// get page size of DRAM DATABLOCK and MATRIX allocations
+NVM_Pages nvm_get_pages(void);
+
+// parse page size name, returns false if 'str' isn't a valid page size
+bool nvm_pages_parse(const char *str, NVM_Pages *pages);
+
+// returns page size name
+const char *nvm_pages_name(NVM_Pages pages);
+
+// set NUMA policy of DRAM DATABLOCK and MATRIX allocations
+void nvm_set_numa(NVM_Numa numa);
+
+// get NUMA policy of DRAM DATABLOCK and MATRIX allocations
+NVM_Numa nvm_get_numa(void);
+
+// parse NUMA policy name, returns false if 'str' isn't a valid policy
+bool nvm_numa_parse(const char *str, NVM_Numa *numa);
+
+// returns NUMA policy name
+const char *nvm_numa_name(NVM_Numa numa);
+
+// restrict NUMA policies to 'nodes', a node list such as "0-1,3"
+// NULL for every node, returns false if 'nodes' isn't a valid node list
+bool nvm_set_numa_nodes(const char *nodes);
+
+// returns true if the system supports NUMA policies
+bool nvm_numa_available(void);
+
+// set allocation threshold of NVM_PLACEMENT_THRESHOLD
+void nvm_set_threshold(size_t threshold);
+
+// get allocation threshold of NVM_PLACEMENT_THRESHOLD
+size_t nvm_get_threshold(void);
+
+// enable or disable threshold self-tuning
+void nvm_set_threshold_adaptive(bool adaptive);
+
+// returns true if the threshold is self-tuning
+bool nvm_get_threshold_adaptive(void);
+
+// adapt the threshold to the allocations seen since the previous call
+// and reset the size-class histogram
+void nvm_tune_threshold(void);
+
+// upper bound of size class 'c', sizes in the class are below it
+size_t nvm_size_class_limit(int c);
+
+// snapshot allocator statistics
+void nvm_get_stats(NVM_Stats *stats);
+
+// allocate according to the placement policy of 'cls'
+void* nvm_class_malloc(NVM_AllocClass cls, size_t size);
+void* nvm_class_calloc(NVM_AllocClass cls, size_t nelem, size_t elemsz);
+
+// reallocate 'p', new allocations (p == NULL) follow the placement of 'cls'
+void* nvm_class_realloc(NVM_AllocClass cls, void *p, size_t n);
+
+// GraphBLAS memory functions, matrices follow NVM_CLASS_MATRIX
+void* nvm_matrix_malloc(size_t size);
+void* nvm_matrix_calloc(size_t nelem, size_t elemsz);
+void* nvm_matrix_realloc(void *p, size_t n);
+
+// move the first 'n' bytes of 'p' to PMEM (to_pmem) or DRAM
+// returns the new address, 'p' is returned if it already resides on the target
+void* nvm_migrate(void *p, size_t n, bool to_pmem);
+
+// usable size of allocation 'p', 0 for NULL
+size_t nvm_usable_size(void *p);
+
+// add the usable size of allocation 'p' to the kind it resides on
+void nvm_usage_add(NVM_Usage *usage, void *p);
+
+// add 'size' bytes to the kind an allocation of class 'cls' is served from
+// used for memory whose address isn't accessible, e.g. GraphBLAS internals
+void nvm_usage_add_estimate(NVM_Usage *usage, NVM_AllocClass cls, size_t size);
+
+// process-wide bytes allocated from each kind, as counted by the allocator
+// on every allocation and free, the persistent heap is not included
+// returns false if the allocator doesn't report statistics
+bool nvm_get_kind_usage(NVM_Usage *usage);
 
-static inline char *nvm_strdup(const char *s) {
+static inline char *nvm_class_strdup(NVM_AllocClass cls, const char *s) {
     size_t l = strlen(s)+1;
-    char *p = nvm_malloc(l);
+    char *p = (char *)nvm_class_malloc(cls, l);
     memcpy(p,s,l);
     return p;
 }
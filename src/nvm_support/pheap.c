@@ -0,0 +1,390 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "pheap.h"
+#include "../RG.h"
+#include <fcntl.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+// offset of the first chunk, header occupies the first pages of the file
+#define PHEAP_DATA_OFFSET \
+	((sizeof(PHeapHeader) + 4095) & ~((size_t)4095))
+
+// pagemap entry flags, see Documentation/admin-guide/mm/pagemap.rst
+#define PAGEMAP_FILE (1ULL << 61)     // page is file backed or shared
+#define PAGEMAP_SWAPPED (1ULL << 62)  // page is swapped out
+#define PAGEMAP_PRESENT (1ULL << 63)  // page is present in memory
+
+// chunk header, precedes every allocation
+typedef struct {
+	uint64_t size_class;  // size class of the chunk
+	uint64_t _pad;        // keeps user data 16 bytes aligned
+} PHeapChunk;
+
+typedef struct {
+	char name[PHEAP_ROOT_NAME_LEN];  // root name, empty if slot is free
+	void *ptr;                       // persisted structure
+} PHeapRoot;
+
+typedef struct {
+	uint64_t magic;                                  // PHEAP_MAGIC
+	uint64_t version;                                // PHEAP_VERSION
+	void *base;                                      // address heap is mapped at
+	size_t size;                                     // size of the mapping
+	size_t top;                                      // offset of first unallocated byte
+	uint64_t clean;                                  // heap was closed cleanly
+	PHeapChunk *free_lists[PHEAP_SIZE_CLASS_COUNT];  // freed chunks per size class
+	PHeapRoot roots[PHEAP_ROOT_CAP];                 // named roots
+} PHeapHeader;
+
+static PHeapHeader *heap = NULL;
+static int heap_fd = -1;
+static bool heap_was_clean = false;
+static size_t heap_used = 0;  // bytes held by allocated chunks, including headers
+static pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// sizes up to 256 bytes are rounded to 16 bytes
+// larger sizes use four classes per power of two
+static inline size_t _PHeap_ClassSize(int c) {
+	if(c < 16) return (size_t)16 * (c + 1);
+	c -= 16;
+	int k = c / 4;
+	int j = c % 4 + 1;
+	return ((size_t)256 << k) + j * ((size_t)64 << k);
+}
+
+static inline int _PHeap_SizeClass(size_t size) {
+	if(size <= 256) return (size == 0) ? 0 : (size + 15) / 16 - 1;
+	int k = (63 - __builtin_clzll(size - 1)) - 8;
+	size_t base = (size_t)256 << k;
+	size_t step = (size_t)64 << k;
+	int j = (size - base + step - 1) / step;
+	return 16 + 4 * k + (j - 1);
+}
+
+// next free chunk is stored in the chunk's data
+static inline PHeapChunk **_PHeap_NextFree(PHeapChunk *chunk) {
+	return (PHeapChunk **)(chunk + 1);
+}
+
+// write 'len' bytes of the heap at 'offset' to its file
+static bool _PHeap_WriteRange(size_t offset, size_t len) {
+	const char *src = (const char *)heap;
+	size_t end = offset + len;
+	while(offset < end) {
+		ssize_t n = pwrite(heap_fd, src + offset, end - offset, offset);
+		if(n <= 0) return false;
+		offset += n;
+	}
+	return true;
+}
+
+// write the first 'len' bytes of the heap to its file
+static bool _PHeap_WriteBack(size_t len) {
+	return _PHeap_WriteRange(0, len) && fsync(heap_fd) == 0;
+}
+
+// write the modified pages among the first 'len' bytes of the heap to its file
+// pages of a private mapping are copied on their first write, pagemap reports
+// such pages as no longer file backed, pages which were never touched or only
+// read are skipped, if pagemap can't be read the whole range is written
+static bool _PHeap_WriteBackModified(size_t len) {
+	int fd = open("/proc/self/pagemap", O_RDONLY);
+	if(fd == -1) return _PHeap_WriteBack(len);
+
+	size_t page_size = sysconf(_SC_PAGESIZE);
+	size_t page_count = (len + page_size - 1) / page_size;
+	off_t first = ((uintptr_t)heap / page_size) * sizeof(uint64_t);
+
+	uint64_t entries[512];
+	size_t run_start = 0;  // first page of the current run of modified pages
+	size_t run_len = 0;    // number of pages in the current run
+	bool ok = true;
+
+	for(size_t i = 0; ok && i < page_count; i += 512) {
+		size_t n = (page_count - i < 512) ? page_count - i : 512;
+		ssize_t bytes = n * sizeof(uint64_t);
+		if(pread(fd, entries, bytes, first + i * sizeof(uint64_t)) != bytes) {
+			close(fd);
+			return _PHeap_WriteBack(len);
+		}
+
+		for(size_t j = 0; ok && j < n; j++) {
+			bool present = entries[j] & PAGEMAP_PRESENT;
+			bool swapped = entries[j] & PAGEMAP_SWAPPED;
+			bool file = entries[j] & PAGEMAP_FILE;
+			if((present && !file) || swapped) {
+				if(run_len == 0) run_start = i + j;
+				run_len++;
+				continue;
+			}
+			if(run_len > 0) {
+				ok = _PHeap_WriteRange(run_start * page_size, run_len * page_size);
+				run_len = 0;
+			}
+		}
+	}
+	close(fd);
+
+	if(ok && run_len > 0) {
+		// the last page might extend past the end of the file
+		size_t offset = run_start * page_size;
+		size_t run_size = run_len * page_size;
+		if(offset + run_size > heap->size) run_size = heap->size - offset;
+		ok = _PHeap_WriteRange(offset, run_size);
+	}
+	return ok && fsync(heap_fd) == 0;
+}
+
+static void _PHeap_Reset(void *base, size_t size) {
+	memset(heap, 0, sizeof(PHeapHeader));
+	heap->magic = PHEAP_MAGIC;
+	heap->version = PHEAP_VERSION;
+	heap->base = base;
+	heap->size = size;
+	heap->top = PHEAP_DATA_OFFSET;
+}
+
+bool PHeap_Open(const char *path, size_t size) {
+	ASSERT(heap == NULL);
+
+	int fd = open(path, O_RDWR | O_CREAT, 0600);
+	if(fd == -1) return false;
+
+	struct stat st;
+	if(fstat(fd, &st) != 0) goto error;
+
+	void *base = PHEAP_BASE_ADDR;
+	bool existing = (st.st_size != 0);
+	bool clean = false;
+
+	if(existing) {
+		// never overwrite a file which isn't a compatible heap
+		PHeapHeader hdr;
+		if(pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr)) goto error;
+		if(hdr.magic != PHEAP_MAGIC || hdr.version != PHEAP_VERSION) goto error;
+		if(hdr.size != (size_t)st.st_size) goto error;
+		base = hdr.base;
+		size = hdr.size;
+		clean = hdr.clean;
+	} else {
+		if(size <= PHEAP_DATA_OFFSET) goto error;
+		if(ftruncate(fd, size) != 0) goto error;
+	}
+
+	// persisted pointers are only valid at the recorded address
+	void *addr = mmap(base, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_FIXED_NOREPLACE, fd, 0);
+	if(addr == MAP_FAILED) goto error;
+	if(addr != base) {
+		munmap(addr, size);
+		goto error;
+	}
+
+	heap = addr;
+	heap_fd = fd;
+	heap_was_clean = clean;
+
+	// an unclean heap might be half-way through a write back, start over
+	if(!clean) _PHeap_Reset(base, size);
+
+	// chunks carved out of the heap, less those on the free lists
+	heap_used = heap->top - PHEAP_DATA_OFFSET;
+	for(int c = 0; c < PHEAP_SIZE_CLASS_COUNT; c++) {
+		for(PHeapChunk *chunk = heap->free_lists[c]; chunk; chunk = *_PHeap_NextFree(chunk)) {
+			heap_used -= sizeof(PHeapChunk) + _PHeap_ClassSize(c);
+		}
+	}
+
+	// mark dirty until closed cleanly
+	heap->clean = 0;
+	if(!_PHeap_WriteBack(sizeof(PHeapHeader))) {
+		munmap(heap, size);
+		heap = NULL;
+		heap_fd = -1;
+		goto error;
+	}
+
+	return true;
+
+error:
+	close(fd);
+	return false;
+}
+
+bool PHeap_WasClean(void) {
+	return heap_was_clean;
+}
+
+bool PHeap_IsOpen(void) {
+	return heap != NULL;
+}
+
+bool PHeap_Contains(const void *p) {
+	return heap != NULL && (const char *)p >= (const char *)heap &&
+		(const char *)p < (const char *)heap + heap->size;
+}
+
+void *PHeap_Malloc(size_t size) {
+	if(heap == NULL) return NULL;
+
+	int c = _PHeap_SizeClass(size);
+	if(c >= PHEAP_SIZE_CLASS_COUNT) return NULL;
+
+	pthread_mutex_lock(&heap_lock);
+
+	PHeapChunk *chunk = heap->free_lists[c];
+	if(chunk != NULL) {
+		heap->free_lists[c] = *_PHeap_NextFree(chunk);
+	} else {
+		size_t chunk_size = sizeof(PHeapChunk) + _PHeap_ClassSize(c);
+		if(heap->top + chunk_size > heap->size) {
+			pthread_mutex_unlock(&heap_lock);
+			return NULL;
+		}
+		chunk = (PHeapChunk *)((char *)heap + heap->top);
+		chunk->size_class = c;
+		heap->top += chunk_size;
+	}
+	heap_used += sizeof(PHeapChunk) + _PHeap_ClassSize(c);
+
+	pthread_mutex_unlock(&heap_lock);
+
+	return chunk + 1;
+}
+
+void *PHeap_Calloc(size_t nelem, size_t elemsz) {
+	size_t size = nelem * elemsz;
+	void *p = PHeap_Malloc(size);
+	if(p != NULL) memset(p, 0, size);
+	return p;
+}
+
+void *PHeap_Realloc(void *p, size_t size) {
+	if(p == NULL) return PHeap_Malloc(size);
+
+	size_t usable = PHeap_UsableSize(p);
+	if(size <= usable) return p;
+
+	void *np = PHeap_Malloc(size);
+	if(np == NULL) return NULL;
+
+	memcpy(np, p, usable);
+	PHeap_Free(p);
+	return np;
+}
+
+void PHeap_Free(void *p) {
+	if(p == NULL) return;
+	ASSERT(PHeap_Contains(p));
+
+	PHeapChunk *chunk = (PHeapChunk *)p - 1;
+
+	pthread_mutex_lock(&heap_lock);
+	*_PHeap_NextFree(chunk) = heap->free_lists[chunk->size_class];
+	heap->free_lists[chunk->size_class] = chunk;
+	heap_used -= sizeof(PHeapChunk) + _PHeap_ClassSize(chunk->size_class);
+	pthread_mutex_unlock(&heap_lock);
+}
+
+size_t PHeap_Used(void) {
+	if(heap == NULL) return 0;
+	return __atomic_load_n(&heap_used, __ATOMIC_RELAXED);
+}
+
+size_t PHeap_UsableSize(const void *p) {
+	const PHeapChunk *chunk = (const PHeapChunk *)p - 1;
+	return _PHeap_ClassSize(chunk->size_class);
+}
+
+bool PHeap_SetRoot(const char *name, void *ptr) {
+	ASSERT(heap != NULL);
+	if(strlen(name) >= PHEAP_ROOT_NAME_LEN) return false;
+
+	PHeapRoot *slot = NULL;
+	for(int i = 0; i < PHEAP_ROOT_CAP; i++) {
+		PHeapRoot *root = heap->roots + i;
+		if(strcmp(root->name, name) == 0) {
+			slot = root;
+			break;
+		}
+		if(slot == NULL && root->name[0] == '\0') slot = root;
+	}
+
+	if(ptr == NULL) {
+		// remove root, if exists
+		if(slot != NULL && strcmp(slot->name, name) == 0) {
+			slot->name[0] = '\0';
+			slot->ptr = NULL;
+		}
+		return true;
+	}
+
+	if(slot == NULL) return false;
+
+	strcpy(slot->name, name);
+	slot->ptr = ptr;
+	return true;
+}
+
+void *PHeap_GetRoot(const char *name) {
+	ASSERT(heap != NULL);
+
+	for(int i = 0; i < PHEAP_ROOT_CAP; i++) {
+		PHeapRoot *root = heap->roots + i;
+		if(root->name[0] != '\0' && strcmp(root->name, name) == 0) {
+			return root->ptr;
+		}
+	}
+
+	return NULL;
+}
+
+bool PHeap_RootAt(int i, const char **name, void **ptr) {
+	ASSERT(heap != NULL && i >= 0 && i < PHEAP_ROOT_CAP);
+
+	PHeapRoot *root = heap->roots + i;
+	if(root->name[0] == '\0') return false;
+
+	*name = root->name;
+	*ptr = root->ptr;
+	return true;
+}
+
+bool PHeap_Sync(void) {
+	ASSERT(heap != NULL);
+
+	// write the heap back while marked dirty, then flip the marker
+	// a crash in between leaves a dirty heap which is discarded on open
+	uint64_t marker = 1;
+	if(!_PHeap_WriteBackModified(heap->top)) return false;
+	if(pwrite(heap_fd, &marker, sizeof(marker),
+			offsetof(PHeapHeader, clean)) != sizeof(marker)) return false;
+	return fsync(heap_fd) == 0;
+}
+
+void PHeap_Close(bool clean) {
+	if(heap == NULL) return;
+
+	size_t size = heap->size;
+	if(clean) PHeap_Sync();
+
+	munmap(heap, size);
+	close(heap_fd);
+
+	heap = NULL;
+	heap_fd = -1;
+	heap_used = 0;
+}
@@ -0,0 +1,86 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* PHeap is a persistent, file-backed heap
+ *
+ * the backing file is mapped at a fixed address which is recorded in the
+ * heap header, as such pointers stored within the heap remain valid across
+ * restarts and no pointer swizzling is required on re-attach
+ *
+ * allocator state (free lists and the bump pointer) lives in the header
+ * alongside a small table of named roots from which persisted structures
+ * are reachable
+ *
+ * the file is mapped privately: forked children (e.g. BGSAVE) observe a
+ * copy-on-write snapshot, and only the pages modified since the heap was
+ * opened are written back to the file when it is synced
+ *
+ * the heap is only trusted if it was closed cleanly, opening the heap marks
+ * it dirty, a heap found dirty on open is reset and its roots are dropped */
+
+#define PHEAP_MAGIC 0x3150414548504752ULL  // "RGPHEAP1"
+#define PHEAP_VERSION 3
+
+// address new heaps are mapped at
+#define PHEAP_BASE_ADDR ((void *)0x300000000000ULL)
+
+#define PHEAP_ROOT_CAP 64        // maximum number of named roots
+#define PHEAP_ROOT_NAME_LEN 128  // maximum root name length, including '\0'
+
+// four size classes per power of two, starting at 16 bytes
+#define PHEAP_SIZE_CLASS_COUNT 160
+
+// open or create the heap backed by 'path'
+// 'size' is only used when creating a new heap
+// returns false if the heap can't be mapped
+bool PHeap_Open(const char *path, size_t size);
+
+// returns true if the heap was closed cleanly before it was last opened
+bool PHeap_WasClean(void);
+
+// returns true if a heap is open
+bool PHeap_IsOpen(void);
+
+// returns true if 'p' points into the heap
+bool PHeap_Contains(const void *p);
+
+void *PHeap_Malloc(size_t size);
+void *PHeap_Calloc(size_t nelem, size_t elemsz);
+void *PHeap_Realloc(void *p, size_t size);
+void PHeap_Free(void *p);
+
+// number of usable bytes of allocation 'p'
+size_t PHeap_UsableSize(const void *p);
+
+// number of bytes held by allocations, maintained as chunks are allocated
+// and freed, 0 if no heap is open
+size_t PHeap_Used(void);
+
+// bind 'ptr' to root 'name', a NULL 'ptr' removes the root
+// returns false if the root table is full
+bool PHeap_SetRoot(const char *name, void *ptr);
+
+// returns the pointer bound to root 'name', NULL if missing
+void *PHeap_GetRoot(const char *name);
+
+// returns true if root slot 'i' is in use, setting its name and pointer
+// valid slots are [0, PHEAP_ROOT_CAP)
+bool PHeap_RootAt(int i, const char **name, void **ptr);
+
+// write the heap back to its file and mark it clean, its roots are trusted
+// by the next PHeap_Open, the heap is expected not to change afterwards
+// returns false if the heap couldn't be written back
+bool PHeap_Sync(void);
+
+// unmap the heap, when 'clean' the heap is synced first, see PHeap_Sync
+void PHeap_Close(bool clean);
+
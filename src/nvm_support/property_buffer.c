@@ -0,0 +1,94 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "property_buffer.h"
+#include "nvm.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+
+// entity whose properties are updated on DRAM
+typedef struct {
+	Entity *e;                // staged entity
+	EntityProperty *dest;     // original PMEM bag, NULL if entity had none
+} StagedEntity;
+
+// entities staged by the current thread
+static __thread StagedEntity *staged = NULL;
+
+void PropertyBuffer_Stage(Entity *e) {
+	ASSERT(e != NULL);
+
+	EntityProperty *bag = e->properties;
+	if(bag == NULL) {
+		// a new bag would be allocated on PMEM
+		if(!pmem_kind || nvm_get_placement(NVM_CLASS_PROPERTIES) == NVM_PLACEMENT_DRAM) {
+			return;
+		}
+	} else if(!is_nvm_addr(bag)) {
+		// bags already on DRAM, including staged ones, are updated in place
+		return;
+	}
+
+	if(staged == NULL) staged = array_new(StagedEntity, 32);
+
+	// the staging bag is never empty, an empty bag stays distinguishable
+	// from an entity which was not staged
+	size_t size = sizeof(EntityProperty) * e->prop_count;
+	EntityProperty *buffer = dram_malloc(size > 0 ? size : sizeof(EntityProperty));
+	if(buffer == NULL) return;
+	if(size > 0) memcpy(buffer, bag, size);
+
+	StagedEntity s = { .e = e, .dest = bag };
+	staged = array_append(staged, s);
+	e->properties = buffer;
+	e->prop_cap = e->prop_count;
+}
+
+// write staged bag of 's' back to PMEM
+static void _PropertyBuffer_FlushEntity(StagedEntity *s) {
+	Entity *e = s->e;
+	EntityProperty *bag = e->properties;
+	size_t size = sizeof(EntityProperty) * e->prop_count;
+
+	// bag was removed or moved by a crossing reallocation
+	if(bag == NULL || is_nvm_addr(bag) || size == 0) {
+		if(s->dest != NULL) nvm_free(s->dest);
+		if(bag != NULL && size == 0) {
+			nvm_free(bag);
+			e->properties = NULL;
+			e->prop_cap = 0;
+		}
+		return;
+	}
+
+	EntityProperty *dest = s->dest;
+	if(dest == NULL || nvm_usable_size(dest) < size) {
+		if(dest != NULL) nvm_free(dest);
+		dest = nvm_class_malloc(NVM_CLASS_PROPERTIES, size);
+	}
+
+	memcpy(dest, bag, size);
+	nvm_free(bag);
+	e->properties = dest;
+	e->prop_cap = e->prop_count;
+}
+
+void PropertyBuffer_Flush(void) {
+	if(staged == NULL) return;
+
+	uint n = array_len(staged);
+	if(n == 0) return;
+
+	// issue writes in ascending address order, new bags go last
+#define islt(a, b) ((uintptr_t)(a)->dest - 1 < (uintptr_t)(b)->dest - 1)
+	QSORT(StagedEntity, staged, n, islt);
+#undef islt
+
+	for(uint i = 0; i < n; i++) _PropertyBuffer_FlushEntity(staged + i);
+	array_clear(staged);
+}
+
@@ -0,0 +1,31 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../graph/entities/graph_entity.h"
+
+/* The property buffer combines property updates of PMEM resident entities
+ *
+ * growing, shrinking or overwriting a property bag in place turns into a
+ * read-modify-write of the PMEM media for every single property, as such
+ * a writer stages each entity it is about to update: the entity's bag is
+ * copied to DRAM and all updates are applied to the copy
+ *
+ * once the commit is done the staged bags are flushed, each bag is written
+ * back to PMEM exactly once, in ascending address order such that writes to
+ * neighbouring bags are issued back to back
+ * a bag is written over its original allocation whenever it still fits
+ *
+ * staging is per thread and must be flushed before the graph's write lock
+ * is released */
+
+// stage 'e' for update, no-op if its properties won't reside on PMEM
+void PropertyBuffer_Stage(Entity *e);
+
+// write all staged entities back to PMEM
+void PropertyBuffer_Flush(void);
+
@@ -0,0 +1,204 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "property_tiering.h"
+#include "nvm.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../util/periodic_task.h"
+#include "../graph/graphcontext.h"
+
+extern GraphContext **graphs_in_keyspace;  // global array tracking all extant GraphContexts
+
+size_t tiering_dram_budget = 0;
+
+// position of the migration sweep over the keyspace
+// only accessed from the writer thread
+typedef struct {
+	GraphContext *gc;    // graph being scanned, NULL when no sweep is in progress
+	bool edges;          // true once the graph's nodes were scanned
+	EntityID id;         // next entity to visit
+	size_t resident;     // DRAM bytes kept by the current sweep
+	bool over_budget;    // a hot entity didn't fit in the budget this sweep
+	uint hot_threshold;  // minimum heat of a DRAM resident entity
+} TieringCursor;
+
+static TieringCursor cursor = {
+	.gc = NULL, .edges = false, .id = 0, .resident = 0,
+	.over_budget = false, .hot_threshold = 1
+};
+
+// entities moved between DRAM and PMEM
+static uint64_t promotions = 0;
+static uint64_t demotions = 0;
+
+void PropertyTiering_SetBudget(size_t budget) {
+	tiering_dram_budget = budget;
+}
+
+size_t PropertyTiering_GetBudget(void) {
+	return tiering_dram_budget;
+}
+
+void PropertyTiering_GetStats(PropertyTiering_Stats *stats) {
+	stats->hot_threshold = __atomic_load_n(&cursor.hot_threshold, __ATOMIC_RELAXED);
+	stats->promotions = __atomic_load_n(&promotions, __ATOMIC_RELAXED);
+	stats->demotions = __atomic_load_n(&demotions, __ATOMIC_RELAXED);
+}
+
+// number of tiered bytes owned by entity
+static size_t _PropertyTiering_EntitySize(const Entity *e) {
+	size_t size = sizeof(EntityProperty) * e->prop_count;
+	for(int i = 0; i < e->prop_count; i++) {
+		SIValue *v = &e->properties[i].value;
+		if(v->type == T_STRING && v->allocation == M_SELF) {
+			size += strlen(v->stringval) + 1;
+		}
+	}
+	return size;
+}
+
+// move entity's property bag and strings to PMEM or DRAM
+static void _PropertyTiering_MoveEntity(Entity *e, bool to_pmem) {
+	// the moved bag is sized to its content
+	EntityProperty *properties = e->properties;
+	e->properties = nvm_migrate(properties,
+			sizeof(EntityProperty) * e->prop_count, to_pmem);
+	e->prop_cap = e->prop_count;
+
+	// the bag stays in place if it already resides on the target kind
+	if(e->properties != properties) {
+		__atomic_fetch_add(to_pmem ? &demotions : &promotions, 1, __ATOMIC_RELAXED);
+	}
+
+	for(int i = 0; i < e->prop_count; i++) {
+		SIValue *v = &e->properties[i].value;
+		if(v->type == T_STRING && v->allocation == M_SELF) {
+			v->stringval = nvm_migrate(v->stringval, strlen(v->stringval) + 1,
+					to_pmem);
+		}
+	}
+}
+
+static void _PropertyTiering_VisitEntity(Entity *e) {
+	if(e->properties == NULL) return;
+
+	// decay heat, recent reads weigh more than older ones
+	uint heat = e->heat;
+	e->heat = heat >> 1;
+
+	size_t size = _PropertyTiering_EntitySize(e);
+	bool hot = heat >= cursor.hot_threshold;
+
+	if(hot && cursor.resident + size <= tiering_dram_budget) {
+		_PropertyTiering_MoveEntity(e, false);
+		cursor.resident += size;
+	} else {
+		if(hot) cursor.over_budget = true;
+		_PropertyTiering_MoveEntity(e, true);
+	}
+}
+
+// adapt the hot threshold to the budget and reset the cursor
+static void _PropertyTiering_EndSweep(void) {
+	uint threshold = cursor.hot_threshold;
+	if(cursor.over_budget) {
+		if(threshold < TIERING_HEAT_MAX) threshold++;
+	} else if(cursor.resident < tiering_dram_budget / 2) {
+		if(threshold > 1) threshold--;
+	}
+	__atomic_store_n(&cursor.hot_threshold, threshold, __ATOMIC_RELAXED);
+
+	cursor.gc = NULL;
+	cursor.edges = false;
+	cursor.id = 0;
+	cursor.resident = 0;
+	cursor.over_budget = false;
+}
+
+// position of 'gc' within the keyspace, -1 if it is no longer registered
+static int _PropertyTiering_GraphIndex(const GraphContext *gc) {
+	uint graph_count = array_len(graphs_in_keyspace);
+	for(uint i = 0; i < graph_count; i++) {
+		if(graphs_in_keyspace[i] == gc) return i;
+	}
+	return -1;
+}
+
+// visit up to TIERING_BATCH_SIZE entities, continuing from the cursor
+// expects the GIL to be held, keeping the keyspace intact
+static void _PropertyTiering_Scan(void) {
+	uint graph_count = array_len(graphs_in_keyspace);
+	if(graph_count == 0) return;
+
+	int idx = _PropertyTiering_GraphIndex(cursor.gc);
+	if(idx == -1) {
+		// graph was deleted mid sweep, start over
+		if(cursor.gc != NULL) _PropertyTiering_EndSweep();
+		idx = 0;
+		cursor.gc = graphs_in_keyspace[0];
+	}
+
+	uint visited = 0;
+	while(visited < TIERING_BATCH_SIZE) {
+		Graph *g = cursor.gc->g;
+
+		// exclude readers while relocating properties
+		Graph_AcquireWriteLock(g);
+
+		DataBlock *entities = cursor.edges ? g->edges : g->nodes;
+		uint64_t n = DataBlock_ItemCount(entities) +
+			DataBlock_DeletedItemsCount(entities);
+
+		for(; cursor.id < n && visited < TIERING_BATCH_SIZE; cursor.id++, visited++) {
+			Entity *e = DataBlock_GetItem(entities, cursor.id);
+			if(e != NULL) _PropertyTiering_VisitEntity(e);
+		}
+
+		Graph_ReleaseLock(g);
+
+		// batch exhausted
+		if(cursor.id < n) break;
+
+		// advance to the next datablock
+		cursor.id = 0;
+		if(!cursor.edges) {
+			cursor.edges = true;
+			continue;
+		}
+
+		cursor.edges = false;
+		if(++idx == graph_count) {
+			_PropertyTiering_EndSweep();
+			break;
+		}
+		cursor.gc = graphs_in_keyspace[idx];
+	}
+}
+
+// tiering is enabled once a DRAM budget is set and a PMEM pool exists
+static bool _PropertyTiering_Enabled(void *pdata) {
+	UNUSED(pdata);
+	return tiering_dram_budget > 0 && pmem_kind != NULL;
+}
+
+// migration pass, the GIL is held throughout the pass
+static void _PropertyTiering_Pass(void *pdata) {
+	UNUSED(pdata);
+
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	RedisModule_ThreadSafeContextLock(ctx);
+
+	_PropertyTiering_Scan();
+
+	RedisModule_ThreadSafeContextUnlock(ctx);
+	RedisModule_FreeThreadSafeContext(ctx);
+}
+
+void PropertyTiering_Start(void) {
+	PeriodicTask_Start(TIERING_INTERVAL, _PropertyTiering_Pass, _PropertyTiering_Enabled, NULL);
+}
+
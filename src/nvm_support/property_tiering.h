@@ -0,0 +1,71 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include "../graph/entities/graph_entity.h"
+
+/* Property tiering keeps frequently read property bags on DRAM
+ * and moves the long tail to the PMEM pool
+ *
+ * property reads are sampled, one out of every TIERING_SAMPLE_RATE reads
+ * bumps the 'heat' of the accessed entity
+ *
+ * a periodic writer task (see util/periodic_task.h) runs a migration pass
+ * each pass visits up to TIERING_BATCH_SIZE entities, halves their heat
+ * and promotes hot entities to DRAM as long as the DRAM budget permits,
+ * all other entities are demoted to PMEM
+ *
+ * the heat threshold separating hot from cold entities adapts at the end of
+ * every sweep over the keyspace: it is raised when hot entities didn't fit the
+ * budget and lowered when less than half of the budget was used */
+
+// one out of every TIERING_SAMPLE_RATE property reads is recorded
+#define TIERING_SAMPLE_RATE 16
+
+// entity heat saturates at this value
+#define TIERING_HEAT_MAX 0xFFFF
+
+// number of milliseconds between migration passes
+#define TIERING_INTERVAL 100
+
+// maximum number of entities visited by a single migration pass
+#define TIERING_BATCH_SIZE 4096
+
+// DRAM budget in bytes of entity properties, 0 disables tiering
+extern size_t tiering_dram_budget;
+
+// tiering counters, reported by INFO
+typedef struct {
+	uint hot_threshold;     // minimum heat of a DRAM resident entity
+	uint64_t promotions;    // entities moved to DRAM
+	uint64_t demotions;     // entities moved to PMEM
+} PropertyTiering_Stats;
+
+// set the DRAM budget of entity properties, 0 disables tiering
+void PropertyTiering_SetBudget(size_t budget);
+
+// get the DRAM budget of entity properties
+size_t PropertyTiering_GetBudget(void);
+
+// get the tiering counters
+void PropertyTiering_GetStats(PropertyTiering_Stats *stats);
+
+// record a property read of 'e'
+static inline void PropertyTiering_RecordAccess(Entity *e) {
+	static __thread uint tick = 0;
+
+	if(tiering_dram_budget == 0) return;
+	if((++tick % TIERING_SAMPLE_RATE) != 0) return;
+
+	// concurrent readers may lose an update, heat is only an estimate
+	if(e->heat < TIERING_HEAT_MAX) __atomic_fetch_add(&e->heat, 1, __ATOMIC_RELAXED);
+}
+
+// start the background migration task, should be called once
+void PropertyTiering_Start(void);
+
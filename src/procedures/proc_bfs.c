@@ -110,20 +110,29 @@ static ProcedureResult Proc_BFS_Invoke(ProcedureCtx *ctx,
 
 	// Get edge matrix and transpose matrix, if available.
 	GrB_Matrix R;
-	GrB_Matrix TR;
+	GrB_Matrix TR = GrB_NULL;
+	GrB_Matrix M;
+	GrB_Matrix DP;
+	GrB_Matrix DM;
+	bool free_R = false;
+	bool free_TR = false;
+	bool transpose = true;
+	int relation = GRAPH_NO_RELATION;
 	GraphContext *gc = QueryCtx_GetGraphCtx();
-	if(reltype == NULL) {
-		R = Graph_GetAdjacencyMatrix(gc->g);
-		TR = Graph_GetTransposedAdjacencyMatrix(gc->g);
-	} else {
+	if(reltype != NULL) {
 		Schema *s = GraphContext_GetSchema(gc, reltype, SCHEMA_EDGE);
 		if(!s) return PROCEDURE_OK; // Failed to find schema, first step will return NULL.
 		bfs_ctx->reltype_id = s->id;
-		R = Graph_GetRelationMatrix(gc->g, s->id);
-		bool maintain_transpose;
-		Config_Option_get(Config_MAINTAIN_TRANSPOSE, &maintain_transpose);
-		if(maintain_transpose) TR = Graph_GetTransposedRelationMatrix(gc->g, s->id);
-		else TR = GrB_NULL;
+		relation = s->id;
+		Config_Option_get(Config_MAINTAIN_TRANSPOSE, &transpose);
+	}
+
+	// Pending changes are materialized for the duration of the call.
+	Graph_GetRelationMatrixDeltas(gc->g, relation, false, &M, &DP, &DM);
+	R = RG_Matrix_Materialize(M, DP, DM, &free_R);
+	if(transpose) {
+		Graph_GetRelationMatrixDeltas(gc->g, relation, true, &M, &DP, &DM);
+		TR = RG_Matrix_Materialize(M, DP, DM, &free_TR);
 	}
 
 	/* If we're not collecting edges, pass a NULL parent pointer
@@ -134,6 +143,8 @@ static ProcedureResult Proc_BFS_Invoke(ProcedureCtx *ctx,
 	if(!bfs_ctx->yield_edges) pPI = NULL;
 	GrB_Info res = LAGraph_bfs_pushpull(&V, pPI, R, TR, src_id, max_level, true);
 	ASSERT(res == GrB_SUCCESS);
+	if(free_R) GrB_free(&R);
+	if(free_TR) GrB_free(&TR);
 
 	/* Remove all values with a level less than or equal to 1.
 	 * Values of 0 are not connected to the source, and values of 1 are the source. */
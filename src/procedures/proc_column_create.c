@@ -0,0 +1,71 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_column_create.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include "../schema/property_column.h"
+
+//------------------------------------------------------------------------------
+// columnar createNodeColumn
+//------------------------------------------------------------------------------
+
+// CALL db.columnar.createNodeColumn(label, fields...)
+// CALL db.columnar.createNodeColumn('Tx', 'amount', 'fee')
+ProcedureResult Proc_ColumnCreateNodeColumnInvoke(ProcedureCtx *ctx,
+		const SIValue *args, const char **yield) {
+	uint arg_count = array_len((SIValue *)args);
+	if(arg_count < 2) return PROCEDURE_ERR;
+
+	// validation, all arguments should be of type string
+	for(uint i = 0; i < arg_count; i++) {
+		if(!(SI_TYPE(args[i]) & T_STRING)) return PROCEDURE_ERR;
+	}
+
+	GraphContext *gc      = QueryCtx_GetGraphCtx();
+	uint fields_count     = arg_count - 1;
+	const char *label     = args[0].stringval;
+	const SIValue *fields = args + 1; // skip label
+
+	// create and populate a column per field
+	for(uint i = 0; i < fields_count; i++) {
+		PropertyColumn *column = NULL;
+		const char *field = fields[i].stringval;
+		if(GraphContext_AddColumn(&column, gc, label, field) == INDEX_OK) {
+			Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+			PropertyColumn_Populate(column, gc->g, s->id);
+		}
+	}
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_ColumnCreateNodeColumnStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_ColumnCreateNodeColumnFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_ColumnCreateNodeColumnGen() {
+	void *privateData = NULL;
+	ProcedureOutput *output = array_new(ProcedureOutput, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.columnar.createNodeColumn",
+								   PROCEDURE_VARIABLE_ARG_COUNT,
+								   output,
+								   Proc_ColumnCreateNodeColumnStep,
+								   Proc_ColumnCreateNodeColumnInvoke,
+								   Proc_ColumnCreateNodeColumnFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
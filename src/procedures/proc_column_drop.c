@@ -0,0 +1,57 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_column_drop.h"
+#include "../query_ctx.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// columnar drop
+//------------------------------------------------------------------------------
+
+// CALL db.columnar.drop(label, field)
+// CALL db.columnar.drop('Tx', 'amount')
+
+ProcedureResult Proc_ColumnDropInvoke(ProcedureCtx *ctx,
+		const SIValue *args, const char **yield) {
+	if(array_len((SIValue *)args) != 2) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING)) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[1]) & T_STRING)) return PROCEDURE_ERR;
+
+	const char *label = args[0].stringval;
+	const char *field = args[1].stringval;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	GraphContext_DeleteColumn(gc, label, field);
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_ColumnDropStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_ColumnDropFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_ColumnDropGen() {
+	void *privateData = NULL;
+	ProcedureOutput *output = array_new(ProcedureOutput, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.columnar.drop",
+								   2,
+								   output,
+								   Proc_ColumnDropStep,
+								   Proc_ColumnDropInvoke,
+								   Proc_ColumnDropFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
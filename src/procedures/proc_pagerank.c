@@ -54,7 +54,11 @@ ProcedureResult Proc_PagerankInvoke(ProcedureCtx *ctx,
 	GrB_Index nvals;               // Number of entries in 'r'
 	GrB_Index nrows;               // Relation matrix row count
 	Schema *s = NULL;
+	bool free_l = false;           // Should 'l' be freed
 	bool free_r = false;           // Should 'r' be freed
+	GrB_Matrix M;                  // Underlying matrix
+	GrB_Matrix DP;                 // Pending additions
+	GrB_Matrix DM;                 // Pending deletions
 	GrB_Matrix l = NULL;           // Label matrix
 	GrB_Matrix r = NULL;           // Relation matrix
 	GrB_Index *mapping = NULL;     // Mapping, array for returning row indices of tuples
@@ -82,19 +86,24 @@ ProcedureResult Proc_PagerankInvoke(ProcedureCtx *ctx,
 		s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
 		// Unknown label, quickly return.
 		if(!s) return PROCEDURE_OK;
-		l = Graph_GetLabelMatrix(g, s->id);
+		Graph_GetLabelMatrixDeltas(g, s->id, &M, &DP, &DM);
+		l = RG_Matrix_Materialize(M, DP, DM, &free_l);
 	}
 
 	// Get relation matrix.
 	if(relation) {
 		s = GraphContext_GetSchema(gc, relation, SCHEMA_EDGE);
 		// Unknown relation, quickly return.
-		if(!s) return PROCEDURE_OK;
-		r = Graph_GetRelationMatrix(g, s->id);
+		if(!s) {
+			if(free_l) GrB_free(&l);
+			return PROCEDURE_OK;
+		}
+		Graph_GetRelationMatrixDeltas(g, s->id, false, &M, &DP, &DM);
 	} else {
 		// Relation isn't specified, 'r' is the adjacency matrix.
-		r = Graph_GetAdjacencyMatrix(g);
+		Graph_GetRelationMatrixDeltas(g, GRAPH_NO_RELATION, false, &M, &DP, &DM);
 	}
+	r = RG_Matrix_Materialize(M, DP, DM, &free_r);
 
 	info = GrB_Matrix_nrows(&nrows, r);
 	UNUSED(info);
@@ -146,6 +155,7 @@ ProcedureResult Proc_PagerankInvoke(ProcedureCtx *ctx,
 			GrB_free(&desc);
 		}
 
+		if(free_r) GrB_free(&r);
 		r = reduced;
 		free_r = true;
 	}
@@ -160,6 +170,7 @@ ProcedureResult Proc_PagerankInvoke(ProcedureCtx *ctx,
 	}
 
 	// Clean up.
+	if(free_l) GrB_free(&l);
 	if(free_r) GrB_free(&r);
 
 	// Update context.
@@ -40,6 +40,10 @@ void Proc_Register() {
 	_procRegister("db.idx.fulltext.drop", Proc_FulltextDropIdxGen);
 	_procRegister("db.idx.fulltext.queryNodes", Proc_FulltextQueryNodeGen);
 	_procRegister("db.idx.fulltext.createNodeIndex", Proc_FulltextCreateNodeIdxGen);
+
+	// Register property column generators.
+	_procRegister("db.columnar.drop", Proc_ColumnDropGen);
+	_procRegister("db.columnar.createNodeColumn", Proc_ColumnCreateNodeColumnGen);
 }
 
 ProcedureCtx *ProcCtxNew(const char *name,
@@ -16,4 +16,6 @@
 #include "proc_fulltext_query.h"
 #include "proc_fulltext_drop_index.h"
 #include "proc_fulltext_create_index.h"
+#include "proc_column_create.h"
+#include "proc_column_drop.h"
 
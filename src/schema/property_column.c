@@ -0,0 +1,141 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "property_column.h"
+#include "RG.h"
+#include "../util/rmalloc.h"
+#include "../graph/entities/node.h"
+#include <string.h>
+
+// Number of bitmap words covering 'n' entries.
+#define COLUMN_WORDS(n) (((n) + 63) >> 6)
+
+// Minimal number of entries a column covers.
+#define COLUMN_MIN_CAP 1024
+
+static uint64_t *_PropertyColumn_GrowBitmap(uint64_t *bitmap, uint64_t cap, uint64_t new_cap) {
+	bitmap = rm_realloc(bitmap, COLUMN_WORDS(new_cap) * sizeof(uint64_t));
+	memset(bitmap + COLUMN_WORDS(cap), 0,
+		   (COLUMN_WORDS(new_cap) - COLUMN_WORDS(cap)) * sizeof(uint64_t));
+	return bitmap;
+}
+
+// Make sure the column covers node 'id'.
+static void _PropertyColumn_Accommodate(PropertyColumn *c, NodeID id) {
+	if(id < c->cap) return;
+
+	// Grow geometrically, keeping the capacity a multiple of the bitmap word.
+	uint64_t cap = c->cap;
+	uint64_t new_cap = cap * 2;
+	if(new_cap < COLUMN_MIN_CAP) new_cap = COLUMN_MIN_CAP;
+	if(new_cap <= id) new_cap = (id + 64) & ~63ULL;
+
+	// Values of uncovered entries are never read.
+	c->values = rm_realloc(c->values, new_cap * sizeof(ColumnValue));
+	c->valid = _PropertyColumn_GrowBitmap(c->valid, cap, new_cap);
+	c->floats = _PropertyColumn_GrowBitmap(c->floats, cap, new_cap);
+	c->spilled = _PropertyColumn_GrowBitmap(c->spilled, cap, new_cap);
+	c->cap = new_cap;
+}
+
+PropertyColumn *PropertyColumn_New(Attribute_ID attr_id) {
+	PropertyColumn *c = rm_calloc(1, sizeof(PropertyColumn));
+	c->attr_id = attr_id;
+	return c;
+}
+
+void PropertyColumn_Set(PropertyColumn *c, NodeID id, const SIValue *v) {
+	ASSERT(c != NULL);
+
+	// Missing attributes are null.
+	if(SI_TYPE(*v) == T_NULL) {
+		PropertyColumn_Clear(c, id);
+		return;
+	}
+
+	_PropertyColumn_Accommodate(c, id);
+	uint64_t word = id >> 6;
+	uint64_t bit = 1ULL << (id & 63);
+
+	switch(SI_TYPE(*v)) {
+	case T_INT64:
+		c->values[id].i = v->longval;
+		c->valid[word] |= bit;
+		c->floats[word] &= ~bit;
+		c->spilled[word] &= ~bit;
+		break;
+	case T_DOUBLE:
+		c->values[id].d = v->doubleval;
+		c->valid[word] |= bit;
+		c->floats[word] |= bit;
+		c->spilled[word] &= ~bit;
+		break;
+	default:
+		c->valid[word] &= ~bit;
+		c->spilled[word] |= bit;
+		break;
+	}
+}
+
+void PropertyColumn_Clear(PropertyColumn *c, NodeID id) {
+	ASSERT(c != NULL);
+	if(id >= c->cap) return;
+
+	uint64_t word = id >> 6;
+	uint64_t bit = 1ULL << (id & 63);
+	c->valid[word] &= ~bit;
+	c->spilled[word] &= ~bit;
+}
+
+void PropertyColumn_Move(PropertyColumn *c, NodeID from, NodeID to) {
+	ASSERT(c != NULL);
+	if(from >= c->cap) {
+		PropertyColumn_Clear(c, to);
+		return;
+	}
+
+	_PropertyColumn_Accommodate(c, to);
+	uint64_t from_word = from >> 6;
+	uint64_t from_bit = 1ULL << (from & 63);
+	uint64_t to_word = to >> 6;
+	uint64_t to_bit = 1ULL << (to & 63);
+
+	c->values[to] = c->values[from];
+	c->valid[to_word] &= ~to_bit;
+	c->floats[to_word] &= ~to_bit;
+	c->spilled[to_word] &= ~to_bit;
+	if(c->valid[from_word] & from_bit) c->valid[to_word] |= to_bit;
+	if(c->floats[from_word] & from_bit) c->floats[to_word] |= to_bit;
+	if(c->spilled[from_word] & from_bit) c->spilled[to_word] |= to_bit;
+
+	PropertyColumn_Clear(c, from);
+}
+
+void PropertyColumn_Populate(PropertyColumn *c, Graph *g, int label) {
+	ASSERT(c != NULL && g != NULL);
+
+	Node node = GE_NEW_NODE();
+	NodeID node_id = 0;
+
+	// Iterate over each labeled node.
+	while(Graph_NextLabeledNode(g, label, &node_id)) {
+		Graph_GetNode(g, node_id, &node);
+		SIValue *v = GraphEntity_GetProperty((GraphEntity *)&node, c->attr_id);
+		PropertyColumn_Set(c, node_id, v);
+		node_id++;
+	}
+}
+
+void PropertyColumn_Free(PropertyColumn *c) {
+	if(c == NULL) return;
+
+	rm_free(c->values);
+	rm_free(c->valid);
+	rm_free(c->floats);
+	rm_free(c->spilled);
+	rm_free(c);
+}
+
@@ -0,0 +1,77 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../value.h"
+#include "../graph/graph.h"
+#include "../graph/entities/graph_entity.h"
+
+/* PROPERTY COLUMNS:
+ *
+ * a column holds a copy of a single attribute of every node of a label,
+ * values are kept in a dense array indexed by node ID next to a null bitmap,
+ * such that reading the attribute of nodes visited in ID order, as label
+ * scans do, sweeps memory sequentially instead of searching property bags
+ *
+ * integer and floating point values are held by the column, values of any
+ * other type are only held by the node's property bag, such entries are
+ * marked as spilled and readers fall back to the bag
+ *
+ * the property bag remains the source of truth, columns are updated by
+ * writers under the graph's write lock, whenever a node of the label is
+ * created, updated or deleted */
+
+typedef union {
+	int64_t i;              // Integer value.
+	double d;               // Floating point value.
+} ColumnValue;
+
+typedef struct {
+	Attribute_ID attr_id;   // Attribute held by the column.
+	uint64_t cap;           // Number of node IDs covered by the column.
+	ColumnValue *values;    // Values, indexed by node ID.
+	uint64_t *valid;        // Null bitmap, a set bit marks a value held by the column.
+	uint64_t *floats;       // A set bit marks a floating point value.
+	uint64_t *spilled;      // A set bit marks a value held by the property bag only.
+} PropertyColumn;
+
+// Creates an empty column for attribute 'attr_id'.
+PropertyColumn *PropertyColumn_New(Attribute_ID attr_id);
+
+// Sets the entry of node 'id' to 'v',
+// PROPERTY_NOTFOUND and NULL values clear the entry.
+void PropertyColumn_Set(PropertyColumn *c, NodeID id, const SIValue *v);
+
+// Clears the entry of node 'id'.
+void PropertyColumn_Clear(PropertyColumn *c, NodeID id);
+
+// Moves the entry of node 'from' to node 'to', clearing 'from'.
+void PropertyColumn_Move(PropertyColumn *c, NodeID from, NodeID to);
+
+// Retrieves the entry of node 'id' into 'v'.
+// Returns false if the value must be read from the node's property bag.
+static inline bool PropertyColumn_Get(const PropertyColumn *c, NodeID id, SIValue *v) {
+	if(id >= c->cap) return false;
+
+	uint64_t word = id >> 6;
+	uint64_t bit = 1ULL << (id & 63);
+	if(c->valid[word] & bit) {
+		*v = (c->floats[word] & bit) ? SI_DoubleVal(c->values[id].d) : SI_LongVal(c->values[id].i);
+		return true;
+	}
+	if(c->spilled[word] & bit) return false;
+
+	*v = SI_NullVal();
+	return true;
+}
+
+// Sets the entries of every node labeled 'label'.
+void PropertyColumn_Populate(PropertyColumn *c, Graph *g, int label);
+
+// Free column.
+void PropertyColumn_Free(PropertyColumn *c);
+
@@ -15,6 +15,7 @@ Schema *Schema_New(const char *name, int id) {
 	schema->id = id;
 	schema->index = NULL;
 	schema->fulltextIdx = NULL;
+	schema->columns = NULL;
 	schema->name = rm_strdup(name);
 	return schema;
 }
@@ -139,12 +140,85 @@ void Schema_AddNodeToIndices(const Schema *s, const Node *n) {
 	if(idx) Index_IndexNode(idx, n);
 }
 
+bool Schema_HasColumns(const Schema *s) {
+	ASSERT(s);
+	return s->columns != NULL;
+}
+
+PropertyColumn *Schema_GetColumn(const Schema *s, Attribute_ID attribute_id) {
+	if(s->columns == NULL) return NULL;
+
+	uint n = array_len(s->columns);
+	for(uint i = 0; i < n; i++) {
+		if(s->columns[i]->attr_id == attribute_id) return s->columns[i];
+	}
+	return NULL;
+}
+
+int Schema_AddColumn(PropertyColumn **column, Schema *s, Attribute_ID attribute_id) {
+	ASSERT(attribute_id != ATTRIBUTE_NOTFOUND);
+
+	*column = NULL;
+	if(Schema_GetColumn(s, attribute_id) != NULL) return INDEX_FAIL;
+
+	if(s->columns == NULL) s->columns = array_new(PropertyColumn *, 1);
+	*column = PropertyColumn_New(attribute_id);
+	s->columns = array_append(s->columns, *column);
+
+	return INDEX_OK;
+}
+
+int Schema_RemoveColumn(Schema *s, Attribute_ID attribute_id) {
+	uint n = array_len(s->columns);
+	for(uint i = 0; i < n; i++) {
+		if(s->columns[i]->attr_id != attribute_id) continue;
+
+		PropertyColumn_Free(s->columns[i]);
+		s->columns = array_del_fast(s->columns, i);
+
+		// if column count dropped to 0, remove columns from schema
+		if(array_len(s->columns) == 0) {
+			array_free(s->columns);
+			s->columns = NULL;
+		}
+		return INDEX_OK;
+	}
+
+	return INDEX_FAIL;
+}
+
+// Write node's attributes to all schema columns.
+void Schema_AddNodeToColumns(const Schema *s, const Node *n) {
+	if(!s || !s->columns) return;
+
+	uint count = array_len(s->columns);
+	for(uint i = 0; i < count; i++) {
+		PropertyColumn *c = s->columns[i];
+		SIValue *v = GraphEntity_GetProperty((GraphEntity *)n, c->attr_id);
+		PropertyColumn_Set(c, ENTITY_GET_ID(n), v);
+	}
+}
+
+void Schema_RemoveNodeFromColumns(const Schema *s, NodeID id) {
+	if(!s || !s->columns) return;
+
+	uint count = array_len(s->columns);
+	for(uint i = 0; i < count; i++) PropertyColumn_Clear(s->columns[i], id);
+}
+
 void Schema_Free(Schema *schema) {
 	if(schema->name) rm_free(schema->name);
 
 	// Free indicies.
 	if(schema->index) Index_Free(schema->index);
 	if(schema->fulltextIdx) Index_Free(schema->fulltextIdx);
+
+	// Free columns.
+	if(schema->columns) {
+		uint n = array_len(schema->columns);
+		for(uint i = 0; i < n; i++) PropertyColumn_Free(schema->columns[i]);
+		array_free(schema->columns);
+	}
 	rm_free(schema);
 }
 
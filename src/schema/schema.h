@@ -8,6 +8,7 @@
 
 #include "../redismodule.h"
 #include "../index/index.h"
+#include "property_column.h"
 #include "rax.h"
 #include "redisearch_api.h"
 #include "../graph/entities/graph_entity.h"
@@ -25,6 +26,7 @@ typedef struct {
 	char *name;           // Schema name.
 	Index *index;         // Exact match index.
 	Index *fulltextIdx;   // Full-text index.
+	PropertyColumn **columns;   // Columnar copies of attributes, see property_column.h
 } Schema;
 
 /* Creates a new schema. */
@@ -52,6 +54,26 @@ int Schema_RemoveIndex(Schema *s, const char *field, IndexType type);
 /* Introduce node schema indicies */
 void Schema_AddNodeToIndices(const Schema *s, const Node *n);
 
+/* Returns true if schema holds property columns. */
+bool Schema_HasColumns(const Schema *s);
+
+/* Retrieves the column holding attribute.
+ * Returns NULL if attribute isn't held by a column. */
+PropertyColumn *Schema_GetColumn(const Schema *s, Attribute_ID attribute_id);
+
+/* Creates an empty column for attribute
+ * returns INDEX_FAIL if attribute is already held by a column. */
+int Schema_AddColumn(PropertyColumn **column, Schema *s, Attribute_ID attribute_id);
+
+/* Removes column. */
+int Schema_RemoveColumn(Schema *s, Attribute_ID attribute_id);
+
+/* Introduce node to schema columns */
+void Schema_AddNodeToColumns(const Schema *s, const Node *n);
+
+/* Clear node from schema columns */
+void Schema_RemoveNodeFromColumns(const Schema *s, NodeID id);
+
 /* Free schema. */
 void Schema_Free(Schema *s);
 
@@ -14,12 +14,14 @@ GraphDecodeContext *GraphDecodeContext_New() {
 	ctx->keys_processed = 0;
 	ctx->graph_keys_count = 1;
 	ctx->meta_keys = raxNew();
+	ctx->attached = false;
 	return ctx;
 }
 
 void GraphDecodeContext_Reset(GraphDecodeContext *ctx) {
 	ASSERT(ctx);
 	ctx->keys_processed = 0;
+	ctx->attached = false;
 }
 
 void GraphDecodeContext_SetKeyCount(GraphDecodeContext *ctx, uint64_t key_count) {
@@ -64,6 +66,16 @@ bool GraphDecodeContext_GetProcessedKeyCount(const GraphDecodeContext *ctx) {
 	return ctx->keys_processed;
 }
 
+void GraphDecodeContext_SetAttached(GraphDecodeContext *ctx, bool attached) {
+	ASSERT(ctx);
+	ctx->attached = attached;
+}
+
+bool GraphDecodeContext_IsAttached(const GraphDecodeContext *ctx) {
+	ASSERT(ctx);
+	return ctx->attached;
+}
+
 void GraphDecodeContext_Free(GraphDecodeContext *ctx) {
 	if(ctx) {
 		raxFree(ctx->meta_keys);
@@ -16,6 +16,7 @@ typedef struct {
 	uint64_t keys_processed;    // Count the number of procssed graph keys.
 	uint64_t graph_keys_count;  // The number of keys representing the graph.
 	rax *meta_keys;             // The meta keys encountered so far in the decode process.
+	bool attached;              // Graph was re-attached from the persistent heap.
 } GraphDecodeContext;
 
 // Creates a new graph decoding context.
@@ -48,5 +49,11 @@ void GraphDecodeContext_IncreaseProcessedKeyCount(GraphDecodeContext *ctx);
 // Returns the number of processed keys.
 bool GraphDecodeContext_GetProcessedKeyCount(const GraphDecodeContext *ctx);
 
+// Mark the graph as re-attached, its RDB carries no entity payloads.
+void GraphDecodeContext_SetAttached(GraphDecodeContext *ctx, bool attached);
+
+// Returns true if the graph was re-attached from the persistent heap.
+bool GraphDecodeContext_IsAttached(const GraphDecodeContext *ctx);
+
 // Free graph decoding context.
 void GraphDecodeContext_Free(GraphDecodeContext *ctx);
@@ -102,10 +102,12 @@ static void _RdbLoadNodes(RedisModuleIO *rdb, GraphContext *gc) {
 		// * (labels) x M
 		// M will currently always be 0 or 1
 		uint64_t l = (nodeLabelCount) ? RedisModule_LoadUnsigned(rdb) : GRAPH_NO_LABEL;
-		Graph_CreateNode(gc->g, l, &n);
+		// Node IDs are implied by the encoding order.
+		Serializer_Graph_SetNode(gc->g, i, l, &n);
 
 		_RdbLoadEntity(rdb, gc, (GraphEntity *)&n);
 	}
+	Serializer_Graph_FinalizeNodes(gc->g);
 }
 
 static void _RdbLoadEdges(RedisModuleIO *rdb, GraphContext *gc) {
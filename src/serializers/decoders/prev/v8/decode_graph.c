@@ -172,6 +172,7 @@ GraphContext *RdbLoadGraphContext_v8(RedisModuleIO *rdb) {
 	}
 
 	if(GraphDecodeContext_Finished(gc->decoding_context)) {
+		Serializer_Graph_FinalizeNodes(gc->g);
 		// Revert to default synchronization behavior
 		Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
 		Graph_ApplyAllPending(gc->g);
@@ -6,10 +6,6 @@
 
 #include "decode_v9.h"
 
-#ifdef LABEL_DATABLOCK
-ConversionInfo_t *conv_info;
-#endif
-
 // Module event handler functions declarations.
 void ModuleEventHandler_IncreaseDecodingGraphsCount(void);
 void ModuleEventHandler_DecreaseDecodingGraphsCount(void);
@@ -79,7 +75,7 @@ static GraphContext *_DecodeHeader(RedisModuleIO *rdb) {
 	Graph *g = gc->g;
 	// If it is the first key of this graph, allocate all the data structures, with the appropriate dimensions.
 	if(GraphDecodeContext_GetProcessedKeyCount(gc->decoding_context) == 0) {
-		_InitGraphDataStructure(gc->g, node_count, edge_count, label_count, relation_count);
+		_InitGraphDataStructure(g, node_count, edge_count, label_count, relation_count);
 
 		// Mark relationship matrices for support of multi-edge entries
 		for(uint i = 0; i < relation_count; i++) {
@@ -116,7 +112,7 @@ static PayloadInfo *_RdbLoadKeySchema(RedisModuleIO *rdb) {
 	return payloads;
 }
 
-GraphContext *RdbLoadGraph_v9(RedisModuleIO *rdb) {
+GraphContext *RdbLoadGraphContext_v9(RedisModuleIO *rdb) {
 
 	/* Key format:
 	 *  Header
@@ -176,6 +172,7 @@ GraphContext *RdbLoadGraph_v9(RedisModuleIO *rdb) {
 	}
 
 	if(GraphDecodeContext_Finished(gc->decoding_context)) {
+		Serializer_Graph_FinalizeNodes(gc->g);
 		// Revert to default synchronization behavior
 		Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
 		Graph_ApplyAllPending(gc->g);
@@ -198,17 +195,6 @@ GraphContext *RdbLoadGraph_v9(RedisModuleIO *rdb) {
 		ModuleEventHandler_DecreaseDecodingGraphsCount();
 		RedisModuleCtx *ctx = RedisModule_GetContextFromIO(rdb);
 		RedisModule_Log(ctx, "notice", "Done decoding graph %s", gc->graph_name);
-#ifdef LABEL_DATABLOCK
-        rm_free(conv_info->ref_pool);
-        rm_free(conv_info);
-#endif
-#ifdef NVM_MATRIX
-		GrB_Info res = GxB_init(GrB_NONBLOCKING, rm_malloc, rm_calloc, rm_realloc, rm_free, true);
-		if(res != GrB_SUCCESS) {
-			RedisModule_Log(ctx, "warning", "GxB malloc reset error!!!");
-			exit(233);
-		}
-#endif
 	}
 
 	return gc;
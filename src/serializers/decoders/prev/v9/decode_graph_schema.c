@@ -6,7 +6,7 @@
 
 #include "decode_v9.h"
 
-static Schema *_RdbLoadSchema(RedisModuleIO *rdb, SchemaType type) {
+static Schema *_RdbLoadSchema(RedisModuleIO *rdb, GraphContext *gc, SchemaType type) {
 	/* Format:
 	 * id
 	 * name
@@ -64,7 +64,7 @@ void RdbLoadGraphSchema_v9(RedisModuleIO *rdb, GraphContext *gc) {
 	// Load each node schema
 	gc->node_schemas = array_ensure_cap(gc->node_schemas, schema_count);
 	for(uint i = 0; i < schema_count; i ++) {
-		gc->node_schemas = array_append(gc->node_schemas, _RdbLoadSchema(rdb, SCHEMA_NODE));
+		gc->node_schemas = array_append(gc->node_schemas, _RdbLoadSchema(rdb, gc, SCHEMA_NODE));
 	}
 
 	// #Edge schemas
@@ -73,6 +73,6 @@ void RdbLoadGraphSchema_v9(RedisModuleIO *rdb, GraphContext *gc) {
 	// Load each edge schema
 	gc->relation_schemas = array_ensure_cap(gc->relation_schemas, schema_count);
 	for(uint i = 0; i < schema_count; i ++) {
-		gc->relation_schemas = array_append(gc->relation_schemas, _RdbLoadSchema(rdb, SCHEMA_EDGE));
+		gc->relation_schemas = array_append(gc->relation_schemas, _RdbLoadSchema(rdb, gc, SCHEMA_EDGE));
 	}
 }
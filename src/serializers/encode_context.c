@@ -56,7 +56,7 @@ void GraphEncodeContext_Reset(GraphEncodeContext *ctx) {
 
 	// Avoid leaks in case or reset during encodeing.
 	if(ctx->matrix_tuple_iterator != NULL) {
-		GxB_MatrixTupleIter_free(ctx->matrix_tuple_iterator);
+		RG_MatrixTupleIter_free(ctx->matrix_tuple_iterator);
 		ctx->matrix_tuple_iterator = NULL;
 	}
 }
@@ -81,7 +81,8 @@ static bool _MultiEdgeMatrix(GrB_Matrix R, GrB_Monoid min_monoid) {
 	return multi_edge;
 }
 
-void GraphEncodeContext_InitHeader(GraphEncodeContext *ctx, const char *graph_name, Graph *g) {
+void GraphEncodeContext_InitHeader(GraphEncodeContext *ctx, const char *graph_name, Graph *g,
+		bool entities) {
 	ASSERT(g != NULL);
 	ASSERT(ctx != NULL);
 
@@ -96,6 +97,14 @@ void GraphEncodeContext_InitHeader(GraphEncodeContext *ctx, const char *graph_na
 	header->label_matrix_count = Graph_LabelTypeCount(g);
 	header->key_count = GraphEncodeContext_GetKeyCount(ctx);
 	header->multi_edge = rm_malloc(sizeof(bool) * r_count);
+	header->entities = entities;
+
+	// matrices of a graph whose entities are omitted were moved into its
+	// graph image, which restores multi-edge support on its own
+	if(!entities) {
+		memset(header->multi_edge, 0, sizeof(bool) * r_count);
+		return;
+	}
 
 	// Denote for each relationship matrix Ri if it contains muti-edge entries
 	// this information alows for an optimization when loading the data
@@ -106,8 +115,16 @@ void GraphEncodeContext_InitHeader(GraphEncodeContext *ctx, const char *graph_na
 	ASSERT(info == GrB_SUCCESS);
 
 	for(uint i = 0; i < r_count; i++) {
-		GrB_Matrix R = Graph_GetRelationMatrix(g, i);
-		bool multi_edge = _MultiEdgeMatrix(R, min_monoid);
+		// pending changes aren't merged, M and DP are inspected separately
+		// entries deleted since the last merge never reference edge arrays
+		GrB_Matrix M;
+		GrB_Matrix DP;
+		GrB_Matrix DM;
+		GrB_Index additions;
+		Graph_GetRelationMatrixDeltas(g, i, false, &M, &DP, &DM);
+		GrB_Matrix_nvals(&additions, DP);
+		bool multi_edge = _MultiEdgeMatrix(M, min_monoid) ||
+						  (additions > 0 && _MultiEdgeMatrix(DP, min_monoid));
 		header->multi_edge[i] = multi_edge;
 	}
 
@@ -185,14 +202,14 @@ void GraphEncodeContext_SetCurrentRelationID(GraphEncodeContext *ctx,
 	ctx->current_relation_matrix_id = current_relation_matrix_id;
 }
 
-GxB_MatrixTupleIter *GraphEncodeContext_GetMatrixTupleIterator(
+RG_MatrixTupleIter *GraphEncodeContext_GetMatrixTupleIterator(
 	const GraphEncodeContext *ctx) {
 	ASSERT(ctx);
 	return ctx->matrix_tuple_iterator;
 }
 
 void GraphEncodeContext_SetMatrixTupleIterator(GraphEncodeContext *ctx,
-											   GxB_MatrixTupleIter *iter) {
+											   RG_MatrixTupleIter *iter) {
 	ASSERT(ctx);
 	ctx->matrix_tuple_iterator = iter;
 }
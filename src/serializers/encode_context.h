@@ -35,6 +35,7 @@ typedef struct {
 	const char *graph_name;          // name of graph
 	uint label_matrix_count;         // number of label matrices
 	uint relationship_matrix_count;  // number of relation matrices
+	bool entities;                   // false if entities are omitted, see graph_image.h
 } GraphEncodeHeader;
 
 // GraphEncodeContext maintains the state of a graph being encoded or decoded
@@ -50,7 +51,7 @@ typedef struct {
 	uint current_relation_matrix_id;            // Current encoded relationship matrix.
 	uint multiple_edges_current_index;          // The current index of the encoded edges array.
 	DataBlockIterator *datablock_iterator;      // Datablock iterator to be saved in the context.
-	GxB_MatrixTupleIter *matrix_tuple_iterator; // Matrix tuple iterator to be saved in the context.
+	RG_MatrixTupleIter *matrix_tuple_iterator;  // Matrix tuple iterator to be saved in the context.
 } GraphEncodeContext;
 
 // Creates a new graph encoding context.
@@ -60,7 +61,8 @@ GraphEncodeContext *GraphEncodeContext_New();
 void GraphEncodeContext_Reset(GraphEncodeContext *ctx);
 
 // Populates graph encode context header.
-void GraphEncodeContext_InitHeader(GraphEncodeContext *ctx, const char *graph_name, Graph *g);
+void GraphEncodeContext_InitHeader(GraphEncodeContext *ctx, const char *graph_name, Graph *g,
+		bool entities);
 
 // Retrieve the graph current encoding phase.
 EncodeState GraphEncodeContext_GetEncodeState(const GraphEncodeContext *ctx);
@@ -103,10 +105,10 @@ void GraphEncodeContext_SetCurrentRelationID(GraphEncodeContext *ctx,
 											 uint current_relation_matrix_id);
 
 // Retrieve stored matrix tuple iterator.
-GxB_MatrixTupleIter *GraphEncodeContext_GetMatrixTupleIterator(const GraphEncodeContext *ctx);
+RG_MatrixTupleIter *GraphEncodeContext_GetMatrixTupleIterator(const GraphEncodeContext *ctx);
 
 // Set graph encoding context matrix tuple iterator - keep iterator state for further usage.
-void GraphEncodeContext_SetMatrixTupleIterator(GraphEncodeContext *ctx, GxB_MatrixTupleIter *iter);
+void GraphEncodeContext_SetMatrixTupleIterator(GraphEncodeContext *ctx, RG_MatrixTupleIter *iter);
 
 // Sets a multiple edges array and the current index, for saving the state of multiple edges encoding.
 void GraphEncodeContext_SetMutipleEdgesArray(GraphEncodeContext *ctx, EdgeID *edges,
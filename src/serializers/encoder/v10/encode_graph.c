@@ -4,7 +4,8 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
-#include "encode_v9.h"
+#include "encode_v10.h"
+#include "../../../nvm_support/graph_image.h"
 
 extern bool process_is_child; // Global variable declared in module.c
 
@@ -23,6 +24,7 @@ static void _RdbSaveHeader(RedisModuleIO *rdb, GraphEncodeContext *ctx) {
 	 * Relation matrix count - N
 	 * Does relationship Ri holds mutiple edges under a single entry X N 
 	 * Number of graph keys (graph context key + meta keys)
+	 * Are entities encoded, false if held by a graph image
 	 */
 
 	ASSERT(ctx != NULL);
@@ -52,6 +54,9 @@ static void _RdbSaveHeader(RedisModuleIO *rdb, GraphEncodeContext *ctx) {
 
 	// Number of keys.
 	RedisModule_SaveUnsigned(rdb, header->key_count);
+
+	// Are entities encoded.
+	RedisModule_SaveUnsigned(rdb, header->entities);
 }
 
 // Returns the a state information regarding the number of entities required to encode in this state.
@@ -97,8 +102,12 @@ static PayloadInfo *_RdbSaveKeySchema(RedisModuleIO *rdb, GraphContext *gc) {
 	PayloadInfo *payloads = array_new(PayloadInfo, 1);
 	// Get current encoding state.
 	EncodeState current_state = GraphEncodeContext_GetEncodeState(gc->encoding_context);
-	// If it is the start of the encodeing, set the state to be NODES.
-	if(current_state == ENCODE_STATE_INIT) current_state = ENCODE_STATE_NODES;
+	// If it is the start of the encodeing, set the state to be NODES,
+	// or straight to the schema if entities are omitted.
+	if(current_state == ENCODE_STATE_INIT) {
+		current_state = (gc->encoding_context->header.entities) ?
+						ENCODE_STATE_NODES : ENCODE_STATE_GRAPH_SCHEMA;
+	}
 
 	uint64_t remaining_entities;
 	Config_Option_get(Config_VKEY_MAX_ENTITY_COUNT, &remaining_entities);
@@ -137,7 +146,7 @@ static PayloadInfo *_RdbSaveKeySchema(RedisModuleIO *rdb, GraphContext *gc) {
 	return payloads;
 }
 
-void RdbSaveGraph_v9(RedisModuleIO *rdb, void *value) {
+void RdbSaveGraph_v10(RedisModuleIO *rdb, void *value) {
 	/* Encoding format for graph context and graph meta key:
 	 *  Header
 	 *  Payload(s) count: N
@@ -166,7 +175,9 @@ void RdbSaveGraph_v9(RedisModuleIO *rdb, void *value) {
 
 	if(current_state == ENCODE_STATE_INIT) {
 		// Inital state, populate encoding context header
-		GraphEncodeContext_InitHeader(gc->encoding_context, gc->graph_name, gc->g);
+		// Entities held by a graph image are not encoded.
+		GraphEncodeContext_InitHeader(gc->encoding_context, gc->graph_name, gc->g,
+									  !GraphImage_SavingImages());
 	}
 
 	// Save header
@@ -182,19 +193,19 @@ void RdbSaveGraph_v9(RedisModuleIO *rdb, void *value) {
 		PayloadInfo payload = key_schema[i];
 		switch(payload.state) {
 		case ENCODE_STATE_NODES:
-			RdbSaveNodes_v9(rdb, gc, payload.entities_count);
+			RdbSaveNodes_v10(rdb, gc, payload.entities_count);
 			break;
 		case ENCODE_STATE_DELETED_NODES:
-			RdbSaveDeletedNodes_v9(rdb, gc, payload.entities_count);
+			RdbSaveDeletedNodes_v10(rdb, gc, payload.entities_count);
 			break;
 		case ENCODE_STATE_EDGES:
-			RdbSaveEdges_v9(rdb, gc, payload.entities_count);
+			RdbSaveEdges_v10(rdb, gc, payload.entities_count);
 			break;
 		case ENCODE_STATE_DELETED_EDGES:
-			RdbSaveDeletedEdges_v9(rdb, gc, payload.entities_count);
+			RdbSaveDeletedEdges_v10(rdb, gc, payload.entities_count);
 			break;
 		case ENCODE_STATE_GRAPH_SCHEMA:
-			RdbSaveGraphSchema_v9(rdb, gc);
+			RdbSaveGraphSchema_v10(rdb, gc);
 			break;
 		default:
 			ASSERT(false && "Unknown encoding phase");
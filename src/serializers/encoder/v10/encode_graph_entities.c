@@ -4,12 +4,22 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
-#include "encode_v9.h"
+#include "encode_v10.h"
 #include "../../../datatypes/datatypes.h"
+#include "../../../graph/entities/multi_edge.h"
 
 // Forword decleration.
 static void _RdbSaveSIValue(RedisModuleIO *rdb, const SIValue *v);
 
+// Creates an iterator over relation matrix 'r' and its pending changes.
+static RG_MatrixTupleIter *_RelationIterator(const Graph *g, int r) {
+	GrB_Matrix M;
+	GrB_Matrix DP;
+	GrB_Matrix DM;
+	Graph_GetRelationMatrixDeltas(g, r, false, &M, &DP, &DM);
+	return RG_MatrixTupleIter_new(M, DP, DM);
+}
+
 static void _RdbSaveSIArray(RedisModuleIO *rdb, const SIValue list) {
 	/* saves array as
 	   unsigned : array legnth
@@ -94,7 +104,7 @@ static void _RdbSaveEdge(RedisModuleIO *rdb, const Graph *g, const Edge *e, int
 	_RdbSaveEntity(rdb, e->entity);
 }
 
-static void _RdbSaveNode_v9(RedisModuleIO *rdb, GraphContext *gc, GraphEntity *n) {
+static void _RdbSaveNode_v10(RedisModuleIO *rdb, GraphContext *gc, GraphEntity *n) {
 	/* Format:
 	*      ID
 	*      #labels M
@@ -119,7 +129,7 @@ static void _RdbSaveNode_v9(RedisModuleIO *rdb, GraphContext *gc, GraphEntity *n
 	_RdbSaveEntity(rdb, n->entity);
 }
 
-static void _RdbSaveDeletedEntities_v9(RedisModuleIO *rdb, GraphContext *gc,
+static void _RdbSaveDeletedEntities_v10(RedisModuleIO *rdb, GraphContext *gc,
 									   uint64_t deleted_entities_to_encode, uint64_t *deleted_id_list) {
 	// Get the number of deleted entities already encoded.
 	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(gc->encoding_context);
@@ -130,7 +140,7 @@ static void _RdbSaveDeletedEntities_v9(RedisModuleIO *rdb, GraphContext *gc,
 	}
 }
 
-void RdbSaveDeletedNodes_v9(RedisModuleIO *rdb, GraphContext *gc,
+void RdbSaveDeletedNodes_v10(RedisModuleIO *rdb, GraphContext *gc,
 							uint64_t deleted_nodes_to_encode) {
 	/* Format:
 	 * node id X N */
@@ -138,10 +148,10 @@ void RdbSaveDeletedNodes_v9(RedisModuleIO *rdb, GraphContext *gc,
 	if(deleted_nodes_to_encode == 0) return;
 	// Get deleted nodes list.
 	uint64_t *deleted_nodes_list = Serializer_Graph_GetDeletedNodesList(gc->g);
-	_RdbSaveDeletedEntities_v9(rdb, gc, deleted_nodes_to_encode, deleted_nodes_list);
+	_RdbSaveDeletedEntities_v10(rdb, gc, deleted_nodes_to_encode, deleted_nodes_list);
 }
 
-void RdbSaveDeletedEdges_v9(RedisModuleIO *rdb, GraphContext *gc,
+void RdbSaveDeletedEdges_v10(RedisModuleIO *rdb, GraphContext *gc,
 							uint64_t deleted_edges_to_encode) {
 	/* Format:
 	 * edge id X N */
@@ -149,10 +159,10 @@ void RdbSaveDeletedEdges_v9(RedisModuleIO *rdb, GraphContext *gc,
 	if(deleted_edges_to_encode == 0) return;
 	// Get deleted edges list.
 	uint64_t *deleted_edges_list = Serializer_Graph_GetDeletedEdgesList(gc->g);
-	_RdbSaveDeletedEntities_v9(rdb, gc, deleted_edges_to_encode, deleted_edges_list);
+	_RdbSaveDeletedEntities_v10(rdb, gc, deleted_edges_to_encode, deleted_edges_list);
 }
 
-void RdbSaveNodes_v9(RedisModuleIO *rdb, GraphContext *gc, uint64_t nodes_to_encode) {
+void RdbSaveNodes_v10(RedisModuleIO *rdb, GraphContext *gc, uint64_t nodes_to_encode) {
 	/* Format:
 	 * Node Format * nodes_to_encode:
 	 *  ID
@@ -178,7 +188,7 @@ void RdbSaveNodes_v9(RedisModuleIO *rdb, GraphContext *gc, uint64_t nodes_to_enc
 	for(uint64_t i = 0; i < nodes_to_encode; i++) {
 		GraphEntity e;
 		e.entity = (Entity *)DataBlockIterator_Next(iter, &e.id);
-		_RdbSaveNode_v9(rdb, gc, &e);
+		_RdbSaveNode_v10(rdb, gc, &e);
 	}
 
 	// Check if done encodeing nodes.
@@ -201,7 +211,7 @@ static void _RdbSaveMultipleEdges(RedisModuleIO *rdb,                  // RDB IO
 								  NodeID src,                          // Edges source node id.
 								  NodeID dest                          // Edges destination node id.
 								 ) {
-	uint edgeCount = array_len(multiple_edges_array);
+	uint edgeCount = MultiEdge_Count(multiple_edges_array);
 	// Define function local variables from passed-by-reference parameters.
 	uint i = *multiple_edges_current_index;
 	uint encoded_edges_count = *encoded_edges;
@@ -220,7 +230,7 @@ static void _RdbSaveMultipleEdges(RedisModuleIO *rdb,                  // RDB IO
 	*multiple_edges_current_index = i;
 }
 
-void RdbSaveEdges_v9(RedisModuleIO *rdb, GraphContext *gc, uint64_t edges_to_encode) {
+void RdbSaveEdges_v10(RedisModuleIO *rdb, GraphContext *gc, uint64_t edges_to_encode) {
 	/* Format:
 	 * Edge format * edges_to_encode:
 	 *  edge ID
@@ -242,10 +252,9 @@ void RdbSaveEdges_v9(RedisModuleIO *rdb, GraphContext *gc, uint64_t edges_to_enc
 	// Get current relation matrix.
 	uint r = GraphEncodeContext_GetCurrentRelationID(gc->encoding_context);
 
-	GrB_Matrix M = Graph_GetRelationMatrix(gc->g, r);
 	// Get matrix tuple iterator from context, already set to the next entry to fetch, for previous edge encide or create new one.
-	GxB_MatrixTupleIter *iter = GraphEncodeContext_GetMatrixTupleIterator(gc->encoding_context);
-	if(!iter) GxB_MatrixTupleIter_new(&iter, M);
+	RG_MatrixTupleIter *iter = GraphEncodeContext_GetMatrixTupleIterator(gc->encoding_context);
+	if(!iter) iter = _RelationIterator(gc->g, r);
 
 	// First, see if the last edges encoding stopped at multiple edges array
 	EdgeID *multiple_edges_array = GraphEncodeContext_GetMultipleEdgesArray(gc->encoding_context);
@@ -272,28 +281,24 @@ void RdbSaveEdges_v9(RedisModuleIO *rdb, GraphContext *gc, uint64_t edges_to_enc
 	while(encoded_edges < edges_to_encode) {
 		Edge e;
 		EdgeID edgeID;
-		bool depleted = false;
-		// Try to get next tuple.
-		GxB_MatrixTupleIter_next(iter, &src, &dest, &depleted);
+		// Try to get next tuple, pending changes are visited along the way.
+		bool depleted = !RG_MatrixTupleIter_next(iter, &src, &dest, &edgeID);
 		// If iterator is depleted, get new tuple from different matrix or finish encode.
 		while(depleted && r < relation_count) {
 			// Free iterator
-			GxB_MatrixTupleIter_free(iter);
+			RG_MatrixTupleIter_free(iter);
 			iter = NULL;
-			depleted = false;
 			// Proceed to next relation matrix.
 			r++;
 			// If done iterating over all the matrices, jump to finish.
 			if(r == relation_count) goto finish;
-			// Get matrix and set iterator.
-			M = Graph_GetRelationMatrix(gc->g, r);
-			GxB_MatrixTupleIter_new(&iter, M);
-			GxB_MatrixTupleIter_next(iter, &src, &dest, &depleted);
+			// Set iterator.
+			iter = _RelationIterator(gc->g, r);
+			depleted = !RG_MatrixTupleIter_next(iter, &src, &dest, &edgeID);
 		}
 
 		e.srcNodeID = src;
 		e.destNodeID = dest;
-		GrB_Matrix_extractElement_UINT64(&edgeID, M, e.srcNodeID, e.destNodeID);
 		if(SINGLE_EDGE(edgeID)) {
 			edgeID = SINGLE_EDGE_ID(edgeID);
 			Graph_GetEdge(gc->g, edgeID, &e);
@@ -318,7 +323,7 @@ finish:
 	// Check if done encoding edges.
 	if(offset + edges_to_encode == graph_edges) {
 		if(iter) {
-			GxB_MatrixTupleIter_free(iter);
+			RG_MatrixTupleIter_free(iter);
 			iter = NULL;
 		}
 	}
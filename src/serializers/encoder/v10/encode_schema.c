@@ -4,7 +4,7 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
-#include "encode_v9.h"
+#include "encode_v10.h"
 
 static void _RdbSaveAttributeKeys(RedisModuleIO *rdb, GraphContext *gc) {
 	/* Format:
@@ -31,12 +31,24 @@ static inline void _RdbSaveIndexData(RedisModuleIO *rdb, Index *idx) {
 	}
 }
 
-static void _RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
+static inline void _RdbSaveColumns(RedisModuleIO *rdb, GraphContext *gc, Schema *s) {
+	uint count = array_len(s->columns);
+	RedisModule_SaveUnsigned(rdb, count);
+	for(uint i = 0; i < count; i++) {
+		// Column property
+		const char *field = GraphContext_GetAttributeString(gc, s->columns[i]->attr_id);
+		RedisModule_SaveStringBuffer(rdb, field, strlen(field) + 1);
+	}
+}
+
+static void _RdbSaveSchema(RedisModuleIO *rdb, GraphContext *gc, Schema *s) {
 	/* Format:
 	 * id
 	 * name
 	 * #indices
-	 * (index type, indexed property) X M */
+	 * (index type, indexed property) X M
+	 * #property columns
+	 * column property X N */
 
 	// Schema ID.
 	RedisModule_SaveUnsigned(rdb, s->id);
@@ -52,9 +64,12 @@ static void _RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
 
 	// Fulltext indices.
 	_RdbSaveIndexData(rdb, s->fulltextIdx);
+
+	// Property columns.
+	_RdbSaveColumns(rdb, gc, s);
 }
 
-void RdbSaveGraphSchema_v9(RedisModuleIO *rdb, GraphContext *gc) {
+void RdbSaveGraphSchema_v10(RedisModuleIO *rdb, GraphContext *gc) {
 	/* Format:
 	 * attribute keys (unified schema)
 	 * #node schemas
@@ -73,7 +88,7 @@ void RdbSaveGraphSchema_v9(RedisModuleIO *rdb, GraphContext *gc) {
 	// Name of label X #node schemas.
 	for(int i = 0; i < schema_count; i++) {
 		Schema *s = gc->node_schemas[i];
-		_RdbSaveSchema(rdb, s);
+		_RdbSaveSchema(rdb, gc, s);
 	}
 
 	// #Relation schemas.
@@ -83,6 +98,6 @@ void RdbSaveGraphSchema_v9(RedisModuleIO *rdb, GraphContext *gc) {
 	// Name of label X #relation schemas.
 	for(unsigned short i = 0; i < relation_count; i++) {
 		Schema *s = gc->relation_schemas[i];
-		_RdbSaveSchema(rdb, s);
+		_RdbSaveSchema(rdb, gc, s);
 	}
 }
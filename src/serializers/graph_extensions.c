@@ -10,6 +10,7 @@
 
 // Functions declerations - implemented in graph.c
 void Graph_FormConnection(Graph *g, NodeID src, NodeID dest, EdgeID edge_id, int r);
+void Graph_MarkNodeLabel(Graph *g, NodeID nodeID, int label);
 
 inline void Serializer_Graph_MarkEdgeDeleted(Graph *g, EdgeID id) {
 	DataBlock_MarkAsDeletedOutOfOrder(g->edges, id);
@@ -21,21 +22,10 @@ inline void Serializer_Graph_MarkNodeDeleted(Graph *g, NodeID id) {
 
 void Serializer_Graph_SetNode(Graph *g, NodeID id, int label, Node *n) {
 	ASSERT(g);
-#ifdef LABEL_DATABLOCK
-	NodeID id_new;
-	Entity *en = DataBlock_AllocateItemOutOfOrder_Label(g->nodes, &id_new, label);
-	en->prop_count = 0;
-	en->properties = NULL;
-	n->id = id_new;
-	n->entity = en;
-	if(label != GRAPH_NO_LABEL) {
-		// Set matrix at position [id, id]
-		GrB_Matrix m = Graph_GetLabelMatrix(g, label);
-		GrB_Matrix_setElement_BOOL(m, true, id_new, id_new);
-	}
-#else
-	Entity *en = DataBlock_AllocateItemOutOfOrder(g->nodes, id);
+	Entity *en = DataBlock_AllocateItemOutOfOrder_Label(g->nodes, id, label);
 	en->prop_count = 0;
+	en->prop_cap = 0;
+	en->heat = 0;
 	en->properties = NULL;
 	n->id = id;
 	n->entity = en;
@@ -43,27 +33,16 @@ void Serializer_Graph_SetNode(Graph *g, NodeID id, int label, Node *n) {
 		// Set matrix at position [id, id]
 		GrB_Matrix m = Graph_GetLabelMatrix(g, label);
 		GrB_Matrix_setElement_BOOL(m, true, id, id);
+		Graph_MarkNodeLabel(g, id, label);
 	}
-#endif
 }
 
 // Set a given edge in the graph - Used for deserialization of graph.
 void Serializer_Graph_SetEdge(Graph *g, EdgeID edge_id, NodeID src, NodeID dest, int r, Edge *e) {
-	GrB_Info info;
-#ifdef LABEL_DATABLOCK
-	EdgeID id_new;
-    Entity *en = DataBlock_AllocateItemOutOfOrder_Label(g->edges, &id_new, r);
-    en->prop_count = 0;
-    en->properties = NULL;
-    e->id = id_new;
-    e->entity = en;
-    e->relationID = r;
-    e->srcNodeID = src;
-    e->destNodeID = dest;
-    Graph_FormConnection(g, src, dest, id_new, r);
-#else
 	Entity *en = DataBlock_AllocateItemOutOfOrder(g->edges, edge_id);
 	en->prop_count = 0;
+	en->prop_cap = 0;
+	en->heat = 0;
 	en->properties = NULL;
 	e->id = edge_id;
 	e->entity = en;
@@ -71,17 +50,20 @@ void Serializer_Graph_SetEdge(Graph *g, EdgeID edge_id, NodeID src, NodeID dest,
 	e->srcNodeID = src;
 	e->destNodeID = dest;
 	Graph_FormConnection(g, src, dest, edge_id, r);
-#endif
 }
 
+// Completes the node storage once every node was set.
+void Serializer_Graph_FinalizeNodes(Graph *g) {
+	DataBlock_BuildLabelChains(g->nodes);
+}
 
 // Returns the graph deleted nodes list.
 uint64_t *Serializer_Graph_GetDeletedNodesList(Graph *g) {
-	return g->nodes->deletedIdx;
+	return DataBlock_DeletedItems(g->nodes);
 }
 
 // Returns the graph deleted nodes list.
 uint64_t *Serializer_Graph_GetDeletedEdgesList(Graph *g) {
-	return g->edges->deletedIdx;
+	return DataBlock_DeletedItems(g->edges);
 }
 
@@ -11,6 +11,10 @@
 // Sets a node in the graph
 void Serializer_Graph_SetNode(Graph *g, NodeID id, int label, Node *n);
 
+// Completes the node storage once every node was set,
+// must be called before the graph is used.
+void Serializer_Graph_FinalizeNodes(Graph *g);
+
 // Set a given edge in the graph.
 void Serializer_Graph_SetEdge(Graph *g, EdgeID edge_id, NodeID src, NodeID dest, int r, Edge *e);
 
@@ -11,6 +11,7 @@
 #include "decoders/decode_graph.h"
 #include "decoders/decode_previous.h"
 #include "../util/redis_version.h"
+#include "../nvm_support/graph_image.h"
 
 // forward declerations of the module event handler functions
 void ModuleEventHandler_AUXBeforeKeyspaceEvent(void);
@@ -39,6 +40,7 @@ static void *_GraphContextType_RdbLoad(RedisModuleIO *rdb, int encver) {
 		// Current version.
 		gc = RdbLoadGraph(rdb);
 	}
+	if(gc == NULL) return NULL;
 	// Add GraphContext to global array of graphs.
 	GraphContext_RegisterWithModule(gc);
 	return gc;
@@ -53,14 +55,16 @@ static void _GraphContextType_AofRewrite(RedisModuleIO *aof, RedisModuleString *
 	// TODO: implement.
 }
 
-// Save an unsigned placeholder before and after the keyspace encoding.
+// Save the identifier of the save in progress before and after the keyspace encoding,
+// 0 if it has none. Persisted graph images are matched against it, see graph_image.h.
 static void _GraphContextType_AuxSave(RedisModuleIO *rdb, int when) {
-	RedisModule_SaveUnsigned(rdb, 0);
+	RedisModule_SaveUnsigned(rdb, GraphImage_SaveID());
 }
 
-// Decode the unsigned placeholders saved before and after the keyspace values and call the module event handler.
+// Decode the save identifiers saved before and after the keyspace values and call the module event handler.
 static int _GraphContextType_AuxLoad(RedisModuleIO *rdb, int encver, int when) {
-	RedisModule_LoadUnsigned(rdb);
+	uint64_t save_id = RedisModule_LoadUnsigned(rdb);
+	if(when == REDISMODULE_AUX_BEFORE_RDB) GraphImage_SetLoadID(save_id);
 	if(when == REDISMODULE_AUX_BEFORE_RDB) ModuleEventHandler_AUXBeforeKeyspaceEvent();
 	else ModuleEventHandler_AUXAfterKeyspaceEvent();
 	return REDISMODULE_OK;
@@ -15,15 +15,15 @@ Block *Block_New(uint itemSize, uint capacity) {
 	return block;
 }
 
+size_t Block_Data_Size(uint itemSize, uint capacity) {
+	return sizeof(Block) + BLOCK_BITMAP_OFFSET(itemSize, capacity) + BLOCK_BITMAP_SIZE(capacity);
+}
+
 Block *Block_New_Data(uint itemSize, uint capacity) {
-    ASSERT(itemSize > 0);
-#ifdef SLOW_BLOCK
-    Block *block = nvm_calloc(1, sizeof(Block) + (capacity * itemSize));
-#else
-    Block *block = rm_calloc(1, sizeof(Block) + (capacity * itemSize));
-#endif
-    block->itemSize = itemSize;
-    return block;
+	ASSERT(itemSize > 0);
+	Block *block = nvm_class_calloc(NVM_CLASS_DATABLOCK, 1, Block_Data_Size(itemSize, capacity));
+	block->itemSize = itemSize;
+	return block;
 }
 
 void Block_Free(Block *block) {
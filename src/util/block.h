@@ -7,28 +7,41 @@
 #pragma once
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <sys/types.h>
 
-//#define LABEL_DATABLOCK
-
-#ifdef LABEL_DATABLOCK
-#define UNKNOWN_LABEL (-2)
-#define LABEL_ITERATOR
-#endif
-
 /* The Block is a type-agnostic block of continuous memory used to hold items of the same type.
- * Each block has a next pointer to another block, or NULL if this is the last block. */
+ * Each block has a next pointer to another block, or NULL if this is the last block.
+ * Blocks of a DataBlock clustered by label also form a chain per label. */
 typedef struct Block {
-	size_t itemSize;        // Size of a single item in bytes.
-	struct Block *next;     // Pointer to next block.
-#ifdef LABEL_ITERATOR
-    int label;
-    int label_next;
-#endif
-	unsigned char data[];   // Item array. MUST BE LAST MEMBER OF THE STRUCT!
+	size_t itemSize;            // Size of a single item in bytes.
+	struct Block *next;         // Pointer to next block.
+	uint index;                 // Position of the block within its DataBlock.
+	int label;                  // Label of the items held by the block.
+	uint used;                  // Number of leading positions handed out.
+	struct Block *label_next;   // Next block with the same label, NULL for last.
+	unsigned char data[];       // Item array. MUST BE LAST MEMBER OF THE STRUCT!
 } Block;
 
+// Data blocks are followed by a validity bitmap, one bit per item, set for items in use.
+// The bitmap starts at the first 8 bytes aligned offset past the item array.
+#define BLOCK_BITMAP_OFFSET(itemSize, capacity) \
+	((((size_t)(itemSize) * (capacity)) + 7) & ~(size_t)7)
+
+#define BLOCK_BITMAP_SIZE(capacity) \
+	((((size_t)(capacity) + 63) / 64) * sizeof(uint64_t))
+
+// Validity bitmap of a data block holding capacity items.
+#define BLOCK_BITMAP(block, capacity) \
+	((uint64_t *)((block)->data + BLOCK_BITMAP_OFFSET((block)->itemSize, capacity)))
+
 Block *Block_New(uint itemSize, uint capacity);
+
+// Creates a data block, every bit of its validity bitmap is clear.
 Block *Block_New_Data(uint itemSize, uint capacity);
+
+// Size in bytes of a data block holding capacity items.
+size_t Block_Data_Size(uint itemSize, uint capacity);
+
 void Block_Free(Block *block);
 
@@ -9,8 +9,10 @@
 #include "datablock_iterator.h"
 #include "../arr.h"
 #include "../rmalloc.h"
+#include "../qsort.h"
 #include <math.h>
 #include <stdbool.h>
+#include <string.h>
 
 // Computes the number of blocks required to accommodate n items.
 #define ITEM_COUNT_TO_BLOCK_COUNT(n) \
@@ -28,64 +30,49 @@
 #define GET_ITEM_BLOCK(dataBlock, idx) \
     dataBlock->blocks[ITEM_INDEX_TO_BLOCK_INDEX(idx)]
 
-#ifdef BITMAP_DATABLOCK
-
-// Computes the number of blocks required to accommodate n items.
-#define AD_ITEM_COUNT_TO_BLOCK_COUNT(n) \
-    ceil((double)n / DATABLOCK_BLOCK_CAP)
-
-void DataBlock_SetBitmap(const DataBlock *dataBlock,
-                                       uint64_t idx, bool bit) {
-    int out_idx = ITEM_POSITION_WITHIN_BLOCK(idx);
-    int in_idx = ITEM_INDEX_TO_BLOCK_INDEX(idx);
-    block_info* target = dataBlock->header + out_idx;
-    uint8_t mask_bit = 1 << (~in_idx & 7);
-    if (bit) target->bitmap[in_idx >> 3] |= mask_bit;
-    else target->bitmap[in_idx >> 3] &= ~mask_bit;
-}
-
-bool DataBlock_GetBitmap(const DataBlock *dataBlock,
-                                              uint64_t idx) {
-    int out_idx = ITEM_POSITION_WITHIN_BLOCK(idx);
-    int in_idx = ITEM_INDEX_TO_BLOCK_INDEX(idx);
-    block_info* target = dataBlock->header + out_idx;
-    return (target->bitmap[in_idx >> 3] >> (~in_idx & 7) & 1);
+// Orders item indices ascending.
+#define is_idx_lt(a, b) (*(a) < *(b))
+
+// Chain index of a label, shared blocks are chained first.
+#define LABEL_CHAIN_INDEX(label) \
+    ((label) - DATABLOCK_SHARED_LABEL)
+
+// Appends the positions within [from, to) of block which don't hold an item,
+// offset by base, to arr. Returns the updated array.
+static uint64_t *_DataBlock_CollectFree(uint64_t *arr, const Block *block, uint from, uint to,
+										uint64_t base) {
+	const uint64_t *bitmap = DATABLOCK_BITMAP(block);
+	for(uint w = from >> 6; (w << 6) < to; w++) {
+		uint64_t holes = ~bitmap[w];
+		// Mask positions outside of [from, to).
+		if((w << 6) < from) holes &= ~0ULL << (from & 63);
+		if(((w + 1) << 6) > to) holes &= ~(~0ULL << (to & 63));
+		while(holes) {
+			arr = array_append(arr, base + (w << 6) + __builtin_ctzll(holes));
+			holes &= holes - 1;
+		}
+	}
+	return arr;
 }
 
-#endif
-
 static void _DataBlock_AddBlocks(DataBlock *dataBlock, uint blockCount) {
 	ASSERT(dataBlock && blockCount > 0);
 
 	uint prevBlockCount = dataBlock->blockCount;
 	dataBlock->blockCount += blockCount;
-	if(!dataBlock->blocks) {
-        dataBlock->blocks = rm_malloc(sizeof(Block *) * dataBlock->blockCount);
-#ifdef LABEL_DATABLOCK
-        dataBlock->header = rm_malloc(sizeof(block_info) * dataBlock->blockCount);
-#endif
-    }
-	else {
+	if(!dataBlock->blocks)
+		dataBlock->blocks = rm_malloc(sizeof(Block *) * dataBlock->blockCount);
+	else
 		dataBlock->blocks = rm_realloc(dataBlock->blocks, sizeof(Block *) * dataBlock->blockCount);
-#ifdef LABEL_DATABLOCK
-		dataBlock->header = rm_realloc(dataBlock->header, sizeof(block_info) * dataBlock->blockCount);
-#endif
-	}
 
 	uint i;
 	for(i = prevBlockCount; i < dataBlock->blockCount; i++) {
-		dataBlock->blocks[i] = Block_New_Data(dataBlock->itemSize, DATABLOCK_BLOCK_CAP);
-#ifdef LABEL_DATABLOCK
-		dataBlock->header[i].count = 0;
-		dataBlock->header[i].label_id = UNKNOWN_LABEL;
-		dataBlock->header[i].label_next = -1;
-		dataBlock->header[i].index = -1;
-		dataBlock->header[i].deletedIdx = NULL;
-#ifdef LABEL_ITERATOR
-		dataBlock->blocks[i]->label_next = -1;
-        dataBlock->blocks[i]->label = UNKNOWN_LABEL;
-#endif
-#endif
+		Block *block = Block_New_Data(dataBlock->itemSize, DATABLOCK_BLOCK_CAP);
+		block->index = i;
+		block->label = DATABLOCK_UNOWNED_LABEL;
+		block->used = 0;
+		block->label_next = NULL;
+		dataBlock->blocks[i] = block;
 		if(i > 0) dataBlock->blocks[i - 1]->next = dataBlock->blocks[i];
 	}
 	dataBlock->blocks[i - 1]->next = NULL;
@@ -93,50 +80,193 @@ static void _DataBlock_AddBlocks(DataBlock *dataBlock, uint blockCount) {
 	dataBlock->itemCap = dataBlock->blockCount * DATABLOCK_BLOCK_CAP;
 }
 
+// Returns one past the highest index in use.
+static inline uint64_t _DataBlock_ItemSpan(const DataBlock *dataBlock) {
+	if(dataBlock->chains) return dataBlock->itemSpan;
+	return dataBlock->itemCount + array_len(dataBlock->deletedIdx);
+}
+
 // Checks to see if idx is within global array bounds
 // array bounds are between 0 and itemCount + #deleted indices
 // e.g. [3, 7, 2, D, 1, D, 5] where itemCount = 5 and #deleted indices is 2
 // and so it is valid to query the array with idx 6.
 static inline bool _DataBlock_IndexOutOfBounds(const DataBlock *dataBlock, uint64_t idx) {
-#ifdef BITMAP_DATABLOCK
-    // return DataBlock_GetBitmap(dataBlock, idx);
-    return 0;
-#else
-	return (idx >= (dataBlock->itemCount + array_len(dataBlock->deletedIdx)));
-#endif
+	return (idx >= _DataBlock_ItemSpan(dataBlock));
 }
 
-static inline DataBlockItemHeader *DataBlock_GetItemHeader(const DataBlock *dataBlock,
-														   uint64_t idx) {
+// Marks item at position idx as in use and returns it.
+static inline void *_DataBlock_SetItem(const DataBlock *dataBlock, uint64_t idx) {
 	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
 	idx = ITEM_POSITION_WITHIN_BLOCK(idx);
-	return (DataBlockItemHeader *)block->data + (idx * block->itemSize);
+	DATABLOCK_BITMAP_SET(block, idx);
+	return DATABLOCK_BLOCK_ITEM(block, idx);
+}
+
+//------------------------------------------------------------------------------
+// Label chains
+//------------------------------------------------------------------------------
+
+// Returns the chain of label, creating it if missing.
+static DataBlockLabelChain *_DataBlock_GetChain(DataBlock *dataBlock, int label) {
+	ASSERT(label >= DATABLOCK_SHARED_LABEL);
+
+	uint idx = LABEL_CHAIN_INDEX(label);
+	while(array_len(dataBlock->chains) <= idx) {
+		DataBlockLabelChain chain = {NULL, NULL, array_new(uint64_t, 16)};
+		dataBlock->chains = array_append(dataBlock->chains, chain);
+	}
+	return dataBlock->chains + idx;
+}
+
+// Appends block to chain, the chain keeps its blocks in ascending index order.
+static void _DataBlock_LinkBlock(DataBlockLabelChain *chain, Block *block) {
+	Block **link = &chain->first;
+	while(*link && (*link)->index < block->index) link = &(*link)->label_next;
+	block->label_next = *link;
+	*link = block;
+}
+
+// Free positions of block within [from, to) become available to its chain.
+static void _DataBlock_ReleasePositions(DataBlockLabelChain *chain, Block *block, uint from,
+										uint to) {
+	if(from >= to) return;
+	uint64_t base = (uint64_t)block->index * DATABLOCK_BLOCK_CAP;
+	chain->deletedIdx = _DataBlock_CollectFree(chain->deletedIdx, block, from, to, base);
+}
+
+// Assigns the lowest unowned block to label, adding a block if none is left.
+static void _DataBlock_ClaimBlock(DataBlock *dataBlock, DataBlockLabelChain *chain, int label) {
+	uint i = 0;
+	while(i < dataBlock->blockCount && dataBlock->blocks[i]->label != DATABLOCK_UNOWNED_LABEL) i++;
+	if(i == dataBlock->blockCount) _DataBlock_AddBlocks(dataBlock, 1);
+
+	Block *block = dataBlock->blocks[i];
+	block->label = label;
+	block->used = 0;
+	_DataBlock_LinkBlock(chain, block);
+	chain->current = block;
+}
+
+static void _DataBlock_FreeChains(DataBlock *dataBlock) {
+	uint n = array_len(dataBlock->chains);
+	for(uint i = 0; i < n; i++) array_free(dataBlock->chains[i].deletedIdx);
+	array_clear(dataBlock->chains);
+}
+
+void DataBlock_BuildLabelChains(DataBlock *dataBlock) {
+	ASSERT(dataBlock != NULL);
+	if(dataBlock->chains == NULL) return;
+
+	_DataBlock_FreeChains(dataBlock);
+	_DataBlock_GetChain(dataBlock, DATABLOCK_NO_LABEL);
+
+	dataBlock->itemSpan = 0;
+	for(uint i = 0; i < dataBlock->blockCount; i++) {
+		Block *block = dataBlock->blocks[i];
+		block->label_next = NULL;
+
+		// Blocks left without items are reused by any label.
+		if(block->label == DATABLOCK_UNOWNED_LABEL) {
+			block->used = 0;
+			continue;
+		}
+
+		DataBlockLabelChain *chain = _DataBlock_GetChain(dataBlock, block->label);
+		_DataBlock_ReleasePositions(chain, block, 0, block->used);
+
+		// Only the last block of a chain hands out unused positions,
+		// shared blocks never do.
+		Block *prev = chain->current;
+		if(prev) {
+			_DataBlock_ReleasePositions(chain, prev, prev->used, DATABLOCK_BLOCK_CAP);
+			prev->used = DATABLOCK_BLOCK_CAP;
+		}
+		if(block->label == DATABLOCK_SHARED_LABEL) {
+			_DataBlock_ReleasePositions(chain, block, block->used, DATABLOCK_BLOCK_CAP);
+			block->used = DATABLOCK_BLOCK_CAP;
+		}
+
+		_DataBlock_LinkBlock(chain, block);
+		chain->current = (block->label == DATABLOCK_SHARED_LABEL) ? NULL : block;
+	}
+
+	for(uint i = 0; i < dataBlock->blockCount; i++) {
+		Block *block = dataBlock->blocks[i];
+		if(block->used == 0) continue;
+		dataBlock->itemSpan = (uint64_t)i * DATABLOCK_BLOCK_CAP + block->used;
+	}
+
+	dataBlock->deletedIdxStale = true;
 }
 
 //------------------------------------------------------------------------------
 // DataBlock API implementation
 //------------------------------------------------------------------------------
 
-DataBlock *DataBlock_New(uint64_t itemCap, uint itemSize, fpDestructor fp) {
+static DataBlock *_DataBlock_New(uint64_t itemCap, uint itemSize, bool clustered,
+								 fpDestructor fp) {
 	DataBlock *dataBlock = rm_malloc(sizeof(DataBlock));
 	dataBlock->itemCount = 0;
-	dataBlock->itemSize = itemSize + ITEM_HEADER_SIZE;
+	dataBlock->itemSize = itemSize;
 	dataBlock->blockCount = 0;
 	dataBlock->blocks = NULL;
 	dataBlock->deletedIdx = array_new(uint64_t, 128);
+	dataBlock->chains = NULL;
+	dataBlock->itemSpan = 0;
+	dataBlock->deletedIdxStale = false;
 	dataBlock->destructor = fp;
 	int res = pthread_mutex_init(&dataBlock->mutex, NULL);
 	UNUSED(res);
 	ASSERT(res == 0);
-#ifdef LABEL_DATABLOCK
-    dataBlock->header = NULL;
-    _DataBlock_AddBlocks(dataBlock, ITEM_COUNT_TO_BLOCK_COUNT(itemCap));
-#else
+
+	if(clustered) {
+		dataBlock->chains = array_new(DataBlockLabelChain, 4);
+		_DataBlock_GetChain(dataBlock, DATABLOCK_NO_LABEL);
+	}
+
 	_DataBlock_AddBlocks(dataBlock, ITEM_COUNT_TO_BLOCK_COUNT(itemCap));
-#endif
 	return dataBlock;
 }
 
+DataBlock *DataBlock_New(uint64_t itemCap, uint itemSize, fpDestructor fp) {
+	return _DataBlock_New(itemCap, itemSize, false, fp);
+}
+
+DataBlock *DataBlock_NewClustered(uint64_t itemCap, uint itemSize, fpDestructor fp) {
+	return _DataBlock_New(itemCap, itemSize, true, fp);
+}
+
+DataBlock *DataBlock_Restore(Block **blocks, uint blockCount, uint64_t itemCount,
+		uint itemSize, uint64_t *deletedIdx, bool clustered, fpDestructor fp) {
+	ASSERT(blocks != NULL && blockCount > 0 && deletedIdx != NULL);
+
+	DataBlock *dataBlock = rm_malloc(sizeof(DataBlock));
+	dataBlock->itemCount = itemCount;
+	dataBlock->itemSize = itemSize;
+	dataBlock->blockCount = blockCount;
+	dataBlock->itemCap = blockCount * DATABLOCK_BLOCK_CAP;
+	dataBlock->blocks = blocks;
+	dataBlock->deletedIdx = deletedIdx;
+	dataBlock->chains = NULL;
+	dataBlock->itemSpan = 0;
+	dataBlock->deletedIdxStale = false;
+	dataBlock->destructor = fp;
+	int res = pthread_mutex_init(&dataBlock->mutex, NULL);
+	UNUSED(res);
+	ASSERT(res == 0);
+
+	// Label chains are kept on DRAM and rebuilt out of the blocks' labels.
+	if(clustered) {
+		dataBlock->chains = array_new(DataBlockLabelChain, 4);
+		DataBlock_BuildLabelChains(dataBlock);
+	}
+	return dataBlock;
+}
+
+inline bool DataBlock_IsClustered(const DataBlock *dataBlock) {
+	return dataBlock->chains != NULL;
+}
+
 uint64_t DataBlock_ItemCount(const DataBlock *dataBlock) {
 	return dataBlock->itemCount;
 }
@@ -146,15 +276,37 @@ DataBlockIterator *DataBlock_Scan(const DataBlock *dataBlock) {
 	Block *startBlock = dataBlock->blocks[0];
 
 	// Deleted items are skipped, we're about to perform
-	// array_len(dataBlock->deletedIdx) skips during out scan.
-#ifdef LABEL_DATABLOCK
-    int64_t endPos = dataBlock->blockCount << 14;
-#else
-	int64_t endPos = dataBlock->itemCount + array_len(dataBlock->deletedIdx);
-#endif
+	// DataBlock_DeletedItemsCount skips during out scan.
+	int64_t endPos = _DataBlock_ItemSpan(dataBlock);
 	return DataBlockIterator_New(startBlock, 0, endPos, 1);
 }
 
+DataBlockIterator *DataBlock_ScanRange(const DataBlock *dataBlock, uint64_t start, uint64_t end) {
+	ASSERT(dataBlock != NULL);
+
+	uint64_t span = _DataBlock_ItemSpan(dataBlock);
+	if(end > span) end = span;
+	// Empty range.
+	if(start >= end) return DataBlockIterator_New(dataBlock->blocks[0], 0, 0, 1);
+
+	Block *startBlock = GET_ITEM_BLOCK(dataBlock, start);
+	return DataBlockIterator_New(startBlock, start, end, 1);
+}
+
+DataBlockIterator *DataBlock_ScanLabel(const DataBlock *dataBlock, int label,
+		uint64_t start, uint64_t end) {
+	ASSERT(dataBlock != NULL && dataBlock->chains != NULL);
+
+	Block *first = NULL;
+	uint idx = LABEL_CHAIN_INDEX(label);
+	if(idx < array_len(dataBlock->chains)) first = dataBlock->chains[idx].first;
+	Block *shared = dataBlock->chains[LABEL_CHAIN_INDEX(DATABLOCK_SHARED_LABEL)].first;
+
+	if(end > dataBlock->itemSpan) end = dataBlock->itemSpan;
+	if(start > end) start = end;
+	return DataBlockIterator_NewLabel(first, shared, start, end);
+}
+
 // Make sure datablock can accommodate at least k items.
 void DataBlock_Accommodate(DataBlock *dataBlock, int64_t k) {
 	// Compute number of free slots.
@@ -172,20 +324,18 @@ void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx) {
 
 	ASSERT(!_DataBlock_IndexOutOfBounds(dataBlock, idx));
 
-	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, idx);
+	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
+	idx = ITEM_POSITION_WITHIN_BLOCK(idx);
 
-#ifdef BITMAP_DATABLOCK
-    if (DataBlock_GetBitmap(dataBlock, idx)) return NULL;
-    return item_header;
-#else
 	// Incase item is marked as deleted, return NULL.
-	if(IS_ITEM_DELETED(item_header)) return NULL;
+	if(!DATABLOCK_BITMAP_TEST(block, idx)) return NULL;
 
-	return ITEM_DATA(item_header);
-#endif
+	return DATABLOCK_BLOCK_ITEM(block, idx);
 }
 
 void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
+	if(dataBlock->chains) return DataBlock_AllocateItem_Label(dataBlock, DATABLOCK_NO_LABEL, idx);
+
 	// Make sure we've got room for items.
 	if(dataBlock->itemCount >= dataBlock->itemCap) {
 		// Allocate twice as much items then we currently hold.
@@ -204,43 +354,56 @@ void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
 
 	if(idx) *idx = pos;
 
-	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, pos);
-#ifdef BITMAP_DATABLOCK
-    DataBlock_SetBitmap(dataBlock, pos, 0);
-    return item_header;
-#else
-	MARK_HEADER_AS_NOT_DELETED(item_header);
-	return ITEM_DATA(item_header);
-#endif
+	return _DataBlock_SetItem(dataBlock, pos);
+}
+
+void *DataBlock_AllocateItem_Label(DataBlock *dataBlock, int label, uint64_t *idx) {
+	if(dataBlock->chains == NULL) return DataBlock_AllocateItem(dataBlock, idx);
+
+	DataBlockLabelChain *chain = _DataBlock_GetChain(dataBlock, label);
+	DataBlockLabelChain *shared = dataBlock->chains + LABEL_CHAIN_INDEX(DATABLOCK_SHARED_LABEL);
+
+	// Prefer reusing free indicies of the label,
+	// unlabeled items also reuse free indicies of shared blocks.
+	uint64_t pos;
+	if(array_len(chain->deletedIdx) > 0) {
+		pos = array_pop(chain->deletedIdx);
+	} else if(label == DATABLOCK_NO_LABEL && array_len(shared->deletedIdx) > 0) {
+		pos = array_pop(shared->deletedIdx);
+	} else {
+		if(!chain->current || chain->current->used == DATABLOCK_BLOCK_CAP) {
+			_DataBlock_ClaimBlock(dataBlock, chain, label);
+		}
+		Block *block = chain->current;
+		pos = (uint64_t)block->index * DATABLOCK_BLOCK_CAP + block->used;
+		block->used++;
+	}
+
+	dataBlock->itemCount++;
+	if(pos >= dataBlock->itemSpan) dataBlock->itemSpan = pos + 1;
+	dataBlock->deletedIdxStale = true;
+
+	if(idx) *idx = pos;
+
+	return _DataBlock_SetItem(dataBlock, pos);
 }
 
 void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx) {
 	ASSERT(dataBlock != NULL);
 	ASSERT(!_DataBlock_IndexOutOfBounds(dataBlock, idx));
 
+	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
+	uint pos = ITEM_POSITION_WITHIN_BLOCK(idx);
+
+	// Deletions may run concurrently and clear bits of the same bitmap word.
 	// Return if item already deleted.
-	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, idx);
-#ifdef BITMAP_DATABLOCK
-    if (DataBlock_GetBitmap(dataBlock, idx)) return;
-#else
-	if(IS_ITEM_DELETED(item_header)) return;
-#endif
+	uint64_t mask = 1ULL << (pos & 63);
+	uint64_t word = __atomic_fetch_and(DATABLOCK_BITMAP(block) + (pos >> 6), ~mask,
+									   __ATOMIC_RELAXED);
+	if(!(word & mask)) return;
 
 	// Call item destructor.
-	if(dataBlock->destructor) {
-#ifdef BITMAP_DATABLOCK
-        unsigned char *item = (unsigned char *)(item_header);
-#else
-		unsigned char *item = ITEM_DATA(item_header);
-#endif
-		dataBlock->destructor(item);
-	}
-
-#ifdef BITMAP_DATABLOCK
-    DataBlock_SetBitmap(dataBlock, idx, 1);
-#else
-	MARK_HEADER_AS_DELETED(item_header);
-#endif
+	if(dataBlock->destructor) dataBlock->destructor(DATABLOCK_BLOCK_ITEM(block, pos));
 
 	/* DataBlock_DeleteItem should be thread-safe as it's being called
 	 * from GraphBLAS concurent operations, e.g. GxB_SelectOp.
@@ -250,23 +413,165 @@ void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx) {
 	 * in a thread safe matter. */
 	pthread_mutex_lock(&dataBlock->mutex);
 	{
-		dataBlock->deletedIdx = array_append(dataBlock->deletedIdx, idx);
+		if(dataBlock->chains) {
+			// Free indicies are reused by items of the block's label.
+			DataBlockLabelChain *chain = dataBlock->chains + LABEL_CHAIN_INDEX(block->label);
+			chain->deletedIdx = array_append(chain->deletedIdx, idx);
+			dataBlock->deletedIdxStale = true;
+		} else {
+			dataBlock->deletedIdx = array_append(dataBlock->deletedIdx, idx);
+		}
 		dataBlock->itemCount--;
 	}
 	pthread_mutex_unlock(&dataBlock->mutex);
 }
 
+void DataBlock_DeleteItems(DataBlock *dataBlock, uint64_t *idx, uint64_t count, int nthreads) {
+	ASSERT(dataBlock != NULL);
+	if(count == 0) return;
+
+	// Group positions by block.
+	QSORT(uint64_t, idx, count, is_idx_lt);
+
+	uint64_t *starts = array_new(uint64_t, 1);
+	for(uint64_t i = 0; i < count; i++) {
+		ASSERT(!_DataBlock_IndexOutOfBounds(dataBlock, idx[i]));
+		if(i == 0 || ITEM_INDEX_TO_BLOCK_INDEX(idx[i]) != ITEM_INDEX_TO_BLOCK_INDEX(idx[i - 1])) {
+			starts = array_append(starts, i);
+		}
+	}
+	int64_t group_count = array_len(starts);
+	starts = array_append(starts, count);
+
+	// Items are released concurrently, one block per thread.
+	// Positions which don't hold an item are marked with UINT64_MAX.
+	uint64_t deleted = 0;
+	#pragma omp parallel for num_threads(nthreads) schedule(dynamic) reduction(+:deleted)
+	for(int64_t g = 0; g < group_count; g++) {
+		Block *block = GET_ITEM_BLOCK(dataBlock, idx[starts[g]]);
+		for(uint64_t i = starts[g]; i < starts[g + 1]; i++) {
+			uint pos = ITEM_POSITION_WITHIN_BLOCK(idx[i]);
+			uint64_t mask = 1ULL << (pos & 63);
+			uint64_t word = __atomic_fetch_and(DATABLOCK_BITMAP(block) + (pos >> 6), ~mask,
+											   __ATOMIC_RELAXED);
+			if(!(word & mask)) {
+				idx[i] = UINT64_MAX;
+				continue;
+			}
+			if(dataBlock->destructor) dataBlock->destructor(DATABLOCK_BLOCK_ITEM(block, pos));
+			deleted++;
+		}
+	}
+	array_free(starts);
+
+	pthread_mutex_lock(&dataBlock->mutex);
+	{
+		for(uint64_t i = 0; i < count; i++) {
+			if(idx[i] == UINT64_MAX) continue;
+			if(dataBlock->chains) {
+				Block *block = GET_ITEM_BLOCK(dataBlock, idx[i]);
+				DataBlockLabelChain *chain = dataBlock->chains + LABEL_CHAIN_INDEX(block->label);
+				chain->deletedIdx = array_append(chain->deletedIdx, idx[i]);
+			} else {
+				dataBlock->deletedIdx = array_append(dataBlock->deletedIdx, idx[i]);
+			}
+		}
+		if(dataBlock->chains && deleted > 0) dataBlock->deletedIdxStale = true;
+		dataBlock->itemCount -= deleted;
+	}
+	pthread_mutex_unlock(&dataBlock->mutex);
+}
+
+// Moves the item at position src into the free position dst.
+static void _DataBlock_MoveItem(DataBlock *dataBlock, uint64_t src, uint64_t dst) {
+	Block *src_block = GET_ITEM_BLOCK(dataBlock, src);
+	Block *dst_block = GET_ITEM_BLOCK(dataBlock, dst);
+	uint src_pos = ITEM_POSITION_WITHIN_BLOCK(src);
+	uint dst_pos = ITEM_POSITION_WITHIN_BLOCK(dst);
+	ASSERT(DATABLOCK_BITMAP_TEST(src_block, src_pos));
+	ASSERT(!DATABLOCK_BITMAP_TEST(dst_block, dst_pos));
+
+	memcpy(DATABLOCK_BLOCK_ITEM(dst_block, dst_pos), DATABLOCK_BLOCK_ITEM(src_block, src_pos),
+		   dataBlock->itemSize);
+	DATABLOCK_BITMAP_SET(dst_block, dst_pos);
+	DATABLOCK_BITMAP_CLEAR(src_block, src_pos);
+}
+
+uint64_t DataBlock_Compact(DataBlock *dataBlock, uint64_t limit, uint64_t *from, uint64_t *to) {
+	ASSERT(dataBlock != NULL);
+	// Items of a clustered DataBlock must stay within blocks of their label.
+	if(dataBlock->chains) return 0;
+
+	// Free positions are filled lowest first, by the items at the highest positions.
+	uint64_t *deleted = dataBlock->deletedIdx;
+	uint64_t deleted_count = array_len(deleted);
+	QSORT(uint64_t, deleted, deleted_count, is_idx_lt);
+
+	uint64_t lo = 0;                    // Next free position to fill.
+	uint64_t hi = deleted_count;        // Free positions [lo, hi) are below span.
+	uint64_t span = _DataBlock_ItemSpan(dataBlock);
+	uint64_t moved = 0;
+	while(true) {
+		// Free positions at the end of the span are dropped.
+		while(hi > lo && deleted[hi - 1] == span - 1) {
+			hi--;
+			span--;
+		}
+		if(lo == hi || moved == limit) break;
+
+		// The last position of the span holds an item.
+		from[moved] = span - 1;
+		to[moved] = deleted[lo++];
+		_DataBlock_MoveItem(dataBlock, from[moved], to[moved]);
+		moved++;
+		span--;
+	}
+
+	// Keep the free positions which weren't filled.
+	memmove(deleted, deleted + lo, (hi - lo) * sizeof(uint64_t));
+	dataBlock->deletedIdx = array_trimm_len(deleted, hi - lo);
+
+	// Free blocks past the span, the first block is always kept.
+	uint blockCount = ITEM_COUNT_TO_BLOCK_COUNT(span);
+	if(blockCount == 0) blockCount = 1;
+	if(blockCount < dataBlock->blockCount) {
+		for(uint i = blockCount; i < dataBlock->blockCount; i++) Block_Free(dataBlock->blocks[i]);
+		dataBlock->blockCount = blockCount;
+		dataBlock->blocks = rm_realloc(dataBlock->blocks, sizeof(Block *) * blockCount);
+		dataBlock->blocks[blockCount - 1]->next = NULL;
+		dataBlock->itemCap = (uint64_t)blockCount * DATABLOCK_BLOCK_CAP;
+	}
+
+	return moved;
+}
+
 uint DataBlock_DeletedItemsCount(const DataBlock *dataBlock) {
+	if(dataBlock->chains) return dataBlock->itemSpan - dataBlock->itemCount;
 	return array_len(dataBlock->deletedIdx);
 }
 
-inline bool DataBlock_ItemIsDeleted(void *item) {
-#ifdef BITMAP_DATABLOCK
-    ASSERT(233);
-#else
-	DataBlockItemHeader *header = GET_ITEM_HEADER(item);
-	return IS_ITEM_DELETED(header);
-#endif
+uint64_t *DataBlock_DeletedItems(DataBlock *dataBlock) {
+	if(dataBlock->chains == NULL || !dataBlock->deletedIdxStale) return dataBlock->deletedIdx;
+
+	// Collect every position below the span which doesn't hold an item.
+	array_clear(dataBlock->deletedIdx);
+	for(uint i = 0; (uint64_t)i * DATABLOCK_BLOCK_CAP < dataBlock->itemSpan; i++) {
+		uint64_t base = (uint64_t)i * DATABLOCK_BLOCK_CAP;
+		uint64_t to = dataBlock->itemSpan - base;
+		if(to > DATABLOCK_BLOCK_CAP) to = DATABLOCK_BLOCK_CAP;
+		dataBlock->deletedIdx = _DataBlock_CollectFree(dataBlock->deletedIdx, dataBlock->blocks[i],
+													   0, to, base);
+	}
+	dataBlock->deletedIdxStale = false;
+	return dataBlock->deletedIdx;
+}
+
+bool DataBlock_ItemIsDeleted(const DataBlock *dataBlock, uint64_t idx) {
+	ASSERT(dataBlock != NULL);
+	if(_DataBlock_IndexOutOfBounds(dataBlock, idx)) return true;
+
+	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
+	return !DATABLOCK_BITMAP_TEST(block, ITEM_POSITION_WITHIN_BLOCK(idx));
 }
 
 void DataBlock_Free(DataBlock *dataBlock) {
@@ -274,139 +579,12 @@ void DataBlock_Free(DataBlock *dataBlock) {
 
 	rm_free(dataBlock->blocks);
 	array_free(dataBlock->deletedIdx);
+	if(dataBlock->chains) {
+		_DataBlock_FreeChains(dataBlock);
+		array_free(dataBlock->chains);
+	}
 	int res = pthread_mutex_destroy(&dataBlock->mutex);
 	UNUSED(res);
 	ASSERT(res == 0);
 	rm_free(dataBlock);
 }
-
-#ifdef LABEL_DATABLOCK
-
-void _DataBlock_InitBlock_Label(block_info *header, int label, int index, int next) {
-    header->count = 0;
-    header->label_id = label;
-    header->index = index;
-    header->label_next = next;
-    if (!header->deletedIdx) header->deletedIdx = array_new(uint64_t, 128);
-}
-
-void _DataBlock_AddBlocks_Label(DataBlock *dataBlock, uint blockCount, int last, int label) {
-	ASSERT(dataBlock && blockCount > 0);
-
-	uint prevBlockCount = dataBlock->blockCount;
-	int last_index = dataBlock->header[last].index;
-	if (last > -1) {
-	    dataBlock->header[last].label_next = prevBlockCount;
-#ifdef LABEL_ITERATOR
-	    dataBlock->blocks[last]->label_next = prevBlockCount;
-#endif
-	}
-	dataBlock->blockCount += blockCount;
-	if(!dataBlock->blocks) {
-        dataBlock->blocks = rm_malloc(sizeof(Block *) * dataBlock->blockCount);
-        dataBlock->header = rm_malloc(sizeof(block_info) * dataBlock->blockCount);
-    }
-	else {
-		dataBlock->blocks = rm_realloc(dataBlock->blocks, sizeof(Block *) * dataBlock->blockCount);
-		dataBlock->header = rm_realloc(dataBlock->header, sizeof(block_info) * dataBlock->blockCount);
-	}
-
-	uint i;
-	for(i = prevBlockCount; i < dataBlock->blockCount; i++) {
-		dataBlock->blocks[i] = Block_New_Data(dataBlock->itemSize, DATABLOCK_BLOCK_CAP);
-        _DataBlock_InitBlock_Label(&(dataBlock->header[i]), label, last_index + i - prevBlockCount + 1, i + 1);
-#ifdef LABEL_ITERATOR
-        dataBlock->blocks[i]->label_next = i + 1;
-        dataBlock->blocks[i]->label = label;
-#endif
-		if(i > 0) {
-			dataBlock->blocks[i - 1]->next = dataBlock->blocks[i];
-		}
-	}
-	dataBlock->blocks[i - 1]->next = NULL;
-	dataBlock->header[i - 1].label_next = -1;
-#ifdef LABEL_ITERATOR
-	dataBlock->blocks[i - 1]->label_next = -1;
-#endif
-
-	dataBlock->itemCap = dataBlock->blockCount * DATABLOCK_BLOCK_CAP;
-}
-
-void DataBlock_AccommodateBlock_Label(DataBlock *dataBlock, int blockCount, int last, int label) {
-    int current = last;
-    int to_alloc = blockCount;
-    int index = dataBlock->header[last].index;
-    for (; current < dataBlock->blockCount; current++) {
-        if (dataBlock->header[current].label_id == UNKNOWN_LABEL) {
-            dataBlock->header[last].label_next = current;
-#ifdef LABEL_ITERATOR
-            dataBlock->blocks[last]->label_next = current;
-#endif
-            _DataBlock_InitBlock_Label(&(dataBlock->header[current]), label, ++index, -1);
-#ifdef LABEL_ITERATOR
-            dataBlock->blocks[current]->label = label;
-#endif
-            to_alloc--;
-            last = current;
-        }
-        if (!to_alloc) return;
-    }
-    _DataBlock_AddBlocks_Label(dataBlock, to_alloc, last, label);
-}
-
-int DataBlock_GetFirstBlockNumByLabel(DataBlock *dataBlock, int label) {
-    uint blockCount = dataBlock->blockCount;
-    int i;
-    for (i = 0; i < blockCount; i++) {
-        if (dataBlock->header[i].label_id == label) return i;
-        if (dataBlock->header[i].label_id == UNKNOWN_LABEL) goto INIT_NEW;
-    }
-    _DataBlock_AddBlocks(dataBlock, 1);
-    INIT_NEW:
-    _DataBlock_InitBlock_Label(&(dataBlock->header[i]), label, 0, -1);
-#ifdef LABEL_ITERATOR
-    dataBlock->blocks[i]->label = label;
-#endif
-    return i;
-}
-
-int DataBlock_GetFirstAvailBlockNumByLabel(DataBlock *dataBlock, int label) {
-	int idx = DataBlock_GetFirstBlockNumByLabel(dataBlock, label);
-    while (idx > -1) {
-        if (dataBlock->header[idx].count >= DATABLOCK_BLOCK_CAP && array_len(dataBlock->header[idx].deletedIdx) <= 0) {
-            if (dataBlock->header[idx].label_next == -1) {
-                int block_to_alloc = 1; // dataBlock->header[idx].index + 1;
-                DataBlock_AccommodateBlock_Label(dataBlock, block_to_alloc, idx, label);
-            }
-            idx = dataBlock->header[idx].label_next;
-        } else return idx;
-    }
-    return -1;
-}
-
-uint64_t DataBlock_AllocateItem_Label(DataBlock *dataBlock, int label) {
-    // Get Block Index
-    int block_idx = DataBlock_GetFirstAvailBlockNumByLabel(dataBlock, label);
-    ASSERT(block_idx > -1);
-
-    // Get index into which to store item,
-    // prefer reusing free indicies.
-    uint pos = dataBlock->header[block_idx].count + block_idx * DATABLOCK_BLOCK_CAP;
-    if(array_len(dataBlock->header[block_idx].deletedIdx) > 0) {
-        pos = array_pop(dataBlock->header[block_idx].deletedIdx);
-    }
-    dataBlock->itemCount++;
-    dataBlock->header[block_idx].count++;
-
-    DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, pos);
-#ifdef BITMAP_DATABLOCK
-    DataBlock_SetBitmap(dataBlock, pos, 0);
-    return item_header;
-#else
-    MARK_HEADER_AS_NOT_DELETED(item_header);
-    return pos;
-#endif
-}
-
-#endif
-
@@ -12,45 +12,45 @@
 #include "../block.h"
 #include "./datablock_iterator.h"
 
-// #define BITMAP_DATABLOCK
-
 typedef void (*fpDestructor)(void *);
 
 // Number of items in a block. Should always be a power of 2.
 #define DATABLOCK_BLOCK_CAP 16384
-#define ITEM_HEADER_SIZE 1
-
-// Returns the item header size.
-#ifdef LABEL_DATABLOCK
-// block info
-typedef struct {
-	int count;				// Item count in this block
-	int label_id;				// The label ID of this block
-    int label_next;	        	// Next block with this label, -1 for last
-	int index;             // The block index of this label
-    uint64_t *deletedIdx;       // Array of free indicies.
-#ifdef BITMAP_DATABLOCK
-	uint8_t bitmap[2048];		// Mark valid items
-#endif
-} block_info;
 
-#endif
+// Block labels of a DataBlock clustered by label, in addition to the labels
+// handed to DataBlock_AllocateItem_Label.
+#define DATABLOCK_UNOWNED_LABEL (-3)  // Block holds no items.
+#define DATABLOCK_SHARED_LABEL  (-2)  // Block holds items of several labels.
+#define DATABLOCK_NO_LABEL      (-1)  // Items without a label, see GRAPH_NO_LABEL.
 
-// DataBlock item is stored as ||header|data||. This macro retrive the data pointer out of the header pointer.
-#define ITEM_DATA(header) ((void *)((header) + ITEM_HEADER_SIZE))
+// Per label chain of blocks of a DataBlock clustered by label.
+// Blocks are chained in ascending index order.
+typedef struct {
+	Block *first;               // First block of the chain, NULL if empty.
+	Block *current;             // Block handing out unused positions, NULL if none.
+	uint64_t *deletedIdx;       // Array of free indices within the chain's blocks.
+} DataBlockLabelChain;
 
-// DataBlock item is stored as ||header|data||. This macro retrive the header pointer out of the data pointer.
-#define GET_ITEM_HEADER(item) ((item) - ITEM_HEADER_SIZE)
+// Each block keeps a validity bitmap, a set bit marks an item in use.
+// Deleted and never used positions are clear, allowing scans to skip
+// 64 positions at a time.
+#define DATABLOCK_BITMAP(block) BLOCK_BITMAP(block, DATABLOCK_BLOCK_CAP)
 
-// Sets the deleted bit in the header to 1.
-#define MARK_HEADER_AS_DELETED(header) ((header)->deleted |= 1)
+// Retrieves item at position pos within block.
+#define DATABLOCK_BLOCK_ITEM(block, pos) \
+	((void *)((block)->data + ((size_t)(pos) * (block)->itemSize)))
 
-// Sets the deleted bit in the header to 0.
-#define MARK_HEADER_AS_NOT_DELETED(header) ((header)->deleted &= 0)
+// Checks if the item at position pos within block is in use.
+#define DATABLOCK_BITMAP_TEST(block, pos) \
+	((DATABLOCK_BITMAP(block)[(pos) >> 6] >> ((pos) & 63)) & 1)
 
-// Checks if the deleted bit in the header is 1 or not.
-#define IS_ITEM_DELETED(header) ((header)->deleted & 1)
+// Marks the item at position pos within block as in use.
+#define DATABLOCK_BITMAP_SET(block, pos) \
+	(DATABLOCK_BITMAP(block)[(pos) >> 6] |= (1ULL << ((pos) & 63)))
 
+// Marks the item at position pos within block as deleted.
+#define DATABLOCK_BITMAP_CLEAR(block, pos) \
+	(DATABLOCK_BITMAP(block)[(pos) >> 6] &= ~(1ULL << ((pos) & 63)))
 
 /* The DataBlock is a container structure for holding arbitrary items of a uniform type
  * in order to reduce the number of alloc/free calls and improve locality of reference.
@@ -62,26 +62,39 @@ typedef struct {
 	uint blockCount;            // Number of blocks in datablock.
 	uint itemSize;              // Size of a single item in bytes.
 	Block **blocks;             // Array of blocks.
-#ifdef LABEL_DATABLOCK
-	block_info *header;			// Array of infos of each block.
-#endif
 	uint64_t *deletedIdx;       // Array of free indicies.
+	DataBlockLabelChain *chains; // Array of label chains, NULL unless clustered by label.
+	uint64_t itemSpan;          // Clustered: one past the highest index handed out.
+	bool deletedIdxStale;       // Clustered: deletedIdx is to be recomputed.
 	pthread_mutex_t mutex;      // Mutex guarding from concurent updates.
 	fpDestructor destructor;    // Function pointer to a clean-up function of an item.
 } DataBlock;
 
-// This struct is for data block item header data.
-// TODO: Consider using pragma pack/pop for tight memory/word alignment.
-typedef struct {
-	unsigned char deleted: 1;  // A bit indicate if the current item is deleted or not.
-} DataBlockItemHeader;
-
 // Create a new DataBlock
 // itemCap - number of items datablock can hold before resizing.
 // itemSize - item size in bytes.
 // fp - destructor routine for freeing items.
 DataBlock *DataBlock_New(uint64_t itemCap, uint itemSize, fpDestructor fp);
 
+// Create a new DataBlock clustered by label,
+// each block only holds items of a single label, see DataBlock_AllocateItem_Label.
+DataBlock *DataBlock_NewClustered(uint64_t itemCap, uint itemSize, fpDestructor fp);
+
+// Rebuild a DataBlock around previously populated blocks.
+// blocks - rm_malloc'ed array of blockCount linked blocks, owned by the DataBlock.
+// deletedIdx - array of free indices, owned by the DataBlock.
+// itemSize - item size in bytes.
+// clustered - blocks are clustered by label, their label chains are rebuilt.
+DataBlock *DataBlock_Restore(Block **blocks, uint blockCount, uint64_t itemCount,
+		uint itemSize, uint64_t *deletedIdx, bool clustered, fpDestructor fp);
+
+// Returns true if the DataBlock is clustered by label.
+bool DataBlock_IsClustered(const DataBlock *dataBlock);
+
+// Rebuild the label chains and free lists of a clustered DataBlock
+// out of its blocks' labels, no-op for DataBlocks which aren't clustered.
+void DataBlock_BuildLabelChains(DataBlock *dataBlock);
+
 // returns number of items stored
 uint64_t DataBlock_ItemCount(const DataBlock *dataBlock);
 
@@ -91,6 +104,16 @@ void DataBlock_Accommodate(DataBlock *dataBlock, int64_t k);
 // Returns an iterator which scans entire datablock.
 DataBlockIterator *DataBlock_Scan(const DataBlock *dataBlock);
 
+// Returns an iterator which scans items within [start, end).
+DataBlockIterator *DataBlock_ScanRange(const DataBlock *dataBlock, uint64_t start, uint64_t end);
+
+// Returns an iterator which scans the blocks of 'label' within [start, end),
+// followed by the shared blocks, whose items are to be checked by the caller
+// see DataBlockIterator_InSecondChain.
+// DataBlock must be clustered by label.
+DataBlockIterator *DataBlock_ScanLabel(const DataBlock *dataBlock, int label,
+		uint64_t start, uint64_t end);
+
 // Get item at position idx
 void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx);
 
@@ -99,32 +122,37 @@ void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx);
 // return a pointer to the newly allocated item.
 void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx);
 
+// Allocate a new item of the given label,
+// clustered DataBlocks place the item in one of the label's blocks
+// otherwise equivalent to DataBlock_AllocateItem.
+void *DataBlock_AllocateItem_Label(DataBlock *dataBlock, int label, uint64_t *idx);
+
 // Removes item at position idx.
 void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx);
 
-// Returns the number of deleted items.
-uint DataBlock_DeletedItemsCount(const DataBlock *dataBlock);
-
-// Returns true if the given item has been deleted.
-bool DataBlock_ItemIsDeleted(void *item);
-
-// Free block.
-void DataBlock_Free(DataBlock *block);
-
-#ifdef BITMAP_DATABLOCK
-
-// Get bitmap at position idx
-bool DataBlock_GetBitmap(const DataBlock *dataBlock, uint64_t idx);
+// Removes the items at the count positions of idx, using up to nthreads threads,
+// each block is handled by a single thread, duplicates and deleted items are ignored.
+// idx is reordered.
+void DataBlock_DeleteItems(DataBlock *dataBlock, uint64_t *idx, uint64_t count, int nthreads);
 
-// Set bitmap at position idx
-void DataBlock_SetBitmap(const DataBlock *dataBlock, uint64_t idx, bool bit);
+// Moves up to limit items from the highest positions into the lowest free positions,
+// frees blocks past the highest position in use.
+// The previous and new position of each moved item are written to from and to,
+// which must be able to hold limit positions, clustered DataBlocks aren't compacted.
+// Returns the number of moved items.
+uint64_t DataBlock_Compact(DataBlock *dataBlock, uint64_t limit, uint64_t *from, uint64_t *to);
 
-#endif
+// Returns the number of deleted items,
+// for clustered DataBlocks this includes never used positions below the highest index.
+uint DataBlock_DeletedItemsCount(const DataBlock *dataBlock);
 
-#ifdef LABEL_DATABLOCK
+// Returns the array of deleted items indices,
+// clustered DataBlocks compute the array on demand.
+uint64_t *DataBlock_DeletedItems(DataBlock *dataBlock);
 
-int DataBlock_GetFirstBlockNumByLabel(DataBlock *dataBlock, int label);
+// Returns true if the item at position idx has been deleted.
+bool DataBlock_ItemIsDeleted(const DataBlock *dataBlock, uint64_t idx);
 
-uint64_t DataBlock_AllocateItem_Label(DataBlock *dataBlock, int label);
+// Free block.
+void DataBlock_Free(DataBlock *block);
 
-#endif
@@ -11,6 +11,32 @@
 #include <stdio.h>
 #include <stdbool.h>
 
+// returns the position of the first item in use within [from, to) of 'block'
+// 'to' if there's none, whole words of deleted items are skipped at once
+static inline uint _DataBlockIterator_FirstSet(const Block *block, uint from, uint to) {
+	const uint64_t *bitmap = DATABLOCK_BITMAP(block);
+	uint w = from >> 6;
+	uint64_t word = bitmap[w] & (~0ULL << (from & 63));
+
+	while(word == 0) {
+		if(((w + 1) << 6) >= to) return to;
+		word = bitmap[++w];
+	}
+
+	uint pos = (w << 6) + __builtin_ctzll(word);
+	return (pos < to) ? pos : to;
+}
+
+// advance iterator by 'n' positions, moving to the next block if needed
+static inline void _DataBlockIterator_Advance(DataBlockIterator *iter, uint n) {
+	iter->_block_pos += n;
+	iter->_current_pos += n;
+	if(iter->_block_pos >= DATABLOCK_BLOCK_CAP) {
+		iter->_block_pos -= DATABLOCK_BLOCK_CAP;
+		iter->_current_block = iter->_current_block->next;
+	}
+}
+
 DataBlockIterator *DataBlockIterator_New(Block *block, uint64_t start_pos, uint64_t end_pos, uint step) {
 	ASSERT(block && end_pos >= start_pos && step >= 1);
 
@@ -22,48 +48,142 @@ DataBlockIterator *DataBlockIterator_New(Block *block, uint64_t start_pos, uint6
 	iter->_current_pos = iter->_start_pos;
 	iter->_end_pos = end_pos;
 	iter->_step = step;
+	iter->_label_chain = false;
+	iter->_second_chain = NULL;
+	iter->_in_second_chain = false;
+	return iter;
+}
+
+// position the iterator at the first block of the chain starting at 'block'
+// which ends past the start position, moving on to the second chain if needed
+static void _DataBlockIterator_SeekChain(DataBlockIterator *iter, Block *block) {
+	while(true) {
+		while(block && (uint64_t)(block->index + 1) * DATABLOCK_BLOCK_CAP <= iter->_start_pos) {
+			block = block->label_next;
+		}
+
+		if(block || iter->_in_second_chain) break;
+		iter->_in_second_chain = true;
+		block = iter->_second_chain;
+	}
+
+	iter->_current_block = block;
+	if(block == NULL) return;
+
+	uint64_t first = (uint64_t)block->index * DATABLOCK_BLOCK_CAP;
+	iter->_current_pos = (first > iter->_start_pos) ? first : iter->_start_pos;
+	iter->_block_pos = iter->_current_pos - first;
+}
+
+DataBlockIterator *DataBlockIterator_NewLabel(Block *block, Block *second, uint64_t start_pos,
+											  uint64_t end_pos) {
+	ASSERT(end_pos >= start_pos);
+
+	DataBlockIterator *iter = rm_malloc(sizeof(DataBlockIterator));
+	iter->_start_block = block;
+	iter->_start_pos = start_pos;
+	iter->_end_pos = end_pos;
+	iter->_step = 1;
+	iter->_label_chain = true;
+	iter->_second_chain = second;
+	iter->_in_second_chain = false;
+	_DataBlockIterator_SeekChain(iter, block);
 	return iter;
 }
 
 DataBlockIterator *DataBlockIterator_Clone(const DataBlockIterator *it) {
+	if(it->_label_chain) {
+		return DataBlockIterator_NewLabel(it->_start_block, it->_second_chain, it->_start_pos,
+										  it->_end_pos);
+	}
 	return DataBlockIterator_New(it->_start_block, it->_start_pos, it->_end_pos, it->_step);
 }
 
+// label chains are sorted by block index, once the end position is passed
+// the rest of the chain is skipped
+static void *_DataBlockIterator_NextLabel(DataBlockIterator *iter, uint64_t *id) {
+	while(iter->_current_block != NULL) {
+		Block *block = iter->_current_block;
+		uint64_t base = iter->_current_pos - iter->_block_pos;
+
+		// Positions past the block's used prefix are never set.
+		uint to = block->used;
+		if(iter->_end_pos <= base) to = 0;
+		else if(iter->_end_pos - base < to) to = iter->_end_pos - base;
+
+		uint pos = to;
+		if(iter->_block_pos < to) pos = _DataBlockIterator_FirstSet(block, iter->_block_pos, to);
+		iter->_block_pos = pos;
+		iter->_current_pos = base + pos;
+
+		// Advance to next block if current block consumed.
+		if(pos == to) {
+			Block *next = (iter->_current_pos < iter->_end_pos) ? block->label_next : NULL;
+			if(next == NULL && !iter->_in_second_chain) {
+				iter->_in_second_chain = true;
+				next = iter->_second_chain;
+			}
+			_DataBlockIterator_SeekChain(iter, next);
+			continue;
+		}
+
+		// Advance to next position.
+		iter->_block_pos++;
+		iter->_current_pos++;
+
+		if(id) *id = base + pos;
+		return DATABLOCK_BLOCK_ITEM(block, pos);
+	}
+
+	return NULL;
+}
+
 void *DataBlockIterator_Next(DataBlockIterator *iter, uint64_t *id) {
 	ASSERT(iter != NULL);
 
-	// Set default.
-	void *item = NULL;
-	DataBlockItemHeader *item_header = NULL;
+	if(iter->_label_chain) return _DataBlockIterator_NextLabel(iter, id);
 
 	// Have we reached the end of our iterator?
 	while(iter->_current_pos < iter->_end_pos && iter->_current_block != NULL) {
-		// Get item at current position.
 		Block *block = iter->_current_block;
-		item_header = (DataBlockItemHeader *)block->data + (iter->_block_pos * block->itemSize);
+		uint pos = iter->_block_pos;
+
+		if(iter->_step == 1) {
+			// Skip to the next item in use within the current block.
+			uint to = DATABLOCK_BLOCK_CAP;
+			if(iter->_end_pos - iter->_current_pos < to - pos) {
+				to = pos + (iter->_end_pos - iter->_current_pos);
+			}
+			uint next = _DataBlockIterator_FirstSet(block, pos, to);
+			if(next == to) {
+				_DataBlockIterator_Advance(iter, to - pos);
+				continue;
+			}
+			_DataBlockIterator_Advance(iter, next - pos);
+			pos = next;
+		} else if(!DATABLOCK_BITMAP_TEST(block, pos)) {
+			_DataBlockIterator_Advance(iter, iter->_step);
+			continue;
+		}
 
 		// Advance to next position.
-		iter->_block_pos += iter->_step;
-		iter->_current_pos += iter->_step;
-
-		// Advance to next block if current block consumed.
-		if(iter->_block_pos >= DATABLOCK_BLOCK_CAP) {
-			iter->_block_pos -= DATABLOCK_BLOCK_CAP;
-			iter->_current_block = iter->_current_block->next;
-		}
+		uint64_t item_pos = iter->_current_pos;
+		_DataBlockIterator_Advance(iter, iter->_step);
 
-		if(!IS_ITEM_DELETED(item_header)) {
-			item = ITEM_DATA(item_header);
-			if(id) *id = iter->_current_pos - iter->_step;
-			break;
-		}
+		if(id) *id = item_pos;
+		return DATABLOCK_BLOCK_ITEM(block, pos);
 	}
 
-	return item;
+	return NULL;
 }
 
 void DataBlockIterator_Reset(DataBlockIterator *iter) {
 	ASSERT(iter != NULL);
+	if(iter->_label_chain) {
+		iter->_in_second_chain = false;
+		_DataBlockIterator_SeekChain(iter, iter->_start_block);
+		return;
+	}
 	iter->_block_pos = iter->_start_pos % DATABLOCK_BLOCK_CAP;
 	iter->_current_block = iter->_start_block;
 	iter->_current_pos = iter->_start_pos;
@@ -73,73 +193,3 @@ void DataBlockIterator_Free(DataBlockIterator *iter) {
 	ASSERT(iter != NULL);
 	rm_free(iter);
 }
-
-#ifdef LABEL_ITERATOR
-
-void DataBlockLabelIterator_RecordDataBlock(DataBlockIterator *iter, void * dataBlock) {
-    iter->dataBlock = dataBlock;
-}
-
-void DataBlockLabelIterator_iterate_range(DataBlockIterator *iter, uint64_t beginID, uint64_t endID) {
-    if (!iter) return;
-
-    iter->_start_pos = beginID;
-    iter->_end_pos = endID;
-    iter->_start_block = ((DataBlock *)(iter->dataBlock))->blocks[beginID >> 14];
-    iter->_current_block = iter->_start_block;
-    iter->_current_pos = beginID;
-    iter->_block_pos = beginID % DATABLOCK_BLOCK_CAP;
-}
-
-void *DataBlockLabelIterator_Next(DataBlockIterator *iter, int label, uint64_t *id) {
-    if (!iter || !iter->_current_block) return NULL;
-
-    // Re-locate the start pos according to the label if necessary
-    while (label != iter->_current_block->label) {
-        iter->_current_block = iter->_current_block->next;
-        if (iter->_current_block == NULL) break;
-        iter->_block_pos = 0;
-        iter->_current_pos = ((iter->_current_pos >> 14) + 1) << 14;
-    }
-
-    // Set default.
-    void *item = NULL;
-    DataBlockItemHeader *item_header = NULL;
-
-    // Have we reached the end of our iterator?
-    while(iter->_current_pos < iter->_end_pos && iter->_current_block != NULL) {
-        // Get item at current position.
-        Block *block = iter->_current_block;
-        item_header = (DataBlockItemHeader *)block->data + (iter->_block_pos * block->itemSize);
-
-        uint64_t current_position = iter->_current_pos;
-
-        // Advance to next position.
-        iter->_block_pos += iter->_step;
-        iter->_current_pos += iter->_step;
-
-        //int itemCount = ((DataBlock *)(iter->dataBlock))->header[current_position >> 14].count;
-
-        // Advance to next block if current block consumed.
-        if(iter->_block_pos >= DATABLOCK_BLOCK_CAP) {
-            iter->_block_pos -= DATABLOCK_BLOCK_CAP;
-            int next_index = iter->_current_block->label_next;
-            if (next_index > -1) iter->_current_block = ((DataBlock *)(iter->dataBlock))->blocks[next_index];
-            else {
-                iter->_current_block = NULL;
-                // return NULL;
-            }
-            iter->_current_pos = next_index << 14;
-        }
-
-        if(!IS_ITEM_DELETED(item_header)) {
-            item = ITEM_DATA(item_header);
-            if(id) *id = current_position;
-            break;
-        }
-    }
-
-    return item;
-}
-
-#endif
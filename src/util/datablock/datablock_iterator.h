@@ -7,6 +7,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "../block.h"
 
 /* Datablock iterator iterates over items within a datablock. */
@@ -19,9 +20,9 @@ typedef struct {
 	uint64_t _current_pos;			// Iterator current position.
 	uint64_t _end_pos;				// Iterator won't pass end position.
 	uint _step;						// Increase current_pos by step each iteration.
-#ifdef LABEL_ITERATOR
-    void *dataBlock;
-#endif
+	bool _label_chain;				// Advance along label chains rather than by index.
+	Block *_second_chain;			// Label chain scanned once the first is consumed.
+	bool _in_second_chain;			// Iterator is scanning the second chain.
 } DataBlockIterator;
 
 // Creates a new datablock iterator.
@@ -32,8 +33,21 @@ DataBlockIterator *DataBlockIterator_New(
 	uint step           // To scan entire range, set step to 1.
 );
 
+// Creates a new datablock iterator over the label chain starting at 'block'
+// followed by the chain starting at 'second', items outside of
+// [start_pos, end_pos) are skipped.
+DataBlockIterator *DataBlockIterator_NewLabel(
+	Block *block,       // First block of the label chain, may be NULL.
+	Block *second,      // First block of the second label chain, may be NULL.
+	uint64_t start_pos,	// Iteration starts here.
+	uint64_t end_pos	// Iteration stops here.
+);
+
 #define DataBlockIterator_Position(iter) (iter)->_current_pos
 
+// True if the last item returned came from the second label chain.
+#define DataBlockIterator_InSecondChain(iter) (iter)->_in_second_chain
+
 // Clones given iterator.
 DataBlockIterator *DataBlockIterator_Clone(
 	const DataBlockIterator *it  // Iterator to clone.
@@ -50,17 +64,3 @@ void DataBlockIterator_Reset(DataBlockIterator *iter);
 
 // Free iterator.
 void DataBlockIterator_Free(DataBlockIterator *iter);
-
-#ifdef LABEL_ITERATOR
-
-void DataBlockLabelIterator_RecordDataBlock(DataBlockIterator *iter, void * dataBlock);
-
-void DataBlockLabelIterator_iterate_range(DataBlockIterator *iter, uint64_t beginID, uint64_t endID);
-
-// Returns the next item, unless we've reached the end
-// in which case NULL is returned.
-// if `id` is provided and an item is located
-// `id` will be set to the returned item index
-void *DataBlockLabelIterator_Next(DataBlockIterator *iter, int label, uint64_t *id);
-
-#endif
@@ -19,54 +19,47 @@
 #define GET_ITEM_BLOCK(dataBlock, idx) \
     dataBlock->blocks[ITEM_INDEX_TO_BLOCK_INDEX(idx)]
 
-static inline DataBlockItemHeader *DataBlock_GetItemHeader(const DataBlock *dataBlock,
-														   uint64_t idx) {
-	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
-	idx = ITEM_POSITION_WITHIN_BLOCK(idx);
-	return (DataBlockItemHeader *)block->data + (idx * block->itemSize);
-}
-
 inline void *DataBlock_AllocateItemOutOfOrder(DataBlock *dataBlock, uint64_t idx) {
 	// Check if idx<=data block's current capacity. If needed, allocate additional blocks.
 	DataBlock_Accommodate(dataBlock, idx);
-	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, idx);
-#ifdef BITMAP_DATABLOCK
-    DataBlock_SetBitmap(dataBlock, idx, 0);
-	dataBlock->itemCount++;
-    return item_header;
-#else
-	MARK_HEADER_AS_NOT_DELETED(item_header);
+	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
+	uint pos = ITEM_POSITION_WITHIN_BLOCK(idx);
+	DATABLOCK_BITMAP_SET(block, pos);
 	dataBlock->itemCount++;
-	return ITEM_DATA(item_header);
-#endif
+	return DATABLOCK_BLOCK_ITEM(block, pos);
 }
 
 inline void DataBlock_MarkAsDeletedOutOfOrder(DataBlock *dataBlock, uint64_t idx) {
+	// Clustered DataBlocks collect their free lists in DataBlock_BuildLabelChains,
+	// positions which weren't allocated are already marked as deleted.
+	if(DataBlock_IsClustered(dataBlock)) return;
+
 	// Check if idx<=data block's current capacity. If needed, allocate additional blocks.
 	DataBlock_Accommodate(dataBlock, idx);
-	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, idx);
+	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
 	// Delete
-#ifdef BITMAP_DATABLOCK
-    DataBlock_SetBitmap(dataBlock, idx, 1);
-#else
-	MARK_HEADER_AS_DELETED(item_header);
-#endif
+	DATABLOCK_BITMAP_CLEAR(block, ITEM_POSITION_WITHIN_BLOCK(idx));
 	dataBlock->deletedIdx = array_append(dataBlock->deletedIdx, idx);
 }
 
-#ifdef LABEL_DATABLOCK
-inline void *DataBlock_AllocateItemOutOfOrder_Label(DataBlock *dataBlock, uint64_t *id, int label) {
-	// Check if idx<=data block's current capacity. If needed, allocate additional blocks.
-	*id = DataBlock_AllocateItem_Label(dataBlock, label);
-	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, *id);
-#ifdef BITMAP_DATABLOCK
-    DataBlock_SetBitmap(dataBlock, idx, 0);
+void *DataBlock_AllocateItemOutOfOrder_Label(DataBlock *dataBlock, uint64_t idx, int label) {
+	if(!DataBlock_IsClustered(dataBlock)) return DataBlock_AllocateItemOutOfOrder(dataBlock, idx);
+
+	// Make sure the block holding idx exists.
+	if(idx >= dataBlock->itemCap) {
+		DataBlock_Accommodate(dataBlock, idx + 1 - dataBlock->itemCount);
+	}
+
+	// Blocks holding items of several labels are shared.
+	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
+	if(block->label == DATABLOCK_UNOWNED_LABEL) block->label = label;
+	else if(block->label != label) block->label = DATABLOCK_SHARED_LABEL;
+
+	uint pos = ITEM_POSITION_WITHIN_BLOCK(idx);
+	if(pos >= block->used) block->used = pos + 1;
+
+	DATABLOCK_BITMAP_SET(block, pos);
 	dataBlock->itemCount++;
-    return item_header;
-#else
-	MARK_HEADER_AS_NOT_DELETED(item_header);
-	//dataBlock->itemCount++;
-	return ITEM_DATA(item_header);
-#endif
+	if(idx >= dataBlock->itemSpan) dataBlock->itemSpan = idx + 1;
+	return DATABLOCK_BLOCK_ITEM(block, pos);
 }
-#endif
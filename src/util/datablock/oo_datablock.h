@@ -25,10 +25,12 @@ void *DataBlock_AllocateItemOutOfOrder(DataBlock *dataBlock, uint64_t idx);
  * The function updates the data block's free list and set the element as deleted.
  * Note:
  * 1. Item distructor is not invoked in this call.
- * 2. This call does not decrease the number of items in the data block. */
+ * 2. This call does not decrease the number of items in the data block.
+ * 3. Clustered DataBlocks ignore this call, see DataBlock_BuildLabelChains. */
 void DataBlock_MarkAsDeletedOutOfOrder(DataBlock *dataBlock, uint64_t idx);
 
-#ifdef LABEL_DATABLOCK
-void *DataBlock_AllocateItemOutOfOrder_Label(DataBlock *dataBlock, uint64_t *id, int label);
-void DataBlock_MarkAsDeletedOutOfOrder_Label(DataBlock *dataBlock, uint64_t idx);
-#endif
+/* Return a pointer to allocated item in a given index of the given label.
+ * Clustered DataBlocks assign the item's block to the label, a block which
+ * ends up holding items of several labels is shared.
+ * Once reconstruction is done, DataBlock_BuildLabelChains must be called. */
+void *DataBlock_AllocateItemOutOfOrder_Label(DataBlock *dataBlock, uint64_t idx, int label);
@@ -0,0 +1,53 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "periodic_task.h"
+#include "cron.h"
+#include "rmalloc.h"
+#include "thpool/pools.h"
+#include "../RG.h"
+
+typedef struct {
+	uint interval;                  // number of milliseconds between passes
+	PeriodicTaskPassCB pass;        // pass to run on the writer thread
+	PeriodicTaskEnabledCB enabled;  // whether the pass should run
+	void *pdata;                    // private data passed to callbacks
+} PeriodicTask;
+
+static void _PeriodicTask_Schedule(void *pdata);
+
+// runs on the writer thread, serialized with graph updates
+static void _PeriodicTask_Run(void *pdata) {
+	PeriodicTask *task = pdata;
+
+	if(task->enabled == NULL || task->enabled(task->pdata)) task->pass(task->pdata);
+
+	Cron_AddTask(task->interval, _PeriodicTask_Schedule, task);
+}
+
+// CRON task, hands the pass over to the writer thread
+static void _PeriodicTask_Schedule(void *pdata) {
+	PeriodicTask *task = pdata;
+
+	if(ThreadPools_AddWorkWriter(_PeriodicTask_Run, task) != 0) {
+		// failed to enqueue, retry later
+		Cron_AddTask(task->interval, _PeriodicTask_Schedule, task);
+	}
+}
+
+void PeriodicTask_Start(uint interval, PeriodicTaskPassCB pass,
+						PeriodicTaskEnabledCB enabled, void *pdata) {
+	ASSERT(pass != NULL);
+
+	// tasks live as long as the module
+	PeriodicTask *task = rm_malloc(sizeof(PeriodicTask));
+	task->interval = interval;
+	task->pass = pass;
+	task->enabled = enabled;
+	task->pdata = pdata;
+
+	Cron_AddTask(interval, _PeriodicTask_Schedule, task);
+}
@@ -0,0 +1,31 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <sys/types.h>
+
+/* Periodic writer tasks run background maintenance passes.
+ * Every 'interval' milliseconds CRON hands the task over to the writer thread,
+ * such that passes are serialized with graph updates,
+ * once a pass completes the task is rescheduled. */
+
+// pass callback, invoked on the writer thread
+typedef void (*PeriodicTaskPassCB)(void *pdata);
+
+// returns false if the pass should be skipped this time around
+typedef bool (*PeriodicTaskEnabledCB)(void *pdata);
+
+// registers a periodic writer task, should be called once CRON
+// and the thread pools are running
+void PeriodicTask_Start
+(
+	uint interval,                  // number of milliseconds between passes
+	PeriodicTaskPassCB pass,        // pass to run on the writer thread
+	PeriodicTaskEnabledCB enabled,  // [optional] whether the pass should run
+	void *pdata                     // [optional] private data passed to callbacks
+);
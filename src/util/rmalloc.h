@@ -11,37 +11,29 @@
 static inline void *rm_malloc(size_t n) {
 #ifndef INDEPENDENT_TEST
     return RedisModule_Alloc(n);
-#elif (defined(NVM_FULL) || defined(NVM_THRESHOLD))
-    return nvm_malloc(n);
 #else
-    return dram_malloc(n);
+    return nvm_class_malloc(NVM_CLASS_SCRATCH, n);
 #endif
 }
 static inline void *rm_calloc(size_t nelem, size_t elemsz) {
 #ifndef INDEPENDENT_TEST
     return RedisModule_Calloc(nelem, elemsz);
-#elif (defined(NVM_FULL) || defined(NVM_THRESHOLD))
-    return nvm_calloc(nelem, elemsz);
 #else
-	return dram_calloc(nelem, elemsz);
+    return nvm_class_calloc(NVM_CLASS_SCRATCH, nelem, elemsz);
 #endif
 }
 static inline void *rm_realloc(void *p, size_t n) {
 #ifndef INDEPENDENT_TEST
     return RedisModule_Realloc(p, n);
-#elif defined(HYBRID_MEMORY)
-	return nvm_realloc(p, n);
 #else
-	return dram_realloc(p, n);
+	return nvm_class_realloc(NVM_CLASS_SCRATCH, p, n);
 #endif
 }
 static inline void rm_free(void *p) {
 #ifndef INDEPENDENT_TEST
     RedisModule_Free(p);
-#elif defined(HYBRID_MEMORY)
-    nvm_free(p);
 #else
-	dram_free(p);
+    nvm_free(p);
 #endif
 }
 static inline char *rm_strdup(const char *s) {
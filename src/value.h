@@ -122,7 +122,9 @@ SIValue SI_ShareValue(const SIValue v);
 
 // SI_CloneValue creates an SIValue that duplicates all of the original's allocations.
 SIValue SI_CloneValue(const SIValue v);
-SIValue SI_ClonePmemValue(const SIValue v);
+
+// SI_ClonePropertyValue clones 'v' into memory placed according to the entity-properties policy.
+SIValue SI_ClonePropertyValue(const SIValue v);
 
 // SI_CloneValue creates an SIValue that duplicates all of the original's self-owned or volatile allocations.
 SIValue SI_ShallowCloneValue(const SIValue v);
@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+"""Compare DRAM/PMEM placement modes on a fixed workload.
+
+For each placement mode a standalone redis-server is started with the module
+loaded, a synthetic social graph is created and a fixed query mix is issued by
+concurrent clients for a fixed duration. PMEM is emulated by a memkind pool
+created on a regular (or tmpfs) directory, such that the benchmark runs on any
+Linux machine; use --pmem_dir to point it at a DAX file system instead.
+
+Reported per mode: throughput, p50/p99 client latency per query type and
+the number of bytes the graph holds on each kind (see GRAPH.MEMORY).
+"""
+
+import argparse
+import json
+import os
+import random
+import shutil
+import subprocess
+import tempfile
+import threading
+import time
+
+import redis
+
+GRAPH_ID = "placement_bench"
+
+# placement of each allocation class per mode, see nvm.h
+MODES = {
+    "DRAM": None,
+    "NVM_PROP": {"PROPERTIES_PLACEMENT": "PMEM", "DATABLOCK_PLACEMENT": "PMEM",
+                 "MATRIX_PLACEMENT": "DRAM", "SCRATCH_PLACEMENT": "DRAM"},
+    "NVM_MATRIX": {"PROPERTIES_PLACEMENT": "DRAM", "DATABLOCK_PLACEMENT": "DRAM",
+                   "MATRIX_PLACEMENT": "PMEM", "SCRATCH_PLACEMENT": "DRAM"},
+    "NVM_FULL": {"PROPERTIES_PLACEMENT": "PMEM", "DATABLOCK_PLACEMENT": "PMEM",
+                 "MATRIX_PLACEMENT": "PMEM", "SCRATCH_PLACEMENT": "PMEM"},
+    "NVM_THRESHOLD": {"PROPERTIES_PLACEMENT": "THRESHOLD", "DATABLOCK_PLACEMENT": "THRESHOLD",
+                      "MATRIX_PLACEMENT": "THRESHOLD", "SCRATCH_PLACEMENT": "THRESHOLD"},
+}
+
+# query mix: name, ratio, template ({id} is replaced by a random node ID)
+QUERIES = [
+    ("scan", 5, "MATCH (p:Person) WHERE p.age > 70 RETURN count(p)"),
+    ("hop1", 30, "MATCH (p)-[:KNOWS]->(f) WHERE id(p) = {id} RETURN f.name"),
+    ("hop2", 15, "MATCH (p)-[:KNOWS]->()-[:KNOWS]->(f) WHERE id(p) = {id} RETURN count(f)"),
+    ("hop3", 10, "MATCH (p)-[:KNOWS]->()-[:KNOWS]->()-[:KNOWS]->(f) WHERE id(p) = {id} RETURN count(f)"),
+    ("aggregate", 5, "MATCH (p:Person) RETURN p.age % 10, count(p), avg(p.score)"),
+    ("update", 35, "MATCH (p) WHERE id(p) = {id} SET p.score = p.score + 1, p.name = 'updated' + toString({id})"),
+]
+
+
+def percentile(samples, p):
+    if not samples:
+        return 0.0
+    samples = sorted(samples)
+    k = min(len(samples) - 1, int(round(p / 100.0 * (len(samples) - 1))))
+    return samples[k]
+
+
+def start_server(args, mode, port, pmem_dir):
+    module_args = []
+    placement = MODES[mode]
+    if placement is not None:
+        module_args += ["PMEM_PATH", pmem_dir]
+        for option, value in placement.items():
+            module_args += [option, value]
+
+    cmd = [args.redis_server, "--port", str(port), "--save", "", "--appendonly", "no",
+           "--loadmodule", args.module_path] + module_args
+    server = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.STDOUT)
+
+    con = redis.Redis(port=port)
+    for _ in range(100):
+        try:
+            con.ping()
+            return server, con
+        except redis.exceptions.ConnectionError:
+            if server.poll() is not None:
+                break
+            time.sleep(0.1)
+
+    server.kill()
+    raise RuntimeError("failed to start redis-server for mode %s: %s" % (mode, " ".join(cmd)))
+
+
+def populate(con, args):
+    # nodes are created in communities of args.community nodes
+    # edges connect random members of the same community
+    rnd = random.Random(args.seed)
+    degree = args.edges // args.nodes
+    for start in range(0, args.nodes, args.community):
+        end = min(start + args.community, args.nodes)
+        parts = []
+        for i in range(start, end):
+            parts.append("(n%d:Person {id: %d, age: %d, score: %d, name: 'person%d'})"
+                         % (i, i, rnd.randrange(100), rnd.randrange(1000), i))
+        for i in range(start, end):
+            for _ in range(degree):
+                parts.append("(n%d)-[:KNOWS {since: %d}]->(n%d)"
+                             % (i, 1950 + rnd.randrange(70), rnd.randrange(start, end)))
+        con.execute_command("GRAPH.QUERY", GRAPH_ID, "CREATE " + ", ".join(parts))
+
+
+def run_workload(port, args):
+    mix = []
+    for name, ratio, template in QUERIES:
+        mix += [(name, template)] * ratio
+
+    latencies = {name: [] for name, _, _ in QUERIES}
+    errors = [0]
+    lock = threading.Lock()
+    deadline = time.time() + args.duration
+
+    def client(seed):
+        rnd = random.Random(seed)
+        con = redis.Redis(port=port)
+        local = {name: [] for name, _, _ in QUERIES}
+        local_errors = 0
+        while time.time() < deadline:
+            name, template = rnd.choice(mix)
+            q = template.format(id=rnd.randrange(args.nodes))
+            start = time.perf_counter()
+            try:
+                con.execute_command("GRAPH.QUERY", GRAPH_ID, q, "--compact")
+            except redis.exceptions.ResponseError:
+                local_errors += 1
+                continue
+            local[name].append((time.perf_counter() - start) * 1000)
+        with lock:
+            for name in local:
+                latencies[name] += local[name]
+            errors[0] += local_errors
+
+    threads = [threading.Thread(target=client, args=(args.seed + i,)) for i in range(args.clients)]
+    started = time.time()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.time() - started
+
+    total = sum(len(v) for v in latencies.values())
+    every = [x for v in latencies.values() for x in v]
+    result = {
+        "queries": total,
+        "errors": errors[0],
+        "throughput": total / elapsed,
+        "p50_ms": percentile(every, 50),
+        "p99_ms": percentile(every, 99),
+        "per_query": {},
+    }
+    for name, samples in latencies.items():
+        result["per_query"][name] = {
+            "queries": len(samples),
+            "throughput": len(samples) / elapsed,
+            "p50_ms": percentile(samples, 50),
+            "p99_ms": percentile(samples, 99),
+        }
+    return result
+
+
+def graph_memory(con):
+    usage = {}
+    for category, kinds in con.execute_command("GRAPH.MEMORY", GRAPH_ID):
+        kinds = [k.decode() if isinstance(k, bytes) else k for k in kinds]
+        usage[category.decode()] = dict(zip(kinds[::2], kinds[1::2]))
+    return usage
+
+
+def run_mode(args, mode, port):
+    pmem_dir = tempfile.mkdtemp(prefix="rg_pmem_", dir=args.pmem_dir)
+    server, con = start_server(args, mode, port, pmem_dir)
+    try:
+        started = time.time()
+        populate(con, args)
+        load_time = time.time() - started
+        result = run_workload(port, args)
+        result["load_seconds"] = load_time
+        result["memory"] = graph_memory(con)
+        return result
+    finally:
+        server.terminate()
+        server.wait()
+        shutil.rmtree(pmem_dir, ignore_errors=True)
+
+
+def report(results):
+    header = "%-14s %10s %9s %9s %14s %14s" % ("mode", "qps", "p50 ms", "p99 ms", "dram bytes", "pmem bytes")
+    print(header)
+    print("-" * len(header))
+    for mode, r in results.items():
+        total = r["memory"]["total"]
+        print("%-14s %10.1f %9.3f %9.3f %14d %14d" %
+              (mode, r["throughput"], r["p50_ms"], r["p99_ms"], total["dram"], total["pmem"]))
+
+    for name, _, _ in QUERIES:
+        print("\n%s" % name)
+        for mode, r in results.items():
+            q = r["per_query"][name]
+            print("  %-14s %10.1f %9.3f %9.3f" % (mode, q["throughput"], q["p50_ms"], q["p99_ms"]))
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description="RedisGraph DRAM/PMEM placement benchmark.",
+                                     formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+    parser.add_argument("--module_path", default=os.path.join(here, "..", "..", "src", "redisgraph.so"))
+    parser.add_argument("--redis_server", default="redis-server")
+    parser.add_argument("--port", type=int, default=6400)
+    parser.add_argument("--pmem_dir", default=tempfile.gettempdir(),
+                        help="directory in which the emulated PMEM pool is created")
+    parser.add_argument("--modes", nargs="+", default=list(MODES.keys()), choices=list(MODES.keys()))
+    parser.add_argument("--nodes", type=int, default=100000)
+    parser.add_argument("--edges", type=int, default=500000)
+    parser.add_argument("--community", type=int, default=1000,
+                        help="number of nodes created per query, edges stay within a community")
+    parser.add_argument("--clients", type=int, default=8)
+    parser.add_argument("--duration", type=int, default=30, help="seconds of workload per mode")
+    parser.add_argument("--seed", type=int, default=12345)
+    parser.add_argument("--output", default=None, help="json results file")
+    args = parser.parse_args()
+
+    results = {}
+    for mode in args.modes:
+        print("running %s..." % mode, flush=True)
+        results[mode] = run_mode(args, mode, args.port)
+
+    report(results)
+
+    output = args.output or os.path.join(here, "%d-placement.json" % int(time.time()))
+    with open(output, "w") as f:
+        json.dump({"config": vars(args), "results": results}, f, indent=2)
+    print("\nresults stored in %s" % output)
+
+    if any(r["errors"] for r in results.values()):
+        exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,80 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "alloc_threshold"
+redis_con = None
+redis_graph = None
+
+class testAllocThreshold(FlowTestsBase):
+    def __init__(self):
+        # property allocations below the threshold are kept on DRAM,
+        # all others are served from a PMEM pool
+        self.env = Env(decodeResponses=True,
+                       moduleArgs="PMEM_PATH /tmp PROPERTIES_PLACEMENT THRESHOLD")
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def allocator_info(self):
+        return redis_con.execute_command("INFO", "graph_allocator")
+
+    # create nodes carrying strings of about 100 bytes
+    def create_nodes(self, label, count):
+        query = """UNWIND range(1, %d) AS x
+                   CREATE (:%s {v: x, s: x + '%s'})""" % (count, label, 'x' * 100)
+        redis_graph.query(query)
+
+    def test01_fixed_threshold(self):
+        redis_con.execute_command("GRAPH.CONFIG SET ALLOC_THRESHOLD 16")
+
+        # a fixed threshold isn't tuned, whatever the load
+        self.create_nodes("Fixed", 10000)
+        time.sleep(1.5)
+        info = self.allocator_info()
+        self.env.assertEquals(info["adaptive_alloc_threshold"], 0)
+        self.env.assertEquals(info["alloc_threshold"], 16)
+
+    def test02_realloc_crossing_threshold(self):
+        redis_con.execute_command("GRAPH.CONFIG SET ALLOC_THRESHOLD 64")
+        migrations = self.allocator_info()["realloc_migrations"]
+
+        # the bag of a single property is kept on DRAM,
+        # it is copied to PMEM once it grows past the threshold
+        redis_graph.query("CREATE (:Grow {p0: 0})")
+        redis_graph.query("MATCH (n:Grow) SET n.p1 = 1, n.p2 = 2, n.p3 = 3, n.p4 = 4")
+
+        info = self.allocator_info()
+        self.env.assertGreater(info["realloc_migrations"], migrations)
+        self.env.assertGreater(info["realloc_migrated_bytes"], 0)
+
+        result = redis_graph.query("MATCH (n:Grow) RETURN n.p0, n.p1, n.p2, n.p3, n.p4")
+        self.env.assertEquals(result.result_set, [[0, 1, 2, 3, 4]])
+
+    def test03_adaptive_threshold_under_load(self):
+        redis_con.execute_command("GRAPH.CONFIG SET ALLOC_THRESHOLD 8")
+        redis_con.execute_command("GRAPH.CONFIG SET ADAPTIVE_ALLOC_THRESHOLD yes")
+
+        # allocations made under load fit in the DRAM share,
+        # the threshold is raised a size class at a time
+        threshold = 8
+        deadline = time.time() + 10
+        while time.time() < deadline and threshold == 8:
+            self.create_nodes("Adaptive", 1000)
+            time.sleep(0.2)
+            threshold = self.allocator_info()["alloc_threshold"]
+
+        self.env.assertGreater(threshold, 8)
+        self.env.assertLessEqual(threshold, 4096)
+        # thresholds are size class boundaries
+        self.env.assertEquals(threshold & (threshold - 1), 0)
+
+        # the tuned value is reported by GRAPH.CONFIG
+        response = redis_con.execute_command("GRAPH.CONFIG GET ALLOC_THRESHOLD")
+        self.env.assertGreaterEqual(response[1], threshold)
+
+        redis_con.execute_command("GRAPH.CONFIG SET ADAPTIVE_ALLOC_THRESHOLD no")
+        redis_con.execute_command("GRAPH.CONFIG SET ALLOC_THRESHOLD 64")
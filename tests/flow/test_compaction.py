@@ -0,0 +1,65 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "compaction"
+redis_con = None
+redis_graph = None
+
+class testCompaction(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def compact(self, *args):
+        return redis_con.execute_command("GRAPH.COMPACT", GRAPH_ID, *args)
+
+    def test01_compact_nodes_and_edges(self):
+        # build a chain of 100 nodes, free the IDs of the first half
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:N {v: x})")
+        redis_graph.query("CREATE INDEX ON :N(v)")
+        redis_graph.query("MATCH (a:N), (b:N) WHERE b.v = a.v + 1 CREATE (a)-[:R {v: a.v}]->(b)")
+        redis_graph.query("MATCH (n:N) WHERE n.v < 50 DELETE n")
+
+        # deleting the nodes removed the edges leading to the second half
+        self.env.assertEquals(self.compact(), "50 nodes relocated, 49 edges relocated")
+
+        # nothing left to relocate
+        self.env.assertEquals(self.compact(), "0 nodes relocated, 0 edges relocated")
+
+        # relocated entities occupy the lowest IDs
+        result = redis_graph.query("MATCH (n:N) RETURN max(ID(n)), count(n), sum(n.v)")
+        self.env.assertEquals(result.result_set[0], [49, 50, sum(range(50, 100))])
+        result = redis_graph.query("MATCH ()-[e:R]->() RETURN max(ID(e)), count(e), sum(e.v)")
+        self.env.assertEquals(result.result_set[0], [48, 49, sum(range(50, 99))])
+
+        # connections are kept
+        result = redis_graph.query("MATCH (a:N)-[e:R]->(b:N) WHERE b.v <> a.v + 1 OR e.v <> a.v RETURN count(e)")
+        self.env.assertEquals(result.result_set[0][0], 0)
+        result = redis_graph.query("MATCH (a:N)<-[:R]-(b:N) WHERE a.v = 75 RETURN b.v")
+        self.env.assertEquals(result.result_set[0][0], 74)
+
+        # the index refers to the new IDs
+        result = redis_graph.query("MATCH (n:N) WHERE n.v = 99 RETURN ID(n), n.v")
+        self.env.assertLess(result.result_set[0][0], 50)
+        self.env.assertEquals(result.result_set[0][1], 99)
+
+    def test02_compact_limit(self):
+        redis_graph.query("MATCH (n:N) WHERE n.v >= 90 DELETE n")
+        redis_graph.query("MATCH (n:N) WHERE n.v < 60 DELETE n")
+
+        # at most 'limit' entities of each kind are relocated
+        self.env.assertEquals(self.compact(5), "5 nodes relocated, 5 edges relocated")
+        result = redis_graph.query("MATCH (n:N) RETURN count(n), sum(n.v)")
+        self.env.assertEquals(result.result_set[0], [30, sum(range(60, 90))])
+
+    def test03_invalid_arguments(self):
+        try:
+            self.compact("x")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("limit", str(e))
@@ -80,3 +80,305 @@ class testConfig(FlowTestsBase):
             assert("Unknown subcommand for GRAPH.CONFIG" in str(e))
             pass
 
+
+    def test06_config_placement(self):
+        global redis_graph
+
+        # Placement defaults to DRAM
+        config_name = "PROPERTIES_PLACEMENT"
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        self.env.assertEqual(response, [config_name, "DRAM"])
+
+        # Placement is run-time configurable
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s PMEM" % config_name)
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        self.env.assertEqual(response, [config_name, "PMEM"])
+
+        # Without a PMEM pool allocations fall back to DRAM, queries keep working
+        redis_graph.query("CREATE (:L {v: 'some string value'})")
+        result = redis_graph.query("MATCH (n:L) RETURN n.v")
+        self.env.assertEqual(result.result_set[0][0], "some string value")
+
+        # Reject unknown placement
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET %s NOWHERE" % config_name)
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Failed to set config value" in str(e))
+            pass
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s DRAM" % config_name)
+        self.env.assertEqual(response, "OK")
+
+    def test07_config_pmem_path_not_runtime(self):
+        global redis_graph
+
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET PMEM_PATH /tmp")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Field can not be re-configured" in str(e))
+            pass
+
+    def test08_config_properties_dram_budget(self):
+        # Tiering is disabled by default
+        config_name = "PROPERTIES_DRAM_BUDGET"
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        self.env.assertEqual(response, [config_name, 0])
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s 1048576" % config_name)
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        self.env.assertEqual(response, [config_name, 1048576])
+
+        # Property reads are sampled, results are unaffected
+        graph = Graph("properties_dram_budget", redis_con)
+        graph.query("CREATE (:L {v: 'some string value'})")
+        result = graph.query("MATCH (n:L) RETURN n.v")
+        self.env.assertEqual(result.result_set[0][0], "some string value")
+        graph.delete()
+
+        # Reject negative budget
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET %s -1" % config_name)
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Failed to set config value" in str(e))
+            pass
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s 0" % config_name)
+        self.env.assertEqual(response, "OK")
+
+    def test09_config_alloc_threshold(self):
+        # Fixed threshold of 64 bytes by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET ALLOC_THRESHOLD")
+        self.env.assertEqual(response, ["ALLOC_THRESHOLD", 64])
+        response = redis_con.execute_command("GRAPH.CONFIG GET ADAPTIVE_ALLOC_THRESHOLD")
+        self.env.assertEqual(response, ["ADAPTIVE_ALLOC_THRESHOLD", 0])
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET ALLOC_THRESHOLD 256")
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET ALLOC_THRESHOLD")
+        self.env.assertEqual(response, ["ALLOC_THRESHOLD", 256])
+
+        # Threshold must be positive
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET ALLOC_THRESHOLD 0")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Failed to set config value" in str(e))
+            pass
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET ADAPTIVE_ALLOC_THRESHOLD yes")
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET ADAPTIVE_ALLOC_THRESHOLD")
+        self.env.assertEqual(response, ["ADAPTIVE_ALLOC_THRESHOLD", 1])
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET ADAPTIVE_ALLOC_THRESHOLD no")
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG SET ALLOC_THRESHOLD 64")
+        self.env.assertEqual(response, "OK")
+
+    def test10_config_pmem_heap_not_runtime(self):
+        # Persistent heap is disabled by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET PMEM_HEAP")
+        self.env.assertEqual(response, ["PMEM_HEAP", None])
+
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET PMEM_HEAP /tmp/graph.heap")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Field can not be re-configured" in str(e))
+            pass
+
+    def test11_config_cluster_nodes_by_label_not_runtime(self):
+        # Nodes are stored in insertion order by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET CLUSTER_NODES_BY_LABEL")
+        self.env.assertEqual(response, ["CLUSTER_NODES_BY_LABEL", 0])
+
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET CLUSTER_NODES_BY_LABEL yes")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Field can not be re-configured" in str(e))
+            pass
+
+    def test12_config_hugepages_numa(self):
+        # Regular pages and kernel default NUMA placement by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET HUGEPAGES")
+        self.env.assertEqual(response, ["HUGEPAGES", "NO"])
+        response = redis_con.execute_command("GRAPH.CONFIG GET NUMA_POLICY")
+        self.env.assertEqual(response, ["NUMA_POLICY", "DEFAULT"])
+        response = redis_con.execute_command("GRAPH.CONFIG GET NUMA_NODES")
+        self.env.assertEqual(response, ["NUMA_NODES", None])
+
+        # Page size and NUMA policy are runtime configurable
+        response = redis_con.execute_command("GRAPH.CONFIG SET HUGEPAGES THP")
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET HUGEPAGES")
+        self.env.assertEqual(response, ["HUGEPAGES", "THP"])
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET NUMA_POLICY INTERLEAVE")
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET NUMA_POLICY")
+        self.env.assertEqual(response, ["NUMA_POLICY", "INTERLEAVE"])
+
+        # Graphs are populated under the new policy
+        graph = Graph("hugepages_numa", redis_con)
+        graph.query("UNWIND range(0, 999) AS x CREATE (:L {v: x})-[:R]->(:L {v: x})")
+        result = graph.query("MATCH (a:L)-[:R]->(b:L) RETURN count(a), sum(b.v)")
+        self.env.assertEqual(result.result_set, [[1000, 499500]])
+        graph.delete()
+
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET HUGEPAGES 1GB")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            pass
+
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET NUMA_NODES 0")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Field can not be re-configured" in str(e))
+            pass
+
+        redis_con.execute_command("GRAPH.CONFIG SET HUGEPAGES NO")
+        redis_con.execute_command("GRAPH.CONFIG SET NUMA_POLICY DEFAULT")
+
+    def test13_config_delta_max_pending_changes(self):
+        # Default threshold
+        response = redis_con.execute_command("GRAPH.CONFIG GET DELTA_MAX_PENDING_CHANGES")
+        self.env.assertEqual(response, ["DELTA_MAX_PENDING_CHANGES", 10000])
+
+        # Threshold is runtime configurable
+        response = redis_con.execute_command("GRAPH.CONFIG SET DELTA_MAX_PENDING_CHANGES 10")
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET DELTA_MAX_PENDING_CHANGES")
+        self.env.assertEqual(response, ["DELTA_MAX_PENDING_CHANGES", 10])
+
+        # Reads observe pending changes, merged or not
+        graph = Graph("delta_merge", redis_con)
+        graph.query("UNWIND range(0, 99) AS x CREATE (:L {v: x})-[:R]->(:L {v: x})")
+        result = graph.query("MATCH (a:L)-[:R]->(b:L) RETURN count(a), sum(b.v)")
+        self.env.assertEqual(result.result_set, [[100, 4950]])
+
+        graph.query("MATCH (a:L)-[r:R]->() WHERE a.v < 50 DELETE r")
+        result = graph.query("MATCH (a:L)-[:R]->(b:L) RETURN count(a), sum(b.v)")
+        self.env.assertEqual(result.result_set, [[50, 3725]])
+
+        graph.query("MATCH (a:L)-[:R]->(b:L) WHERE a.v >= 90 CREATE (b)-[:R]->(a)")
+        result = graph.query("MATCH (a:L)-[:R]->(b:L) RETURN count(a)")
+        self.env.assertEqual(result.result_set, [[60]])
+        result = graph.query("MATCH (a:L) RETURN count(a)")
+        self.env.assertEqual(result.result_set, [[200]])
+        graph.delete()
+
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET DELTA_MAX_PENDING_CHANGES 0")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            pass
+
+        redis_con.execute_command("GRAPH.CONFIG SET DELTA_MAX_PENDING_CHANGES 10000")
+
+    def test14_config_lazy_transposed_matrices(self):
+        # Transposed matrices are maintained eagerly by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET LAZY_TRANSPOSED_MATRICES")
+        self.env.assertEqual(response, ["LAZY_TRANSPOSED_MATRICES", 0])
+
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET LAZY_TRANSPOSED_MATRICES yes")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Field can not be re-configured" in str(e))
+            pass
+
+        # Budget is unlimited by default and runtime configurable
+        response = redis_con.execute_command("GRAPH.CONFIG GET TRANSPOSED_MATRICES_MAX_MEMORY")
+        self.env.assertEqual(response, ["TRANSPOSED_MATRICES_MAX_MEMORY", 0])
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET TRANSPOSED_MATRICES_MAX_MEMORY 1048576")
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET TRANSPOSED_MATRICES_MAX_MEMORY")
+        self.env.assertEqual(response, ["TRANSPOSED_MATRICES_MAX_MEMORY", 1048576])
+
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET TRANSPOSED_MATRICES_MAX_MEMORY -1")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            pass
+
+        redis_con.execute_command("GRAPH.CONFIG SET TRANSPOSED_MATRICES_MAX_MEMORY 0")
+
+    def test15_config_compaction_threshold(self):
+        # Compaction is disabled by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET COMPACTION_THRESHOLD")
+        self.env.assertEqual(response, ["COMPACTION_THRESHOLD", 0])
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET COMPACTION_THRESHOLD 50")
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET COMPACTION_THRESHOLD")
+        self.env.assertEqual(response, ["COMPACTION_THRESHOLD", 50])
+
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET COMPACTION_THRESHOLD 101")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            pass
+
+        redis_con.execute_command("GRAPH.CONFIG SET COMPACTION_THRESHOLD 0")
+
+    def test16_config_parallel_scan_threads(self):
+        # Nodes are scanned by the query's thread by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET PARALLEL_SCAN_THREADS")
+        self.env.assertEqual(response, ["PARALLEL_SCAN_THREADS", 1])
+
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET PARALLEL_SCAN_THREADS 4")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Field can not be re-configured" in str(e))
+            pass
+
+    def test17_config_traverse_batch_size(self):
+        response = redis_con.execute_command("GRAPH.CONFIG GET TRAVERSE_BATCH_SIZE")
+        self.env.assertEqual(response, ["TRAVERSE_BATCH_SIZE", 4096])
+
+        redis_graph.query("UNWIND range(1, 100) AS x CREATE (:Src {v: x})-[:R]->(:Dst {v: x})")
+        query = "MATCH (s:Src)-[:R]->(d:Dst) RETURN count(d), sum(d.v)"
+        expected = redis_graph.query(query).result_set
+
+        # Traversals produce the same results regardless of the batch size
+        for batch_size in [1, 3, 16]:
+            response = redis_con.execute_command("GRAPH.CONFIG SET TRAVERSE_BATCH_SIZE %d" % batch_size)
+            self.env.assertEqual(response, "OK")
+            self.env.assertEqual(redis_graph.query(query).result_set, expected)
+        self.env.assertEqual(expected, [[100, 5050]])
+
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET TRAVERSE_BATCH_SIZE 0")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            pass
+
+        redis_con.execute_command("GRAPH.CONFIG SET TRAVERSE_BATCH_SIZE 4096")
+
+    def test18_config_join_dram_budget(self):
+        # Hash join tables are kept on DRAM by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET JOIN_DRAM_BUDGET")
+        self.env.assertEqual(response, ["JOIN_DRAM_BUDGET", 0])
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET JOIN_DRAM_BUDGET 1048576")
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET JOIN_DRAM_BUDGET")
+        self.env.assertEqual(response, ["JOIN_DRAM_BUDGET", 1048576])
+
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET JOIN_DRAM_BUDGET -1")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            pass
+
+        redis_con.execute_command("GRAPH.CONFIG SET JOIN_DRAM_BUDGET 0")
@@ -51,3 +51,27 @@ class testEntityUpdate(FlowTestsBase):
         expected_result = [[1, 'Calgary']]
         self.env.assertEqual(result.properties_set, 1)
         self.env.assertEqual(result.result_set, expected_result)
+
+    def test06_update_many_attributes(self):
+        # attribute IDs are assigned in order of first appearance,
+        # the second node introduces its attributes in reverse ID order
+        attrs = ['a%d' % i for i in range(60)]
+        props = ', '.join('%s: %d' % (a, i) for i, a in enumerate(attrs))
+        graph.query("CREATE (:Doc {id: 0, %s})" % props)
+        props = ', '.join('%s: %d' % (a, i) for i, a in reversed(list(enumerate(attrs))))
+        graph.query("CREATE (:Doc {id: 1, %s})" % props)
+
+        # remove every third attribute, update the others
+        updates = ', '.join('n.%s = %s' % (a, 'NULL' if i % 3 == 0 else str(i * 10))
+                            for i, a in enumerate(attrs))
+        result = graph.query("MATCH (n:Doc) SET %s" % updates)
+        self.env.assertEqual(result.properties_set, 2 * len(attrs))
+
+        # re-introduce a removed attribute
+        graph.query("MATCH (n:Doc) SET n.a30 = 'back'")
+
+        projection = ', '.join('n.%s' % a for a in attrs)
+        result = graph.query("MATCH (n:Doc) RETURN %s ORDER BY n.id" % projection)
+        expected = [None if i % 3 == 0 else i * 10 for i in range(60)]
+        expected[30] = 'back'
+        self.env.assertEqual(result.result_set, [expected, expected])
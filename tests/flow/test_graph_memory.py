@@ -0,0 +1,64 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "memory_test"
+redis_con = None
+redis_graph = None
+
+CATEGORIES = ["nodes", "edges", "properties", "labels", "relations",
+              "transposes", "indexes", "plan_cache", "total"]
+
+class testGraphMemory(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def memory(self):
+        reply = redis_con.execute_command("GRAPH.MEMORY", GRAPH_ID)
+        usage = {}
+        for category, kinds in reply:
+            usage[category] = dict(zip(kinds[::2], kinds[1::2]))
+        return usage
+
+    def test01_memory_categories(self):
+        redis_graph.query("CREATE (:L {v: 'value'})-[:R]->(:L)")
+        usage = self.memory()
+
+        self.env.assertEquals(list(usage.keys()), CATEGORIES)
+        for category in CATEGORIES:
+            self.env.assertEquals(sorted(usage[category].keys()), ["dram", "pmem"])
+
+        # no PMEM pool was configured, everything resides on DRAM
+        self.env.assertEquals(usage["total"]["pmem"], 0)
+        self.env.assertGreater(usage["nodes"]["dram"], 0)
+        self.env.assertGreater(usage["properties"]["dram"], 0)
+
+        total = sum(usage[c]["dram"] for c in CATEGORIES[:-1])
+        self.env.assertEquals(usage["total"]["dram"], total)
+
+    def test02_memory_grows_with_graph(self):
+        before = self.memory()
+        redis_graph.query("UNWIND range(0, 999) AS x CREATE (:L {v: 'value' + toString(x)})")
+        after = self.memory()
+
+        self.env.assertGreater(after["properties"]["dram"], before["properties"]["dram"])
+        self.env.assertGreater(after["total"]["dram"], before["total"]["dram"])
+
+    def test03_memory_info_section(self):
+        # INFO reports allocator counters rather than scanning graphs
+        info = redis_con.execute_command("INFO", "graph_memory")
+        self.env.assertIn("persistent_heap", info)
+        for category in CATEGORIES[:-1]:
+            self.env.assertNotIn(category, info)
+
+    def test04_memory_arity(self):
+        try:
+            redis_con.execute_command("GRAPH.MEMORY")
+            self.env.assertTrue(False)
+        except Exception:
+            pass
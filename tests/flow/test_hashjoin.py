@@ -36,3 +36,27 @@ class testHashJoin(FlowTestsBase):
 
         self.env.assertEquals(actual_result.result_set, expected_result)
 
+
+    def test_hashjoin_values(self):
+        con = self.env.getConnection()
+        graph = Graph("hashjoin_values", con)
+
+        # Join values repeat on both sides, right hand side values are floats
+        graph.query("UNWIND range(0, 999) AS x CREATE (:L {v: x % 100})")
+        graph.query("UNWIND range(0, 499) AS x CREATE (:R {v: toFloat(x % 50)})")
+        # Values of other types and missing values don't intersect
+        graph.query("CREATE (:L {v: '1'}), (:L {v: true}), (:L), (:R {v: '1'}), (:R)")
+
+        q = "MATCH (l:L), (r:R) WHERE l.v = r.v RETURN count(l), count(DISTINCT l.v), count(DISTINCT r.v)"
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Value Hash Join", plan)
+
+        expected_result = [[50 * 10 * 10 + 1, 51, 51]]
+        actual_result = graph.query(q)
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # Tables exceeding the DRAM budget produce the same results
+        con.execute_command("GRAPH.CONFIG SET JOIN_DRAM_BUDGET 1")
+        actual_result = graph.query(q)
+        self.env.assertEquals(actual_result.result_set, expected_result)
+        con.execute_command("GRAPH.CONFIG SET JOIN_DRAM_BUDGET 0")
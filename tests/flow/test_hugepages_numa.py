@@ -0,0 +1,78 @@
+import os
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "hugepages_numa"
+NODE_COUNT = 20000
+redis_con = None
+
+# hugepages the module may still claim, reserved pages included
+def available_hugepages():
+    meminfo = {}
+    with open("/proc/meminfo") as f:
+        for line in f:
+            name, value = line.split(":", 1)
+            meminfo[name] = int(value.split()[0])
+    return meminfo.get("HugePages_Free", 0) - meminfo.get("HugePages_Rsvd", 0)
+
+class testHugepagesNuma(FlowTestsBase):
+    def __init__(self):
+        # DataBlock blocks are placed on DRAM, small matrix arrays as well
+        # while large ones are served from a PMEM pool
+        self.env = Env(decodeResponses=True,
+                       moduleArgs="PMEM_PATH /tmp MATRIX_PLACEMENT THRESHOLD ALLOC_THRESHOLD 4096 HUGEPAGES HUGETLB NUMA_POLICY BIND")
+        global redis_con
+        redis_con = self.env.getConnection()
+
+    def allocator_info(self):
+        return redis_con.execute_command("INFO", "graph_allocator")
+
+    def populate_and_validate(self, graph):
+        query = """UNWIND range(0, %d) AS x
+                   CREATE (:L {v: x})-[:R]->(:L {v: x})""" % (NODE_COUNT - 1)
+        graph.query(query)
+        result = graph.query("MATCH (a:L)-[:R]->(b:L) RETURN count(a), sum(b.v)")
+        self.env.assertEquals(result.result_set, [[NODE_COUNT, NODE_COUNT * (NODE_COUNT - 1) // 2]])
+
+    def test01_hugetlb_placement(self):
+        available = available_hugepages()
+        fallbacks = self.allocator_info()["hugetlb_fallbacks"]
+
+        graph = Graph(GRAPH_ID, redis_con)
+        self.populate_and_validate(graph)
+
+        info = self.allocator_info()
+        if available <= 0:
+            # no hugepages are reserved, allocations fall back to regular pages
+            self.env.assertGreater(info["hugetlb_fallbacks"], fallbacks)
+        else:
+            # blocks are served from reserved hugepages until they run out
+            self.env.assertTrue(available_hugepages() < available or
+                                info["hugetlb_fallbacks"] > fallbacks)
+
+    def test02_numa_bind(self):
+        # NUMA policies require kernel support
+        if not os.path.exists("/sys/devices/system/node/node0"):
+            self.env.skip()
+
+        info = self.allocator_info()
+        if info["numa_policy_failures"] > 0:
+            # failures are counted rather than failing allocations
+            return
+
+        # pages of blocks and matrices are bound to the configured nodes
+        pid = redis_con.execute_command("INFO", "server")["process_id"]
+        with open("/proc/%d/numa_maps" % pid) as f:
+            numa_maps = f.read()
+        self.env.assertIn("bind:", numa_maps)
+
+    def test03_regular_pages(self):
+        redis_con.execute_command("GRAPH.CONFIG SET HUGEPAGES NO")
+        redis_con.execute_command("GRAPH.CONFIG SET NUMA_POLICY DEFAULT")
+        fallbacks = self.allocator_info()["hugetlb_fallbacks"]
+
+        # allocations made afterwards don't ask for hugepages
+        graph = Graph(GRAPH_ID + "_regular", redis_con)
+        self.populate_and_validate(graph)
+        self.env.assertEquals(self.allocator_info()["hugetlb_fallbacks"], fallbacks)
@@ -0,0 +1,95 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "label_clustering"
+redis_con = None
+redis_graph = None
+
+class testLabelClustering(FlowTestsBase):
+    def __init__(self):
+        # nodes are stored in blocks dedicated to their label
+        self.env = Env(decodeResponses=True, moduleArgs="CLUSTER_NODES_BY_LABEL yes")
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def test01_label_scan(self):
+        # interleave nodes of different labels and unlabeled nodes
+        query = """UNWIND range(0, 99) AS x
+                   CREATE (:A {v: x}), (:B {v: x}), ({v: x})"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.nodes_created, 300)
+
+        result = redis_graph.query("MATCH (a:A) RETURN count(a), sum(a.v)")
+        self.env.assertEquals(result.result_set, [[100, 4950]])
+
+        result = redis_graph.query("MATCH (b:B) RETURN count(b), sum(b.v)")
+        self.env.assertEquals(result.result_set, [[100, 4950]])
+
+        result = redis_graph.query("MATCH (n) RETURN count(n)")
+        self.env.assertEquals(result.result_set, [[300]])
+
+        # every label scan only visits nodes of its own label
+        result = redis_graph.query("MATCH (a:A), (b:B) WHERE a.v = b.v RETURN count(a)")
+        self.env.assertEquals(result.result_set, [[100]])
+
+    def test02_id_range_scan(self):
+        result = redis_graph.query("MATCH (a:A) RETURN min(id(a)), max(id(a))")
+        min_id, max_id = result.result_set[0]
+
+        query = "MATCH (a:A) WHERE id(a) > %d AND id(a) <= %d RETURN count(a)" % (min_id, max_id)
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[99]])
+
+        query = "MATCH (b:B) WHERE id(b) >= %d AND id(b) <= %d RETURN count(b)" % (min_id, max_id)
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[0]])
+
+    def test03_reuse_deleted_ids(self):
+        result = redis_graph.query("MATCH (a:A) WHERE a.v < 10 RETURN collect(id(a))")
+        deleted = set(result.result_set[0][0])
+
+        result = redis_graph.query("MATCH (a:A) WHERE a.v < 10 DELETE a")
+        self.env.assertEquals(result.nodes_deleted, 10)
+
+        # nodes of other labels don't reuse the freed IDs
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:B {v: 100 + x})")
+        result = redis_graph.query("MATCH (b:B) RETURN collect(id(b))")
+        self.env.assertEquals(len(deleted & set(result.result_set[0][0])), 0)
+
+        # nodes of the same label do
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:A {v: x})")
+        result = redis_graph.query("MATCH (a:A) WHERE a.v < 10 RETURN collect(id(a))")
+        self.env.assertEquals(set(result.result_set[0][0]), deleted)
+
+        result = redis_graph.query("MATCH (a:A) RETURN count(a), sum(a.v)")
+        self.env.assertEquals(result.result_set, [[100, 4950]])
+
+    def test04_persistency(self):
+        redis_graph.query("MATCH (a:A), (b:B) WHERE a.v = b.v CREATE (a)-[:R {v: a.v}]->(b)")
+
+        result = redis_graph.query("MATCH (a:A) RETURN collect(id(a))")
+        ids = sorted(result.result_set[0][0])
+
+        redis_con.execute_command("DEBUG", "RELOAD")
+
+        # node IDs are preserved
+        result = redis_graph.query("MATCH (a:A) RETURN collect(id(a))")
+        self.env.assertEquals(sorted(result.result_set[0][0]), ids)
+
+        result = redis_graph.query("MATCH (b:B) RETURN count(b)")
+        self.env.assertEquals(result.result_set, [[110]])
+
+        result = redis_graph.query("MATCH (a:A)-[r:R]->(b:B) WHERE a.v = b.v AND r.v = a.v RETURN count(r)")
+        self.env.assertEquals(result.result_set, [[100]])
+
+        # new nodes keep being clustered after reload
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:C {v: x})")
+        result = redis_graph.query("MATCH (c:C) RETURN count(c), sum(c.v)")
+        self.env.assertEquals(result.result_set, [[10, 45]])
+
+        result = redis_graph.query("MATCH (n) RETURN count(n)")
+        self.env.assertEquals(result.result_set, [[320]])
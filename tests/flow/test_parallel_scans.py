@@ -0,0 +1,75 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "parallel_scans"
+redis_con = None
+redis_graph = None
+
+# spans several morsels of 16384 node IDs
+NODE_COUNT = 50000
+
+class testParallelScans(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs="PARALLEL_SCAN_THREADS 4")
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+        query = "UNWIND range(0, %d) AS x CREATE (:A {v: x, k: x %% 10})" % (NODE_COUNT - 1)
+        redis_graph.query(query)
+        query = "UNWIND range(0, 99) AS x CREATE (:B {v: x})"
+        redis_graph.query(query)
+
+    def test01_exchange_plan(self):
+        plan = redis_graph.execution_plan("MATCH (a:A) WHERE a.v > 10 RETURN sum(a.v)")
+        self.env.assertIn("Exchange", plan)
+
+        # aggregations followed by a sort hold on to records
+        plan = redis_graph.execution_plan("MATCH (a:A) RETURN a.k, count(a) AS c ORDER BY c")
+        self.env.assertNotIn("Exchange", plan)
+
+        # traversals are executed by the query's thread
+        plan = redis_graph.execution_plan("MATCH (a:A)-[]->(b) RETURN count(b)")
+        self.env.assertNotIn("Exchange", plan)
+
+    def test02_aggregate(self):
+        result = redis_graph.query("MATCH (a:A) RETURN count(a), sum(a.v), min(a.v), max(a.v)")
+        self.env.assertEquals(result.result_set, [[NODE_COUNT, sum(range(NODE_COUNT)), 0, NODE_COUNT - 1]])
+
+        result = redis_graph.query("MATCH (n) WHERE n.v % 2 = 0 RETURN count(n)")
+        self.env.assertEquals(result.result_set, [[NODE_COUNT // 2 + 50]])
+
+        # grouping
+        result = redis_graph.query("MATCH (a:A) WHERE a.v < 1000 RETURN a.k, count(a)")
+        self.env.assertEquals(sorted(result.result_set), [[k, 100] for k in range(10)])
+
+        # records are aggregated in node ID order
+        result = redis_graph.query("MATCH (a:A) WHERE a.v % 5000 = 0 RETURN collect(a.v)")
+        self.env.assertEquals(result.result_set, [[list(range(0, NODE_COUNT, 5000))]])
+
+    def test03_id_range(self):
+        query = "MATCH (a:A) WHERE ID(a) >= 20000 AND ID(a) < 40000 RETURN count(a), min(ID(a)), max(ID(a))"
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[20000, 20000, 39999]])
+
+    def test04_profile(self):
+        # profiled scans are executed by the query's thread
+        query = "MATCH (a:A) WHERE a.v >= 100 RETURN count(a.v)"
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, query)
+        profile = [x[0:x.index(',')].strip() for x in profile]
+        self.env.assertIn("Exchange | Workers: 4 | Records produced: %d" % (NODE_COUNT - 100), profile)
+        self.env.assertIn("Filter | Records produced: %d" % (NODE_COUNT - 100), profile)
+
+    def test05_runtime_error(self):
+        try:
+            redis_graph.query("MATCH (a:A) WHERE toUpper(a.v) = 'X' RETURN count(a)")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Type mismatch", str(e))
+
+        # the graph remains queryable
+        result = redis_graph.query("MATCH (b:B) RETURN count(b)")
+        self.env.assertEquals(result.result_set, [[100]])
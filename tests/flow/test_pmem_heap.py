@@ -0,0 +1,110 @@
+import os
+import sys
+import shutil
+from RLTest import Env
+from redisgraph import Graph, Node, Edge
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "pmem_heap"
+STALE_GRAPH_ID = "pmem_heap_stale"
+HEAP_PATH = "/tmp/redisgraph_test.heap"
+
+class testPersistentHeap(FlowTestsBase):
+    def __init__(self):
+        if os.path.exists(HEAP_PATH):
+            os.remove(HEAP_PATH)
+        self.env = Env(decodeResponses=True, moduleArgs="PMEM_HEAP " + HEAP_PATH)
+
+    def populate_graph(self, graph):
+        graph.query("""UNWIND range(0, 99) AS x
+                       CREATE (:L {v: x, s: 'str' + toString(x), a: [x, 'x']})""")
+        # Multiple edges between the same pair of nodes
+        graph.query("""MATCH (a:L {v: 0}), (b:L {v: 1})
+                       CREATE (a)-[:E {w: 1}]->(b), (a)-[:E {w: 2}]->(b)""")
+        graph.query("""MATCH (a:L), (b:L) WHERE b.v = a.v + 1
+                       CREATE (a)-[:R]->(b)""")
+        # Leave deleted entities behind
+        graph.query("MATCH (n:L) WHERE n.v >= 90 DETACH DELETE n")
+
+    def validate_graph(self, graph):
+        result = graph.query("MATCH (n:L) RETURN count(n), sum(n.v)")
+        self.env.assertEquals(result.result_set, [[90, 4005]])
+
+        result = graph.query("MATCH (n:L {v: 42}) RETURN n.s, n.a")
+        self.env.assertEquals(result.result_set, [['str42', [42, 'x']]])
+
+        result = graph.query("MATCH (:L {v: 0})-[e:E]->(:L {v: 1}) RETURN e.w ORDER BY e.w")
+        self.env.assertEquals(result.result_set, [[1], [2]])
+
+        result = graph.query("MATCH (a)<-[:R]-(b) RETURN count(a)")
+        self.env.assertEquals(result.result_set, [[89]])
+
+        # Deleted IDs are reused
+        graph.query("CREATE (:L {v: 1000})")
+        result = graph.query("MATCH (n:L) RETURN count(n)")
+        self.env.assertEquals(result.result_set, [[91]])
+
+    def test01_restart_attaches_graph(self):
+        redis_con = self.env.getConnection()
+        graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph(graph)
+        redis_con.execute_command("SAVE")
+
+        # Restart, graph is persisted into the heap on shutdown
+        self.env.stop()
+        self.env.start()
+
+        redis_con = self.env.getConnection()
+        graph = Graph(GRAPH_ID, redis_con)
+        self.validate_graph(graph)
+
+    def test02_stale_rdb_is_decoded(self):
+        redis_con = self.env.getConnection()
+        graph = Graph(STALE_GRAPH_ID, redis_con)
+        graph.query("UNWIND range(0, 9) AS x CREATE (:S {v: x})")
+        redis_con.execute_command("SAVE")
+
+        # Keep a copy of the RDB, then change values but not counts
+        rdb_dir = redis_con.config_get("dir")["dir"]
+        rdb_file = os.path.join(rdb_dir, redis_con.config_get("dbfilename")["dbfilename"])
+        stale_file = rdb_file + ".stale"
+        shutil.copyfile(rdb_file, stale_file)
+
+        graph.query("MATCH (n:S) SET n.v = n.v + 100")
+        redis_con.execute_command("SAVE")
+
+        # Restart from the older RDB, whose counts agree with the image
+        # persisted on shutdown but which wasn't saved alongside it
+        self.env.stop()
+        shutil.move(stale_file, rdb_file)
+        self.env.start()
+
+        redis_con = self.env.getConnection()
+        graph = Graph(STALE_GRAPH_ID, redis_con)
+        result = graph.query("MATCH (n:S) RETURN count(n), sum(n.v)")
+        self.env.assertEquals(result.result_set, [[10, 45]])
+
+    def test03_shutdown_rdb_omits_entities(self):
+        redis_con = self.env.getConnection()
+        graph = Graph(GRAPH_ID, redis_con)
+        graph.query("""UNWIND range(0, 9999) AS x
+                       CREATE (:B {v: x, s: 'padding' + toString(x)})""")
+        redis_con.execute_command("SAVE")
+
+        rdb_dir = redis_con.config_get("dir")["dir"]
+        rdb_file = os.path.join(rdb_dir, redis_con.config_get("dbfilename")["dbfilename"])
+        full_size = os.path.getsize(rdb_file)
+
+        # Entities are held by the heap, the RDB saved on shutdown only
+        # carries headers and schemas
+        self.env.stop()
+        self.env.assertLess(os.path.getsize(rdb_file), full_size / 10)
+        self.env.start()
+
+        redis_con = self.env.getConnection()
+        graph = Graph(GRAPH_ID, redis_con)
+        result = graph.query("MATCH (n:B) RETURN count(n), sum(n.v)")
+        self.env.assertEquals(result.result_set, [[10000, 49995000]])
@@ -0,0 +1,73 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "pmem_properties"
+redis_con = None
+redis_graph = None
+
+class testPMEMProperties(FlowTestsBase):
+    def __init__(self):
+        # property bags are served from a PMEM pool, updates are staged on DRAM
+        self.env = Env(decodeResponses=True,
+                       moduleArgs="PMEM_PATH /tmp PROPERTIES_PLACEMENT PMEM")
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def test01_create_properties(self):
+        result = redis_graph.query("UNWIND range(0, 99) AS x CREATE (:L {v: x, s: 'str' + toString(x), a: [x, x]})")
+        self.env.assertEquals(result.properties_set, 300)
+
+        result = redis_graph.query("MATCH (n:L) RETURN sum(n.v), count(n.s), sum(size(n.a))")
+        self.env.assertEquals(result.result_set, [[4950, 100, 200]])
+
+    def test02_update_properties(self):
+        # overwrite, add and remove properties of the same entities within a single commit
+        query = """MATCH (n:L) SET n.v = n.v + 1, n.w = n.v, n.s = NULL"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.properties_set, 300)
+
+        result = redis_graph.query("MATCH (n:L) RETURN sum(n.v), sum(n.w), count(n.s)")
+        self.env.assertEquals(result.result_set, [[5050, 4950, 0]])
+
+    def test03_remove_all_properties(self):
+        # empty every bag, then re-populate some within the same query
+        query = """MATCH (n:L) SET n.v = NULL, n.w = NULL, n.a = NULL
+                   WITH n WHERE id(n) % 2 = 0 SET n.z = id(n)"""
+        redis_graph.query(query)
+
+        result = redis_graph.query("MATCH (n:L) RETURN count(n.v), count(n.w), count(n.a), count(n.z)")
+        self.env.assertEquals(result.result_set, [[0, 0, 0, 50]])
+
+        result = redis_graph.query("MATCH (n:L) WHERE n.z IS NOT NULL RETURN sum(n.z)")
+        self.env.assertEquals(result.result_set, [[2450]])
+
+    def test04_repeated_entity_updates(self):
+        # the same entity appears in multiple records
+        redis_graph.query("CREATE (:M {v: 0})")
+        redis_graph.query("UNWIND range(1, 10) AS x MATCH (m:M) SET m.v = x, m.last = x")
+
+        result = redis_graph.query("MATCH (m:M) RETURN m.v, m.last")
+        self.env.assertEquals(result.result_set, [[10, 10]])
+
+    def test05_merge_updates(self):
+        # ON CREATE SET and ON MATCH SET stage PMEM resident bags on DRAM
+        query = """UNWIND range(0, 9) AS x
+                   MERGE (n:Merged {k: x})
+                   ON CREATE SET n.created = true, n.s = 'str' + toString(x)"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.nodes_created, 10)
+        self.env.assertEquals(result.properties_set, 30)
+
+        query = """UNWIND range(0, 19) AS x
+                   MERGE (n:Merged {k: x})
+                   ON MATCH SET n.matched = x, n.s = NULL
+                   ON CREATE SET n.created = true"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.nodes_created, 10)
+
+        result = redis_graph.query("""MATCH (n:Merged) RETURN count(n.created), sum(n.matched), count(n.s)""")
+        self.env.assertEquals(result.result_set, [[20, 45, 0]])
@@ -0,0 +1,76 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "property_columns"
+redis_con = None
+redis_graph = None
+
+class testPropertyColumns(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def aggregate(self):
+        query = """MATCH (t:Tx) WHERE t.amount >= 0
+                   RETURN count(t.amount), sum(t.amount), min(t.amount), max(t.amount)"""
+        return redis_graph.query(query).result_set[0]
+
+    def test01_populate_column(self):
+        # integer, floating point and string values, and a node without amount
+        redis_graph.query("UNWIND range(1, 100) AS x CREATE (:Tx {amount: x})")
+        redis_graph.query("CREATE (:Tx {amount: 0.5}), (:Tx {amount: 'n/a'}), (:Tx), (:Other {amount: 1000})")
+        expected = self.aggregate()
+
+        redis_graph.query("CALL db.columnar.createNodeColumn('Tx', 'amount')")
+        self.env.assertEquals(self.aggregate(), expected)
+        self.env.assertEquals(expected, [101, 5050.5, 0.5, 100])
+
+        # values are typed as stored
+        result = redis_graph.query("MATCH (t:Tx) WHERE t.amount < 1 RETURN t.amount")
+        self.env.assertEquals(result.result_set, [[0.5]])
+        result = redis_graph.query("MATCH (t:Tx) WHERE t.amount = 7 RETURN t.amount")
+        self.env.assertEquals(result.result_set, [[7]])
+
+        # values which aren't numeric are read from the node
+        result = redis_graph.query("MATCH (t:Tx) WHERE toString(t.amount) = 'n/a' RETURN t.amount")
+        self.env.assertEquals(result.result_set, [['n/a']])
+        result = redis_graph.query("MATCH (t:Tx) WHERE t.amount IS NULL RETURN count(t)")
+        self.env.assertEquals(result.result_set[0][0], 1)
+
+    def test02_column_maintenance(self):
+        # creations
+        redis_graph.query("CREATE (:Tx {amount: 200})")
+        # updates, including removals and type changes
+        redis_graph.query("MATCH (t:Tx) WHERE t.amount = 1 SET t.amount = 300")
+        redis_graph.query("MATCH (t:Tx) WHERE t.amount = 2 SET t.amount = NULL")
+        redis_graph.query("MATCH (t:Tx) WHERE t.amount = 3 SET t.amount = 'x'")
+        redis_graph.query("MATCH (t:Tx) WHERE t.amount = 0.5 SET t.amount = 4.5")
+        redis_graph.query("MERGE (t:Tx {amount: 4}) ON MATCH SET t.amount = 400")
+        # deletions, freed IDs are reused by nodes without amount
+        redis_graph.query("MATCH (t:Tx) WHERE t.amount = 5 DELETE t")
+        redis_graph.query("CREATE (:Tx)")
+
+        result = redis_graph.query("MATCH (t:Tx) WHERE t.amount >= 0 RETURN count(t), sum(t.amount)")
+        self.env.assertEquals(result.result_set[0], [99, 5050 - 15 + 200 + 300 + 4.5 + 400])
+        result = redis_graph.query("MATCH (t:Tx) WHERE t.amount IS NULL RETURN count(t)")
+        self.env.assertEquals(result.result_set[0][0], 3)
+
+    def test03_persistence(self):
+        expected = self.aggregate()
+        self.env.dumpAndReload()
+        self.env.assertEquals(self.aggregate(), expected)
+
+        # the column is kept after reload
+        redis_graph.query("MATCH (t:Tx) WHERE t.amount = 200 SET t.amount = 201")
+        result = redis_graph.query("MATCH (t:Tx) WHERE t.amount > 200 AND t.amount < 300 RETURN t.amount")
+        self.env.assertEquals(result.result_set, [[201]])
+
+    def test04_drop_column(self):
+        expected = self.aggregate()
+        redis_graph.query("CALL db.columnar.drop('Tx', 'amount')")
+        self.env.assertEquals(self.aggregate(), expected)
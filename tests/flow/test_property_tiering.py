@@ -0,0 +1,87 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "property_tiering"
+NODE_COUNT = 1000
+DRAM_BUDGET = 1048576
+redis_con = None
+redis_graph = None
+
+class testPropertyTiering(FlowTestsBase):
+    def __init__(self):
+        # property bags are created on DRAM and tiered against a PMEM pool
+        self.env = Env(decodeResponses=True,
+                       moduleArgs="PMEM_PATH /tmp PROPERTIES_DRAM_BUDGET %d" % DRAM_BUDGET)
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def tiering_info(self):
+        return redis_con.execute_command("INFO", "graph_tiering")
+
+    # wait for a tiering counter to exceed 'value', reading the hot entities
+    # in the meantime if 'hot' is set
+    def wait_for(self, counter, value, hot=False):
+        deadline = time.time() + 10
+        while time.time() < deadline:
+            if hot:
+                result = redis_graph.query("MATCH (n:L) WHERE id(n) < 10 RETURN sum(n.v), count(n.s)")
+                self.env.assertEquals(result.result_set, [[45, 10]])
+            else:
+                time.sleep(0.1)
+            info = self.tiering_info()
+            if info[counter] > value:
+                return info
+        return self.tiering_info()
+
+    def test01_cold_properties_demoted(self):
+        info = self.tiering_info()
+        self.env.assertEquals(info["dram_budget"], DRAM_BUDGET)
+        self.env.assertEquals(info["promotions"], 0)
+        self.env.assertEquals(info["demotions"], 0)
+
+        query = "UNWIND range(0, %d) AS x CREATE (:L {v: x, s: 'str' + toString(x)})" % (NODE_COUNT - 1)
+        redis_graph.query(query)
+
+        # unread entities are cold, their bags leave DRAM
+        info = self.wait_for("demotions", NODE_COUNT - 1)
+        self.env.assertEquals(info["demotions"], NODE_COUNT)
+        self.env.assertEquals(info["promotions"], 0)
+
+        # demoted properties are intact
+        result = redis_graph.query("MATCH (n:L) RETURN sum(n.v), count(n.s)")
+        self.env.assertEquals(result.result_set, [[NODE_COUNT * (NODE_COUNT - 1) // 2, NODE_COUNT]])
+
+    def test02_hot_properties_promoted(self):
+        # let entities heated by earlier reads settle
+        time.sleep(0.5)
+        promotions = self.tiering_info()["promotions"]
+
+        # frequently read entities return to DRAM
+        info = self.wait_for("promotions", promotions, hot=True)
+        self.env.assertGreater(info["promotions"], promotions)
+        # only the entities being read are hot
+        self.env.assertLessEqual(info["promotions"] - promotions, 10)
+
+        result = redis_graph.query("MATCH (n:L {v: 5}) RETURN n.s")
+        self.env.assertEquals(result.result_set, [["str5"]])
+
+    def test03_tiering_disabled(self):
+        redis_con.execute_command("GRAPH.CONFIG SET PROPERTIES_DRAM_BUDGET 0")
+        # a pass may be in flight
+        time.sleep(0.2)
+        info = self.tiering_info()
+        self.env.assertEquals(info["dram_budget"], 0)
+
+        # no pass runs once the budget is cleared
+        promotions = info["promotions"]
+        demotions = info["demotions"]
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:M {v: x})")
+        time.sleep(0.5)
+        info = self.tiering_info()
+        self.env.assertEquals(info["promotions"], promotions)
+        self.env.assertEquals(info["demotions"], demotions)
@@ -196,3 +196,24 @@ class testResultSetFlow(FlowTestsBase):
         unlimited_record_count = len(result.result_set)
         assert(unlimited_record_count == record_count)
 
+
+    # Test results spanning multiple record batches
+    def test10_batched_results(self):
+        graph.query("UNWIND range(1, 1000) AS x CREATE (:batched {v: x})")
+
+        # scan, filter and project across batch boundaries
+        query = "MATCH (a:batched) WHERE a.v % 3 = 0 RETURN a.v"
+        result = graph.query(query)
+        self.env.assertEqual([row[0] for row in result.result_set], list(range(3, 1001, 3)))
+
+        query = "MATCH (a:batched) WHERE a.v > 100 RETURN count(a), sum(a.v)"
+        result = graph.query(query)
+        self.env.assertEqual(result.result_set[0], [900, sum(range(101, 1001))])
+
+        # implicit limit smaller than a batch, and spanning several batches
+        for limit in [5, 300]:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_SIZE", limit)
+            result = graph.query("MATCH (a:batched) RETURN a.v")
+            self.env.assertEqual([row[0] for row in result.result_set], list(range(1, limit + 1)))
+
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_SIZE", -1)
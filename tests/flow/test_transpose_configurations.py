@@ -149,3 +149,44 @@ class testTransposeConfigurations(FlowTestsBase):
 
         # Validate that the output is the same with both configurations
         configured_env.assertEquals(configured_result.result_set, default_result.result_set)
+
+    # Test transposed matrices built on first use.
+    def test04_lazy_transposed_traversal(self):
+        traverse_query = """MATCH (a)-[:E]->(b:L) RETURN a.val, b.val ORDER BY a.val, b.val"""
+        expected_result = [['v1', 'v2'],
+                           ['v1', 'v3'],
+                           ['v2', 'v3']]
+
+        # Flush and tear down the default environment
+        self.env.flush()
+        self.env.stop()
+
+        # Instantiate a new server building transposed matrices lazily
+        configured_env = Env(decodeResponses=True, moduleArgs="LAZY_TRANSPOSED_MATRICES yes")
+        redis_con = configured_env.getConnection()
+        configured_graph = Graph(GRAPH_ID, redis_con)
+        # Repopulate the graph
+        self.populate_graph(configured_graph)
+
+        # The transposed matrix is built by the first traversal
+        configured_result = configured_graph.query(traverse_query)
+        configured_env.assertEquals(configured_result.result_set, expected_result)
+
+        # Later updates are applied to the built transposed matrix
+        configured_graph.query("MATCH (a:L {val: 'v3'}), (b:L {val: 'v2'}) CREATE (a)-[:E]->(b)")
+        configured_graph.query("MATCH (a:L {val: 'v1'})-[e:E]->(b:L {val: 'v2'}) DELETE e")
+        configured_result = configured_graph.query(traverse_query)
+        configured_env.assertEquals(configured_result.result_set, [['v1', 'v3'],
+                                                                    ['v2', 'v3'],
+                                                                    ['v3', 'v2']])
+
+        # Transposed matrices dropped under a tiny budget are rebuilt on use
+        redis_con.execute_command("GRAPH.CONFIG SET TRANSPOSED_MATRICES_MAX_MEMORY 1")
+        configured_result = configured_graph.query(traverse_query)
+        configured_env.assertEquals(configured_result.result_set, [['v1', 'v3'],
+                                                                    ['v2', 'v3'],
+                                                                    ['v3', 'v2']])
+
+        # Flush and tear down the new environment
+        configured_env.flush()
+        configured_env.stop()
@@ -159,6 +159,7 @@ class AlgebraicExpressionTest: public ::testing::Test {
 		Graph_ConnectNodes(g, 2, 3, war_relation_id, &e);
 		Graph_ConnectNodes(g, 3, 2, war_relation_id, &e);
 
+		Graph_ApplyAllPending(g);
 		Graph_ReleaseLock(g);
 	}
 
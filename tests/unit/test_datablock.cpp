@@ -38,7 +38,7 @@ TEST_F(DataBlockTest, New) {
 
 	ASSERT_EQ(dataBlock->itemCount, 0);     // No items were added.
 	ASSERT_GE(dataBlock->itemCap, 1024);
-	ASSERT_EQ(dataBlock->itemSize, itemSize + ITEM_HEADER_SIZE);
+	ASSERT_EQ(dataBlock->itemSize, itemSize);
 	ASSERT_GE(dataBlock->blockCount, 1024 / DATABLOCK_BLOCK_CAP);
 
 	for(int i = 0; i < dataBlock->blockCount; i++) {
@@ -159,8 +159,8 @@ TEST_F(DataBlockTest, RemoveItem) {
 	DataBlock_DeleteItem(dataBlock, 0);
 	ASSERT_EQ(dataBlock->itemCount, itemCount - 1);
 	ASSERT_EQ(array_len(dataBlock->deletedIdx), 1);
-	DataBlockItemHeader *header = (DataBlockItemHeader *)dataBlock->blocks[0]->data;
-	ASSERT_TRUE(IS_ITEM_DELETED(header));
+	ASSERT_FALSE(DATABLOCK_BITMAP_TEST(dataBlock->blocks[0], 0));
+	ASSERT_TRUE(DataBlock_ItemIsDeleted(dataBlock, 0));
 
 	// Try to get item from deleted cell.
 	item = (int *)DataBlock_GetItem(dataBlock, 0);
@@ -180,7 +180,7 @@ TEST_F(DataBlockTest, RemoveItem) {
 	int *newItem = (int *)DataBlock_AllocateItem(dataBlock, NULL);
 	ASSERT_EQ(dataBlock->itemCount, itemCount);
 	ASSERT_EQ(array_len(dataBlock->deletedIdx), 0);
-	ASSERT_TRUE((void *)newItem == (void *)((dataBlock->blocks[0]->data) + ITEM_HEADER_SIZE));
+	ASSERT_TRUE((void *)newItem == (void *)dataBlock->blocks[0]->data);
 
 	it = DataBlock_Scan(dataBlock);
 	counter = 0;
@@ -192,6 +192,80 @@ TEST_F(DataBlockTest, RemoveItem) {
 	DataBlock_Free(dataBlock);
 }
 
+TEST_F(DataBlockTest, RemoveItems) {
+	DataBlock *dataBlock = DataBlock_New(1024, sizeof(int), NULL);
+	uint itemCount = DATABLOCK_BLOCK_CAP * 4;
+	DataBlock_Accommodate(dataBlock, itemCount);
+
+	for(int i = 0 ; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// Remove every other item of each block, out of order and with duplicates.
+	uint64_t idx[itemCount];
+	uint count = 0;
+	for(int i = itemCount - 2; i >= 0; i -= 2) idx[count++] = i;
+	idx[count++] = 0;
+	DataBlock_DeleteItems(dataBlock, idx, count, 4);
+
+	ASSERT_EQ(dataBlock->itemCount, itemCount / 2);
+	ASSERT_EQ(array_len(dataBlock->deletedIdx), itemCount / 2);
+	for(int i = 0 ; i < itemCount; i++) {
+		ASSERT_EQ(DataBlock_ItemIsDeleted(dataBlock, i), i % 2 == 0);
+	}
+
+	// There's no harm in deleting deleted items.
+	idx[0] = 0;
+	idx[1] = 1;
+	DataBlock_DeleteItems(dataBlock, idx, 2, 4);
+	ASSERT_EQ(dataBlock->itemCount, itemCount / 2 - 1);
+	ASSERT_EQ(array_len(dataBlock->deletedIdx), itemCount / 2 + 1);
+
+	// Cleanup.
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, Compact) {
+	DataBlock *dataBlock = DataBlock_New(1, sizeof(int), NULL);
+	uint64_t itemCount = DATABLOCK_BLOCK_CAP * 3;
+
+	for(uint64_t i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// Free the first 10 positions and the entire last block.
+	for(uint64_t i = 0; i < 10; i++) DataBlock_DeleteItem(dataBlock, i);
+	for(uint64_t i = DATABLOCK_BLOCK_CAP * 2; i < itemCount; i++) DataBlock_DeleteItem(dataBlock, i);
+
+	// Move a few items, the free last block is released.
+	uint64_t from[10];
+	uint64_t to[10];
+	ASSERT_EQ(DataBlock_Compact(dataBlock, 4, from, to), 4);
+	ASSERT_EQ(dataBlock->blockCount, 2);
+	for(uint64_t i = 0; i < 4; i++) {
+		ASSERT_EQ(from[i], DATABLOCK_BLOCK_CAP * 2 - 1 - i);
+		ASSERT_EQ(to[i], i);
+		ASSERT_EQ(*(int *)DataBlock_GetItem(dataBlock, to[i]), from[i]);
+		ASSERT_TRUE(DataBlock_ItemIsDeleted(dataBlock, from[i]));
+	}
+	ASSERT_EQ(array_len(dataBlock->deletedIdx), 6);
+
+	// Fill the remaining free positions.
+	ASSERT_EQ(DataBlock_Compact(dataBlock, 10, from, to), 6);
+	ASSERT_EQ(array_len(dataBlock->deletedIdx), 0);
+	ASSERT_EQ(dataBlock->itemCount, DATABLOCK_BLOCK_CAP * 2 - 10);
+
+	// Nothing left to move, new items are appended.
+	ASSERT_EQ(DataBlock_Compact(dataBlock, 10, from, to), 0);
+	uint64_t idx;
+	DataBlock_AllocateItem(dataBlock, &idx);
+	ASSERT_EQ(idx, DATABLOCK_BLOCK_CAP * 2 - 10);
+
+	DataBlock_Free(dataBlock);
+}
+
 TEST_F(DataBlockTest, OutOfOrderBuilding) {
 	// This test checks for a fragmented, data block out of order re-construction.
 	DataBlock *dataBlock = DataBlock_New(1, sizeof(int), NULL);
@@ -239,3 +313,133 @@ TEST_F(DataBlockTest, OutOfOrderBuilding) {
 	DataBlock_Free(dataBlock);
 }
 
+
+TEST_F(DataBlockTest, LabelClustering) {
+	DataBlock *dataBlock = DataBlock_NewClustered(1, sizeof(int), NULL);
+	ASSERT_TRUE(DataBlock_IsClustered(dataBlock));
+
+	// Interleave items of two labels.
+	uint64_t ids[20];
+	for(int i = 0; i < 20; i++) {
+		int *item = (int *)DataBlock_AllocateItem_Label(dataBlock, i % 2, ids + i);
+		*item = i;
+	}
+	ASSERT_EQ(20, dataBlock->itemCount);
+
+	// Each label resides in its own block.
+	for(int i = 0; i < 20; i++) {
+		ASSERT_EQ(ids[i] / DATABLOCK_BLOCK_CAP, ids[i % 2] / DATABLOCK_BLOCK_CAP);
+	}
+	ASSERT_NE(ids[0] / DATABLOCK_BLOCK_CAP, ids[1] / DATABLOCK_BLOCK_CAP);
+
+	// Scan a single label.
+	int *item;
+	int count = 0;
+	DataBlockIterator *it = DataBlock_ScanLabel(dataBlock, 1, 0, UINT64_MAX);
+	while((item = (int *)DataBlockIterator_Next(it, NULL))) {
+		ASSERT_EQ(1, *item % 2);
+		count++;
+	}
+	ASSERT_EQ(10, count);
+	DataBlockIterator_Free(it);
+
+	// Free indices are reused by items of the same label.
+	DataBlock_DeleteItem(dataBlock, ids[3]);
+	ASSERT_EQ(19, dataBlock->itemCount);
+	uint64_t id;
+	DataBlock_AllocateItem_Label(dataBlock, 0, &id);
+	ASSERT_NE(ids[3], id);
+	DataBlock_AllocateItem_Label(dataBlock, 1, &id);
+	ASSERT_EQ(ids[3], id);
+
+	// Never used positions below the highest index count as deleted.
+	uint64_t *deleted = DataBlock_DeletedItems(dataBlock);
+	ASSERT_EQ(DataBlock_DeletedItemsCount(dataBlock), array_len(deleted));
+	ASSERT_EQ(dataBlock->itemCount + array_len(deleted), ids[1] + 10);
+
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, LabelClusteredOutOfOrderBuilding) {
+	DataBlock *dataBlock = DataBlock_NewClustered(1, sizeof(int), NULL);
+
+	// Block 0 holds items of both labels, block 1 of label 1 only.
+	uint64_t shared[3] = {0, 1, 3};
+	int shared_labels[3] = {0, 1, 0};
+	for(int i = 0; i < 3; i++) {
+		int *item = (int *)DataBlock_AllocateItemOutOfOrder_Label(dataBlock, shared[i],
+																  shared_labels[i]);
+		*item = shared_labels[i];
+	}
+	uint64_t owned = DATABLOCK_BLOCK_CAP + 5;
+	int *item = (int *)DataBlock_AllocateItemOutOfOrder_Label(dataBlock, owned, 1);
+	*item = 1;
+	DataBlock_MarkAsDeletedOutOfOrder(dataBlock, 2);
+	DataBlock_BuildLabelChains(dataBlock);
+
+	ASSERT_EQ(4, dataBlock->itemCount);
+	ASSERT_EQ(owned + 1, dataBlock->itemCount + DataBlock_DeletedItemsCount(dataBlock));
+
+	// Label scans visit the shared block last.
+	uint64_t id;
+	DataBlockIterator *it = DataBlock_ScanLabel(dataBlock, 1, 0, UINT64_MAX);
+	ASSERT_TRUE(DataBlockIterator_Next(it, &id));
+	ASSERT_EQ(owned, id);
+	ASSERT_FALSE(DataBlockIterator_InSecondChain(it));
+	for(int i = 0; i < 3; i++) {
+		ASSERT_TRUE(DataBlockIterator_Next(it, &id));
+		ASSERT_EQ(shared[i], id);
+		ASSERT_TRUE(DataBlockIterator_InSecondChain(it));
+	}
+	ASSERT_FALSE(DataBlockIterator_Next(it, NULL));
+	DataBlockIterator_Free(it);
+
+	// Label 1 reuses the free positions of its own block.
+	DataBlock_AllocateItem_Label(dataBlock, 1, &id);
+	ASSERT_EQ(owned - 1, id);
+
+	// ID range restricted scan.
+	it = DataBlock_ScanLabel(dataBlock, 1, 1, 2);
+	ASSERT_TRUE(DataBlockIterator_Next(it, &id));
+	ASSERT_EQ(1, id);
+	ASSERT_FALSE(DataBlockIterator_Next(it, NULL));
+	DataBlockIterator_Free(it);
+
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, SparseScan) {
+	DataBlock *dataBlock = DataBlock_New(1, sizeof(int), NULL);
+	uint64_t itemCount = DATABLOCK_BLOCK_CAP * 3;
+
+	for(uint64_t i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// Delete every item but those at a multiple of 1000,
+	// leaving entire bitmap words and the whole middle block empty.
+	for(uint64_t i = 0; i < itemCount; i++) {
+		if(i % 1000 == 0 && i / DATABLOCK_BLOCK_CAP != 1) continue;
+		DataBlock_DeleteItem(dataBlock, i);
+	}
+
+	uint64_t idx;
+	uint64_t expected = 0;
+	int *item;
+	DataBlockIterator *it = DataBlock_Scan(dataBlock);
+	while((item = (int *)DataBlockIterator_Next(it, &idx))) {
+		while(expected % 1000 != 0 || expected / DATABLOCK_BLOCK_CAP == 1) expected++;
+		ASSERT_EQ(expected, idx);
+		ASSERT_EQ(expected, *item);
+		ASSERT_FALSE(DataBlock_ItemIsDeleted(dataBlock, idx));
+		expected++;
+	}
+	ASSERT_EQ(dataBlock->itemCount, 34);
+	DataBlockIterator_Free(it);
+
+	// Freed positions are reported once.
+	ASSERT_EQ(array_len(dataBlock->deletedIdx), itemCount - dataBlock->itemCount);
+
+	DataBlock_Free(dataBlock);
+}
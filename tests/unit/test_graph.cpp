@@ -37,6 +37,19 @@ typedef struct {
 	int64_t relationId; // Relation type ID.
 } EdgeDesc;
 
+// Number of entries in M + DP - DM, counted through the delta matrices.
+static GrB_Index _RelationEntryCount(const Graph *g, int r, bool transposed) {
+	GrB_Matrix M;
+	GrB_Matrix DP;
+	GrB_Matrix DM;
+	GrB_Index n = 0;
+	Graph_GetRelationMatrixDeltas(g, r, transposed, &M, &DP, &DM);
+	RG_MatrixTupleIter *it = RG_MatrixTupleIter_new(M, DP, DM);
+	while(RG_MatrixTupleIter_next(it, NULL, NULL, NULL)) n++;
+	RG_MatrixTupleIter_free(it);
+	return n;
+}
+
 class GraphTest : public ::testing::Test {
   protected:
 	static void SetUpTestCase() {
@@ -886,3 +899,264 @@ TEST_F(GraphTest, BulkDelete) {
 	Graph_Free(g);
 }
 
+
+TEST_F(GraphTest, DeltaMatrices) {
+	/* Modify a graph and make sure pending changes are kept in delta
+	 * matrices, visible to readers and merged by Graph_MergeDeltas. */
+
+	Node n;
+	Edge e;
+	GrB_Index nvals;
+	GrB_Matrix M;
+	GrB_Matrix DP;
+	GrB_Matrix DM;
+	size_t nodeCount = 8;
+
+	Graph *g = Graph_New(nodeCount, nodeCount);
+	Graph_AcquireWriteLock(g);
+	int label = Graph_AddLabel(g);
+	int r = Graph_AddRelationType(g);
+	for(int i = 0; i < nodeCount; i++) Graph_CreateNode(g, label, &n);
+	for(int i = 0; i < nodeCount - 1; i++) Graph_ConnectNodes(g, i, i + 1, r, &e);
+	Graph_ReleaseLock(g);
+
+	// Changes are pending.
+	Graph_GetRelationMatrixDeltas(g, r, false, &M, &DP, &DM);
+	GrB_Matrix_nvals(&nvals, DP);
+	ASSERT_EQ(nvals, nodeCount - 1);
+	GrB_Matrix_nvals(&nvals, M);
+	ASSERT_EQ(nvals, 0);
+
+	// Readers observe pending changes.
+	Graph_AcquireReadLock(g);
+	ASSERT_TRUE(Graph_EdgeExists(g, 0, 1, r));
+	ASSERT_FALSE(Graph_EdgeExists(g, 1, 0, r));
+	ASSERT_EQ(Graph_LabeledNodeCount(g, label), nodeCount);
+	ASSERT_EQ(_RelationEntryCount(g, r, false), nodeCount - 1);
+	ASSERT_EQ(_RelationEntryCount(g, r, true), nodeCount - 1);
+	Graph_ReleaseLock(g);
+
+	// Reading doesn't merge pending changes.
+	Graph_GetRelationMatrixDeltas(g, r, false, &M, &DP, &DM);
+	GrB_Matrix_nvals(&nvals, M);
+	ASSERT_EQ(nvals, 0);
+
+	// Merge all pending changes.
+	Graph_MergeDeltas(g, 1);
+
+	Graph_GetRelationMatrixDeltas(g, r, false, &M, &DP, &DM);
+	GrB_Matrix_nvals(&nvals, DP);
+	ASSERT_EQ(nvals, 0);
+	GrB_Matrix_nvals(&nvals, M);
+	ASSERT_EQ(nvals, nodeCount - 1);
+
+	// Deleting a merged edge records it in DM.
+	Edge *edges = array_new(Edge, 1);
+	Graph_AcquireWriteLock(g);
+	Graph_GetEdgesConnectingNodes(g, 0, 1, r, &edges);
+	ASSERT_EQ(array_len(edges), 1);
+	ASSERT_EQ(Graph_DeleteEdge(g, edges), 1);
+	Graph_ReleaseLock(g);
+	array_free(edges);
+
+	Graph_GetRelationMatrixDeltas(g, r, false, &M, &DP, &DM);
+	GrB_Matrix_nvals(&nvals, DM);
+	ASSERT_EQ(nvals, 1);
+
+	Graph_AcquireReadLock(g);
+	ASSERT_FALSE(Graph_EdgeExists(g, 0, 1, r));
+	ASSERT_TRUE(Graph_EdgeExists(g, 1, 2, r));
+	ASSERT_EQ(_RelationEntryCount(g, r, false), nodeCount - 2);
+	Graph_ReleaseLock(g);
+
+	// A quiescent matrix is merged even below the threshold.
+	Graph_MergeDeltas(g, 1000);
+	Graph_MergeDeltas(g, 1000);
+
+	Graph_GetRelationMatrixDeltas(g, r, false, &M, &DP, &DM);
+	GrB_Matrix_nvals(&nvals, DM);
+	ASSERT_EQ(nvals, 0);
+	GrB_Matrix_nvals(&nvals, M);
+	ASSERT_EQ(nvals, nodeCount - 2);
+
+	Graph_Free(g);
+}
+
+TEST_F(GraphTest, ConnectNodesBatch) {
+	/* Connect a batch of edges, including multiple edges between the same
+	 * pair of nodes and edges between already connected nodes, make sure
+	 * the graph is identical to one built edge by edge. */
+
+	Node n;
+	Edge e;
+	size_t nodeCount = 4;
+	GrB_Index nvals;
+
+	Graph *g = Graph_New(nodeCount, nodeCount);
+	Graph_AcquireWriteLock(g);
+	for(int i = 0; i < nodeCount; i++) Graph_CreateNode(g, GRAPH_NO_LABEL, &n);
+	int r0 = Graph_AddRelationType(g);
+	int r1 = Graph_AddRelationType(g);
+
+	// (0)-[r0]->(1) exists prior to the batch.
+	Graph_ConnectNodes(g, 0, 1, r0, &e);
+	Graph_ApplyAllPending(g);
+
+	EdgeDesc desc[6] = {
+		{0, 1, r0},     // already connected
+		{1, 2, r0},
+		{1, 2, r0},     // multiple edges within the batch
+		{1, 2, r1},
+		{2, 3, r1},
+		{1, 2, r0},
+	};
+
+	Edge batch[6];
+	Edge *edges[6];
+	for(int i = 0; i < 6; i++) {
+		Graph_CreateEdge(g, desc[i].srcId, desc[i].destId, desc[i].relationId, batch + i);
+		edges[i] = batch + i;
+	}
+	Graph_ConnectNodesBatch(g, edges, 6);
+	Graph_ReleaseLock(g);
+
+	ASSERT_EQ(Graph_EdgeCount(g), 7);
+
+	Edge *connecting = array_new(Edge, 3);
+	Graph_GetEdgesConnectingNodes(g, 0, 1, r0, &connecting);
+	ASSERT_EQ(array_len(connecting), 2);
+	array_clear(connecting);
+
+	// Edges are kept in insertion order.
+	Graph_GetEdgesConnectingNodes(g, 1, 2, r0, &connecting);
+	ASSERT_EQ(array_len(connecting), 3);
+	ASSERT_EQ(connecting[0].id, batch[1].id);
+	ASSERT_EQ(connecting[1].id, batch[2].id);
+	ASSERT_EQ(connecting[2].id, batch[5].id);
+	array_clear(connecting);
+
+	Graph_GetEdgesConnectingNodes(g, 1, 2, r1, &connecting);
+	ASSERT_EQ(array_len(connecting), 1);
+	ASSERT_EQ(connecting[0].id, batch[3].id);
+	array_clear(connecting);
+
+	// Incoming edges are found through the transposed matrices.
+	Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_INCOMING, r1, &connecting);
+	ASSERT_EQ(array_len(connecting), 1);
+	ASSERT_EQ(connecting[0].id, batch[4].id);
+	array_free(connecting);
+
+	Graph_AcquireReadLock(g);
+	GrB_Matrix_nvals(&nvals, Graph_GetAdjacencyMatrix(g));
+	ASSERT_EQ(nvals, 3);
+	GrB_Matrix_nvals(&nvals, Graph_GetRelationMatrix(g, r0));
+	ASSERT_EQ(nvals, 2);
+	GrB_Matrix_nvals(&nvals, Graph_GetTransposedRelationMatrix(g, r1));
+	ASSERT_EQ(nvals, 2);
+	Graph_ReleaseLock(g);
+
+	Graph_Free(g);
+}
+
+TEST_F(GraphTest, GetTypedIncomingEdges) {
+	/* Connect a hub node to sources of different relation types and make
+	 * sure typed incoming edges are collected through the transposed
+	 * relation matrices. */
+
+	Node n;
+	Edge e;
+	size_t nodeCount = 16;
+
+	Graph *g = Graph_New(nodeCount, nodeCount);
+	Graph_AcquireWriteLock(g);
+	for(int i = 0; i < nodeCount; i++) Graph_CreateNode(g, GRAPH_NO_LABEL, &n);
+	int r0 = Graph_AddRelationType(g);
+	int r1 = Graph_AddRelationType(g);
+
+	// Node 0 is the hub, odd nodes connect via r0, even nodes via r1.
+	for(NodeID i = 1; i < nodeCount; i++) Graph_ConnectNodes(g, i, 0, (i % 2) ? r0 : r1, &e);
+	// Multiple edges and an outgoing edge of the hub.
+	Graph_ConnectNodes(g, 1, 0, r0, &e);
+	Graph_ConnectNodes(g, 0, 2, r0, &e);
+	Graph_ReleaseLock(g);
+
+	Graph_GetNode(g, 0, &n);
+	Edge *edges = array_new(Edge, 0);
+
+	Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_INCOMING, r0, &edges);
+	ASSERT_EQ(array_len(edges), 9);
+	for(uint i = 0; i < array_len(edges); i++) {
+		ASSERT_EQ(Edge_GetRelationID(edges + i), r0);
+		ASSERT_EQ(Edge_GetDestNodeID(edges + i), 0);
+		ASSERT_EQ(Edge_GetSrcNodeID(edges + i) % 2, 1);
+	}
+	array_clear(edges);
+
+	Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_INCOMING, r1, &edges);
+	ASSERT_EQ(array_len(edges), 7);
+	array_clear(edges);
+
+	Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_BOTH, r0, &edges);
+	ASSERT_EQ(array_len(edges), 10);
+	array_clear(edges);
+
+	Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_INCOMING, GRAPH_NO_RELATION, &edges);
+	ASSERT_EQ(array_len(edges), 16);
+	array_free(edges);
+
+	Graph_Free(g);
+}
+
+TEST_F(GraphTest, LabelBitmaps) {
+	/* Label nodes alternately and make sure label bitmaps agree
+	 * with label matrices, across node deletion. */
+
+	Node n;
+	size_t nodeCount = 256;
+
+	Graph *g = Graph_New(nodeCount, nodeCount);
+	Graph_AcquireWriteLock(g);
+	int l0 = Graph_AddLabel(g);
+	int l1 = Graph_AddLabel(g);
+	for(int i = 0; i < nodeCount; i++) {
+		int label = (i % 3 == 0) ? GRAPH_NO_LABEL : ((i % 3 == 1) ? l0 : l1);
+		Graph_CreateNode(g, label, &n);
+	}
+
+	for(NodeID i = 0; i < nodeCount; i++) {
+		int label = (i % 3 == 0) ? GRAPH_NO_LABEL : ((i % 3 == 1) ? l0 : l1);
+		ASSERT_EQ(Graph_GetNodeLabel(g, i), label);
+		ASSERT_EQ(Graph_NodeHasLabel(g, i, l0), label == l0);
+		ASSERT_EQ(Graph_NodeHasLabel(g, i, l1), label == l1);
+		ASSERT_FALSE(Graph_NodeHasLabel(g, i, GRAPH_UNKNOWN_LABEL));
+	}
+
+	// Iterate over l0 labeled nodes.
+	NodeID id = 0;
+	uint count = 0;
+	while(Graph_NextLabeledNode(g, l0, &id)) {
+		ASSERT_EQ(id % 3, 1);
+		count++;
+		id++;
+	}
+	ASSERT_EQ(count, nodeCount / 3);
+
+	// Deleted nodes are cleared from their label's bitmap.
+	Graph_GetNode(g, 1, &n);
+	Graph_DeleteNode(g, &n);
+	ASSERT_EQ(Graph_GetNodeLabel(g, 1), GRAPH_NO_LABEL);
+	id = 0;
+	ASSERT_TRUE(Graph_NextLabeledNode(g, l0, &id));
+	ASSERT_EQ(id, 4);
+	Graph_ReleaseLock(g);
+
+	// Bitmaps rebuilt from label matrices are identical.
+	Graph_RebuildLabelBitmaps(g);
+	for(NodeID i = 2; i < nodeCount; i++) {
+		int label = (i % 3 == 0) ? GRAPH_NO_LABEL : ((i % 3 == 1) ? l0 : l1);
+		ASSERT_EQ(Graph_GetNodeLabel(g, i), label);
+	}
+	ASSERT_FALSE(Graph_NodeHasLabel(g, 1, l0));
+
+	Graph_Free(g);
+}
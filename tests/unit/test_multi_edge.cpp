@@ -0,0 +1,170 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <pthread.h>
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/entities/multi_edge.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class MultiEdgeTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+
+	// Fills the first slab of a class and frees its arrays,
+	// runs on a thread of its own such that it starts with no slabs.
+	static void *release_empty_slab(void *arg) {
+		size_t size = 0;
+		uint count = 0;
+		EdgeID *arrays[MULTI_EDGE_SLAB_SIZE / 16];
+
+		// Allocate arrays until one isn't adjacent to its predecessor,
+		// it is the first array of a second slab.
+		while(true) {
+			EdgeID *ids = MultiEdge_New(64);
+			size = MultiEdge_SizeOf(ids);
+			arrays[count++] = ids;
+			if(count > 1 && (char *)ids != (char *)arrays[count - 2] + size) break;
+		}
+		EdgeID *last = arrays[count - 1];
+
+		// Free the arrays of the first slab, which is then released
+		// rather than handing its slots to the next array.
+		for(uint i = 0; i < count - 1; i++) MultiEdge_Free(arrays[i]);
+		EdgeID *next = MultiEdge_New(64);
+		*(bool *)arg = ((char *)next == (char *)last + size);
+
+		MultiEdge_Free(last);
+		MultiEdge_Free(next);
+		return NULL;
+	}
+
+	static void *alloc_arrays(void *arg) {
+		EdgeID **arrays = (EdgeID **)arg;
+		for(EdgeID i = 0; i < 1024; i++) {
+			arrays[i] = MultiEdge_New(2);
+			arrays[i] = MultiEdge_Append(arrays[i], i);
+		}
+		return NULL;
+	}
+};
+
+TEST_F(MultiEdgeTest, Append) {
+	EdgeID *ids = MultiEdge_New(MULTI_EDGE_MIN_CAP);
+	ASSERT_EQ(MultiEdge_Count(ids), 0);
+	// Arrays of the slab classes aren't heap allocated.
+	ASSERT_TRUE(MultiEdge_Allocation(ids) == NULL);
+
+	// Grow the array past the largest class.
+	uint count = 1024;
+	for(uint i = 0; i < count; i++) {
+		ids = MultiEdge_Append(ids, i);
+		ASSERT_EQ(MultiEdge_Count(ids), i + 1);
+	}
+	ASSERT_TRUE(MultiEdge_Allocation(ids) != NULL);
+	ASSERT_GE(MultiEdge_SizeOf(ids), count * sizeof(EdgeID));
+
+	// IDs are contiguous and kept in insertion order.
+	for(uint i = 0; i < count; i++) ASSERT_EQ(ids[i], i);
+
+	MultiEdge_Free(ids);
+}
+
+TEST_F(MultiEdgeTest, Remove) {
+	EdgeID *ids = MultiEdge_New(4);
+	for(EdgeID i = 0; i < 4; i++) ids = MultiEdge_Append(ids, i);
+
+	// The last ID takes the place of the removed one.
+	MultiEdge_Remove(ids, 1);
+	ASSERT_EQ(MultiEdge_Count(ids), 3);
+	ASSERT_EQ(ids[0], 0);
+	ASSERT_EQ(ids[1], 3);
+	ASSERT_EQ(ids[2], 2);
+
+	MultiEdge_Remove(ids, 2);
+	ASSERT_EQ(MultiEdge_Count(ids), 2);
+	ASSERT_EQ(ids[0], 0);
+	ASSERT_EQ(ids[1], 3);
+
+	MultiEdge_Free(ids);
+}
+
+TEST_F(MultiEdgeTest, ReuseSlots) {
+	EdgeID *a = MultiEdge_New(2);
+	EdgeID *b = MultiEdge_New(2);
+	ASSERT_NE(a, b);
+
+	// A released slot is handed to the next array of its class.
+	MultiEdge_Free(a);
+	EdgeID *c = MultiEdge_New(2);
+	ASSERT_EQ(a, c);
+	ASSERT_EQ(MultiEdge_Count(c), 0);
+
+	// Arrays of a different class are served from other slabs.
+	MultiEdge_Free(b);
+	EdgeID *d = MultiEdge_New(8);
+	ASSERT_NE(b, d);
+
+	MultiEdge_Free(c);
+	MultiEdge_Free(d);
+}
+
+TEST_F(MultiEdgeTest, Move) {
+	EdgeID *ids = MultiEdge_New(2);
+	for(EdgeID i = 0; i < 3; i++) ids = MultiEdge_Append(ids, i);
+
+	// Moved arrays are sized to their content.
+	EdgeID *moved = MultiEdge_Move(ids, dram_malloc);
+	ASSERT_TRUE(moved != NULL);
+	ASSERT_TRUE(MultiEdge_Allocation(moved) != NULL);
+	ASSERT_EQ(MultiEdge_Count(moved), 3);
+	ASSERT_EQ(MultiEdge_SizeOf(moved), 8 + 3 * sizeof(EdgeID));
+	for(EdgeID i = 0; i < 3; i++) ASSERT_EQ(moved[i], i);
+
+	// Appending to a full moved array moves it back into a slab.
+	moved = MultiEdge_Append(moved, 3);
+	ASSERT_TRUE(MultiEdge_Allocation(moved) == NULL);
+	ASSERT_EQ(MultiEdge_Count(moved), 4);
+	for(EdgeID i = 0; i < 4; i++) ASSERT_EQ(moved[i], i);
+
+	MultiEdge_Free(moved);
+}
+
+TEST_F(MultiEdgeTest, ReleaseEmptySlabs) {
+	bool released = false;
+	pthread_t t;
+	ASSERT_EQ(pthread_create(&t, NULL, release_empty_slab, &released), 0);
+	pthread_join(t, NULL);
+	ASSERT_TRUE(released);
+}
+
+TEST_F(MultiEdgeTest, ReleaseFromOtherThread) {
+	EdgeID *arrays[1024];
+	pthread_t t;
+
+	// Arrays outlive the thread which allocated them.
+	ASSERT_EQ(pthread_create(&t, NULL, alloc_arrays, arrays), 0);
+	pthread_join(t, NULL);
+
+	for(EdgeID i = 0; i < 1024; i++) {
+		ASSERT_EQ(MultiEdge_Count(arrays[i]), 1);
+		ASSERT_EQ(arrays[i][0], i);
+		arrays[i] = MultiEdge_Append(arrays[i], i);
+		MultiEdge_Free(arrays[i]);
+	}
+}